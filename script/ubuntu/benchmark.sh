@@ -0,0 +1,48 @@
+#! /bin/bash
+
+set -u
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+BACKEND="${BACKEND:-vm}"
+COMPILER="${COMPILER:-build/Compiler}"
+STATUS=0
+
+# With "perf" installed, it also counts the branches and mispredictions.
+PERF=""
+if command -v perf > /dev/null 2>&1; then
+	PERF="perf stat --field-separator=, --event=instructions,branches,branch-misses --output=build/perf.csv"
+fi
+
+echo "Running benchmarks with \"$COMPILER\" and the \"$BACKEND\" backend..."
+echo ""
+
+for benchmark in $(ls src/test/c/benchmark/ | grep "\.arcx$"); do
+	# The "c" backend only translates the program, so it's built beforehand,
+	# and the time is the one of the executable.
+	if [ "$BACKEND" == "c" ]; then
+		EXECUTABLE="build/native/${benchmark%.arcx}"
+		COMPILER="$COMPILER" script/ubuntu/native.sh "src/test/c/benchmark/$benchmark" "$EXECUTABLE" > /dev/null 2>&1
+		START=$(date +%s%N)
+		OUTPUT=$($PERF "$EXECUTABLE" 2> /dev/null)
+		RESULT="$?"
+	else
+		START=$(date +%s%N)
+		OUTPUT=$(cat "src/test/c/benchmark/$benchmark" | BACKEND="$BACKEND" LOGGING_LEVEL=ERROR $PERF "$COMPILER" 2> /dev/null)
+		RESULT="$?"
+	fi
+	END=$(date +%s%N)
+	if [ "$RESULT" != "0" ]; then
+		STATUS=1
+	fi
+	printf "    %-24s %8d ms (status %d, output: %s)\n" "$benchmark" $(((END - START) / 1000000)) "$RESULT" "$OUTPUT"
+	if [ -n "$PERF" ]; then
+		grep --extended-regexp "instructions|branches|branch-misses" build/perf.csv \
+			| awk -F, '{ printf "        %-16s %16s\n", $3, $1 }'
+	fi
+done
+echo ""
+
+echo "All done."
+exit $STATUS
@@ -0,0 +1,23 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# Builds the compiler twice, once per dispatch strategy of the virtual
+# machine and without AddressSanitizer, and runs the benchmarks with each
+# one. A failing benchmark sets the status, but doesn't stop the comparison.
+STATUS=0
+for DISPATCH in ON OFF; do
+	cmake -S . -B "build-dispatch-$DISPATCH" -DDIRECT_THREADED_DISPATCH=$DISPATCH -DADDRESS_SANITIZER=OFF > /dev/null
+	cmake --build "build-dispatch-$DISPATCH" > /dev/null
+done
+
+mkdir --parents build
+echo "Direct threading (computed goto):"
+COMPILER="build-dispatch-ON/Compiler" script/ubuntu/benchmark.sh || STATUS=1
+echo ""
+echo "Switch:"
+COMPILER="build-dispatch-OFF/Compiler" script/ubuntu/benchmark.sh || STATUS=1
+exit $STATUS
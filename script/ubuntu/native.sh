@@ -0,0 +1,18 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# Translates a program to C with the "c" backend, and builds it with the
+# runtime into "build/native/<program>" (or the given executable).
+INPUT="$1"
+NAME="$(basename "${INPUT%.*}")"
+OUTPUT="${2:-build/native/$NAME}"
+COMPILER="${COMPILER:-build/Compiler}"
+RUNTIME="src/main/c/backend/code-generation/runtime"
+
+mkdir --parents "$(dirname "$OUTPUT")"
+cat "$INPUT" | BACKEND=c LOGGING_LEVEL=ERROR "$COMPILER" > "$OUTPUT.c"
+${CC:-cc} -std=gnu99 -O2 -I "$RUNTIME" "$OUTPUT.c" "$RUNTIME/ArcanaRuntime.c" -o "$OUTPUT" -lm
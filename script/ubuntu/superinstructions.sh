@@ -0,0 +1,95 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# The amount of superinstructions to generate.
+COUNT="${1:-8}"
+COMPILER="${COMPILER:-build-profile/Compiler}"
+PROFILE="build-profile/opcode-pairs.csv"
+BYTECODE="src/main/c/backend/virtual-machine/Bytecode.h"
+MACHINE="src/main/c/backend/virtual-machine/VirtualMachine.c"
+HEADER="src/main/c/backend/virtual-machine/Superinstructions.h"
+
+# Builds the compiler with the opcode-pair profiling, unless COMPILER already
+# points to such a build.
+if [ "$COMPILER" == "build-profile/Compiler" ]; then
+	cmake -S . -B build-profile -DOPCODE_PROFILING=ON > /dev/null
+	cmake --build build-profile > /dev/null
+fi
+mkdir --parents build-profile
+rm --force "$PROFILE"
+
+# Without superinstructions, every pair of opcodes shows up in the profile.
+echo "Profiling pairs of opcodes with \"$COMPILER\"..."
+for program in src/test/c/benchmark/*.arcx src/test/c/execute/*.arcx; do
+	cat "$program" | BACKEND=vm LOGGING_LEVEL=ERROR VM_SUPERINSTRUCTIONS=false VM_PROFILE="$PROFILE" "$COMPILER" > /dev/null 2>&1 \
+		|| echo "    The program \"$program\" fails."
+done
+
+# A pair qualifies if its first opcode has an effect in the virtual machine
+# (EFFECT_* macros), and its second opcode doesn't quicken (i.e., it has no
+# specialized forms, which would be rewritten on every run).
+FORMATS=$(grep --only-matching --perl-regexp "OPCODE\(\K[A-Z_]+, [A-Z]+(?=\))" "$BYTECODE" | tr --delete " " | tr "\n" " ")
+EFFECTS=$(grep --only-matching --perl-regexp "#define EFFECT_\K[A-Z_]+(?=\(\))" "$MACHINE" | tr "\n" " ")
+
+# The pairs of every run, added up, from the hottest one.
+awk -F, '
+	{ counts[$1 "," $2] += $3; total += $3; }
+	END { for (key in counts) print counts[key] "," key "," total; }' "$PROFILE" \
+	| sort --field-separator=, --key=1,1 --numeric-sort --reverse > "$PROFILE.sorted"
+
+SELECTED=$(awk -F, -v count="$COUNT" -v formats="$FORMATS" -v effects="$EFFECTS" '
+	BEGIN {
+		split(formats, lines, " ");
+		for (k in lines) {
+			split(lines[k], pair, ",");
+			format[pair[1]] = pair[2];
+			if (match(pair[1], /_(INT|DEC|LIST|RANGE)$/)) {
+				quickens[substr(pair[1], 1, RSTART - 1)] = 1;
+			}
+		}
+		split(effects, names, " ");
+		for (k in names) {
+			hasEffect[names[k]] = 1;
+		}
+	}
+	{
+		qualifies = ($2 in hasEffect) && !($3 in quickens) && selected < count;
+		if (NR <= 24) {
+			printf "    %-14s %-14s %14d %6.2f%% %s\n", $2, $3, $1, 100.0 * $1 / $4, qualifies ? "(selected)" : "" > "/dev/stderr";
+		}
+		if (qualifies) {
+			selected += 1;
+			print $2 "," $3 "," format[$2];
+		}
+	}' "$PROFILE.sorted")
+
+# Generates the superinstructions, for the next build.
+{
+	echo "#ifndef SUPERINSTRUCTIONS_HEADER"
+	echo "#define SUPERINSTRUCTIONS_HEADER"
+	echo ""
+	echo "/**"
+	echo " * The superinstructions of the virtual machine, as SUPERINSTRUCTION(argument,"
+	echo " * name, first, second, format of the first). Generated by"
+	echo " * \"script/ubuntu/superinstructions.sh\" from the hottest pairs of opcodes of"
+	echo " * the benchmarks and the execution tests. Don't edit it by hand."
+	echo " */"
+	if [ -z "$SELECTED" ]; then
+		echo "#define SUPERINSTRUCTIONS(SUPERINSTRUCTION, argument)"
+	else
+		echo "#define SUPERINSTRUCTIONS(SUPERINSTRUCTION, argument) \\"
+		echo "$SELECTED" | awk -F, '
+			{ lines[NR] = sprintf("\tSUPERINSTRUCTION(argument, %s_%s, %s, %s, %s)", $1, $2, $1, $2, $3); }
+			END { for (k = 1; k <= NR; ++k) print lines[k] (k < NR ? " \\" : ""); }'
+	fi
+	echo ""
+	echo "#endif"
+} > "$HEADER"
+
+echo ""
+echo "Generated $(echo -n "$SELECTED" | grep --count "," || true) superinstruction(s) into \"$HEADER\"."
+echo "All done."
@@ -40,5 +40,39 @@ for test in $(ls src/test/c/reject/); do
 done
 echo ""
 
+echo "Compiler should execute..."
+echo ""
+
+for test in $(ls src/test/c/execute/ | grep "\.arcx$"); do
+	EXPECTED="src/test/c/execute/${test%.arcx}.out"
+	OUTPUT=$(cat "src/test/c/execute/$test" | BACKEND=vm LOGGING_LEVEL=ERROR build/Compiler 2> /dev/null)
+	RESULT="$?"
+	if [ "$RESULT" == "0" ] && [ "$OUTPUT" == "$(cat "$EXPECTED")" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it fails${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+echo "Compiler should translate to C and execute..."
+echo ""
+
+for test in $(ls src/test/c/execute/ | grep "\.arcx$"); do
+	EXPECTED="src/test/c/execute/${test%.arcx}.out"
+	EXECUTABLE="build/native/${test%.arcx}"
+	script/ubuntu/native.sh "src/test/c/execute/$test" "$EXECUTABLE" > /dev/null 2>&1 \
+		&& OUTPUT=$("$EXECUTABLE" 2> /dev/null)
+	RESULT="$?"
+	if [ "$RESULT" == "0" ] && [ "$OUTPUT" == "$(cat "$EXPECTED")" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it fails${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
 echo "All done."
 exit $STATUS
@@ -34,6 +34,26 @@
 	)
 )
 
+@echo Compiler should execute...
+@echo:
+
+@set BACKEND=vm
+@set LOGGING_LEVEL=ERROR
+@for /f %%f in ('dir /b !BASE_PATH!\src\test\c\execute\*.arcx') do @(
+	@type !BASE_PATH!\src\test\c\execute\%%f | !BASE_PATH!\build\Debug\Compiler.exe >!TEMP!\%%~nf.txt 2>nul
+	@set RESULT=!ERRORLEVEL!
+	@set SAME=1
+	@fc /w !TEMP!\%%~nf.txt !BASE_PATH!\src\test\c\execute\%%~nf.out >nul 2>&1 || set SAME=0
+	if !RESULT!!SAME! equ 01 (
+		@echo     "%%f", [92mand it does[0m ^(status !RESULT!^)
+	) else (
+		@set STATUS=1
+		@echo     "%%f", [91mbut it fails[0m ^(status !RESULT!^)
+	)
+	@del !TEMP!\%%~nf.txt
+)
+@echo:
+
 @exit /B %STATUS%
 
 @ENDLOCAL
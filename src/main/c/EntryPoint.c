@@ -1,5 +1,22 @@
-#include "backend/code-generation/Generator.h"
+#include "backend/Backend.h"
+#include "backend/Emitter.h"
+#include "backend/code-generation/Transpiler.h"
+#include "backend/intermediate-representation/EscapeAnalysis.h"
+#include "backend/intermediate-representation/Inliner.h"
+#include "backend/intermediate-representation/IntermediateRepresentation.h"
+#include "backend/intermediate-representation/Optimizer.h"
+#include "backend/virtual-machine/BytecodeCompiler.h"
+#include "backend/virtual-machine/GarbageCollector.h"
+#include "backend/virtual-machine/VirtualMachine.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/semantic-analysis/CaptureAnalysis.h"
+#include "frontend/semantic-analysis/ControlFlowGraph.h"
+#include "frontend/semantic-analysis/PassManager.h"
+#include "frontend/semantic-analysis/Reachability.h"
+#include "frontend/semantic-analysis/SemanticAnalyzer.h"
+#include "frontend/semantic-analysis/Signatures.h"
+#include "frontend/semantic-analysis/TreeStatistics.h"
+#include "frontend/semantic-analysis/VariableAnalysis.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
@@ -21,7 +38,24 @@ const int main(const int count, const char ** arguments) {
 	initializeBisonActionsModule();
 	initializeSyntacticAnalyzerModule();
 	initializeAbstractSyntaxTreeModule();
-	// initializeGeneratorModule();
+	initializeReachabilityModule();
+	initializeSignaturesModule();
+	initializeTreeStatisticsModule();
+	initializeCaptureAnalysisModule();
+	initializeControlFlowGraphModule();
+	initializeVariableAnalysisModule();
+	initializePassManagerModule();
+	initializeSemanticAnalyzerModule();
+	initializeEmitterModule();
+	initializeInlinerModule();
+	initializeIntermediateRepresentationModule();
+	initializeOptimizerModule();
+	initializeEscapeAnalysisModule();
+	initializeTranspilerModule();
+	initializeBytecodeCompilerModule();
+	initializeGarbageCollectorModule();
+	initializeVirtualMachineModule();
+	initializeBackendModule();
 	initializeContextStack();
 	
 	// Logs the arguments of the application.
@@ -38,15 +72,20 @@ const int main(const int count, const char ** arguments) {
 	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
 	CompilationStatus compilationStatus = SUCCEED;
 	if (syntacticAnalysisStatus == ACCEPT) {
-		// ----------------------------------------------------------------------------------------
-		// Beginning of the Backend... ------------------------------------------------------------
-		
-		// logDebugging(logger, "Computing expression value...");
 		Program * program = compilerState.abstractSyntaxtTree;
- 		// ...end of the Backend. -----------------------------------------------------------------
-		// ----------------------------------------------------------------------------------------
-
 		logDebugging(logger, "The syntactic is ok");
+		if (analyze(&compilerState) == SEMANTIC_ACCEPT) {
+			// ----------------------------------------------------------------------------------------
+			// Beginning of the Backend... ------------------------------------------------------------
+
+			compilationStatus = runBackend(program);
+			// ...end of the Backend. -----------------------------------------------------------------
+			// ----------------------------------------------------------------------------------------
+		}
+		else {
+			logError(logger, "The semantic-analysis phase rejects the input program.");
+			compilationStatus = FAILED;
+		}
 		logDebugging(logger, "Releasing AST resources...");
 		releaseProgram(program);
 	}
@@ -57,7 +96,24 @@ const int main(const int count, const char ** arguments) {
 	
 	logDebugging(logger, "Releasing modules resources...");
 	shutdownContextStack();
-	// shutdownGeneratorModule();
+	shutdownBackendModule();
+	shutdownVirtualMachineModule();
+	shutdownGarbageCollectorModule();
+	shutdownBytecodeCompilerModule();
+	shutdownTranspilerModule();
+	shutdownEscapeAnalysisModule();
+	shutdownOptimizerModule();
+	shutdownIntermediateRepresentationModule();
+	shutdownInlinerModule();
+	shutdownEmitterModule();
+	shutdownSemanticAnalyzerModule();
+	shutdownPassManagerModule();
+	shutdownVariableAnalysisModule();
+	shutdownControlFlowGraphModule();
+	shutdownCaptureAnalysisModule();
+	shutdownTreeStatisticsModule();
+	shutdownSignaturesModule();
+	shutdownReachabilityModule();
 	shutdownAbstractSyntaxTreeModule();
 	shutdownSyntacticAnalyzerModule();
 	shutdownBisonActionsModule();
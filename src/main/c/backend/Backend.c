@@ -0,0 +1,105 @@
+#include "Backend.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeBackendModule() {
+	_logger = createLogger("Backend");
+}
+
+void shutdownBackendModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static CompilationStatus _runTranspiler(Program * program);
+static CompilationStatus _runVirtualMachine(Program * program);
+
+/**
+ * Translates the program to C, and writes it to the standard output (see
+ * "script/ubuntu/native.sh" to build it).
+ */
+static CompilationStatus _runTranspiler(Program * program) {
+	fflush(stdout);
+	if (!transpileProgram(program, STDOUT_FILENO)) {
+		logError(_logger, "The transpiler rejects the input program.");
+		return FAILED;
+	}
+	return SUCCEED;
+}
+
+/**
+ * Compiles and executes the program. With "VM_DISASSEMBLE", it also prints
+ * the bytecode before the execution (with its superinstructions, unless
+ * "VM_SUPERINSTRUCTIONS" turns them off).
+ */
+static CompilationStatus _runVirtualMachine(Program * program) {
+	CompiledProgram * compiledProgram = compileProgram(program);
+	if (compiledProgram == NULL) {
+		logError(_logger, "The bytecode compiler rejects the input program.");
+		return FAILED;
+	}
+	if (getBooleanOrDefault("VM_SUPERINSTRUCTIONS", true)) {
+		fuseSuperinstructions(compiledProgram);
+	}
+	if (getBooleanOrDefault("VM_DISASSEMBLE", false)) {
+		Emitter * emitter = createEmitter(STDOUT_FILENO);
+		fflush(stdout);
+		disassembleProgram(emitter, compiledProgram);
+		destroyEmitter(emitter);
+	}
+	fflush(stdout);
+	const boolean succeed = executeProgram(compiledProgram);
+	releaseCompiledProgram(compiledProgram);
+	if (!succeed) {
+		logError(_logger, "The execution of the program fails.");
+		return FAILED;
+	}
+	return SUCCEED;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus runBackend(Program * program) {
+	const char * backend = getStringOrDefault("BACKEND", "none");
+	if (strcmp(backend, "none") == 0) {
+		return SUCCEED;
+	}
+	if (getBooleanOrDefault("INLINING", true)) {
+		Emitter * report = NULL;
+		if (getBooleanOrDefault("INLINING_REPORT", false)) {
+			fflush(stdout);
+			report = createEmitter(STDOUT_FILENO);
+		}
+		inlineCalls(program, report);
+		if (report != NULL) {
+			destroyEmitter(report);
+		}
+	}
+	if (getBooleanOrDefault("IR_OPTIMIZATIONS", true)) {
+		Emitter * dump = NULL;
+		if (getBooleanOrDefault("IR_DUMP", false)) {
+			fflush(stdout);
+			dump = createEmitter(STDOUT_FILENO);
+		}
+		optimizeProgram(program, dump);
+		if (dump != NULL) {
+			destroyEmitter(dump);
+		}
+	}
+	if (getBooleanOrDefault("ESCAPE_ANALYSIS", true)) {
+		analyzeEscapes(program);
+	}
+	if (strcmp(backend, "vm") == 0) {
+		return _runVirtualMachine(program);
+	}
+	if (strcmp(backend, "c") == 0) {
+		return _runTranspiler(program);
+	}
+	logError(_logger, "Unknown backend: \"%s\".", backend);
+	return FAILED;
+}
@@ -0,0 +1,33 @@
+#ifndef BACKEND_HEADER
+#define BACKEND_HEADER
+
+#include "../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Environment.h"
+#include "../shared/Logger.h"
+#include "../shared/Type.h"
+#include "Emitter.h"
+#include "code-generation/Transpiler.h"
+#include "intermediate-representation/EscapeAnalysis.h"
+#include "intermediate-representation/Inliner.h"
+#include "intermediate-representation/Optimizer.h"
+#include "virtual-machine/Bytecode.h"
+#include "virtual-machine/BytecodeCompiler.h"
+#include "virtual-machine/VirtualMachine.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBackendModule();
+
+/** Shutdown module's internal state. */
+void shutdownBackendModule();
+
+/**
+ * Runs the backend selected with the "BACKEND" environment variable over an
+ * analyzed program: "none" stops after the analysis, "vm" compiles the
+ * program to bytecode and executes it, and "c" translates it to C.
+ */
+CompilationStatus runBackend(Program * program);
+
+#endif
@@ -0,0 +1,185 @@
+#include "Emitter.h"
+
+/* MODULE INTERNAL STATE */
+
+static const char _tabs[] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+static Logger * _logger = NULL;
+
+void initializeEmitterModule() {
+	_logger = createLogger("Emitter");
+}
+
+void shutdownEmitterModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _reserve(Emitter * emitter, const int length);
+static boolean _write(const int fileDescriptor, EmitterSegment * segments, int count);
+
+/**
+ * Makes room for more characters (and a terminator). A full batch is written
+ * first, if the emitter has a file descriptor.
+ */
+static void _reserve(Emitter * emitter, const int length) {
+	if (0 <= emitter->fileDescriptor && EMITTER_BATCH_SIZE <= emitter->length) {
+		flushEmitter(emitter);
+	}
+	if (emitter->length + length < emitter->capacity) {
+		return;
+	}
+	int capacity = emitter->capacity == 0 ? 256 : emitter->capacity;
+	while (capacity <= emitter->length + length) {
+		capacity *= 2;
+	}
+	emitter->data = realloc(emitter->data, capacity);
+	emitter->capacity = capacity;
+}
+
+/**
+ * Writes every segment, retrying after interruptions and partial writes
+ * (which consume the segments).
+ */
+static boolean _write(const int fileDescriptor, EmitterSegment * segments, int count) {
+#ifdef EMITTER_VECTORED_WRITES
+	while (0 < count) {
+		const int batch = count < IOV_MAX ? count : IOV_MAX;
+		const ssize_t written = writev(fileDescriptor, segments, batch);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			logError(_logger, "Cannot write to the file descriptor %d: %s.", fileDescriptor, strerror(errno));
+			return false;
+		}
+		size_t remaining = (size_t) written;
+		while (0 < count && segments->iov_len <= remaining) {
+			remaining -= segments->iov_len;
+			++segments;
+			--count;
+		}
+		if (0 < count) {
+			segments->iov_base = (char *) segments->iov_base + remaining;
+			segments->iov_len -= remaining;
+		}
+	}
+	return true;
+#else
+	FILE * stream = fileDescriptor == STDOUT_FILENO ? stdout : (fileDescriptor == STDERR_FILENO ? stderr : NULL);
+	if (stream == NULL) {
+		logError(_logger, "Cannot write to the file descriptor %d: only the standard output and error are supported.", fileDescriptor);
+		return false;
+	}
+	for (int k = 0; k < count; ++k) {
+		if (fwrite(segments[k].iov_base, 1, segments[k].iov_len, stream) < segments[k].iov_len) {
+			logError(_logger, "Cannot write to the file descriptor %d: %s.", fileDescriptor, strerror(errno));
+			return false;
+		}
+	}
+	return fflush(stream) == 0 ? true : false;
+#endif
+}
+
+/* PUBLIC FUNCTIONS */
+
+Emitter * createEmitter(const int fileDescriptor) {
+	Emitter * emitter = calloc(1, sizeof(Emitter));
+	emitter->fileDescriptor = fileDescriptor;
+	return emitter;
+}
+
+void destroyEmitter(Emitter * emitter) {
+	if (emitter != NULL) {
+		if (0 <= emitter->fileDescriptor) {
+			flushEmitter(emitter);
+		}
+		free(emitter->data);
+		free(emitter);
+	}
+}
+
+void emit(Emitter * emitter, const char * format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	emitArguments(emitter, format, arguments);
+	va_end(arguments);
+}
+
+void emitArguments(Emitter * emitter, const char * format, va_list arguments) {
+	_reserve(emitter, 0);
+	va_list copy;
+	va_copy(copy, arguments);
+	const int available = emitter->capacity - emitter->length;
+	const int length = vsnprintf(emitter->data + emitter->length, available, format, copy);
+	va_end(copy);
+	if (available <= length) {
+		_reserve(emitter, length);
+		vsnprintf(emitter->data + emitter->length, length + 1, format, arguments);
+	}
+	emitter->length += length;
+}
+
+void emitIndentation(Emitter * emitter, const int level) {
+	const int size = sizeof(_tabs) - 1;
+	for (int remaining = level; 0 < remaining; remaining -= size) {
+		emitText(emitter, _tabs, remaining < size ? remaining : size);
+	}
+}
+
+void emitLine(Emitter * emitter, const int level, const char * format, ...) {
+	emitIndentation(emitter, level);
+	va_list arguments;
+	va_start(arguments, format);
+	emitArguments(emitter, format, arguments);
+	va_end(arguments);
+	emitText(emitter, "\n", 1);
+}
+
+void emitText(Emitter * emitter, const char * text, const int length) {
+	_reserve(emitter, length);
+	memcpy(emitter->data + emitter->length, text, length);
+	emitter->length += length;
+	emitter->data[emitter->length] = '\0';
+}
+
+void emitEmitter(Emitter * emitter, const Emitter * source) {
+	if (0 < source->length) {
+		emitText(emitter, source->data, source->length);
+	}
+}
+
+void clearEmitter(Emitter * emitter) {
+	emitter->length = 0;
+	if (emitter->data != NULL) {
+		emitter->data[0] = '\0';
+	}
+}
+
+boolean flushEmitter(Emitter * emitter) {
+	if (0 < emitter->length && 0 <= emitter->fileDescriptor) {
+		EmitterSegment segment = { emitter->data, (size_t) emitter->length };
+		if (!emitter->hasFailed && !_write(emitter->fileDescriptor, &segment, 1)) {
+			emitter->hasFailed = true;
+		}
+		clearEmitter(emitter);
+	}
+	return emitter->hasFailed ? false : true;
+}
+
+boolean flushEmitters(const int fileDescriptor, Emitter ** emitters, const int count) {
+	EmitterSegment * segments = calloc(count + 1, sizeof(EmitterSegment));
+	int segmentCount = 0;
+	for (int k = 0; k < count; ++k) {
+		if (0 < emitters[k]->length) {
+			segments[segmentCount].iov_base = emitters[k]->data;
+			segments[segmentCount++].iov_len = (size_t) emitters[k]->length;
+		}
+	}
+	const boolean succeed = _write(fileDescriptor, segments, segmentCount);
+	for (int k = 0; k < count; ++k) {
+		clearEmitter(emitters[k]);
+	}
+	free(segments);
+	return succeed;
+}
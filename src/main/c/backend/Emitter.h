@@ -0,0 +1,112 @@
+#ifndef EMITTER_HEADER
+#define EMITTER_HEADER
+
+#include "../shared/Logger.h"
+#include "../shared/Type.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Vectored writes are a fast path of POSIX systems. Without them (e.g., with
+ * MSVC), the segments are written one at a time to the standard stream of
+ * the file descriptor.
+ */
+#if defined (HAVE_WRITEV) && !defined (_WIN32)
+#define EMITTER_VECTORED_WRITES
+#include <sys/uio.h>
+#include <unistd.h>
+typedef struct iovec EmitterSegment;
+#else
+typedef struct {
+	void * iov_base;
+	size_t iov_len;
+} EmitterSegment;
+#endif
+
+#ifndef STDOUT_FILENO
+#define STDOUT_FILENO 1
+#endif
+
+#ifndef STDERR_FILENO
+#define STDERR_FILENO 2
+#endif
+
+/** The most segments of a single vectored write (POSIX guarantees 16). */
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/** The amount of buffered bytes that an emitter writes at once. */
+#define EMITTER_BATCH_SIZE (1 << 16)
+
+/**
+ * A growable output buffer, shared by every backend. An emitter with a file
+ * descriptor writes its output in large batches (and when it's flushed), and
+ * one without it only accumulates the output, e.g., to emit it later as a
+ * segment of another output.
+ */
+typedef struct {
+	char * data;
+	int length;
+	int capacity;
+	int fileDescriptor;
+	boolean hasFailed;
+} Emitter;
+
+/** Initialize module's internal state. */
+void initializeEmitterModule();
+
+/** Shutdown module's internal state. */
+void shutdownEmitterModule();
+
+/**
+ * Creates an emitter (using heap-memory) that writes to the file descriptor,
+ * or only buffers its output if the descriptor is negative.
+ */
+Emitter * createEmitter(const int fileDescriptor);
+
+/** Writes the pending output (if any), and releases the emitter. */
+void destroyEmitter(Emitter * emitter);
+
+/** Appends formatted text, like "printf". */
+void emit(Emitter * emitter, const char * format, ...);
+
+/** Appends formatted text, like "vprintf". */
+void emitArguments(Emitter * emitter, const char * format, va_list arguments);
+
+/** Appends a number of tabs, without allocations. */
+void emitIndentation(Emitter * emitter, const int level);
+
+/** Appends a formatted line, after the indentation of the given level. */
+void emitLine(Emitter * emitter, const int level, const char * format, ...);
+
+/** Appends the characters, which don't need a terminator. */
+void emitText(Emitter * emitter, const char * text, const int length);
+
+/** Appends the output buffered by another emitter. */
+void emitEmitter(Emitter * emitter, const Emitter * source);
+
+/** Discards the buffered output. */
+void clearEmitter(Emitter * emitter);
+
+/**
+ * Writes the buffered output to the file descriptor of the emitter.
+ *
+ * @return Whether every write succeeds (since the creation of the emitter).
+ */
+boolean flushEmitter(Emitter * emitter);
+
+/**
+ * Writes the output buffered by several emitters to a file descriptor, as
+ * consecutive segments of a single vectored write (when possible), and
+ * discards it.
+ *
+ * @return Whether the whole output is written.
+ */
+boolean flushEmitters(const int fileDescriptor, Emitter ** emitters, const int count);
+
+#endif
@@ -0,0 +1,2848 @@
+#include "Transpiler.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeTranspilerModule() {
+	_logger = createLogger("Transpiler");
+}
+
+void shutdownTranspilerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * What the transpiler knows about the values of a local variable or an
+ * expression, as the C type that holds them. Undetermined is the bottom of
+ * the lattice (e.g., a variable whose stores haven't been seen yet), and any
+ * mix of types is a value of the runtime.
+ */
+typedef enum {
+	UNDETERMINED_NATIVE_TYPE,
+	INTEGER_NATIVE_TYPE,
+	DECIMAL_NATIVE_TYPE,
+	VALUE_NATIVE_TYPE
+} NativeType;
+
+/**
+ * The versions of a function. The entry checks the arguments and computes
+ * the missing ones, and then calls the typed body if the arguments have the
+ * declared types, or the generic body otherwise.
+ */
+typedef enum {
+	ENTRY_VERSION,
+	TYPED_VERSION,
+	GENERIC_VERSION
+} Version;
+
+typedef enum {
+	LOCAL_LOCATION,
+	CAPTURE_LOCATION,
+	FIELD_LOCATION,
+	STATIC_LOCATION,
+	METHOD_LOCATION,
+	GLOBAL_LOCATION,
+	UNRESOLVED_LOCATION
+} LocationType;
+
+typedef struct {
+	const char ** names;
+	int count;
+	int capacity;
+} NameSet;
+
+typedef struct ClassLayout ClassLayout;
+typedef struct FunctionRecord FunctionRecord;
+
+/** The type of the values of a local variable, in a version of a function. */
+typedef struct {
+	Version version;
+	const void * node;
+	NativeType type;
+} TypeFact;
+
+/**
+ * A field lives in the structure of the class that declares it first, at the
+ * same index of the fields of every descendant. The slot of the owner knows
+ * the type of the values of the field, in any instance. An eternal field
+ * lives in the static segment of its owner instead.
+ */
+typedef struct {
+	const char * name;
+	ClassLayout * owner;
+	int index;
+	NativeType type;
+} FieldSlot;
+
+/**
+ * A method lives in the table of the class that declares it first, and the
+ * tables of its descendants point to their own implementation (if any). A
+ * slot is overridden if a descendant has another implementation in it.
+ */
+typedef struct {
+	const char * name;
+	ClassLayout * owner;
+	FunctionRecord * function;
+	boolean isOverridden;
+} MethodSlot;
+
+/**
+ * The layout of a class, or of an instantiation of a generic class: the
+ * types that its constructions bind to each parameter of the generic one,
+ * and the fewest arguments that they pass (only those constructions create
+ * its instances).
+ */
+struct ClassLayout {
+	Class * source;
+	const char * name;
+	ClassLayout * parent;
+	ClassLayout * generic;
+	NativeType * bindings;
+	int leastArgumentCount;
+	int depth;
+	FieldSlot * fields;
+	int fieldCount;
+	FieldSlot * statics;
+	int staticCount;
+	MethodSlot * methods;
+	int methodCount;
+	FunctionRecord * initializer;
+	boolean isLaidOut;
+};
+
+/**
+ * A function of the output: a lambda, a method, the initializer of a class,
+ * or the program. Records persist across the passes, since they accumulate
+ * what the transpiler learns about the function. The shared captures are
+ * cells, and the environment copies the value of any other one. The
+ * functions of an instantiation (and their lambdas) have records of their
+ * own.
+ */
+struct FunctionRecord {
+	const void * key;
+	Lambda * lambda;
+	ClassLayout * class;
+	ClassLayout * instantiation;
+	char * name;
+	char * displayName;
+	NameSet captures;
+	NameSet sharedCaptures;
+	int parameterCount;
+	NativeType * parameterTypes;
+	boolean hasTypedBody;
+	NativeType returnTypes[GENERIC_VERSION + 1];
+	TypeFact * facts;
+	int factCount;
+	int factCapacity;
+	int pass;
+};
+
+/**
+ * The whole translation. The program is generated again until a pass learns
+ * nothing new about the types, and only the output of that pass is kept.
+ */
+typedef struct {
+	Program * program;
+	FunctionRecord ** functions;
+	int functionCount;
+	ClassLayout ** classes;
+	int classCount;
+	int monomorphizationBudget;
+	int monomorphizedCost;
+	const char ** storedNames;
+	int * storeCounts;
+	Lambda ** boundLambdas;
+	int storedNameCount;
+	int pass;
+	boolean hasChanged;
+	Emitter * types;
+	Emitter * globals;
+	Emitter * prototypes;
+	Emitter * tables;
+	Emitter * definitions;
+	NameSet globalNames;
+	NameSet declaredGlobals;
+	NameSet literals;
+	char ** strings;
+	int stringCount;
+	int stringCapacity;
+	int errors;
+} Transpilation;
+
+typedef struct {
+	const char * name;
+	const char * cName;
+	int fact;
+	NativeType type;
+	boolean isBoxed;
+	int depth;
+} LocalVariable;
+
+typedef struct {
+	LocationType type;
+	int index;
+	FieldSlot * field;
+	MethodSlot * method;
+} Location;
+
+/**
+ * A C expression. Stable expressions always have the same value (constants
+ * and temporaries), local ones only read local variables, and effectful ones
+ * call functions.
+ */
+typedef struct {
+	const char * code;
+	NativeType type;
+	boolean isStable;
+	boolean isLocal;
+	boolean hasEffects;
+} Operand;
+
+/** An operand, and the statements that must run before it (if any). */
+typedef struct {
+	Operand operand;
+	Emitter * statements;
+} PendingOperand;
+
+typedef struct FunctionState FunctionState;
+
+/**
+ * The state of the version of a function being generated. Methods and class
+ * initializers have a class, and their receiver is the "this" variable. The
+ * tail call is the call of the "return" being generated, if any, and it
+ * becomes a jump to the start of the body if it calls this same version.
+ * The discarded call is the one of the expression statement being generated.
+ */
+struct FunctionState {
+	FunctionState * parent;
+	Transpilation * transpilation;
+	FunctionRecord * function;
+	ClassLayout * class;
+	Version version;
+	Emitter * output;
+	LocalVariable * locals;
+	int localCount;
+	int localCapacity;
+	NameSet boxedNames;
+	int depth;
+	int indentation;
+	int temporaryCount;
+	int loopDepth;
+	boolean isTopLevel;
+	boolean isInitializer;
+	boolean usesEnvironment;
+	int parameterBase;
+	FunctionCall * tailCall;
+	FunctionCall * discardedCall;
+	boolean isTailJump;
+	boolean hasTailLabel;
+};
+
+/** A scan of the body of a for-in loop, for the calls that may grow a list. */
+typedef struct {
+	FunctionState * function;
+	boolean growsLists;
+} GrowthScan;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addCapture(FunctionRecord * function, const char * name);
+static void _addName(NameSet * set, const char * name);
+static boolean _alwaysReturns(Block * block);
+static Operand _arithmetic(FunctionState * state, const ExpressionType type, Operand left, Operand right);
+static Lambda * _boundLambda(Transpilation * transpilation, const char * name);
+static const char * _captureSource(FunctionState * state, const FunctionRecord * function, const char * name);
+static VisitAction _collectBoxedNames(void * state, void * node);
+static const char * _calledNative(FunctionState * state, const char * name);
+static Version _callVersion(FunctionRecord * function, PendingOperand * pending, const int count);
+static VisitAction _collectClass(void * state, void * node);
+static boolean _containsName(const NameSet * set, const char * name);
+static const char * _convert(FunctionState * state, const Operand operand, const NativeType type);
+static VisitAction _countAssignment(void * state, void * node);
+static VisitAction _countDeclaration(void * state, void * node);
+static VisitAction _countIncrement(void * state, void * node);
+static VisitAction _countLoop(void * state, void * node);
+static VisitAction _countParameter(void * state, void * node);
+static void _countStore(Transpilation * transpilation, const char * name);
+static FieldSlot * _canonicalField(FieldSlot * field);
+static const char * _cType(const NativeType type);
+static NativeType _declaredType(const VariableType type);
+static int _declareLocal(FunctionState * state, const char * name, const void * node, const NativeType type);
+static Location _declareVariable(FunctionState * state, const char * name, const void * node);
+static const char * _directCall(FunctionState * state, FunctionRecord * function, const Version version, PendingOperand * pending, const int count);
+static void _emitClassTables(Transpilation * transpilation, ClassLayout * class);
+static void _emitClassTypes(Transpilation * transpilation, ClassLayout * class);
+static void _emitFunction(FunctionState * state, const char * signature, const Emitter * body);
+static void _enterScope(FunctionState * state);
+static void _exitScope(FunctionState * state);
+static int _factIndex(FunctionState * state, const void * node);
+static int _fieldParameter(const Class * source, const char * name);
+static int _fieldSize(const NativeType type);
+static FieldSlot * _findField(ClassLayout * class, const char * name);
+static FieldSlot * _findStatic(ClassLayout * class, const char * name);
+static ClassLayout * _findClass(Transpilation * transpilation, const char * name);
+static MethodSlot * _findMethod(ClassLayout * class, const char * name);
+static void _findBoundLambdas(Transpilation * transpilation);
+static VisitAction _findGrowth(void * state, void * node);
+static FunctionCall * _findMap(FunctionState * state, const Loop * loop, Expression ** operand, boolean * isOperandFirst);
+static AssignmentOperation * _findReduction(const Loop * loop, ExpressionType * operation);
+static void _finishFunctionState(FunctionState * state);
+static char * _format(Transpilation * transpilation, const char * format, ...);
+static FunctionRecord * _functionRecord(Transpilation * transpilation, const void * key, Lambda * lambda, ClassLayout * class, ClassLayout * instantiation, const char * displayName, const char * base);
+static Operand _generateArgument(FunctionState * state, Expression * expression, PendingOperand * pending);
+static void _generateAssignment(FunctionState * state, AssignmentOperation * assignment);
+static void _generateBlock(FunctionState * state, Block * block);
+static Operand _generateCall(FunctionState * state, FunctionCall * functionCall);
+static const char * _generateComparison(FunctionState * state, Expression * expression);
+static const char * _generateCondition(FunctionState * state, Expression * expression);
+static void _generateConditional(FunctionState * state, Conditional * conditional);
+static Operand _generateConstant(FunctionState * state, Constant * constant);
+static void _generateDeclaration(FunctionState * state, VariableDeclaration * variableDeclaration);
+static Operand _generateDefaultValue(FunctionState * state, const VariableType type);
+static Operand _generateExpression(FunctionState * state, Expression * expression, const char * name);
+static Operand _generateFactor(FunctionState * state, Factor * factor, const char * name);
+static void _generateForLoop(FunctionState * state, Loop * loop);
+static void _generateFunction(FunctionState * parent, FunctionRecord * function);
+static Operand _generateIncrement(FunctionState * state, const char * name, const int delta, const boolean needsValue);
+static void _generateInitializer(Transpilation * transpilation, ClassLayout * class);
+static void _generateInstruction(FunctionState * state, Instruction * instruction);
+static boolean _generateJoin(FunctionState * state, Expression * expression, const char * name, Operand * result);
+static boolean _generateKernel(FunctionState * state, Loop * loop, const char * collection);
+static Operand _generateLambda(FunctionState * state, Lambda * lambda, const char * name);
+static void _generateTailJump(FunctionState * state, PendingOperand * pending);
+static boolean _generateProgram(Transpilation * transpilation, const int fileDescriptor);
+static void _generateReturn(FunctionState * state, Instruction * returned);
+static void _generateScopedBlock(FunctionState * state, Block * block);
+static void _generateStatics(FunctionState * state, Class * source);
+static void _generateVersion(FunctionState * parent, FunctionRecord * function, const Version version);
+static void _generateWhileLoop(FunctionState * state, Loop * loop);
+static const char * _globalName(Transpilation * transpilation, const char * name);
+static boolean _growsLists(FunctionState * state, Block * block);
+static void _initializeFunctionState(FunctionState * state, Transpilation * transpilation, FunctionState * parent, FunctionRecord * function, const Version version, Emitter * output);
+static ClassLayout * _instantiate(Transpilation * transpilation, ClassLayout * class, PendingOperand * pending, const int count);
+static boolean _instructionAlwaysReturns(Instruction * instruction);
+static boolean _isEternal(Instruction * instruction);
+static boolean _isEndless(Expression * expression);
+static boolean _isString(const Expression * expression);
+static boolean _isVariable(const Expression * expression, const char * name);
+static NativeType _join(const NativeType left, const NativeType right);
+static void _layoutClass(Transpilation * transpilation, ClassLayout * class, const int depth);
+static void _learn(Transpilation * transpilation, NativeType * known, const NativeType type);
+static void _line(FunctionState * state, const char * format, ...);
+static const char * _literal(Transpilation * transpilation, const char * characters);
+static Instruction * _onlyInstruction(const Block * block);
+static Operand _load(FunctionState * state, const Location location, const char * name);
+static const char * _localName(FunctionState * state, const char * name);
+static void _markOverrides(Transpilation * transpilation);
+static VisitAction _measureNode(void * state, void * node);
+static void _materialize(FunctionState * state, Operand * operand);
+static Lambda * _memberLambda(Instruction * instruction);
+static const char * _memberName(Instruction * instruction);
+static const char * _nativeFunction(const char * name);
+static Operand _operand(const char * code, const NativeType type);
+static void _prepareBoxedNames(NameSet * set, Block * block);
+static boolean _promoteUndetermined(Transpilation * transpilation);
+static const char * _quote(Transpilation * transpilation, const char * characters);
+static const char * _receiver(FunctionState * state);
+static void _releaseNames(NameSet * set);
+static void _releasePass(Transpilation * transpilation);
+static void _releaseTranspilation(Transpilation * transpilation);
+static Location _resolve(FunctionState * state, const char * name);
+static void _sequence(FunctionState * state, PendingOperand * pending, const int count);
+static VisitAction _skipClass(void * state, void * node);
+static VisitAction _skipLambda(void * state, void * node);
+static void _store(FunctionState * state, const Location location, const char * name, const Operand value);
+static int _storeCount(Transpilation * transpilation, const char * name);
+static int _storeIndex(Transpilation * transpilation, const char * name);
+static const char * _temporary(FunctionState * state);
+static int _typeParameter(const Class * source, const VariableDeclaration * declaration);
+
+/* ------------------------------- Output --------------------------------- */
+
+/** Appends an indented line to the output of the function. */
+static void _line(FunctionState * state, const char * format, ...) {
+	emitIndentation(state->output, state->indentation);
+	va_list arguments;
+	va_start(arguments, format);
+	emitArguments(state->output, format, arguments);
+	va_end(arguments);
+	emitText(state->output, "\n", 1);
+}
+
+/** A string that lives until the end of the pass. */
+static char * _format(Transpilation * transpilation, const char * format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	va_list copy;
+	va_copy(copy, arguments);
+	const int length = vsnprintf(NULL, 0, format, copy);
+	va_end(copy);
+	char * string = malloc(length + 1);
+	vsnprintf(string, length + 1, format, arguments);
+	va_end(arguments);
+	if (transpilation->stringCount == transpilation->stringCapacity) {
+		transpilation->stringCapacity = transpilation->stringCapacity == 0 ? 256 : 2 * transpilation->stringCapacity;
+		transpilation->strings = realloc(transpilation->strings, transpilation->stringCapacity * sizeof(char *));
+	}
+	transpilation->strings[transpilation->stringCount++] = string;
+	return string;
+}
+
+/** A C string literal with the characters. */
+static const char * _quote(Transpilation * transpilation, const char * characters) {
+	Emitter * literal = createEmitter(-1);
+	emit(literal, "\"");
+	for (const unsigned char * character = (const unsigned char *) characters; *character != '\0'; ++character) {
+		switch (*character) {
+			case '"': emit(literal, "\\\""); break;
+			case '\\': emit(literal, "\\\\"); break;
+			case '\n': emit(literal, "\\n"); break;
+			case '\t': emit(literal, "\\t"); break;
+			case '\r': emit(literal, "\\r"); break;
+			case '?': emit(literal, "\\?"); break;
+			default:
+				if (*character < ' ' || 127 <= *character) {
+					emit(literal, "\\%03o", *character);
+				}
+				else {
+					emit(literal, "%c", *character);
+				}
+				break;
+		}
+	}
+	emit(literal, "\"");
+	const char * quoted = _format(transpilation, "%s", literal->data);
+	destroyEmitter(literal);
+	return quoted;
+}
+
+/* ------------------------------ Name sets ------------------------------- */
+
+static boolean _containsName(const NameSet * set, const char * name) {
+	for (int k = 0; k < set->count; ++k) {
+		if (strcmp(set->names[k], name) == 0) return true;
+	}
+	return false;
+}
+
+static void _addName(NameSet * set, const char * name) {
+	if (_containsName(set, name)) return;
+	if (set->count == set->capacity) {
+		set->capacity = set->capacity == 0 ? 8 : 2 * set->capacity;
+		set->names = realloc(set->names, set->capacity * sizeof(const char *));
+	}
+	set->names[set->count++] = name;
+}
+
+static void _releaseNames(NameSet * set) {
+	free(set->names);
+	memset(set, 0, sizeof(NameSet));
+}
+
+/**
+ * The variables captured by the lambdas of a body (according to the capture
+ * analysis) that are assigned after a lambda is created live in cells, so
+ * every closure shares them.
+ */
+static VisitAction _collectBoxedNames(void * state, void * node) {
+	NameSet * set = state;
+	Lambda * lambda = ((Expression *) node)->lambda;
+	if (lambda->captureList != NULL) {
+		for (Node * capture = lambda->captureList->first; capture != NULL; capture = capture->next) {
+			if (((Capture *) capture->data)->isMutable) {
+				_addName(set, ((Capture *) capture->data)->name);
+			}
+		}
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+static VisitAction _skipClass(void * state, void * node) {
+	return VISIT_SKIP_CHILDREN;
+}
+
+static VisitAction _skipLambda(void * state, void * node) {
+	return VISIT_SKIP_CHILDREN;
+}
+
+static void _prepareBoxedNames(NameSet * set, Block * block) {
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "boxed names";
+	visitor.pre[LAMBDA_NODE] = _collectBoxedNames;
+	visitor.pre[CLASS_NODE] = _skipClass;
+	visitor.pre[INTERFACE_NODE] = _skipClass;
+	visitor.state = set;
+	Visitor * visitors[] = { &visitor };
+	walkBlock(block, visitors, 1);
+}
+
+/* -------------------------------- Stores -------------------------------- */
+
+static void _countStore(Transpilation * transpilation, const char * name) {
+	for (int k = 0; k < transpilation->storedNameCount; ++k) {
+		if (strcmp(transpilation->storedNames[k], name) == 0) {
+			transpilation->storeCounts[k] += 1;
+			return;
+		}
+	}
+	const int count = transpilation->storedNameCount + 1;
+	transpilation->storedNames = realloc(transpilation->storedNames, count * sizeof(const char *));
+	transpilation->storeCounts = realloc(transpilation->storeCounts, count * sizeof(int));
+	transpilation->boundLambdas = realloc(transpilation->boundLambdas, count * sizeof(Lambda *));
+	transpilation->storedNames[count - 1] = name;
+	transpilation->storeCounts[count - 1] = 1;
+	transpilation->boundLambdas[count - 1] = NULL;
+	transpilation->storedNameCount = count;
+}
+
+static VisitAction _countAssignment(void * state, void * node) {
+	_countStore(state, ((Instruction *) node)->assignment->name);
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _countDeclaration(void * state, void * node) {
+	_countStore(state, ((Instruction *) node)->variableDeclaration->name);
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _countIncrement(void * state, void * node) {
+	_countStore(state, ((Factor *) node)->variable);
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _countLoop(void * state, void * node) {
+	Loop * loop = ((Instruction *) node)->loop;
+	if (loop->type == FOR_LOOP) {
+		_countStore(state, loop->itemName);
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _countParameter(void * state, void * node) {
+	_countStore(state, ((VariableDeclaration *) node)->name);
+	return VISIT_CHILDREN;
+}
+
+static int _storeIndex(Transpilation * transpilation, const char * name) {
+	for (int k = 0; k < transpilation->storedNameCount; ++k) {
+		if (strcmp(transpilation->storedNames[k], name) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+/** How many instructions, in the whole program, store a variable with the name. */
+static int _storeCount(Transpilation * transpilation, const char * name) {
+	const int index = _storeIndex(transpilation, name);
+	return index < 0 ? 0 : transpilation->storeCounts[index];
+}
+
+/**
+ * The lambda that a global holds for the whole program: the program assigns
+ * it once (at the top-level) and never stores anything else in a variable
+ * with the same name. Its calls skip the dynamic dispatch.
+ */
+static Lambda * _boundLambda(Transpilation * transpilation, const char * name) {
+	const int index = _storeIndex(transpilation, name);
+	return index < 0 ? NULL : transpilation->boundLambdas[index];
+}
+
+/** Finds the lambdas bound to globals, after counting the stores. */
+static void _findBoundLambdas(Transpilation * transpilation) {
+	if (transpilation->program->block == NULL) return;
+	for (Node * node = transpilation->program->block->first; node != NULL; node = node->next) {
+		const char * name = _memberName(node->data);
+		const int index = name == NULL ? -1 : _storeIndex(transpilation, name);
+		if (0 <= index && transpilation->storeCounts[index] == 1) {
+			transpilation->boundLambdas[index] = _memberLambda(node->data);
+		}
+	}
+}
+
+/** The function of the runtime that implements a native, or NULL. */
+static const char * _nativeFunction(const char * name) {
+	static const struct {
+		const char * name;
+		const char * function;
+	} natives[] = {
+		{ "clock", "arcClock" },
+		{ "get", "arcGet" },
+		{ "list", "arcList" },
+		{ "print", "arcPrint" },
+		{ "push", "arcPush" },
+		{ "range", "arcRange" },
+		{ "set", "arcSet" },
+		{ "size", "arcSize" }
+	};
+	for (unsigned int k = 0; k < sizeof(natives) / sizeof(natives[0]); ++k) {
+		if (strcmp(natives[k].name, name) == 0) return natives[k].function;
+	}
+	return NULL;
+}
+
+/**
+ * The native that a call runs, if the callee is a global that the program
+ * never stores (and no class hides it), or NULL.
+ */
+static const char * _calledNative(FunctionState * state, const char * name) {
+	const char * native = _storeCount(state->transpilation, name) == 0 ? _nativeFunction(name) : NULL;
+	if (native == NULL) return NULL;
+	// No variable has the name, so resolving it captures nothing.
+	const Location callee = _resolve(state, name);
+	if (callee.type != GLOBAL_LOCATION && callee.type != UNRESOLVED_LOCATION) return NULL;
+	return (callee.type == UNRESOLVED_LOCATION && _findClass(state->transpilation, name) != NULL) ? NULL : native;
+}
+
+/* -------------------------------- Types --------------------------------- */
+
+static NativeType _join(const NativeType left, const NativeType right) {
+	if (left == UNDETERMINED_NATIVE_TYPE) return right;
+	if (right == UNDETERMINED_NATIVE_TYPE || left == right) return left;
+	return VALUE_NATIVE_TYPE;
+}
+
+/** Widens what the transpiler knows, which takes another pass. */
+static void _learn(Transpilation * transpilation, NativeType * known, const NativeType type) {
+	const NativeType joined = _join(*known, type);
+	if (joined != *known) {
+		*known = joined;
+		transpilation->hasChanged = true;
+	}
+}
+
+static const char * _cType(const NativeType type) {
+	switch (type) {
+		case INTEGER_NATIVE_TYPE: return "int64_t";
+		case DECIMAL_NATIVE_TYPE: return "double";
+		default: return "ArcValue";
+	}
+}
+
+static NativeType _declaredType(const VariableType type) {
+	switch (type) {
+		case V_INT:
+		case V_LONG:
+		case V_SHORT:
+			return INTEGER_NATIVE_TYPE;
+		case V_DOUBLE:
+		case V_FLOAT:
+			return DECIMAL_NATIVE_TYPE;
+		default:
+			return VALUE_NATIVE_TYPE;
+	}
+}
+
+static int _factIndex(FunctionState * state, const void * node) {
+	FunctionRecord * function = state->function;
+	for (int k = 0; k < function->factCount; ++k) {
+		const TypeFact * fact = &function->facts[k];
+		if (fact->node == node && fact->version == state->version) {
+			return k;
+		}
+	}
+	if (function->factCount == function->factCapacity) {
+		function->factCapacity = function->factCapacity == 0 ? 8 : 2 * function->factCapacity;
+		function->facts = realloc(function->facts, function->factCapacity * sizeof(TypeFact));
+	}
+	TypeFact * fact = &function->facts[function->factCount];
+	fact->version = state->version;
+	fact->node = node;
+	fact->type = UNDETERMINED_NATIVE_TYPE;
+	return function->factCount++;
+}
+
+/**
+ * Once the passes stabilize, whatever remains undetermined (e.g., functions
+ * that never return) becomes a value, which may take more passes.
+ */
+static boolean _promoteUndetermined(Transpilation * transpilation) {
+	boolean hasPromoted = false;
+	for (int k = 0; k < transpilation->functionCount; ++k) {
+		FunctionRecord * function = transpilation->functions[k];
+		for (int f = 0; f < function->factCount; ++f) {
+			if (function->facts[f].type == UNDETERMINED_NATIVE_TYPE) {
+				function->facts[f].type = VALUE_NATIVE_TYPE;
+				hasPromoted = true;
+			}
+		}
+		for (int version = TYPED_VERSION; version <= GENERIC_VERSION; ++version) {
+			if (transpilation->functions[k]->returnTypes[version] == UNDETERMINED_NATIVE_TYPE) {
+				transpilation->functions[k]->returnTypes[version] = VALUE_NATIVE_TYPE;
+				hasPromoted = true;
+			}
+		}
+	}
+	return hasPromoted;
+}
+
+/* ------------------------------- Operands ------------------------------- */
+
+static Operand _operand(const char * code, const NativeType type) {
+	Operand operand = { code, type, false, false, false };
+	return operand;
+}
+
+static const char * _temporary(FunctionState * state) {
+	return _format(state->transpilation, "t%d", ++state->temporaryCount);
+}
+
+/** The code of an operand, as the given type. */
+static const char * _convert(FunctionState * state, const Operand operand, const NativeType type) {
+	if (operand.type == type || operand.type == UNDETERMINED_NATIVE_TYPE || type == UNDETERMINED_NATIVE_TYPE) {
+		return operand.code;
+	}
+	Transpilation * transpilation = state->transpilation;
+	switch (type) {
+		case VALUE_NATIVE_TYPE:
+			return _format(transpilation, operand.type == INTEGER_NATIVE_TYPE ? "arcInteger(%s)" : "arcDecimal(%s)", operand.code);
+		case DECIMAL_NATIVE_TYPE:
+			if (operand.type == INTEGER_NATIVE_TYPE) {
+				return _format(transpilation, "(double) %s", operand.code);
+			}
+			return _format(transpilation, "%s.asDecimal", operand.code);
+		default:
+			return _format(transpilation, "%s.asInteger", operand.code);
+	}
+}
+
+/** Computes the operand into a temporary, at this point of the output. */
+static void _materialize(FunctionState * state, Operand * operand) {
+	const char * temporary = _temporary(state);
+	_line(state, "const %s %s = %s;", _cType(operand->type), temporary, operand->code);
+	operand->code = temporary;
+	operand->isStable = true;
+	operand->isLocal = true;
+	operand->hasEffects = false;
+}
+
+/**
+ * Emits the statements of several operands, left to right, and computes an
+ * operand into a temporary when a later one could change its value, or
+ * when both have effects, so the C compiler can't reorder them.
+ */
+static void _sequence(FunctionState * state, PendingOperand * pending, const int count) {
+	for (int k = 0; k < count; ++k) {
+		if (pending[k].statements != NULL) {
+			emitEmitter(state->output, pending[k].statements);
+			destroyEmitter(pending[k].statements);
+		}
+		Operand * operand = &pending[k].operand;
+		if (operand->isStable) continue;
+		for (int j = k + 1; j < count; ++j) {
+			const Operand * later = &pending[j].operand;
+			if ((pending[j].statements != NULL && 0 < pending[j].statements->length)
+				|| (!operand->isLocal && later->hasEffects)
+				|| (operand->hasEffects && !later->isStable && !later->isLocal)) {
+				_materialize(state, operand);
+				break;
+			}
+		}
+	}
+}
+
+/** Generates an operand into its own statements. */
+static Operand _generateArgument(FunctionState * state, Expression * expression, PendingOperand * pending) {
+	Emitter * output = state->output;
+	pending->statements = createEmitter(-1);
+	state->output = pending->statements;
+	pending->operand = _generateExpression(state, expression, NULL);
+	state->output = output;
+	return pending->operand;
+}
+
+/* -------------------------------- Scopes -------------------------------- */
+
+static void _initializeFunctionState(FunctionState * state, Transpilation * transpilation, FunctionState * parent, FunctionRecord * function, const Version version, Emitter * output) {
+	memset(state, 0, sizeof(FunctionState));
+	state->parent = parent;
+	state->transpilation = transpilation;
+	state->function = function;
+	state->class = function->class;
+	state->version = version;
+	state->output = output;
+	state->indentation = 1;
+}
+
+static void _finishFunctionState(FunctionState * state) {
+	free(state->locals);
+	_releaseNames(&state->boxedNames);
+}
+
+static void _enterScope(FunctionState * state) {
+	state->depth += 1;
+}
+
+static void _exitScope(FunctionState * state) {
+	while (0 < state->localCount && state->depth <= state->locals[state->localCount - 1].depth) {
+		state->localCount -= 1;
+	}
+	state->depth -= 1;
+}
+
+/** A C name for a local variable, which doesn't hide another one in scope. */
+static const char * _localName(FunctionState * state, const char * name) {
+	const char * cName = _format(state->transpilation, "v_%s", name);
+	for (int suffix = 2;; ++suffix) {
+		boolean isUsed = false;
+		for (int k = 0; k < state->localCount && !isUsed; ++k) {
+			isUsed = strcmp(state->locals[k].cName, cName) == 0 ? true : false;
+		}
+		if (!isUsed) return cName;
+		cName = _format(state->transpilation, "v_%s_%d", name, suffix);
+	}
+}
+
+/**
+ * Declares a local variable, whose type is what the transpiler knows about
+ * the stores of the node that declares it (and the given store). Boxed
+ * variables live in cells.
+ */
+static int _declareLocal(FunctionState * state, const char * name, const void * node, const NativeType type) {
+	if (state->localCount == state->localCapacity) {
+		state->localCapacity = state->localCapacity == 0 ? 16 : 2 * state->localCapacity;
+		state->locals = realloc(state->locals, state->localCapacity * sizeof(LocalVariable));
+	}
+	const char * cName = _localName(state, name);
+	LocalVariable * local = &state->locals[state->localCount];
+	local->name = name;
+	local->cName = cName;
+	local->fact = _factIndex(state, node);
+	local->isBoxed = (state->version != ENTRY_VERSION && _containsName(&state->boxedNames, name)) ? true : false;
+	local->depth = state->depth;
+	if (local->isBoxed) {
+		_learn(state->transpilation, &state->function->facts[local->fact].type, VALUE_NATIVE_TYPE);
+	}
+	else {
+		_learn(state->transpilation, &state->function->facts[local->fact].type, type);
+	}
+	local->type = state->function->facts[local->fact].type;
+	return state->localCount++;
+}
+
+/* ---------------------------- Name resolution --------------------------- */
+
+static const char * _globalName(Transpilation * transpilation, const char * name) {
+	_addName(&transpilation->globalNames, name);
+	return _format(transpilation, "g_%s", name);
+}
+
+static const char * _literal(Transpilation * transpilation, const char * characters) {
+	for (int k = 0; k < transpilation->literals.count; ++k) {
+		if (strcmp(transpilation->literals.names[k], characters) == 0) {
+			return _format(transpilation, "k%d", k + 1);
+		}
+	}
+	_addName(&transpilation->literals, _format(transpilation, "%s", characters));
+	return _format(transpilation, "k%d", transpilation->literals.count);
+}
+
+static FieldSlot * _findField(ClassLayout * class, const char * name) {
+	for (int k = 0; k < class->fieldCount; ++k) {
+		if (strcmp(class->fields[k].name, name) == 0) return &class->fields[k];
+	}
+	return NULL;
+}
+
+static FieldSlot * _findStatic(ClassLayout * class, const char * name) {
+	for (int k = 0; k < class->staticCount; ++k) {
+		if (strcmp(class->statics[k].name, name) == 0) return &class->statics[k];
+	}
+	return NULL;
+}
+
+/** The slot of a field in the class that declares it. */
+static FieldSlot * _canonicalField(FieldSlot * field) {
+	return &field->owner->fields[field->index];
+}
+
+static MethodSlot * _findMethod(ClassLayout * class, const char * name) {
+	for (int k = 0; k < class->methodCount; ++k) {
+		if (strcmp(class->methods[k].name, name) == 0) return &class->methods[k];
+	}
+	return NULL;
+}
+
+static ClassLayout * _findClass(Transpilation * transpilation, const char * name) {
+	for (int k = 0; k < transpilation->classCount; ++k) {
+		if (strcmp(transpilation->classes[k]->name, name) == 0) {
+			return transpilation->classes[k];
+		}
+	}
+	return NULL;
+}
+
+/** A capture is shared unless the capture analysis finds it immutable. */
+static void _addCapture(FunctionRecord * function, const char * name) {
+	_addName(&function->captures, name);
+	if (function->lambda != NULL && function->lambda->captureList != NULL) {
+		for (Node * node = function->lambda->captureList->first; node != NULL; node = node->next) {
+			const Capture * capture = node->data;
+			if (strcmp(capture->name, name) == 0) {
+				if (capture->isMutable) _addName(&function->sharedCaptures, name);
+				return;
+			}
+		}
+	}
+	_addName(&function->sharedCaptures, name);
+}
+
+/**
+ * Resolves a name from the innermost scope outwards, like the bytecode
+ * compiler does. A variable of an enclosing function becomes a capture of
+ * every function in between, so the environments stay flat.
+ */
+static Location _resolve(FunctionState * state, const char * name) {
+	Location location = { UNRESOLVED_LOCATION, 0, NULL, NULL };
+	for (int k = state->localCount - 1; 0 <= k; --k) {
+		if (strcmp(state->locals[k].name, name) == 0) {
+			location.type = LOCAL_LOCATION;
+			location.index = k;
+			return location;
+		}
+	}
+	if (_containsName(&state->function->captures, name)) {
+		location.type = CAPTURE_LOCATION;
+		return location;
+	}
+	if (state->class != NULL) {
+		location.field = _findField(state->class, name);
+		if (location.field != NULL) {
+			location.type = FIELD_LOCATION;
+			return location;
+		}
+		location.field = _findStatic(state->class, name);
+		if (location.field != NULL) {
+			location.type = STATIC_LOCATION;
+			return location;
+		}
+		location.method = _findMethod(state->class, name);
+		if (location.method != NULL) {
+			location.type = METHOD_LOCATION;
+			return location;
+		}
+	}
+	if (state->parent != NULL) {
+		const Location outer = _resolve(state->parent, name);
+		if (outer.type == LOCAL_LOCATION || outer.type == CAPTURE_LOCATION) {
+			_addCapture(state->function, name);
+			location.type = CAPTURE_LOCATION;
+			return location;
+		}
+		return outer;
+	}
+	location.type = _containsName(&state->transpilation->declaredGlobals, name) ? GLOBAL_LOCATION : UNRESOLVED_LOCATION;
+	return location;
+}
+
+/**
+ * Declares a name in the current scope: a global at the top-level, or a new
+ * local otherwise. A boxed local gets its cell before its value, so the
+ * lambdas of the value can capture it.
+ */
+static Location _declareVariable(FunctionState * state, const char * name, const void * node) {
+	Location location = { LOCAL_LOCATION, 0, NULL, NULL };
+	if (state->isTopLevel && state->depth == 0) {
+		location.type = GLOBAL_LOCATION;
+		_addName(&state->transpilation->declaredGlobals, name);
+		return location;
+	}
+	location.index = _declareLocal(state, name, node, UNDETERMINED_NATIVE_TYPE);
+	const LocalVariable * local = &state->locals[location.index];
+	if (local->isBoxed) {
+		_line(state, "ArcCell * %s = arcCell(arcNil());", local->cName);
+	}
+	return location;
+}
+
+/** The code of the receiver of the current method. */
+static const char * _receiver(FunctionState * state) {
+	const Location location = _resolve(state, "this");
+	return _load(state, location, "this").code;
+}
+
+static Operand _load(FunctionState * state, const Location location, const char * name) {
+	Transpilation * transpilation = state->transpilation;
+	Operand operand = _operand(NULL, VALUE_NATIVE_TYPE);
+	switch (location.type) {
+		case LOCAL_LOCATION: {
+			const LocalVariable * local = &state->locals[location.index];
+			if (local->isBoxed) {
+				operand.code = _format(transpilation, "%s->value", local->cName);
+			}
+			else {
+				operand.code = local->cName;
+				operand.type = local->type;
+				operand.isLocal = true;
+			}
+			break;
+		}
+		case CAPTURE_LOCATION:
+			state->usesEnvironment = true;
+			operand.code = _format(transpilation, _containsName(&state->function->sharedCaptures, name) ? "environment->v_%s->value" : "environment->v_%s", name);
+			break;
+		case FIELD_LOCATION:
+			operand.code = _format(transpilation, "ARC_FIELDS(%s, %s)->v_%s",
+				location.field->owner->name, _receiver(state), name);
+			operand.type = _canonicalField(location.field)->type;
+			break;
+		case STATIC_LOCATION:
+			operand.code = _format(transpilation, "arcGlobal(%s_statics.v_%s, \"%s.%s\")",
+				location.field->owner->name, name, location.field->owner->name, name);
+			break;
+		case METHOD_LOCATION: {
+			const char * receiver = _receiver(state);
+			operand.code = _format(transpilation, "arcBind(%s, ARC_VTABLE(%s, %s)->v_%s)",
+				receiver, location.method->owner->name, receiver, name);
+			break;
+		}
+		default:
+			operand.code = _format(transpilation, "arcGlobal(%s, \"%s\")", _globalName(transpilation, name), name);
+			break;
+	}
+	return operand;
+}
+
+static void _store(FunctionState * state, const Location location, const char * name, const Operand value) {
+	Transpilation * transpilation = state->transpilation;
+	switch (location.type) {
+		case LOCAL_LOCATION: {
+			const LocalVariable * local = &state->locals[location.index];
+			if (local->isBoxed) {
+				_line(state, "%s->value = %s;", local->cName, _convert(state, value, VALUE_NATIVE_TYPE));
+			}
+			else {
+				_learn(transpilation, &state->function->facts[local->fact].type, value.type);
+				_line(state, "%s = %s;", local->cName, _convert(state, value, local->type));
+			}
+			break;
+		}
+		case CAPTURE_LOCATION:
+			if (!_containsName(&state->function->sharedCaptures, name)) {
+				logError(_logger, "Captured variable '%s' is copied, so it cannot be assigned (in '%s').", name, state->function->displayName);
+				transpilation->errors += 1;
+			}
+			state->usesEnvironment = true;
+			_line(state, "environment->v_%s->value = %s;", name, _convert(state, value, VALUE_NATIVE_TYPE));
+			break;
+		case FIELD_LOCATION: {
+			FieldSlot * field = _canonicalField(location.field);
+			_learn(transpilation, &field->type, value.type);
+			_line(state, "ARC_FIELDS(%s, %s)->v_%s = %s;",
+				field->owner->name, _receiver(state), name, _convert(state, value, field->type));
+			break;
+		}
+		case STATIC_LOCATION:
+			_line(state, "%s_statics.v_%s = %s;", location.field->owner->name, name, _convert(state, value, VALUE_NATIVE_TYPE));
+			break;
+		case METHOD_LOCATION:
+			logError(_logger, "Method '%s' cannot be reassigned (in '%s').", name, state->function->displayName);
+			transpilation->errors += 1;
+			break;
+		default:
+			_line(state, "%s = %s;", _globalName(transpilation, name), _convert(state, value, VALUE_NATIVE_TYPE));
+			break;
+	}
+}
+
+/**
+ * A capture of a new closure (a cell if it's shared, or a value), from the
+ * point of view of its creator.
+ */
+static const char * _captureSource(FunctionState * state, const FunctionRecord * function, const char * name) {
+	const Location location = _resolve(state, name);
+	if (!_containsName(&function->sharedCaptures, name)) {
+		if (location.type == CAPTURE_LOCATION || location.type == LOCAL_LOCATION) {
+			return _convert(state, _load(state, location, name), VALUE_NATIVE_TYPE);
+		}
+		return "arcNil()";
+	}
+	if (location.type == CAPTURE_LOCATION) {
+		state->usesEnvironment = true;
+		return _format(state->transpilation, "environment->v_%s", name);
+	}
+	if (location.type == LOCAL_LOCATION) {
+		const LocalVariable * local = &state->locals[location.index];
+		if (local->isBoxed) {
+			return local->cName;
+		}
+		return _format(state->transpilation, "arcCell(%s)", _convert(state, _load(state, location, name), VALUE_NATIVE_TYPE));
+	}
+	return "arcCell(arcNil())";
+}
+
+/* ------------------------------ Expressions ----------------------------- */
+
+static Operand _generateConstant(FunctionState * state, Constant * constant) {
+	Transpilation * transpilation = state->transpilation;
+	Operand operand = _operand(NULL, VALUE_NATIVE_TYPE);
+	operand.isStable = true;
+	switch (constant->type) {
+		case C_INT_TYPE:
+			operand.code = _format(transpilation, "%d", constant->intValue);
+			operand.type = INTEGER_NATIVE_TYPE;
+			break;
+		case C_BOOLEAN_TYPE:
+			operand.code = constant->booleanValue ? "arcBoolean(true)" : "arcBoolean(false)";
+			break;
+		case C_DOUBLE_TYPE:
+		case C_FLOAT_TYPE: {
+			const double decimal = constant->type == C_DOUBLE_TYPE ? constant->doubleValue : constant->floatValue;
+			char * code = _format(transpilation, "%.17g", decimal);
+			if (strpbrk(code, ".eninf") == NULL) {
+				code = _format(transpilation, "%s.0", code);
+			}
+			operand.code = code;
+			operand.type = DECIMAL_NATIVE_TYPE;
+			break;
+		}
+		case C_CHAR_TYPE: {
+			const char characters[2] = { constant->charValue, '\0' };
+			operand.code = _literal(transpilation, characters);
+			break;
+		}
+		case C_STRING_TYPE:
+			operand.code = _literal(transpilation, constant->stringValue);
+			break;
+	}
+	return operand;
+}
+
+/** The value of a declaration without initializer. */
+static Operand _generateDefaultValue(FunctionState * state, const VariableType type) {
+	Operand operand = _operand("arcNil()", VALUE_NATIVE_TYPE);
+	operand.isStable = true;
+	switch (type) {
+		case V_INT:
+		case V_LONG:
+		case V_SHORT:
+			operand.code = "0";
+			operand.type = INTEGER_NATIVE_TYPE;
+			break;
+		case V_DOUBLE:
+		case V_FLOAT:
+			operand.code = "0.0";
+			operand.type = DECIMAL_NATIVE_TYPE;
+			break;
+		case V_BOOLEAN:
+			operand.code = "arcBoolean(false)";
+			break;
+		case V_CHAR:
+		case V_STRING:
+			operand.code = _literal(state->transpilation, "");
+			break;
+		default:
+			break;
+	}
+	return operand;
+}
+
+/**
+ * Integers wrap around, and mixing an integer with a decimal produces a
+ * decimal, as C doubles. Anything else goes through the runtime.
+ */
+static Operand _arithmetic(FunctionState * state, const ExpressionType type, Operand left, Operand right) {
+	static const char * const integerFunctions[] = {
+		[ADDITION] = "arcAddIntegers", [SUBTRACTION] = "arcSubtractIntegers", [MULTIPLICATION] = "arcMultiplyIntegers", [DIVISION] = "arcDivideIntegers"
+	};
+	static const char * const valueFunctions[] = {
+		[ADDITION] = "arcAdd", [SUBTRACTION] = "arcSubtract", [MULTIPLICATION] = "arcMultiply", [DIVISION] = "arcDivide"
+	};
+	static const char * const symbols[] = { [ADDITION] = "+", [SUBTRACTION] = "-", [MULTIPLICATION] = "*", [DIVISION] = "/" };
+	Transpilation * transpilation = state->transpilation;
+	Operand result = _operand(NULL, VALUE_NATIVE_TYPE);
+	result.isStable = (left.isStable && right.isStable) ? true : false;
+	result.isLocal = ((left.isStable || left.isLocal) && (right.isStable || right.isLocal)) ? true : false;
+	result.hasEffects = (left.hasEffects || right.hasEffects) ? true : false;
+	if (left.type == UNDETERMINED_NATIVE_TYPE || right.type == UNDETERMINED_NATIVE_TYPE) {
+		result.code = "arcNil()";
+		result.type = UNDETERMINED_NATIVE_TYPE;
+	}
+	else if (left.type == INTEGER_NATIVE_TYPE && right.type == INTEGER_NATIVE_TYPE) {
+		result.code = _format(transpilation, "%s(%s, %s)", integerFunctions[type], left.code, right.code);
+		result.type = INTEGER_NATIVE_TYPE;
+	}
+	else if (left.type != VALUE_NATIVE_TYPE && right.type != VALUE_NATIVE_TYPE) {
+		result.code = _format(transpilation, "(%s %s %s)",
+			_convert(state, left, DECIMAL_NATIVE_TYPE), symbols[type], _convert(state, right, DECIMAL_NATIVE_TYPE));
+		result.type = DECIMAL_NATIVE_TYPE;
+	}
+	else {
+		result.code = _format(transpilation, "%s(%s, %s)", valueFunctions[type],
+			_convert(state, left, VALUE_NATIVE_TYPE), _convert(state, right, VALUE_NATIVE_TYPE));
+	}
+	return result;
+}
+
+/**
+ * Increments or decrements a variable, like adding the delta to it. If the
+ * value is needed, it's the previous one.
+ */
+static Operand _generateIncrement(FunctionState * state, const char * name, const int delta, const boolean needsValue) {
+	const Location location = _resolve(state, name);
+	Operand previous = _load(state, location, name);
+	const boolean isLocal = (location.type == LOCAL_LOCATION && !state->locals[location.index].isBoxed) ? true : false;
+	if (needsValue || !isLocal) {
+		_materialize(state, &previous);
+	}
+	Operand one = _operand(_format(state->transpilation, "%d", delta), INTEGER_NATIVE_TYPE);
+	one.isStable = true;
+	_store(state, location, name, _arithmetic(state, ADDITION, previous, one));
+	return previous;
+}
+
+/**
+ * The callee is resolved statically: a method of the receiver is invoked
+ * through its table, a class (if no variable hides it) is instantiated,
+ * natives and lambdas bound to a global are called directly, and anything
+ * else must hold a callable value. A discarded instantiation of a class with
+ * scoped instances places the instance in the frame of the caller. A method that no descendant overrides is
+ * called directly too. The call of any other method is an inline cache that
+ * predicts the implementation of the class of the call: if the table of the
+ * receiver has it, the call is direct (to its typed version, if the
+ * arguments allow it), and otherwise it goes through the table.
+ */
+static Operand _generateCall(FunctionState * state, FunctionCall * functionCall) {
+	Transpilation * transpilation = state->transpilation;
+	const char * name = functionCall->name;
+	const Location callee = _resolve(state, name);
+	const boolean isGlobal = (callee.type == GLOBAL_LOCATION || callee.type == UNRESOLVED_LOCATION) ? true : false;
+	ClassLayout * class = callee.type == UNRESOLVED_LOCATION ? _findClass(transpilation, name) : NULL;
+	const char * native = _calledNative(state, name);
+	Lambda * lambda = (isGlobal && class == NULL && native == NULL) ? _boundLambda(transpilation, name) : NULL;
+	const int count = functionCall->expressionList == NULL ? 0 : functionCall->expressionList->size;
+	PendingOperand * pending = calloc(count + 1, sizeof(PendingOperand));
+	pending[0].operand = _operand("arcNil()", VALUE_NATIVE_TYPE);
+	pending[0].operand.isStable = true;
+	if (callee.type == METHOD_LOCATION) {
+		pending[0].operand.code = _receiver(state);
+		pending[0].operand.isStable = false;
+		pending[0].operand.isLocal = true;
+	}
+	else if (class == NULL && native == NULL) {
+		pending[0].operand = _load(state, callee, name);
+	}
+	int k = 1;
+	if (functionCall->expressionList != NULL) {
+		for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next, ++k) {
+			_generateArgument(state, node->data, &pending[k]);
+		}
+	}
+	_sequence(state, pending, count + 1);
+
+	Operand result = _operand(NULL, VALUE_NATIVE_TYPE);
+	result.hasEffects = true;
+	FunctionRecord * function = lambda == NULL ? NULL : _functionRecord(transpilation, lambda, lambda, NULL, NULL, name, name);
+	if (callee.type == METHOD_LOCATION && !callee.method->isOverridden) {
+		function = callee.method->function;
+	}
+	if (function != NULL && count == function->parameterCount) {
+		const Version version = _callVersion(function, pending, count);
+		if (state->tailCall == functionCall && function == state->function && version == state->version) {
+			_generateTailJump(state, pending);
+			free(pending);
+			return result;
+		}
+		result.code = _directCall(state, function, version, pending, count);
+		result.type = function->returnTypes[version];
+		free(pending);
+		return result;
+	}
+	Emitter * arguments = createEmitter(-1);
+	if (count == 0) {
+		emit(arguments, "NULL");
+	}
+	else {
+		emit(arguments, "(ArcValue[]) { ");
+		for (int k = 0; k < count; ++k) {
+			emit(arguments, k == 0 ? "%s" : ", %s", _convert(state, pending[k + 1].operand, VALUE_NATIVE_TYPE));
+		}
+		emit(arguments, " }");
+	}
+	const char * receiver = pending[0].operand.code;
+	if (callee.type == METHOD_LOCATION) {
+		const char * entry = _format(transpilation, "ARC_VTABLE(%s, %s)->v_%s.function", callee.method->owner->name, receiver, name);
+		result.code = _format(transpilation, "%s(%s, %d, %s)", entry, receiver, count, arguments->data);
+		FunctionRecord * predicted = callee.method->function;
+		if (count == predicted->parameterCount) {
+			const Version version = _callVersion(predicted, pending, count);
+			const char * direct = _convert(state, _operand(_directCall(state, predicted, version, pending, count), predicted->returnTypes[version]), VALUE_NATIVE_TYPE);
+			result.code = _format(transpilation, "(%s == %s ? %s : %s)", entry, predicted->name, direct, result.code);
+		}
+	}
+	else if (class != NULL) {
+		class = _instantiate(transpilation, class, pending, count);
+		for (int k = 0; k < count && k < class->fieldCount; ++k) {
+			_learn(transpilation, &_canonicalField(&class->fields[k])->type, pending[k + 1].operand.type);
+		}
+		if (state->discardedCall == functionCall && class->source->hasScopedInstances) {
+			result.code = _format(transpilation, "%s_init(arcScopedInstance(&(%s_Instance) { 0 }, (const ArcClass *) &%s_vtable), %d, %s)",
+				class->name, class->name, class->name, count, arguments->data);
+		}
+		else {
+			result.code = _format(transpilation, "%s_new(%d, %s)", class->name, count, arguments->data);
+		}
+	}
+	else if (native != NULL) {
+		result.code = _format(transpilation, "%s(arcNil(), %d, %s)", native, count, arguments->data);
+	}
+	else if (function != NULL) {
+		result.code = _format(transpilation, "%s(%s, %d, %s)", function->name, receiver, count, arguments->data);
+	}
+	else {
+		// Declared types aren't enforced, so the callee may be a native value, which arcCall rejects at runtime.
+		result.code = _format(transpilation, "arcCall(%s, %d, %s)", _convert(state, pending[0].operand, VALUE_NATIVE_TYPE), count, arguments->data);
+	}
+	destroyEmitter(arguments);
+	free(pending);
+	return result;
+}
+
+/**
+ * The version of a function that a direct call runs: the typed one if the
+ * types of the arguments are the ones of its parameters.
+ */
+static Version _callVersion(FunctionRecord * function, PendingOperand * pending, const int count) {
+	boolean isTyped = function->hasTypedBody;
+	for (int k = 0; k < count && isTyped; ++k) {
+		const NativeType type = function->parameterTypes[k];
+		isTyped = (type == VALUE_NATIVE_TYPE || type == pending[k + 1].operand.type) ? true : false;
+	}
+	return isTyped ? TYPED_VERSION : GENERIC_VERSION;
+}
+
+/** A call of a version of a function, with the receiver and the arguments (as its parameters). */
+static const char * _directCall(FunctionState * state, FunctionRecord * function, const Version version, PendingOperand * pending, const int count) {
+	Emitter * arguments = createEmitter(-1);
+	emit(arguments, "%s", pending[0].operand.code);
+	for (int k = 0; k < count; ++k) {
+		const NativeType type = version == TYPED_VERSION ? function->parameterTypes[k] : VALUE_NATIVE_TYPE;
+		emit(arguments, ", %s", _convert(state, pending[k + 1].operand, type));
+	}
+	const char * call = _format(state->transpilation, "%s_%s(%s)", function->name, version == TYPED_VERSION ? "typed" : "body", arguments->data);
+	destroyEmitter(arguments);
+	return call;
+}
+
+/**
+ * A call of a function to its own version, in tail position: the arguments
+ * (after the receiver) replace the parameters, and the body starts again, so
+ * the recursion runs in constant stack. Every argument is computed before
+ * any parameter changes, since it may read them.
+ */
+static void _generateTailJump(FunctionState * state, PendingOperand * pending) {
+	FunctionRecord * function = state->function;
+	const char ** values = calloc(function->parameterCount + 1, sizeof(const char *));
+	for (int k = 0; k < function->parameterCount; ++k) {
+		const NativeType type = state->version == TYPED_VERSION ? function->parameterTypes[k] : VALUE_NATIVE_TYPE;
+		Operand value = _operand(_convert(state, pending[k + 1].operand, type), type);
+		_materialize(state, &value);
+		values[k] = value.code;
+	}
+	for (int k = 0; k < function->parameterCount; ++k) {
+		const LocalVariable * local = &state->locals[state->parameterBase + k];
+		const NativeType type = state->version == TYPED_VERSION ? function->parameterTypes[k] : VALUE_NATIVE_TYPE;
+		if (local->isBoxed) {
+			_line(state, "%s = arcCell(%s);", local->cName, values[k]);
+		}
+		else {
+			_line(state, "%s = %s;", local->cName, _convert(state, _operand(values[k], type), local->type));
+		}
+	}
+	_line(state, "goto tail;");
+	free(values);
+	state->hasTailLabel = true;
+	state->isTailJump = true;
+}
+
+/**
+ * The grammar only compares factors. Numbers compare as C numbers, and
+ * anything else through the runtime, where the greater-than comparisons swap
+ * their operands (like the virtual machine does).
+ */
+static const char * _generateComparison(FunctionState * state, Expression * expression) {
+	static const char * const operators[] = {
+		[LESS_TYPE] = "<", [LESS_EQUAL_TYPE] = "<=", [GREATER_TYPE] = ">", [GREATER_EQUAL_TYPE] = ">=", [EQUAL_EQUAL_TYPE] = "==", [NOT_EQUAL_TYPE] = "!="
+	};
+	Transpilation * transpilation = state->transpilation;
+	PendingOperand pending[2];
+	Factor * factors[] = { expression->leftFactor, expression->rightFactor };
+	for (int k = 0; k < 2; ++k) {
+		Emitter * output = state->output;
+		pending[k].statements = createEmitter(-1);
+		state->output = pending[k].statements;
+		pending[k].operand = _generateFactor(state, factors[k], NULL);
+		state->output = output;
+	}
+	_sequence(state, pending, 2);
+	const Operand left = pending[0].operand;
+	const Operand right = pending[1].operand;
+	if (left.type == UNDETERMINED_NATIVE_TYPE || right.type == UNDETERMINED_NATIVE_TYPE) {
+		return "false";
+	}
+	if (left.type != VALUE_NATIVE_TYPE && right.type != VALUE_NATIVE_TYPE) {
+		const NativeType type = left.type == right.type ? left.type : DECIMAL_NATIVE_TYPE;
+		return _format(transpilation, "%s %s %s", _convert(state, left, type), operators[expression->type], _convert(state, right, type));
+	}
+	const char * x = _convert(state, left, VALUE_NATIVE_TYPE);
+	const char * y = _convert(state, right, VALUE_NATIVE_TYPE);
+	switch (expression->type) {
+		case LESS_TYPE: return _format(transpilation, "arcLess(\"<\", %s, %s, false)", x, y);
+		case LESS_EQUAL_TYPE: return _format(transpilation, "arcLess(\"<=\", %s, %s, true)", x, y);
+		case GREATER_TYPE: return _format(transpilation, "arcLess(\"<\", %s, %s, false)", y, x);
+		case GREATER_EQUAL_TYPE: return _format(transpilation, "arcLess(\"<=\", %s, %s, true)", y, x);
+		case EQUAL_EQUAL_TYPE: return _format(transpilation, "arcEqual(%s, %s)", x, y);
+		default: return _format(transpilation, "!arcEqual(%s, %s)", x, y);
+	}
+}
+
+/** A C condition that holds when the expression is truthy. */
+static const char * _generateCondition(FunctionState * state, Expression * expression) {
+	switch (expression->type) {
+		case LESS_TYPE:
+		case GREATER_TYPE:
+		case LESS_EQUAL_TYPE:
+		case GREATER_EQUAL_TYPE:
+		case EQUAL_EQUAL_TYPE:
+		case NOT_EQUAL_TYPE:
+			return _generateComparison(state, expression);
+		default:
+			break;
+	}
+	const Operand operand = _generateExpression(state, expression, NULL);
+	switch (operand.type) {
+		case INTEGER_NATIVE_TYPE: return _format(state->transpilation, "%s != 0", operand.code);
+		case DECIMAL_NATIVE_TYPE: return _format(state->transpilation, "%s != 0.0", operand.code);
+		case VALUE_NATIVE_TYPE: return _format(state->transpilation, "arcTruthy(%s)", operand.code);
+		default: return "false";
+	}
+}
+
+static Operand _generateFactor(FunctionState * state, Factor * factor, const char * name) {
+	switch (factor->type) {
+		case CONSTANT:
+			return _generateConstant(state, factor->constant);
+		case VARIABLE_TYPE:
+			return _load(state, _resolve(state, factor->variable), factor->variable);
+		case INCREMENT_TYPE:
+			return _generateIncrement(state, factor->variable, 1, true);
+		case DECREMENT_TYPE:
+			return _generateIncrement(state, factor->variable, -1, true);
+		default:
+			return _generateExpression(state, factor->expression, name);
+	}
+}
+
+static boolean _isString(const Expression * expression) {
+	return (expression->type == FACTOR && expression->factor->type == CONSTANT
+		&& (expression->factor->constant->type == C_STRING_TYPE || expression->factor->constant->type == C_CHAR_TYPE)) ? true : false;
+}
+
+/**
+ * A chain of additions whose first or second operand is a string constant
+ * (e.g., a template string) builds its string at once, with the whole
+ * length of its operands, instead of once per addition. If the head of the
+ * chain (after an empty string) is the variable that receives it, it
+ * appends to the string of the variable instead.
+ */
+static boolean _generateJoin(FunctionState * state, Expression * expression, const char * name, Operand * result) {
+	int count = 1;
+	Expression * link = expression;
+	for (; link->type == ADDITION; link = link->leftExpression) {
+		count += 1;
+	}
+	Expression ** parts = calloc(count, sizeof(Expression *));
+	parts[0] = link;
+	link = expression;
+	for (int k = count - 1; 0 < k; --k, link = link->leftExpression) {
+		parts[k] = link->rightExpression;
+	}
+	const Expression * head = (2 < count && _isString(parts[0]) && parts[0]->factor->constant->type == C_STRING_TYPE
+		&& parts[0]->factor->constant->stringValue[0] == '\0') ? parts[1] : parts[0];
+	const boolean isAppended = (name != NULL && head->type == FACTOR && head->factor->type == VARIABLE_TYPE
+		&& strcmp(head->factor->variable, name) == 0) ? true : false;
+	if ((count < 3 && !isAppended) || (!_isString(parts[0]) && !_isString(parts[1]))) {
+		free(parts);
+		return false;
+	}
+	PendingOperand * pending = calloc(count, sizeof(PendingOperand));
+	for (int k = 0; k < count; ++k) {
+		_generateArgument(state, parts[k], &pending[k]);
+	}
+	_sequence(state, pending, count);
+	Emitter * code = createEmitter(-1);
+	emit(code, "%s(%d, (ArcValue[]) { ", isAppended ? "arcAppend" : "arcJoin", count);
+	*result = _operand(NULL, VALUE_NATIVE_TYPE);
+	for (int k = 0; k < count; ++k) {
+		emit(code, k == 0 ? "%s" : ", %s", _convert(state, pending[k].operand, VALUE_NATIVE_TYPE));
+		result->hasEffects = (result->hasEffects || pending[k].operand.hasEffects) ? true : false;
+	}
+	emit(code, " })");
+	result->code = _format(state->transpilation, "%s", code->data);
+	destroyEmitter(code);
+	free(pending);
+	free(parts);
+	return true;
+}
+
+/**
+ * Generates an expression, and returns its code. The statements it needs
+ * (e.g., temporaries) go to the output first. The name is the one of the
+ * variable that receives it, if any, to name the lambdas.
+ */
+static Operand _generateExpression(FunctionState * state, Expression * expression, const char * name) {
+	switch (expression->type) {
+		case ADDITION:
+		case SUBTRACTION:
+		case MULTIPLICATION:
+		case DIVISION: {
+			Operand joined;
+			if (expression->type == ADDITION && _generateJoin(state, expression, name, &joined)) {
+				return joined;
+			}
+			PendingOperand pending[2];
+			_generateArgument(state, expression->leftExpression, &pending[0]);
+			_generateArgument(state, expression->rightExpression, &pending[1]);
+			_sequence(state, pending, 2);
+			return _arithmetic(state, expression->type, pending[0].operand, pending[1].operand);
+		}
+		case FACTOR:
+			return _generateFactor(state, expression->factor, name);
+		case FUNCTION_CALL:
+			return _generateCall(state, expression->functionCall);
+		case LAMBDA:
+			return _generateLambda(state, expression->lambda, name);
+		default: {
+			const char * condition = _generateCondition(state, expression);
+			return _operand(_format(state->transpilation, "arcBoolean(%s)", condition), VALUE_NATIVE_TYPE);
+		}
+	}
+}
+
+/* ------------------------------ Functions ------------------------------- */
+
+/**
+ * The record of a function, created the first time the transpiler finds
+ * it. Its parameters are typed if they're declared as integers or decimals
+ * (or as a parameter of the class that the instantiation binds to them),
+ * and they don't live in cells.
+ */
+static FunctionRecord * _functionRecord(Transpilation * transpilation, const void * key, Lambda * lambda, ClassLayout * class, ClassLayout * instantiation, const char * displayName, const char * base) {
+	for (int k = 0; k < transpilation->functionCount; ++k) {
+		if (transpilation->functions[k]->key == key && transpilation->functions[k]->instantiation == instantiation) {
+			return transpilation->functions[k];
+		}
+	}
+	FunctionRecord * function = calloc(1, sizeof(FunctionRecord));
+	function->key = key;
+	function->lambda = lambda;
+	function->class = class;
+	function->instantiation = instantiation;
+	function->displayName = strdup(displayName);
+	function->name = calloc(strlen(base) + 16, sizeof(char));
+	sprintf(function->name, "%s_%d", base, transpilation->functionCount + 1);
+	for (char * character = function->name; *character != '\0'; ++character) {
+		if (*character == '<' || *character == '>') *character = '_';
+	}
+	if (lambda != NULL && lambda->variableDeclarationList != NULL) {
+		NameSet boxedNames = { NULL, 0, 0 };
+		_prepareBoxedNames(&boxedNames, lambda->block);
+		function->parameterCount = lambda->variableDeclarationList->size;
+		function->parameterTypes = calloc(function->parameterCount, sizeof(NativeType));
+		int k = 0;
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next, ++k) {
+			VariableDeclaration * parameter = node->data;
+			const int typeParameter = instantiation == NULL ? -1 : _typeParameter(instantiation->source, parameter);
+			function->parameterTypes[k] = _containsName(&boxedNames, parameter->name) ? VALUE_NATIVE_TYPE
+				: 0 <= typeParameter ? instantiation->bindings[typeParameter] : _declaredType(parameter->type);
+			if (function->parameterTypes[k] != VALUE_NATIVE_TYPE) {
+				function->hasTypedBody = true;
+			}
+		}
+		_releaseNames(&boxedNames);
+	}
+	transpilation->functions = realloc(transpilation->functions, (transpilation->functionCount + 1) * sizeof(FunctionRecord *));
+	transpilation->functions[transpilation->functionCount++] = function;
+	return function;
+}
+
+/** Writes the definition of a function, and its prototype. */
+static void _emitFunction(FunctionState * state, const char * signature, const Emitter * body) {
+	Transpilation * transpilation = state->transpilation;
+	emit(transpilation->prototypes, "static %s;\n", signature);
+	emit(transpilation->definitions, "\nstatic %s {\n", signature);
+	if (state->usesEnvironment) {
+		emit(transpilation->definitions, "\t%s_Environment * environment = (%s_Environment *) self.asObject;\n",
+			state->function->name, state->function->name);
+	}
+	emitEmitter(transpilation->definitions, body);
+	emit(transpilation->definitions, "}\n");
+}
+
+/**
+ * Generates a version of a lambda or a method. The entry declares the
+ * parameters as values, and the bodies receive them as C parameters.
+ */
+static void _generateVersion(FunctionState * parent, FunctionRecord * function, const Version version) {
+	Transpilation * transpilation = parent->transpilation;
+	Lambda * lambda = function->lambda;
+	Emitter * body = createEmitter(-1);
+	Emitter * parameters = createEmitter(-1);
+	FunctionState state;
+	_initializeFunctionState(&state, transpilation, function->class == NULL ? parent : NULL, function, version, body);
+	if (version != ENTRY_VERSION) {
+		_prepareBoxedNames(&state.boxedNames, lambda->block);
+	}
+	_enterScope(&state);
+	if (function->class != NULL) {
+		const int receiver = _declareLocal(&state, "this", NULL, VALUE_NATIVE_TYPE);
+		if (state.locals[receiver].isBoxed) {
+			_line(&state, "ArcCell * %s = arcCell(self);", state.locals[receiver].cName);
+		}
+		else {
+			state.locals[receiver].cName = "self";
+		}
+	}
+	if (version == ENTRY_VERSION) {
+		_line(&state, "arcExpectArguments(%s, count, %d);", _quote(transpilation, function->displayName), function->parameterCount);
+	}
+	int k = 0;
+	state.parameterBase = state.localCount;
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next, ++k) {
+			VariableDeclaration * parameter = node->data;
+			const NativeType type = version == TYPED_VERSION ? function->parameterTypes[k] : VALUE_NATIVE_TYPE;
+			const int index = _declareLocal(&state, parameter->name, parameter, type);
+			LocalVariable * local = &state.locals[index];
+			if (version == ENTRY_VERSION) {
+				_line(&state, "ArcValue %s = %d < count ? arguments[%d] : arcNil();", local->cName, k, k);
+				if (parameter->expression != NULL) {
+					_line(&state, "if (count <= %d) {", k);
+					state.indentation += 1;
+					const Operand value = _generateExpression(&state, parameter->expression, parameter->name);
+					_line(&state, "%s = %s;", local->cName, _convert(&state, value, VALUE_NATIVE_TYPE));
+					state.indentation -= 1;
+					_line(&state, "}");
+				}
+				continue;
+			}
+			const char * cName = local->cName;
+			if (local->isBoxed || local->type != type) {
+				cName = _format(transpilation, "p_%s", parameter->name);
+				if (local->isBoxed) {
+					_line(&state, "ArcCell * %s = arcCell(%s);", local->cName, cName);
+				}
+				else {
+					Operand argument = _operand(cName, type);
+					_line(&state, "%s %s = %s;", _cType(local->type), local->cName, _convert(&state, argument, local->type));
+				}
+			}
+			emit(parameters, ", %s %s", _cType(type), cName);
+		}
+	}
+	if (version == ENTRY_VERSION) {
+		Emitter * guard = createEmitter(-1);
+		Emitter * typedArguments = createEmitter(-1);
+		Emitter * arguments = createEmitter(-1);
+		for (int k = 0; k < function->parameterCount; ++k) {
+			const LocalVariable * local = &state.locals[state.localCount - function->parameterCount + k];
+			const NativeType type = function->parameterTypes[k];
+			if (type != VALUE_NATIVE_TYPE) {
+				emit(guard, "%s%s.type == %s", guard->length == 0 ? "" : " && ", local->cName,
+					type == INTEGER_NATIVE_TYPE ? "ARC_INTEGER" : "ARC_DECIMAL");
+			}
+			emit(typedArguments, ", %s", _convert(&state, _operand(local->cName, VALUE_NATIVE_TYPE), type));
+			emit(arguments, ", %s", local->cName);
+		}
+		if (function->hasTypedBody) {
+			_line(&state, "if (%s) {", guard->data);
+			const Operand typedResult = _operand(_format(transpilation, "%s_typed(self%s)", function->name, typedArguments->data == NULL ? "" : typedArguments->data),
+				function->returnTypes[TYPED_VERSION]);
+			_line(&state, "\treturn %s;", _convert(&state, typedResult, VALUE_NATIVE_TYPE));
+			_line(&state, "}");
+		}
+		const Operand result = _operand(_format(transpilation, "%s_body(self%s)", function->name, arguments->data == NULL ? "" : arguments->data),
+			function->returnTypes[GENERIC_VERSION]);
+		_line(&state, "return %s;", _convert(&state, result, VALUE_NATIVE_TYPE));
+		destroyEmitter(guard);
+		destroyEmitter(typedArguments);
+		destroyEmitter(arguments);
+	}
+	else {
+		Emitter * block = createEmitter(-1);
+		state.output = block;
+		_generateBlock(&state, lambda->block);
+		if (!_alwaysReturns(lambda->block)) {
+			_generateReturn(&state, NULL);
+		}
+		state.output = body;
+		if (state.hasTailLabel) {
+			emit(body, "tail:\n");
+		}
+		emitEmitter(body, block);
+		destroyEmitter(block);
+	}
+	_exitScope(&state);
+
+	const char * signature;
+	if (version == ENTRY_VERSION) {
+		signature = _format(transpilation, "ArcValue %s(ArcValue self, int count, ArcValue * arguments)", function->name);
+	}
+	else {
+		signature = _format(transpilation, "%s %s_%s(ArcValue self%s)", _cType(function->returnTypes[version]),
+			function->name, version == TYPED_VERSION ? "typed" : "body", parameters->data == NULL ? "" : parameters->data);
+	}
+	_emitFunction(&state, signature, body);
+	_finishFunctionState(&state);
+	destroyEmitter(body);
+	destroyEmitter(parameters);
+}
+
+/**
+ * Generates every version of a lambda or a method. A lambda that captures
+ * variables also gets the structure of its environment, and a function that
+ * creates it.
+ */
+static void _generateFunction(FunctionState * parent, FunctionRecord * function) {
+	Transpilation * transpilation = parent->transpilation;
+	function->pass = transpilation->pass;
+	_generateVersion(parent, function, ENTRY_VERSION);
+	if (function->hasTypedBody) {
+		_generateVersion(parent, function, TYPED_VERSION);
+	}
+	_generateVersion(parent, function, GENERIC_VERSION);
+	if (function->captures.count == 0) return;
+	const char * name = function->name;
+	emit(transpilation->types, "\ntypedef struct {\n\tArcClosure closure;\n");
+	Emitter * parameters = createEmitter(-1);
+	for (int k = 0; k < function->captures.count; ++k) {
+		const char * type = _containsName(&function->sharedCaptures, function->captures.names[k]) ? "ArcCell *" : "ArcValue";
+		emit(transpilation->types, "\t%s v_%s;\n", type, function->captures.names[k]);
+		emit(parameters, "%s%s v_%s", k == 0 ? "" : ", ", type, function->captures.names[k]);
+	}
+	emit(transpilation->types, "} %s_Environment;\n", name);
+	emit(transpilation->prototypes, "static ArcValue %s_new(%s);\n", name, parameters->data);
+	emit(transpilation->definitions, "\nstatic ArcValue %s_new(%s) {\n", name, parameters->data);
+	emit(transpilation->definitions, "\t%s_Environment * environment = arcAllocate(ARC_CLOSURE, sizeof(%s_Environment));\n", name, name);
+	emit(transpilation->definitions, "\tenvironment->closure.function = %s;\n", name);
+	emit(transpilation->definitions, "\tenvironment->closure.name = %s;\n", _quote(transpilation, function->displayName));
+	for (int k = 0; k < function->captures.count; ++k) {
+		emit(transpilation->definitions, "\tenvironment->v_%s = v_%s;\n", function->captures.names[k], function->captures.names[k]);
+	}
+	emit(transpilation->definitions, "\treturn arcObject(environment);\n}\n");
+	destroyEmitter(parameters);
+}
+
+/**
+ * Creates a closure. The functions of a lambda are generated the first time
+ * a pass finds it, and its captures come from the variables of the creator.
+ */
+static Operand _generateLambda(FunctionState * state, Lambda * lambda, const char * name) {
+	Transpilation * transpilation = state->transpilation;
+	const char * displayName = name == NULL ? "<lambda>" : name;
+	FunctionRecord * function = _functionRecord(transpilation, lambda, lambda, NULL, state->function->instantiation, displayName, name == NULL ? "lambda" : name);
+	if (function->pass != transpilation->pass) {
+		_generateFunction(state, function);
+	}
+	Operand operand = _operand(NULL, VALUE_NATIVE_TYPE);
+	operand.isLocal = true;
+	if (function->captures.count == 0) {
+		operand.code = _format(transpilation, "arcClosure(%s, %s)", function->name, _quote(transpilation, function->displayName));
+		return operand;
+	}
+	Emitter * sources = createEmitter(-1);
+	for (int k = 0; k < function->captures.count; ++k) {
+		emit(sources, "%s%s", k == 0 ? "" : ", ", _captureSource(state, function, function->captures.names[k]));
+	}
+	operand.code = _format(transpilation, "%s_new(%s)", function->name, sources->data);
+	destroyEmitter(sources);
+	return operand;
+}
+
+/* ----------------------------- Instructions ----------------------------- */
+
+static boolean _isEndless(Expression * expression) {
+	if (expression->type != FACTOR || expression->factor->type != CONSTANT) return false;
+	const Constant * constant = expression->factor->constant;
+	switch (constant->type) {
+		case C_BOOLEAN_TYPE: return constant->booleanValue;
+		case C_INT_TYPE: return constant->intValue != 0 ? true : false;
+		case C_DOUBLE_TYPE: return constant->doubleValue != 0.0 ? true : false;
+		case C_FLOAT_TYPE: return constant->floatValue != 0.0f ? true : false;
+		default: return false;
+	}
+}
+
+static boolean _instructionAlwaysReturns(Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_RETURN:
+			return true;
+		case INSTRUCTION_BLOCK:
+			return _alwaysReturns(instruction->block);
+		case INSTRUCTION_CONDITIONAL:
+			for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+				if (!_alwaysReturns(conditional->block)) return false;
+				if (conditional->expression == NULL) return true;
+			}
+			return false;
+		case INSTRUCTION_LOOP:
+			return (instruction->loop->type == WHILE_LOOP && _isEndless(instruction->loop->expression)) ? true : false;
+		default:
+			return false;
+	}
+}
+
+/** Whether the end of the block is unreachable. */
+static boolean _alwaysReturns(Block * block) {
+	if (block == NULL) return false;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		if (_instructionAlwaysReturns(node->data)) return true;
+	}
+	return false;
+}
+
+static void _generateAssignment(FunctionState * state, AssignmentOperation * assignment) {
+	static const ExpressionType operations[] = { [ADD_ASSIGN_TYPE] = ADDITION, [SUB_ASSIGN_TYPE] = SUBTRACTION, [MUL_ASSIGN_TYPE] = MULTIPLICATION };
+	Transpilation * transpilation = state->transpilation;
+	const char * name = assignment->name;
+	Location location = _resolve(state, name);
+	if (assignment->assignmentOperator == ASSIGN_TYPE) {
+		if (location.type == UNRESOLVED_LOCATION) {
+			location = _declareVariable(state, name, assignment);
+			if (location.type == LOCAL_LOCATION && !state->locals[location.index].isBoxed) {
+				const Operand value = _generateExpression(state, assignment->expression, name);
+				LocalVariable * local = &state->locals[location.index];
+				_learn(transpilation, &state->function->facts[local->fact].type, value.type);
+				local->type = state->function->facts[local->fact].type;
+				_line(state, "%s %s = %s;", _cType(local->type), local->cName, _convert(state, value, local->type));
+				return;
+			}
+		}
+		_store(state, location, name, _generateExpression(state, assignment->expression, name));
+		return;
+	}
+	PendingOperand pending[2];
+	pending[0].statements = NULL;
+	pending[0].operand = _load(state, location, name);
+	_generateArgument(state, assignment->expression, &pending[1]);
+	_sequence(state, pending, 2);
+	if (assignment->assignmentOperator == ADD_ASSIGN_TYPE && _isString(assignment->expression)) {
+		const char * code = _format(transpilation, "arcAppend(2, (ArcValue[]) { %s, %s })",
+			_convert(state, pending[0].operand, VALUE_NATIVE_TYPE), _convert(state, pending[1].operand, VALUE_NATIVE_TYPE));
+		_store(state, location, name, _operand(code, VALUE_NATIVE_TYPE));
+		return;
+	}
+	_store(state, location, name, _arithmetic(state, operations[assignment->assignmentOperator], pending[0].operand, pending[1].operand));
+}
+
+static void _generateDeclaration(FunctionState * state, VariableDeclaration * variableDeclaration) {
+	Transpilation * transpilation = state->transpilation;
+	const char * name = variableDeclaration->name;
+	const Location location = _declareVariable(state, name, variableDeclaration);
+	const Operand value = variableDeclaration->expression == NULL
+		? _generateDefaultValue(state, variableDeclaration->type)
+		: _generateExpression(state, variableDeclaration->expression, name);
+	if (location.type == LOCAL_LOCATION && !state->locals[location.index].isBoxed) {
+		LocalVariable * local = &state->locals[location.index];
+		_learn(transpilation, &state->function->facts[local->fact].type, value.type);
+		local->type = state->function->facts[local->fact].type;
+		_line(state, "%s %s = %s;", _cType(local->type), local->cName, _convert(state, value, local->type));
+		return;
+	}
+	_store(state, location, name, value);
+}
+
+/**
+ * An else-if whose condition needs statements becomes an if nested in the
+ * else branch, after them.
+ */
+static void _generateConditional(FunctionState * state, Conditional * conditional) {
+	int nesting = 0;
+	for (Conditional * branch = conditional; branch != NULL; branch = branch->nextConditional) {
+		if (branch->expression == NULL) {
+			_line(state, "else {");
+			_generateScopedBlock(state, branch->block);
+			_line(state, "}");
+			break;
+		}
+		if (branch == conditional) {
+			_line(state, "if (%s) {", _generateCondition(state, branch->expression));
+		}
+		else {
+			Emitter * statements = createEmitter(-1);
+			Emitter * output = state->output;
+			state->output = statements;
+			state->indentation += 1;
+			const char * condition = _generateCondition(state, branch->expression);
+			state->indentation -= 1;
+			state->output = output;
+			if (statements->length == 0) {
+				_line(state, "else if (%s) {", condition);
+			}
+			else {
+				_line(state, "else {");
+				emitEmitter(state->output, statements);
+				state->indentation += 1;
+				nesting += 1;
+				_line(state, "if (%s) {", condition);
+			}
+			destroyEmitter(statements);
+		}
+		_generateScopedBlock(state, branch->block);
+		_line(state, "}");
+	}
+	for (; 0 < nesting; --nesting) {
+		state->indentation -= 1;
+		_line(state, "}");
+	}
+}
+
+/**
+ * A condition that needs statements is tested at the start of an endless
+ * loop, after them. A constant condition that holds needs no test at all.
+ */
+static void _generateWhileLoop(FunctionState * state, Loop * loop) {
+	if (_isEndless(loop->expression)) {
+		_line(state, "for (;;) {");
+	}
+	else {
+		Emitter * statements = createEmitter(-1);
+		Emitter * output = state->output;
+		state->output = statements;
+		state->indentation += 1;
+		const char * condition = _generateCondition(state, loop->expression);
+		state->indentation -= 1;
+		state->output = output;
+		if (statements->length == 0) {
+			_line(state, "while (%s) {", condition);
+		}
+		else {
+			_line(state, "for (;;) {");
+			emitEmitter(state->output, statements);
+			_line(state, "\tif (!(%s)) break;", condition);
+		}
+		destroyEmitter(statements);
+	}
+	state->loopDepth += 1;
+	_generateScopedBlock(state, loop->block);
+	state->loopDepth -= 1;
+	_line(state, "}");
+}
+
+/**
+ * Any call may push into a list, except the one of a native other than
+ * "push". The lambdas of the body don't run unless a call does.
+ */
+static VisitAction _findGrowth(void * state, void * node) {
+	GrowthScan * scan = state;
+	const char * native = _calledNative(scan->function, ((Expression *) node)->functionCall->name);
+	if (native == NULL || strcmp(native, "arcPush") == 0) {
+		scan->growsLists = true;
+	}
+	return VISIT_CHILDREN;
+}
+
+static boolean _growsLists(FunctionState * state, Block * block) {
+	GrowthScan scan = { state, false };
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "list growth";
+	visitor.pre[CALL_NODE] = _findGrowth;
+	visitor.pre[LAMBDA_NODE] = _skipLambda;
+	visitor.pre[CLASS_NODE] = _skipClass;
+	visitor.pre[INTERFACE_NODE] = _skipClass;
+	visitor.state = &scan;
+	Visitor * visitors[] = { &visitor };
+	walkBlock(block, visitors, 1);
+	return scan.growsLists;
+}
+
+static Instruction * _onlyInstruction(const Block * block) {
+	return (block != NULL && block->size == 1) ? block->first->data : NULL;
+}
+
+static boolean _isVariable(const Expression * expression, const char * name) {
+	return (expression->type == FACTOR && expression->factor->type == VARIABLE_TYPE && strcmp(expression->factor->variable, name) == 0) ? true : false;
+}
+
+/**
+ * The assignment of a body that only adds the item to a variable (or
+ * subtracts it), or NULL.
+ */
+static AssignmentOperation * _findReduction(const Loop * loop, ExpressionType * operation) {
+	const Instruction * instruction = _onlyInstruction(loop->block);
+	if (instruction == NULL || instruction->type != INSTRUCTION_ASSIGNMENT) return NULL;
+	AssignmentOperation * assignment = instruction->assignment;
+	const Expression * expression = assignment->expression;
+	const char * item = loop->itemName;
+	if (strcmp(assignment->name, item) == 0) return NULL;
+	switch (assignment->assignmentOperator) {
+		case ADD_ASSIGN_TYPE:
+		case SUB_ASSIGN_TYPE:
+			*operation = assignment->assignmentOperator == ADD_ASSIGN_TYPE ? ADDITION : SUBTRACTION;
+			return _isVariable(expression, item) ? assignment : NULL;
+		case ASSIGN_TYPE:
+			*operation = expression->type;
+			if (expression->type == ADDITION && _isVariable(expression->leftExpression, item) && _isVariable(expression->rightExpression, assignment->name)) {
+				return assignment;
+			}
+			if ((expression->type == ADDITION || expression->type == SUBTRACTION)
+					&& _isVariable(expression->leftExpression, assignment->name) && _isVariable(expression->rightExpression, item)) {
+				return assignment;
+			}
+			return NULL;
+		default:
+			return NULL;
+	}
+}
+
+/**
+ * The call of a body that only pushes the item, combined with a constant or
+ * another variable, into a list, or NULL.
+ */
+static FunctionCall * _findMap(FunctionState * state, const Loop * loop, Expression ** operand, boolean * isOperandFirst) {
+	const Instruction * instruction = _onlyInstruction(loop->block);
+	if (instruction == NULL || instruction->type != INSTRUCTION_EXPRESSION || instruction->expression->type != FUNCTION_CALL) return NULL;
+	FunctionCall * call = instruction->expression->functionCall;
+	const char * native = _calledNative(state, call->name);
+	if (native == NULL || strcmp(native, "arcPush") != 0 || call->expressionList == NULL || call->expressionList->size != 2) return NULL;
+	const Expression * target = call->expressionList->first->data;
+	const Expression * value = call->expressionList->last->data;
+	const char * item = loop->itemName;
+	if (target->type != FACTOR || target->factor->type != VARIABLE_TYPE || strcmp(target->factor->variable, item) == 0) return NULL;
+	if (value->type != ADDITION && value->type != SUBTRACTION && value->type != MULTIPLICATION) return NULL;
+	*isOperandFirst = _isVariable(value->rightExpression, item);
+	*operand = *isOperandFirst ? value->leftExpression : value->rightExpression;
+	if (!_isVariable(*isOperandFirst ? value->rightExpression : value->leftExpression, item) || (*operand)->type != FACTOR) return NULL;
+	const Factor * factor = (*operand)->factor;
+	if (factor->type == VARIABLE_TYPE) {
+		return strcmp(factor->variable, item) == 0 ? NULL : call;
+	}
+	if (factor->type != CONSTANT) return NULL;
+	const ConstantType type = factor->constant->type;
+	return (type == C_INT_TYPE || type == C_DOUBLE_TYPE || type == C_FLOAT_TYPE) ? call : NULL;
+}
+
+/**
+ * A loop that only adds up the items, or only maps them into a list, tries
+ * a kernel of the runtime first, which works on whole vectors of numbers.
+ * The loop runs only if the kernel can't (e.g., an item isn't a number), so
+ * the kernels have no effects when they fail. A sum is added at once, so
+ * the accumulator must be an integer too. Returns whether the loop is
+ * guarded, and then it needs a closing brace.
+ */
+static boolean _generateKernel(FunctionState * state, Loop * loop, const char * collection) {
+	static const char symbols[] = { [ADDITION] = '+', [SUBTRACTION] = '-', [MULTIPLICATION] = '*' };
+	Transpilation * transpilation = state->transpilation;
+	ExpressionType operation;
+	AssignmentOperation * reduction = _findReduction(loop, &operation);
+	if (reduction != NULL) {
+		const Location location = _resolve(state, reduction->name);
+		if (location.type != LOCAL_LOCATION && location.type != GLOBAL_LOCATION) return false;
+		const Operand accumulator = _load(state, location, reduction->name);
+		if (accumulator.type != INTEGER_NATIVE_TYPE && accumulator.type != VALUE_NATIVE_TYPE) return false;
+		const char * sum = _temporary(state);
+		const char * check = accumulator.type == VALUE_NATIVE_TYPE ? _format(transpilation, "%s.type == ARC_INTEGER && ", accumulator.code) : "";
+		_line(state, "int64_t %s;", sum);
+		_line(state, "if (0 < arcLength(%s) && %sarcSumIntegers(%s, &%s)) {", collection, check, collection, sum);
+		state->indentation += 1;
+		_store(state, location, reduction->name, _arithmetic(state, operation, accumulator, _operand(sum, INTEGER_NATIVE_TYPE)));
+		state->indentation -= 1;
+		_line(state, "}");
+		_line(state, "else {");
+		return true;
+	}
+	Expression * operand = NULL;
+	boolean isOperandFirst = false;
+	FunctionCall * map = _findMap(state, loop, &operand, &isOperandFirst);
+	if (map == NULL) return false;
+	Expression * value = map->expressionList->last->data;
+	// Both are constants or loads, which only run if there are items.
+	const Operand target = _generateExpression(state, map->expressionList->first->data, NULL);
+	const Operand combined = _generateExpression(state, operand, NULL);
+	_line(state, "if (arcLength(%s) == 0 || !arcMapNumbers(%s, %s, '%c', %s, %s)) {", collection,
+		_convert(state, target, VALUE_NATIVE_TYPE), collection, symbols[value->type],
+		_convert(state, combined, VALUE_NATIVE_TYPE), isOperandFirst ? "true" : "false");
+	return true;
+}
+
+/**
+ * A for-in loop is a counted loop over the collection, which is read once.
+ * Lists only grow, so if the body can't push into any, the loop counts up to
+ * the length it has at the start, and reads the items without checks.
+ * Otherwise, the length is checked on every iteration.
+ */
+static void _generateForLoop(FunctionState * state, Loop * loop) {
+	_enterScope(state);
+	const Operand collection = _load(state, _resolve(state, loop->collectionName), loop->collectionName);
+	const char * name = _temporary(state);
+	const char * index = _temporary(state);
+	_line(state, "const ArcValue %s = %s;", name, _convert(state, collection, VALUE_NATIVE_TYPE));
+	_line(state, "arcExpectIterable(%s);", name);
+	const boolean isGuarded = _generateKernel(state, loop, name);
+	state->indentation += isGuarded ? 1 : 0;
+	const char * element = _format(state->transpilation, "arcElement(%s, %s)", name, index);
+	if (_growsLists(state, loop->block)) {
+		_line(state, "for (int64_t %s = 0; %s < arcLength(%s); ++%s) {", index, index, name, index);
+	}
+	else {
+		const char * length = _temporary(state);
+		const char * items = _temporary(state);
+		_line(state, "const int64_t %s = arcLength(%s);", length, name);
+		_line(state, "const ArcValue * %s = arcItems(%s);", items, name);
+		_line(state, "for (int64_t %s = 0; %s < %s; ++%s) {", index, index, length, index);
+		element = _format(state->transpilation, "%s != NULL ? %s[%s] : %s", items, items, index, element);
+	}
+	state->indentation += 1;
+	const int item = _declareLocal(state, loop->itemName, loop, VALUE_NATIVE_TYPE);
+	const LocalVariable * local = &state->locals[item];
+	if (local->isBoxed) {
+		_line(state, "ArcCell * %s = arcCell(%s);", local->cName, element);
+	}
+	else {
+		_line(state, "%s %s = %s;", _cType(local->type), local->cName, element);
+	}
+	state->loopDepth += 1;
+	_generateBlock(state, loop->block);
+	state->loopDepth -= 1;
+	state->indentation -= 1;
+	_line(state, "}");
+	if (isGuarded) {
+		state->indentation -= 1;
+		_line(state, "}");
+	}
+	_exitScope(state);
+}
+
+/**
+ * Returns from the function. The initializer of a class returns the
+ * instance, and the program stops.
+ */
+static void _generateReturn(FunctionState * state, Instruction * returned) {
+	Transpilation * transpilation = state->transpilation;
+	Operand value = _operand("arcNil()", VALUE_NATIVE_TYPE);
+	value.isStable = true;
+	if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION) {
+		state->tailCall = returned->expression->type == FUNCTION_CALL ? returned->expression->functionCall : NULL;
+		value = _generateExpression(state, returned->expression, NULL);
+		state->tailCall = NULL;
+		if (state->isTailJump) {
+			state->isTailJump = false;
+			return;
+		}
+	}
+	else {
+		if (returned != NULL) {
+			_generateInstruction(state, returned);
+		}
+		if (state->isInitializer) {
+			value.code = _receiver(state);
+		}
+	}
+	if (state->isTopLevel) {
+		if (!value.isStable) {
+			_line(state, "(void) %s;", value.code);
+		}
+		_line(state, "return 0;");
+		return;
+	}
+	if (state->isInitializer) {
+		_line(state, "return %s;", _convert(state, value, VALUE_NATIVE_TYPE));
+		return;
+	}
+	NativeType * returnType = &state->function->returnTypes[state->version];
+	_learn(transpilation, returnType, value.type);
+	_line(state, "return %s;", _convert(state, value, *returnType));
+}
+
+static void _generateInstruction(FunctionState * state, Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			_generateAssignment(state, instruction->assignment);
+			break;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			_generateDeclaration(state, instruction->variableDeclaration);
+			break;
+		case INSTRUCTION_EXPRESSION: {
+			Expression * expression = instruction->expression;
+			if (expression->type == FACTOR && expression->factor->type == INCREMENT_TYPE) {
+				_generateIncrement(state, expression->factor->variable, 1, false);
+			}
+			else if (expression->type == FACTOR && expression->factor->type == DECREMENT_TYPE) {
+				_generateIncrement(state, expression->factor->variable, -1, false);
+			}
+			else {
+				state->discardedCall = expression->type == FUNCTION_CALL ? expression->functionCall : NULL;
+				const Operand operand = _generateExpression(state, expression, NULL);
+				state->discardedCall = NULL;
+				_line(state, operand.hasEffects ? "%s;" : "(void) %s;", operand.code);
+			}
+			break;
+		}
+		case INSTRUCTION_BLOCK:
+			_line(state, "{");
+			_generateScopedBlock(state, instruction->block);
+			_line(state, "}");
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			_generateConditional(state, instruction->conditional);
+			break;
+		case INSTRUCTION_LOOP:
+			if (instruction->loop->type == FOR_LOOP) {
+				_generateForLoop(state, instruction->loop);
+			}
+			else {
+				_generateWhileLoop(state, instruction->loop);
+			}
+			break;
+		case INSTRUCTION_RETURN:
+			_generateReturn(state, instruction->returnInstruction);
+			break;
+		case INSTRUCTION_PASS:
+			if (0 < state->loopDepth) {
+				_line(state, "continue;");
+			}
+			break;
+		case INSTRUCTION_CLASS:
+			_generateStatics(state, instruction->class);
+			break;
+		case INSTRUCTION_INTERFACE:
+			break;
+	}
+}
+
+static void _generateBlock(FunctionState * state, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_generateInstruction(state, node->data);
+	}
+}
+
+/** A block of the language is a block of C, one level deeper. */
+static void _generateScopedBlock(FunctionState * state, Block * block) {
+	_enterScope(state);
+	state->indentation += 1;
+	_generateBlock(state, block);
+	state->indentation -= 1;
+	_exitScope(state);
+}
+
+/* -------------------------------- Classes ------------------------------- */
+
+/** The name a class-body instruction declares, or NULL. */
+static const char * _memberName(Instruction * instruction) {
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		return instruction->variableDeclaration->name;
+	}
+	if (instruction->type == INSTRUCTION_ASSIGNMENT && instruction->assignment->assignmentOperator == ASSIGN_TYPE) {
+		return instruction->assignment->name;
+	}
+	return NULL;
+}
+
+/** Whether a class-body instruction declares an eternal field. */
+static boolean _isEternal(Instruction * instruction) {
+	if (instruction->type != INSTRUCTION_VARIABLE_DECLARATION || instruction->variableDeclaration->privacyModifierList == NULL) {
+		return false;
+	}
+	for (Node * node = instruction->variableDeclaration->privacyModifierList->first; node != NULL; node = node->next) {
+		if (((PrivacyModifier *) node->data)->type == STATIC_A) return true;
+	}
+	return false;
+}
+
+/** The lambda literal that defines a member, if it's a method. */
+static Lambda * _memberLambda(Instruction * instruction) {
+	Expression * expression = NULL;
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		expression = instruction->variableDeclaration->expression;
+	}
+	else if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+		expression = instruction->assignment->expression;
+	}
+	return (expression != NULL && expression->type == LAMBDA) ? expression->lambda : NULL;
+}
+
+static VisitAction _collectClass(void * state, void * node) {
+	Transpilation * transpilation = state;
+	Class * source = ((Instruction *) node)->class;
+	if (_findClass(transpilation, source->object->name) != NULL) return VISIT_CHILDREN;
+	ClassLayout * class = calloc(1, sizeof(ClassLayout));
+	class->source = source;
+	class->name = source->object->name;
+	transpilation->classes = realloc(transpilation->classes, (transpilation->classCount + 1) * sizeof(ClassLayout *));
+	transpilation->classes[transpilation->classCount++] = class;
+	return VISIT_CHILDREN;
+}
+
+/**
+ * Lays out the fields and the methods of a class after the ones of its
+ * parent, like the bytecode compiler does. Redeclared fields keep their
+ * inherited slot, and overridden methods replace the inherited ones. Unknown
+ * parents are ignored. The eternal fields go to the static segment, which
+ * the instantiations of a generic class share with it.
+ */
+static void _layoutClass(Transpilation * transpilation, ClassLayout * class, const int depth) {
+	if (class->isLaidOut || transpilation->classCount < depth) return;
+	Class * source = class->source;
+	ClassLayout * instantiation = class->generic == NULL ? NULL : class;
+	ClassLayout * parent = source->inherits == NULL ? NULL : _findClass(transpilation, source->inherits->name);
+	if (parent != NULL && parent != class) {
+		_layoutClass(transpilation, parent, depth + 1);
+		class->parent = parent;
+		class->depth = parent->depth + 1;
+		class->fields = calloc(parent->fieldCount + 1, sizeof(FieldSlot));
+		if (0 < parent->fieldCount) {
+			memcpy(class->fields, parent->fields, parent->fieldCount * sizeof(FieldSlot));
+		}
+		class->fieldCount = parent->fieldCount;
+		class->statics = calloc(parent->staticCount + 1, sizeof(FieldSlot));
+		if (0 < parent->staticCount) {
+			memcpy(class->statics, parent->statics, parent->staticCount * sizeof(FieldSlot));
+		}
+		class->staticCount = parent->staticCount;
+		class->methods = calloc(parent->methodCount + 1, sizeof(MethodSlot));
+		if (0 < parent->methodCount) {
+			memcpy(class->methods, parent->methods, parent->methodCount * sizeof(MethodSlot));
+		}
+		class->methodCount = parent->methodCount;
+	}
+	if (source->block != NULL) {
+		for (Node * node = source->block->first; node != NULL; node = node->next) {
+			const char * name = _memberName(node->data);
+			if (name == NULL) continue;
+			Lambda * lambda = _memberLambda(node->data);
+			if (lambda == NULL) {
+				if (_findField(class, name) != NULL || _findStatic(class, name) != NULL) continue;
+				FieldSlot ** slots = _isEternal(node->data) ? &class->statics : &class->fields;
+				int * count = _isEternal(node->data) ? &class->staticCount : &class->fieldCount;
+				*slots = realloc(*slots, (*count + 1) * sizeof(FieldSlot));
+				FieldSlot * field = &(*slots)[*count];
+				if (_isEternal(node->data) && class->generic != NULL) {
+					*field = *_findStatic(class->generic, name);
+					*count += 1;
+					continue;
+				}
+				field->name = name;
+				field->owner = class;
+				field->index = (*count)++;
+				field->type = UNDETERMINED_NATIVE_TYPE;
+				continue;
+			}
+			char * displayName = calloc(strlen(source->object->name) + strlen(name) + 2, sizeof(char));
+			sprintf(displayName, "%s.%s", source->object->name, name);
+			char * base = calloc(strlen(class->name) + strlen(name) + 2, sizeof(char));
+			sprintf(base, "%s_%s", class->name, name);
+			FunctionRecord * function = _functionRecord(transpilation, lambda, lambda, class, instantiation, displayName, base);
+			free(displayName);
+			free(base);
+			MethodSlot * method = _findMethod(class, name);
+			if (method == NULL) {
+				class->methods = realloc(class->methods, (class->methodCount + 1) * sizeof(MethodSlot));
+				method = &class->methods[class->methodCount++];
+				method->name = name;
+				method->owner = class;
+				method->isOverridden = false;
+			}
+			method->function = function;
+		}
+	}
+	class->initializer = _functionRecord(transpilation, class, NULL, class, instantiation, source->object->name, class->name);
+	class->isLaidOut = true;
+}
+
+/**
+ * The class hierarchy analysis, once every class is laid out (the program is
+ * the whole world): a slot is overridden in an ancestor if a descendant has
+ * another implementation in it. The calls to a method that isn't overridden
+ * (e.g., any method of a class without subclasses) are direct.
+ */
+static void _markOverrides(Transpilation * transpilation) {
+	for (int k = 0; k < transpilation->classCount; ++k) {
+		const ClassLayout * class = transpilation->classes[k];
+		ClassLayout * ancestor = class->parent;
+		for (int depth = 0; ancestor != NULL && depth < transpilation->classCount; ++depth, ancestor = ancestor->parent) {
+			for (int m = 0; m < ancestor->methodCount && m < class->methodCount; ++m) {
+				if (ancestor->methods[m].function != class->methods[m].function) {
+					ancestor->methods[m].isOverridden = true;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * The unbounded parameter of a generic class that a declaration has as its
+ * type, or -1. A bounded parameter only takes objects.
+ */
+static int _typeParameter(const Class * source, const VariableDeclaration * declaration) {
+	const Object * type = declaration->object;
+	if (declaration->type != OBJECT || type == NULL || type->genericList != NULL || source->object->genericList == NULL) return -1;
+	int index = 0;
+	for (Node * node = source->object->genericList->first; node != NULL; node = node->next, ++index) {
+		const Generic * generic = node->data;
+		if (generic->isObject == NULL && strcmp(generic->object->name, type->name) == 0) return index;
+	}
+	return -1;
+}
+
+/** The unbounded parameter of a generic class that types one of its fields, or -1. */
+static int _fieldParameter(const Class * source, const char * name) {
+	for (Node * node = source->block->first; node != NULL; node = node->next) {
+		const Instruction * instruction = node->data;
+		if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION && strcmp(instruction->variableDeclaration->name, name) == 0) {
+			return _typeParameter(source, instruction->variableDeclaration);
+		}
+	}
+	return -1;
+}
+
+static VisitAction _measureNode(void * state, void * node) {
+	*((int *) state) += 1;
+	return VISIT_CHILDREN;
+}
+
+/**
+ * The class that a construction instantiates. A generic class is
+ * monomorphized for the integers and decimals that the arguments bind to its
+ * unbounded parameters, so the fields of those types are plain C variables
+ * in its instances (and its methods). Any other construction shares the
+ * erased class, and so does any instantiation whose nodes don't fit in what
+ * remains of "MONOMORPHIZATION_BUDGET".
+ */
+static ClassLayout * _instantiate(Transpilation * transpilation, ClassLayout * class, PendingOperand * pending, const int count) {
+	const GenericList * parameters = class->source->object->genericList;
+	if (parameters == NULL || class->source->block == NULL) return class;
+	NativeType * bindings = calloc(parameters->size, sizeof(NativeType));
+	for (int k = 0; k < count && k < class->fieldCount; ++k) {
+		if (class->fields[k].owner != class) continue;
+		const int parameter = _fieldParameter(class->source, class->fields[k].name);
+		if (0 <= parameter) {
+			bindings[parameter] = _join(bindings[parameter], pending[k + 1].operand.type);
+		}
+	}
+	boolean isPrimitive = false;
+	for (int k = 0; k < parameters->size; ++k) {
+		if (bindings[k] == INTEGER_NATIVE_TYPE || bindings[k] == DECIMAL_NATIVE_TYPE) {
+			isPrimitive = true;
+		}
+		else {
+			bindings[k] = VALUE_NATIVE_TYPE;
+		}
+	}
+	for (int k = 0; k < transpilation->classCount && isPrimitive; ++k) {
+		ClassLayout * instantiation = transpilation->classes[k];
+		if (instantiation->generic == class && memcmp(instantiation->bindings, bindings, parameters->size * sizeof(NativeType)) == 0) {
+			if (count < instantiation->leastArgumentCount) {
+				instantiation->leastArgumentCount = count;
+				transpilation->hasChanged = true;
+			}
+			free(bindings);
+			return instantiation;
+		}
+	}
+	int cost = 0;
+	if (isPrimitive) {
+		Visitor measure;
+		memset(&measure, 0, sizeof(Visitor));
+		measure.name = "measure";
+		for (int kind = 0; kind < NODE_KIND_COUNT; ++kind) {
+			measure.pre[kind] = _measureNode;
+		}
+		measure.state = &cost;
+		Visitor * visitors[] = { &measure };
+		walkBlock(class->source->block, visitors, 1);
+	}
+	if (!isPrimitive || transpilation->monomorphizationBudget < transpilation->monomorphizedCost + cost) {
+		free(bindings);
+		return class;
+	}
+	transpilation->monomorphizedCost += cost;
+	ClassLayout * instantiation = calloc(1, sizeof(ClassLayout));
+	instantiation->source = class->source;
+	instantiation->generic = class;
+	instantiation->bindings = bindings;
+	instantiation->leastArgumentCount = count;
+	Emitter * name = createEmitter(-1);
+	emit(name, "%s_", class->name);
+	for (int k = 0; k < parameters->size; ++k) {
+		emit(name, "_%s", bindings[k] == INTEGER_NATIVE_TYPE ? "int" : bindings[k] == DECIMAL_NATIVE_TYPE ? "double" : "value");
+	}
+	instantiation->name = strdup(name->data);
+	destroyEmitter(name);
+	transpilation->classes = realloc(transpilation->classes, (transpilation->classCount + 1) * sizeof(ClassLayout *));
+	transpilation->classes[transpilation->classCount++] = instantiation;
+	_layoutClass(transpilation, instantiation, 0);
+	transpilation->hasChanged = true;
+	return instantiation;
+}
+
+/**
+ * The bytes of a field of the given type. A value of the runtime is a tag
+ * and an 8-byte union, and every type aligns to 8 bytes.
+ */
+static int _fieldSize(const NativeType type) {
+	return type == INTEGER_NATIVE_TYPE || type == DECIMAL_NATIVE_TYPE ? 8 : 16;
+}
+
+/**
+ * The structure of the instances of a class starts with the one of its
+ * parent (so the inherited fields keep their offsets), and so does its table
+ * of methods. Its own fields follow from the largest to the smallest, in the
+ * order of declaration among the ones of the same size, so there's no
+ * padding between them. The eternal fields it declares get a structure of
+ * their own, and a single instance of it.
+ */
+static void _emitClassTypes(Transpilation * transpilation, ClassLayout * class) {
+	const int firstField = class->parent == NULL ? 0 : class->parent->fieldCount;
+	const int firstMethod = class->parent == NULL ? 0 : class->parent->methodCount;
+	const int firstStatic = class->parent == NULL ? 0 : class->parent->staticCount;
+	emit(transpilation->types, "\ntypedef struct {\n");
+	if (class->parent == NULL) {
+		emit(transpilation->types, "\tArcInstance instance;\n");
+	}
+	else {
+		emit(transpilation->types, "\t%s_Instance parent;\n", class->parent->name);
+	}
+	for (int size = 16; 8 <= size; size -= 8) {
+		for (int k = firstField; k < class->fieldCount; ++k) {
+			if (_fieldSize(class->fields[k].type) == size) {
+				emit(transpilation->types, "\t%s v_%s;\n", _cType(class->fields[k].type), class->fields[k].name);
+			}
+		}
+	}
+	emit(transpilation->types, "} %s_Instance;\n", class->name);
+	if (class->generic == NULL && firstStatic < class->staticCount) {
+		emit(transpilation->types, "\ntypedef struct {\n");
+		for (int k = firstStatic; k < class->staticCount; ++k) {
+			emit(transpilation->types, "\tArcValue v_%s;\n", class->statics[k].name);
+		}
+		emit(transpilation->types, "} %s_Statics;\n", class->name);
+		emit(transpilation->globals, "static %s_Statics %s_statics;\n", class->name, class->name);
+	}
+	emit(transpilation->types, "\ntypedef struct {\n");
+	if (class->parent == NULL) {
+		emit(transpilation->types, "\tArcClass class;\n");
+	}
+	else {
+		emit(transpilation->types, "\t%s_Vtable parent;\n", class->parent->name);
+	}
+	for (int k = firstMethod; k < class->methodCount; ++k) {
+		emit(transpilation->types, "\tArcMethod v_%s;\n", class->methods[k].name);
+	}
+	emit(transpilation->types, "} %s_Vtable;\n", class->name);
+}
+
+/** The table of methods of a class, with the implementation of every slot. */
+static void _emitClassTables(Transpilation * transpilation, ClassLayout * class) {
+	emit(transpilation->tables, "\nstatic const %s_Vtable %s_vtable = {\n\t.", class->name, class->name);
+	for (int k = 0; k < class->depth; ++k) {
+		emit(transpilation->tables, "parent.");
+	}
+	emit(transpilation->tables, "class = { %s, %d }", _quote(transpilation, class->source->object->name), class->fieldCount);
+	for (int k = 0; k < class->methodCount; ++k) {
+		const MethodSlot * method = &class->methods[k];
+		emit(transpilation->tables, ",\n\t.");
+		for (int depth = method->owner->depth; depth < class->depth; ++depth) {
+			emit(transpilation->tables, "parent.");
+		}
+		emit(transpilation->tables, "v_%s = { %s, %s }", method->name, method->function->name,
+			_quote(transpilation, method->function->displayName));
+	}
+	emit(transpilation->tables, "\n};\n");
+}
+
+/**
+ * The eternal fields are defined where their class is declared, once, and in
+ * the scope of the declaration, like the bytecode compiler does.
+ */
+static void _generateStatics(FunctionState * state, Class * source) {
+	ClassLayout * class = _findClass(state->transpilation, source->object->name);
+	if (class == NULL || class->source != source || source->block == NULL) return;
+	for (Node * node = source->block->first; node != NULL; node = node->next) {
+		if (!_isEternal(node->data) || _memberLambda(node->data) != NULL) continue;
+		VariableDeclaration * declaration = ((Instruction *) node->data)->variableDeclaration;
+		FieldSlot * field = _findStatic(class, declaration->name);
+		if (field == NULL) continue;
+		const Location location = { STATIC_LOCATION, 0, field, NULL };
+		const Operand value = declaration->expression == NULL
+			? _generateDefaultValue(state, declaration->type)
+			: _generateExpression(state, declaration->expression, declaration->name);
+		_store(state, location, declaration->name, value);
+	}
+}
+
+/**
+ * The initializer runs the bodies of the ancestors and then the body of the
+ * class on an instance, wherever it lives. The first definition of each
+ * field only runs if its argument is missing (never, in an instantiation
+ * whose constructions all pass it). The eternal fields are already
+ * defined, but the other assignments to them run as usual. The constructor
+ * runs it on a new instance in the heap.
+ */
+static void _generateInitializer(Transpilation * transpilation, ClassLayout * class) {
+	ClassLayout ** lineage = calloc(transpilation->classCount + 1, sizeof(ClassLayout *));
+	int lineageSize = 0;
+	for (ClassLayout * ancestor = class; ancestor != NULL && lineageSize <= transpilation->classCount; ancestor = ancestor->parent) {
+		lineage[lineageSize++] = ancestor;
+	}
+	boolean * isInitialized = calloc(class->fieldCount + 1, sizeof(boolean));
+	Emitter * body = createEmitter(-1);
+	FunctionState state;
+	_initializeFunctionState(&state, transpilation, NULL, class->initializer, GENERIC_VERSION, body);
+	state.isInitializer = true;
+	for (int k = lineageSize - 1; 0 <= k; --k) {
+		_prepareBoxedNames(&state.boxedNames, lineage[k]->source->block);
+	}
+	_line(&state, "arcExpectFields((const ArcClass *) &%s_vtable, count);", class->name);
+	const int receiver = _declareLocal(&state, "this", NULL, VALUE_NATIVE_TYPE);
+	if (state.locals[receiver].isBoxed) {
+		_line(&state, "ArcCell * %s = arcCell(self);", state.locals[receiver].cName);
+	}
+	else {
+		state.locals[receiver].cName = "self";
+	}
+	for (int k = lineageSize - 1; 0 <= k; --k) {
+		Block * block = lineage[k]->source->block;
+		if (block == NULL) continue;
+		for (Node * node = block->first; node != NULL; node = node->next) {
+			Instruction * instruction = node->data;
+			const char * name = _memberName(instruction);
+			if (name == NULL) {
+				_generateInstruction(&state, instruction);
+				continue;
+			}
+			if (_memberLambda(instruction) != NULL) continue;
+			FieldSlot * field = _findField(class, name);
+			if (field == NULL) {
+				if (!_isEternal(instruction)) {
+					_generateInstruction(&state, instruction);
+				}
+				continue;
+			}
+			const int index = field->index;
+			const Location location = { FIELD_LOCATION, 0, field, NULL };
+			Expression * expression = instruction->type == INSTRUCTION_ASSIGNMENT
+				? instruction->assignment->expression : instruction->variableDeclaration->expression;
+			if (!isInitialized[index]) {
+				const boolean isPassed = (class->generic != NULL && index < class->leastArgumentCount) ? true : false;
+				if (!isPassed) {
+					_line(&state, "if (%d < count) {", index);
+					state.indentation += 1;
+				}
+				const NativeType type = _canonicalField(field)->type;
+				_store(&state, location, name, _operand(_convert(&state, _operand(_format(transpilation, "arguments[%d]", index), VALUE_NATIVE_TYPE), type), type));
+				if (isPassed) {
+					isInitialized[index] = true;
+					continue;
+				}
+				state.indentation -= 1;
+				_line(&state, "}");
+				_line(&state, "else {");
+				state.indentation += 1;
+			}
+			const Operand value = expression == NULL
+				? _generateDefaultValue(&state, instruction->variableDeclaration->type)
+				: _generateExpression(&state, expression, name);
+			_store(&state, location, name, value);
+			if (!isInitialized[index]) {
+				state.indentation -= 1;
+				_line(&state, "}");
+			}
+			isInitialized[index] = true;
+		}
+	}
+	_line(&state, "return self;");
+	_emitFunction(&state, _format(transpilation, "ArcValue %s_init(ArcValue self, int count, ArcValue * arguments)", class->name), body);
+	Emitter * construction = createEmitter(-1);
+	emit(construction, "\treturn %s_init(arcInstance((const ArcClass *) &%s_vtable, sizeof(%s_Instance)), count, arguments);\n",
+		class->name, class->name, class->name);
+	_emitFunction(&state, _format(transpilation, "ArcValue %s_new(int count, ArcValue * arguments)", class->name), construction);
+	destroyEmitter(construction);
+	_finishFunctionState(&state);
+	destroyEmitter(body);
+	free(isInitialized);
+	free(lineage);
+}
+
+/* -------------------------------- Program ------------------------------- */
+
+static void _releasePass(Transpilation * transpilation) {
+	Emitter ** emitters[] = {
+		&transpilation->types, &transpilation->globals, &transpilation->prototypes, &transpilation->tables, &transpilation->definitions
+	};
+	for (unsigned int k = 0; k < sizeof(emitters) / sizeof(emitters[0]); ++k) {
+		destroyEmitter(*emitters[k]);
+		*emitters[k] = NULL;
+	}
+	_releaseNames(&transpilation->globalNames);
+	_releaseNames(&transpilation->declaredGlobals);
+	_releaseNames(&transpilation->literals);
+	for (int k = 0; k < transpilation->stringCount; ++k) {
+		free(transpilation->strings[k]);
+	}
+	transpilation->stringCount = 0;
+}
+
+static void _releaseTranspilation(Transpilation * transpilation) {
+	_releasePass(transpilation);
+	free(transpilation->strings);
+	for (int k = 0; k < transpilation->functionCount; ++k) {
+		FunctionRecord * function = transpilation->functions[k];
+		free(function->name);
+		free(function->displayName);
+		_releaseNames(&function->captures);
+		_releaseNames(&function->sharedCaptures);
+		free(function->parameterTypes);
+		free(function->facts);
+		free(function);
+	}
+	free(transpilation->functions);
+	for (int k = 0; k < transpilation->classCount; ++k) {
+		if (transpilation->classes[k]->generic != NULL) {
+			free((char *) transpilation->classes[k]->name);
+			free(transpilation->classes[k]->bindings);
+		}
+		free(transpilation->classes[k]->fields);
+		free(transpilation->classes[k]->statics);
+		free(transpilation->classes[k]->methods);
+		free(transpilation->classes[k]);
+	}
+	free(transpilation->classes);
+	free(transpilation->storedNames);
+	free(transpilation->storeCounts);
+	free(transpilation->boundLambdas);
+}
+
+/**
+ * Generates the whole program, in the same order as the bytecode compiler:
+ * the top-level code (and its lambdas), and then the classes. The output is
+ * only written if the file descriptor isn't negative, with a single vectored
+ * write of every section.
+ */
+static boolean _generateProgram(Transpilation * transpilation, const int fileDescriptor) {
+	Program * program = transpilation->program;
+	transpilation->pass += 1;
+	transpilation->hasChanged = false;
+	transpilation->types = createEmitter(-1);
+	transpilation->globals = createEmitter(-1);
+	transpilation->prototypes = createEmitter(-1);
+	transpilation->tables = createEmitter(-1);
+	transpilation->definitions = createEmitter(-1);
+	FunctionRecord * main = _functionRecord(transpilation, program, NULL, NULL, NULL, "<program>", "main");
+	Emitter * body = createEmitter(-1);
+	FunctionState state;
+	_initializeFunctionState(&state, transpilation, NULL, main, GENERIC_VERSION, body);
+	state.isTopLevel = true;
+	if (program->block != NULL) {
+		_prepareBoxedNames(&state.boxedNames, program->block);
+	}
+	_generateBlock(&state, program->block);
+	for (int k = 0; k < transpilation->classCount; ++k) {
+		ClassLayout * class = transpilation->classes[k];
+		_generateInitializer(transpilation, class);
+		for (int k = 0; k < class->methodCount; ++k) {
+			FunctionRecord * function = class->methods[k].function;
+			if (function->class == class && function->pass != transpilation->pass) {
+				FunctionState methodState;
+				_initializeFunctionState(&methodState, transpilation, NULL, function, GENERIC_VERSION, NULL);
+				_generateFunction(&methodState, function);
+				_finishFunctionState(&methodState);
+			}
+		}
+	}
+	for (int depth = 0; depth <= transpilation->classCount; ++depth) {
+		for (int k = 0; k < transpilation->classCount; ++k) {
+			if (transpilation->classes[k]->depth == depth) {
+				_emitClassTypes(transpilation, transpilation->classes[k]);
+				_emitClassTables(transpilation, transpilation->classes[k]);
+			}
+		}
+	}
+	boolean succeed = transpilation->errors == 0 ? true : false;
+	if (0 <= fileDescriptor && succeed) {
+		Emitter * header = createEmitter(-1);
+		Emitter * main = createEmitter(-1);
+		emit(header, "#include \"ArcanaRuntime.h\"\n");
+		emit(transpilation->types, "\n");
+		for (int k = 0; k < transpilation->globalNames.count; ++k) {
+			emit(transpilation->globals, "static ArcValue g_%s;\n", transpilation->globalNames.names[k]);
+		}
+		for (int k = 0; k < transpilation->literals.count; ++k) {
+			emit(transpilation->globals, "static ArcValue k%d;\n", k + 1);
+		}
+		emit(transpilation->globals, "\n");
+		emit(main, "\nint main(void) {\n\tarcStart();\n");
+		for (int k = 0; k < transpilation->literals.count; ++k) {
+			emit(main, "\tk%d = arcLiteral(%s);\n", k + 1, _quote(transpilation, transpilation->literals.names[k]));
+		}
+		for (int k = 0; k < transpilation->globalNames.count; ++k) {
+			const char * name = transpilation->globalNames.names[k];
+			if (_nativeFunction(name) != NULL) {
+				emit(main, "\tg_%s = arcNative(%s, \"%s\");\n", name, _nativeFunction(name), name);
+			}
+		}
+		emitEmitter(main, body);
+		emit(main, "\treturn 0;\n}\n");
+		Emitter * sections[] = {
+			header, transpilation->types, transpilation->globals, transpilation->prototypes, transpilation->tables, transpilation->definitions, main
+		};
+		succeed = flushEmitters(fileDescriptor, sections, sizeof(sections) / sizeof(sections[0]));
+		destroyEmitter(header);
+		destroyEmitter(main);
+	}
+	_finishFunctionState(&state);
+	destroyEmitter(body);
+	return succeed;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean transpileProgram(Program * program, const int fileDescriptor) {
+	Transpilation transpilation;
+	memset(&transpilation, 0, sizeof(Transpilation));
+	transpilation.program = program;
+	transpilation.monomorphizationBudget = getIntegerOrDefault("MONOMORPHIZATION_BUDGET", 256);
+
+	Visitor classes;
+	memset(&classes, 0, sizeof(Visitor));
+	classes.name = "classes";
+	classes.pre[CLASS_NODE] = _collectClass;
+	classes.state = &transpilation;
+	Visitor stores;
+	memset(&stores, 0, sizeof(Visitor));
+	stores.name = "stores";
+	stores.pre[ASSIGNMENT_NODE] = _countAssignment;
+	stores.pre[DECLARATION_NODE] = _countDeclaration;
+	stores.pre[INCREMENT_NODE] = _countIncrement;
+	stores.pre[DECREMENT_NODE] = _countIncrement;
+	stores.pre[LOOP_NODE] = _countLoop;
+	stores.pre[PARAMETER_NODE] = _countParameter;
+	stores.state = &transpilation;
+	Visitor * visitors[] = { &classes, &stores };
+	walkProgram(program, visitors, 2);
+	_findBoundLambdas(&transpilation);
+	for (int k = 0; k < transpilation.classCount; ++k) {
+		_layoutClass(&transpilation, transpilation.classes[k], 0);
+	}
+	_markOverrides(&transpilation);
+
+	boolean succeed = true;
+	while (succeed) {
+		succeed = _generateProgram(&transpilation, -1);
+		if (succeed && !transpilation.hasChanged && !_promoteUndetermined(&transpilation)) break;
+		_releasePass(&transpilation);
+	}
+	if (succeed) {
+		_releasePass(&transpilation);
+		succeed = _generateProgram(&transpilation, fileDescriptor);
+		logDebugging(_logger, "Transpiled %d function(s) and %d class(es) in %d pass(es), and monomorphized %d node(s) of generic classes.",
+			transpilation.functionCount, transpilation.classCount, transpilation.pass, transpilation.monomorphizedCost);
+	}
+	_releaseTranspilation(&transpilation);
+	return succeed;
+}
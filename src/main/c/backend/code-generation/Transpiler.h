@@ -0,0 +1,45 @@
+#ifndef TRANSPILER_HEADER
+#define TRANSPILER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/Visitor.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../Emitter.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeTranspilerModule();
+
+/** Shutdown module's internal state. */
+void shutdownTranspilerModule();
+
+/**
+ * Translates an analyzed program to C, with the same semantics as the
+ * virtual machine. The output includes "ArcanaRuntime.h", and it builds with
+ * "runtime/ArcanaRuntime.c" (e.g., "cc -O2 -I<runtime> program.c
+ * <runtime>/ArcanaRuntime.c -lm").
+ *
+ * Classes become structures with a table of methods, lambdas become
+ * functions (plus a structure with the captured variables, if any), and
+ * for-in loops become counted loops. Local variables that only hold integers
+ * (or decimals) are plain C variables, and so are the parameters declared as
+ * such, in a second version of the body that is called when the arguments
+ * have those types.
+ *
+ * A generic class gets an instantiation of its own for each combination of
+ * integers and decimals that its constructions bind to its parameters, where
+ * the fields of those types are plain C variables too. The other
+ * constructions share the erased class, and so do the ones beyond the budget
+ * of nodes of the instantiations ("MONOMORPHIZATION_BUDGET").
+ *
+ * @return Whether it translates the program, and writes it to the file
+ * descriptor.
+ */
+boolean transpileProgram(Program * program, const int fileDescriptor);
+
+#endif
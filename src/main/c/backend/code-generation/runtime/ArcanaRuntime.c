@@ -0,0 +1,815 @@
+#include "ArcanaRuntime.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * The kernels have vector versions for x86-64, where SSE2 is always
+ * available, and AVX2 is used if the processor has it.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ARC_VECTORS
+#define ARC_AVX2 __attribute__((target("avx2")))
+// A value is its type, and then its payload in the upper half.
+#define ARC_VECTOR_LAYOUT (sizeof(ArcValue) == 16 && offsetof(ArcValue, asInteger) == 8)
+#endif
+
+/**
+ * The text of the parts of a join that aren't strings, formatted once (while
+ * they fit), and kept with their terminators.
+ */
+typedef struct {
+	char characters[1024];
+	int top;
+} ArcFormattedParts;
+
+/* MODULE INTERNAL STATE */
+
+#ifdef ARC_VECTORS
+static boolean _hasAvx2 = false;
+#endif
+
+/* PRIVATE FUNCTIONS */
+
+static void _append(ArcList * list, const ArcValue value);
+static ArcValue _combine(const char symbol, const ArcValue left, const ArcValue right);
+static char * _copyParts(ArcFormattedParts * formatted, char * characters, const ArcValue * parts, const int count);
+static void _expectBetween(const char * name, const int count, const int minimum, const int maximum);
+static int64_t _expectIndex(const char * name, const ArcValue index, const int64_t size);
+static int _formatDecimal(char * buffer, const size_t size, const double decimal);
+static int _formatInteger(char * buffer, const int64_t integer);
+static int _formatPrimitive(char * buffer, const size_t size, const ArcValue value);
+static boolean _hasType(const ArcValue * restrict items, const int64_t length, const ArcValueType type);
+static void _mapItems(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const ArcValue operand, const boolean isOperandFirst);
+static size_t _measureParts(ArcFormattedParts * formatted, const ArcValue * parts, const int count);
+static void _printValue(FILE * stream, const ArcValue value);
+static void _reserve(ArcList * list, const int64_t capacity);
+static boolean _sumItems(const ArcValue * restrict items, const int64_t length, int64_t * sum);
+#ifdef ARC_VECTORS
+static ARC_AVX2 int64_t _mapDecimalsAvx2(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const double operand, const boolean isOperandFirst);
+static ARC_AVX2 int64_t _mapIntegersAvx2(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const int64_t operand, const boolean isOperandFirst);
+static ARC_AVX2 boolean _sumItemsAvx2(const ArcValue * restrict items, const int64_t length, int64_t * sum);
+static boolean _sumItemsSse2(const ArcValue * restrict items, const int64_t length, int64_t * sum);
+#endif
+
+static void _append(ArcList * list, const ArcValue value) {
+	if (list->size == list->capacity) {
+		list->capacity *= 2;
+		list->items = realloc(list->items, list->capacity * sizeof(ArcValue));
+	}
+	list->items[list->size++] = value;
+}
+
+/** Combines two numbers, as the operator would. */
+static ArcValue _combine(const char symbol, const ArcValue left, const ArcValue right) {
+	switch (symbol) {
+		case '+': return arcAdd(left, right);
+		case '-': return arcSubtract(left, right);
+		default: return arcMultiply(left, right);
+	}
+}
+
+static void _expectBetween(const char * name, const int count, const int minimum, const int maximum) {
+	if (count < minimum || maximum < count) {
+		arcError("Function '%s' expects between %d and %d argument(s), but it receives %d.", name, minimum, maximum, count);
+	}
+}
+
+static int64_t _expectIndex(const char * name, const ArcValue index, const int64_t size) {
+	if (index.type != ARC_INTEGER) {
+		arcError("Function '%s' expects an integer index, but it receives a %s.", name, arcTypeName(index));
+	}
+	if (index.asInteger < 0 || size <= index.asInteger) {
+		arcError("Index %lld is out of bounds [0, %lld).", (long long) index.asInteger, (long long) size);
+	}
+	return index.asInteger;
+}
+
+/**
+ * Decimals always show a decimal point (or an exponent), so they can't be
+ * confused with integers.
+ */
+static int _formatDecimal(char * buffer, const size_t size, const double decimal) {
+	int length = snprintf(buffer, size, "%.15g", decimal);
+	if (strpbrk(buffer, ".eninf") == NULL && length + 2 < (int) size) {
+		buffer[length++] = '.';
+		buffer[length++] = '0';
+		buffer[length] = '\0';
+	}
+	return length;
+}
+
+/** Formats an integer without going through printf, since strings interpolate them often. */
+static int _formatInteger(char * buffer, const int64_t integer) {
+	char digits[24];
+	int count = 0;
+	uint64_t magnitude = integer < 0 ? 0 - (uint64_t) integer : (uint64_t) integer;
+	do {
+		digits[count++] = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	int length = 0;
+	if (integer < 0) {
+		buffer[length++] = '-';
+	}
+	while (0 < count) {
+		buffer[length++] = digits[--count];
+	}
+	buffer[length] = '\0';
+	return length;
+}
+
+/**
+ * Formats a value that isn't a string. The buffer must have room for, at
+ * least, 64 characters.
+ */
+static int _formatPrimitive(char * buffer, const size_t size, const ArcValue value) {
+	switch (value.type) {
+		case ARC_UNDEFINED:
+		case ARC_NIL:
+			return snprintf(buffer, size, "nil");
+		case ARC_BOOLEAN:
+			return snprintf(buffer, size, "%s", value.asBoolean ? "true" : "false");
+		case ARC_INTEGER:
+			return _formatInteger(buffer, value.asInteger);
+		case ARC_DECIMAL:
+			return _formatDecimal(buffer, size, value.asDecimal);
+		default:
+			break;
+	}
+	switch (value.asObject->type) {
+		case ARC_LIST:
+			return snprintf(buffer, size, "<list of %d>", ((ArcList *) value.asObject)->size);
+		case ARC_RANGE:
+			return snprintf(buffer, size, "<range %lld..%lld>",
+				(long long) ((ArcRange *) value.asObject)->start, (long long) ((ArcRange *) value.asObject)->end);
+		case ARC_CELL:
+			return snprintf(buffer, size, "<cell>");
+		case ARC_CLOSURE:
+			return snprintf(buffer, size, "<lambda %.40s>", ((ArcClosure *) value.asObject)->name);
+		case ARC_INSTANCE:
+			return snprintf(buffer, size, "<%.40s>", ((ArcInstance *) value.asObject)->class->name);
+		case ARC_BOUND_METHOD:
+			return snprintf(buffer, size, "<method %.40s>", ((ArcBoundMethod *) value.asObject)->method.name);
+		case ARC_NATIVE:
+			return snprintf(buffer, size, "<native %.40s>", ((ArcClosure *) value.asObject)->name);
+		default:
+			return snprintf(buffer, size, "<object>");
+	}
+}
+
+static boolean _hasType(const ArcValue * restrict items, const int64_t length, const ArcValueType type) {
+	unsigned int mismatch = 0;
+	for (int64_t k = 0; k < length; ++k) {
+		mismatch |= items[k].type ^ type;
+	}
+	return mismatch == 0 ? true : false;
+}
+
+/**
+ * Combines the items (of a single type) with the operand, into the output.
+ * The vector versions leave the last items, if any, to the scalar loop.
+ */
+static void _mapItems(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const ArcValue operand, const boolean isOperandFirst) {
+	int64_t k = 0;
+#ifdef ARC_VECTORS
+	if (_hasAvx2 && ARC_VECTOR_LAYOUT && 0 < length) {
+		if (items[0].type == ARC_DECIMAL) {
+			const double y = operand.type == ARC_INTEGER ? (double) operand.asInteger : operand.asDecimal;
+			k = _mapDecimalsAvx2(output, items, length, symbol, y, isOperandFirst);
+		}
+		else if (operand.type == ARC_INTEGER && symbol != '*') {
+			k = _mapIntegersAvx2(output, items, length, symbol, operand.asInteger, isOperandFirst);
+		}
+	}
+#endif
+	for (; k < length; ++k) {
+		output[k] = isOperandFirst ? _combine(symbol, operand, items[k]) : _combine(symbol, items[k], operand);
+	}
+}
+
+/** The length of the text of the parts, which formats the ones that aren't strings. */
+static size_t _measureParts(ArcFormattedParts * formatted, const ArcValue * parts, const int count) {
+	char buffer[64];
+	size_t length = 0;
+	for (int k = 0; k < count; ++k) {
+		if (arcIsObject(parts[k], ARC_STRING)) {
+			length += ((ArcString *) parts[k].asObject)->length;
+		}
+		else if (formatted->top + (int) sizeof(buffer) <= (int) sizeof(formatted->characters)) {
+			const int partLength = _formatPrimitive(formatted->characters + formatted->top, sizeof(buffer), parts[k]);
+			length += partLength;
+			formatted->top += partLength + 1;
+		}
+		else {
+			length += _formatPrimitive(buffer, sizeof(buffer), parts[k]);
+		}
+	}
+	return length;
+}
+
+/** Copies the text of the parts that "_measureParts" measured, and returns its end. */
+static char * _copyParts(ArcFormattedParts * formatted, char * characters, const ArcValue * parts, const int count) {
+	char buffer[64];
+	int cursor = 0;
+	for (int k = 0; k < count; ++k) {
+		const char * part = buffer;
+		int partLength;
+		if (arcIsObject(parts[k], ARC_STRING)) {
+			part = arcCharacters((ArcString *) parts[k].asObject);
+			partLength = ((ArcString *) parts[k].asObject)->length;
+		}
+		else if (cursor + (int) sizeof(buffer) <= (int) sizeof(formatted->characters)) {
+			part = formatted->characters + cursor;
+			partLength = strlen(part);
+			cursor += partLength + 1;
+		}
+		else {
+			partLength = _formatPrimitive(buffer, sizeof(buffer), parts[k]);
+		}
+		memcpy(characters, part, partLength);
+		characters += partLength;
+	}
+	return characters;
+}
+
+static void _printValue(FILE * stream, const ArcValue value) {
+	if (arcIsObject(value, ARC_STRING)) {
+		fwrite(arcCharacters((ArcString *) value.asObject), 1, ((ArcString *) value.asObject)->length, stream);
+	}
+	else if (arcIsObject(value, ARC_LIST)) {
+		const ArcList * list = (ArcList *) value.asObject;
+		fputc('[', stream);
+		for (int k = 0; k < list->size; ++k) {
+			if (0 < k) fputs(", ", stream);
+			_printValue(stream, list->items[k]);
+		}
+		fputc(']', stream);
+	}
+	else {
+		char buffer[64];
+		_formatPrimitive(buffer, sizeof(buffer), value);
+		fputs(buffer, stream);
+	}
+}
+
+static void _reserve(ArcList * list, const int64_t capacity) {
+	if (list->capacity < capacity) {
+		while (list->capacity < capacity) {
+			list->capacity *= 2;
+		}
+		list->items = realloc(list->items, list->capacity * sizeof(ArcValue));
+	}
+}
+
+static boolean _sumItems(const ArcValue * restrict items, const int64_t length, int64_t * sum) {
+#ifdef ARC_VECTORS
+	if (ARC_VECTOR_LAYOUT) {
+		return _hasAvx2 ? _sumItemsAvx2(items, length, sum) : _sumItemsSse2(items, length, sum);
+	}
+#endif
+	uint64_t total = 0;
+	for (int64_t k = 0; k < length; ++k) {
+		total += (uint64_t) items[k].asInteger;
+	}
+	*sum = (int64_t) total;
+	return _hasType(items, length, ARC_INTEGER);
+}
+
+#ifdef ARC_VECTORS
+
+/**
+ * Each half of an AVX2 register holds a value: its type in the lower lane,
+ * and its payload in the upper one. The payloads of two registers are
+ * gathered into one (a type read as a decimal is subnormal, which slows the
+ * arithmetic down), and the results go back between the types.
+ */
+static ARC_AVX2 int64_t _mapDecimalsAvx2(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const double operand, const boolean isOperandFirst) {
+	const __m256d y = _mm256_set1_pd(operand);
+	int64_t k = 0;
+	for (; k + 4 <= length; k += 4) {
+		const __m256d first = _mm256_loadu_pd((const double *) &items[k]);
+		const __m256d second = _mm256_loadu_pd((const double *) &items[k + 2]);
+		const __m256d x = _mm256_unpackhi_pd(first, second);
+		__m256d result;
+		switch (symbol) {
+			case '+': result = _mm256_add_pd(x, y); break;
+			case '-': result = isOperandFirst ? _mm256_sub_pd(y, x) : _mm256_sub_pd(x, y); break;
+			default: result = _mm256_mul_pd(x, y); break;
+		}
+		_mm256_storeu_pd((double *) &output[k], _mm256_unpacklo_pd(first, result));
+		_mm256_storeu_pd((double *) &output[k + 2], _mm256_unpacklo_pd(second, _mm256_unpackhi_pd(result, result)));
+	}
+	return k;
+}
+
+static ARC_AVX2 int64_t _mapIntegersAvx2(ArcValue * restrict output, const ArcValue * restrict items, const int64_t length, const char symbol, const int64_t operand, const boolean isOperandFirst) {
+	const __m256i y = _mm256_set1_epi64x(operand);
+	int64_t k = 0;
+	for (; k + 2 <= length; k += 2) {
+		const __m256i x = _mm256_loadu_si256((const __m256i *) &items[k]);
+		__m256i result;
+		if (symbol == '+') {
+			result = _mm256_add_epi64(x, y);
+		}
+		else {
+			result = isOperandFirst ? _mm256_sub_epi64(y, x) : _mm256_sub_epi64(x, y);
+		}
+		_mm256_storeu_si256((__m256i *) &output[k], _mm256_blend_epi32(x, result, 0xCC));
+	}
+	return k;
+}
+
+/**
+ * The payloads add up in the upper lanes, and the types (xor the integer
+ * type) accumulate in the lower ones, which must stay zero.
+ */
+static ARC_AVX2 boolean _sumItemsAvx2(const ArcValue * restrict items, const int64_t length, int64_t * sum) {
+	const __m256i type = _mm256_set_epi32(0, 0, 0, ARC_INTEGER, 0, 0, 0, ARC_INTEGER);
+	__m256i totals[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+	__m256i mismatch = _mm256_setzero_si256();
+	int64_t k = 0;
+	for (; k + 4 <= length; k += 4) {
+		const __m256i first = _mm256_loadu_si256((const __m256i *) &items[k]);
+		const __m256i second = _mm256_loadu_si256((const __m256i *) &items[k + 2]);
+		totals[0] = _mm256_add_epi64(totals[0], first);
+		totals[1] = _mm256_add_epi64(totals[1], second);
+		mismatch = _mm256_or_si256(mismatch, _mm256_or_si256(_mm256_xor_si256(first, type), _mm256_xor_si256(second, type)));
+	}
+	const __m256i total = _mm256_add_epi64(totals[0], totals[1]);
+	uint64_t payload = (uint64_t) _mm256_extract_epi64(total, 1) + (uint64_t) _mm256_extract_epi64(total, 3);
+	unsigned int types = (unsigned int) (_mm256_extract_epi32(mismatch, 0) | _mm256_extract_epi32(mismatch, 4));
+	for (; k < length; ++k) {
+		payload += (uint64_t) items[k].asInteger;
+		types |= items[k].type ^ ARC_INTEGER;
+	}
+	*sum = (int64_t) payload;
+	return types == 0 ? true : false;
+}
+
+static boolean _sumItemsSse2(const ArcValue * restrict items, const int64_t length, int64_t * sum) {
+	const __m128i type = _mm_set_epi32(0, 0, 0, ARC_INTEGER);
+	__m128i totals[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+	__m128i mismatch = _mm_setzero_si128();
+	int64_t k = 0;
+	for (; k + 2 <= length; k += 2) {
+		const __m128i first = _mm_loadu_si128((const __m128i *) &items[k]);
+		const __m128i second = _mm_loadu_si128((const __m128i *) &items[k + 1]);
+		totals[0] = _mm_add_epi64(totals[0], first);
+		totals[1] = _mm_add_epi64(totals[1], second);
+		mismatch = _mm_or_si128(mismatch, _mm_or_si128(_mm_xor_si128(first, type), _mm_xor_si128(second, type)));
+	}
+	const __m128i total = _mm_add_epi64(totals[0], totals[1]);
+	uint64_t payload = (uint64_t) _mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total));
+	unsigned int types = (unsigned int) _mm_cvtsi128_si32(mismatch);
+	for (; k < length; ++k) {
+		payload += (uint64_t) items[k].asInteger;
+		types |= items[k].type ^ ARC_INTEGER;
+	}
+	*sum = (int64_t) payload;
+	return types == 0 ? true : false;
+}
+
+#endif
+
+/* PUBLIC FUNCTIONS */
+
+void arcStart(void) {
+	static char buffer[1 << 16];
+	setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+#ifdef ARC_VECTORS
+	_hasAvx2 = __builtin_cpu_supports("avx2") ? true : false;
+#endif
+}
+
+void arcError(const char * format, ...) {
+	fflush(stdout);
+	va_list arguments;
+	va_start(arguments, format);
+	fputs("Runtime error: ", stderr);
+	vfprintf(stderr, format, arguments);
+	fputc('\n', stderr);
+	va_end(arguments);
+	exit(EXIT_FAILURE);
+}
+
+void arcOperatorError(const char * symbol, const ArcValue left, const ArcValue right) {
+	arcError("Operator '%s' cannot be applied to a %s and a %s.", symbol, arcTypeName(left), arcTypeName(right));
+}
+
+/* ---------------------------- Construction ---------------------------- */
+
+void * arcAllocate(const ArcObjectType type, const size_t size) {
+	ArcObject * object = calloc(1, size);
+	if (object == NULL) {
+		arcError("Out of memory.");
+	}
+	object->type = type;
+	return object;
+}
+
+ArcValue arcString(const char * characters, const int length) {
+	ArcString * string = arcAllocate(ARC_STRING, sizeof(ArcString) + length + 1);
+	string->length = length;
+	memcpy(string->characters, characters, length);
+	string->characters[length] = '\0';
+	return arcObject(string);
+}
+
+ArcValue arcLiteral(const char * characters) {
+	return arcString(characters, strlen(characters));
+}
+
+ArcValue arcClosure(ArcFunction function, const char * name) {
+	ArcClosure * closure = arcAllocate(ARC_CLOSURE, sizeof(ArcClosure));
+	closure->function = function;
+	closure->name = name;
+	return arcObject(closure);
+}
+
+ArcValue arcNative(ArcFunction function, const char * name) {
+	ArcClosure * native = arcAllocate(ARC_NATIVE, sizeof(ArcClosure));
+	native->function = function;
+	native->name = name;
+	return arcObject(native);
+}
+
+ArcValue arcInstance(const ArcClass * class, const size_t size) {
+	ArcInstance * instance = arcAllocate(ARC_INSTANCE, size);
+	instance->class = class;
+	return arcObject(instance);
+}
+
+ArcValue arcBind(const ArcValue receiver, const ArcMethod method) {
+	ArcBoundMethod * boundMethod = arcAllocate(ARC_BOUND_METHOD, sizeof(ArcBoundMethod));
+	boundMethod->receiver = receiver;
+	boundMethod->method = method;
+	return arcObject(boundMethod);
+}
+
+ArcCell * arcCell(const ArcValue value) {
+	ArcCell * cell = arcAllocate(ARC_CELL, sizeof(ArcCell));
+	cell->value = value;
+	return cell;
+}
+
+/* ----------------------------- Operations ----------------------------- */
+
+/**
+ * Mixing an integer with a decimal produces a decimal, and adding anything
+ * to a string concatenates them.
+ */
+ArcValue arcArithmeticSlow(const char symbol, const ArcValue left, const ArcValue right) {
+	const char symbols[2] = { symbol, '\0' };
+	if (symbol == '+' && (arcIsObject(left, ARC_STRING) || arcIsObject(right, ARC_STRING))) {
+		char leftBuffer[64];
+		char rightBuffer[64];
+		const char * leftCharacters = leftBuffer;
+		const char * rightCharacters = rightBuffer;
+		int leftLength;
+		int rightLength;
+		if (arcIsObject(left, ARC_STRING)) {
+			leftCharacters = arcCharacters((ArcString *) left.asObject);
+			leftLength = ((ArcString *) left.asObject)->length;
+		}
+		else {
+			leftLength = _formatPrimitive(leftBuffer, sizeof(leftBuffer), left);
+		}
+		if (arcIsObject(right, ARC_STRING)) {
+			rightCharacters = arcCharacters((ArcString *) right.asObject);
+			rightLength = ((ArcString *) right.asObject)->length;
+		}
+		else {
+			rightLength = _formatPrimitive(rightBuffer, sizeof(rightBuffer), right);
+		}
+		ArcString * string = arcAllocate(ARC_STRING, sizeof(ArcString) + leftLength + rightLength + 1);
+		string->length = leftLength + rightLength;
+		memcpy(string->characters, leftCharacters, leftLength);
+		memcpy(string->characters + leftLength, rightCharacters, rightLength);
+		string->characters[string->length] = '\0';
+		return arcObject(string);
+	}
+	const boolean isLeftNumber = (left.type == ARC_INTEGER || left.type == ARC_DECIMAL) ? true : false;
+	const boolean isRightNumber = (right.type == ARC_INTEGER || right.type == ARC_DECIMAL) ? true : false;
+	if (!isLeftNumber || !isRightNumber) {
+		arcOperatorError(symbols, left, right);
+	}
+	if (left.type == ARC_INTEGER && right.type == ARC_INTEGER) {
+		switch (symbol) {
+			case '+': return arcInteger(arcAddIntegers(left.asInteger, right.asInteger));
+			case '-': return arcInteger(arcSubtractIntegers(left.asInteger, right.asInteger));
+			case '*': return arcInteger(arcMultiplyIntegers(left.asInteger, right.asInteger));
+			default: return arcInteger(arcDivideIntegers(left.asInteger, right.asInteger));
+		}
+	}
+	const double x = left.type == ARC_INTEGER ? (double) left.asInteger : left.asDecimal;
+	const double y = right.type == ARC_INTEGER ? (double) right.asInteger : right.asDecimal;
+	switch (symbol) {
+		case '+': return arcDecimal(x + y);
+		case '-': return arcDecimal(x - y);
+		case '*': return arcDecimal(x * y);
+		default: return arcDecimal(x / y);
+	}
+}
+
+ArcValue arcJoin(const int count, ArcValue * parts) {
+	ArcValue sum = parts[0];
+	int first = 1;
+	for (; first < count && !arcIsObject(sum, ARC_STRING) && !arcIsObject(parts[first], ARC_STRING); ++first) {
+		sum = arcAdd(sum, parts[first]);
+	}
+	if (first == count) return sum;
+	parts[first - 1] = sum;
+	ArcFormattedParts formatted;
+	formatted.top = 0;
+	const size_t length = _measureParts(&formatted, &parts[first - 1], count - first + 1);
+	ArcString * string = arcAllocate(ARC_STRING, sizeof(ArcString) + length + 1);
+	*_copyParts(&formatted, string->characters, &parts[first - 1], count - first + 1) = '\0';
+	string->length = (int) length;
+	return arcObject(string);
+}
+
+ArcValue arcAppend(const int count, ArcValue * parts) {
+	if (!arcIsObject(parts[0], ARC_STRING) && !arcIsObject(parts[1], ARC_STRING)) return arcJoin(count, parts);
+	int first = 0;
+	while (first < count - 1 && arcIsObject(parts[first], ARC_STRING) && ((ArcString *) parts[first].asObject)->length == 0) {
+		first += 1;
+	}
+	ArcFormattedParts formatted;
+	formatted.top = 0;
+	const ArcString * head = arcIsObject(parts[first], ARC_STRING) ? (ArcString *) parts[first].asObject : NULL;
+	ArcString * base = head == NULL ? NULL : head->base;
+	if (base != NULL && head->length == base->length) {
+		const size_t length = _measureParts(&formatted, &parts[first + 1], count - first - 1);
+		if (base->length + length <= (size_t) base->capacity) {
+			_copyParts(&formatted, base->characters + base->length, &parts[first + 1], count - first - 1);
+			base->length += (int) length;
+		}
+		else {
+			base = NULL;
+			formatted.top = 0;
+		}
+	}
+	else {
+		base = NULL;
+	}
+	if (base == NULL) {
+		const size_t length = _measureParts(&formatted, &parts[first], count - first);
+		const size_t capacity = length < 32 ? 64 : 2 * length;
+		base = arcAllocate(ARC_STRING, sizeof(ArcString) + capacity + 1);
+		_copyParts(&formatted, base->characters, &parts[first], count - first);
+		base->length = (int) length;
+		base->capacity = (int) capacity;
+	}
+	ArcString * string = arcAllocate(ARC_STRING, sizeof(ArcString));
+	string->length = base->length;
+	string->base = base;
+	return arcObject(string);
+}
+
+boolean arcLessSlow(const char * symbol, const ArcValue left, const ArcValue right, const boolean orEqual) {
+	int comparison;
+	if ((left.type == ARC_INTEGER || left.type == ARC_DECIMAL) && (right.type == ARC_INTEGER || right.type == ARC_DECIMAL)) {
+		const double x = left.type == ARC_INTEGER ? (double) left.asInteger : left.asDecimal;
+		const double y = right.type == ARC_INTEGER ? (double) right.asInteger : right.asDecimal;
+		if (x != x || y != y) return false;
+		comparison = x < y ? -1 : (x == y ? 0 : 1);
+	}
+	else if (arcIsObject(left, ARC_STRING) && arcIsObject(right, ARC_STRING)) {
+		const ArcString * x = (ArcString *) left.asObject;
+		const ArcString * y = (ArcString *) right.asObject;
+		comparison = memcmp(arcCharacters(x), arcCharacters(y), x->length < y->length ? x->length : y->length);
+		if (comparison == 0) {
+			comparison = x->length - y->length;
+		}
+	}
+	else {
+		arcOperatorError(symbol, left, right);
+	}
+	return (orEqual ? comparison <= 0 : comparison < 0) ? true : false;
+}
+
+boolean arcEqualSlow(const ArcValue left, const ArcValue right) {
+	const boolean isLeftNumber = (left.type == ARC_INTEGER || left.type == ARC_DECIMAL) ? true : false;
+	const boolean isRightNumber = (right.type == ARC_INTEGER || right.type == ARC_DECIMAL) ? true : false;
+	if (isLeftNumber && isRightNumber) {
+		const double x = left.type == ARC_INTEGER ? (double) left.asInteger : left.asDecimal;
+		const double y = right.type == ARC_INTEGER ? (double) right.asInteger : right.asDecimal;
+		return x == y ? true : false;
+	}
+	if (left.type != right.type) return false;
+	switch (left.type) {
+		case ARC_UNDEFINED:
+		case ARC_NIL:
+			return true;
+		case ARC_BOOLEAN:
+			return left.asBoolean == right.asBoolean ? true : false;
+		default:
+			break;
+	}
+	if (left.asObject == right.asObject) return true;
+	if (arcIsObject(left, ARC_STRING) && arcIsObject(right, ARC_STRING)) {
+		const ArcString * leftString = (ArcString *) left.asObject;
+		const ArcString * rightString = (ArcString *) right.asObject;
+		return (leftString->length == rightString->length
+			&& memcmp(arcCharacters(leftString), arcCharacters(rightString), leftString->length) == 0) ? true : false;
+	}
+	return false;
+}
+
+boolean arcTruthySlow(const ArcValue value) {
+	switch (value.type) {
+		case ARC_UNDEFINED:
+		case ARC_NIL:
+			return false;
+		case ARC_BOOLEAN:
+			return value.asBoolean;
+		case ARC_INTEGER:
+			return value.asInteger != 0 ? true : false;
+		case ARC_DECIMAL:
+			return value.asDecimal != 0.0 ? true : false;
+		default:
+			if (value.asObject->type == ARC_STRING) {
+				return ((ArcString *) value.asObject)->length != 0 ? true : false;
+			}
+			return true;
+	}
+}
+
+ArcValue arcCallSlow(const ArcValue callee, const int count, ArcValue * arguments) {
+	if (arcIsObject(callee, ARC_BOUND_METHOD)) {
+		const ArcBoundMethod * boundMethod = (ArcBoundMethod *) callee.asObject;
+		return boundMethod->method.function(boundMethod->receiver, count, arguments);
+	}
+	arcError("A %s cannot be called.", arcTypeName(callee));
+}
+
+const char * arcTypeName(const ArcValue value) {
+	switch (value.type) {
+		case ARC_UNDEFINED:
+		case ARC_NIL: return "nil";
+		case ARC_BOOLEAN: return "boolean";
+		case ARC_INTEGER: return "integer";
+		case ARC_DECIMAL: return "decimal";
+		default: break;
+	}
+	switch (value.asObject->type) {
+		case ARC_STRING: return "string";
+		case ARC_LIST: return "list";
+		case ARC_RANGE: return "range";
+		case ARC_CELL: return "cell";
+		case ARC_CLOSURE: return "lambda";
+		case ARC_INSTANCE: return "instance";
+		case ARC_BOUND_METHOD: return "method";
+		case ARC_NATIVE: return "native function";
+		default: return "object";
+	}
+}
+
+void arcExpectIterable(const ArcValue collection) {
+	if (!arcIsObject(collection, ARC_LIST) && !arcIsObject(collection, ARC_RANGE) && !arcIsObject(collection, ARC_STRING)) {
+		arcError("A %s cannot be iterated.", arcTypeName(collection));
+	}
+}
+
+/** The items of strings are new values. */
+ArcValue arcElementSlow(const ArcValue collection, const int64_t index) {
+	return arcString(&arcCharacters((ArcString *) collection.asObject)[index], 1);
+}
+
+/* ------------------------------- Kernels ------------------------------ */
+
+/** A range adds up to its length times its start, plus a triangular number. */
+boolean arcSumIntegers(const ArcValue collection, int64_t * sum) {
+	if (arcIsObject(collection, ARC_RANGE)) {
+		const ArcRange * range = (ArcRange *) collection.asObject;
+		const uint64_t length = range->start < range->end ? (uint64_t) range->end - (uint64_t) range->start : 0;
+		const uint64_t triangle = length % 2 == 0 ? (length / 2) * (length - 1) : length * ((length - 1) / 2);
+		*sum = (int64_t) (length * (uint64_t) range->start + triangle);
+		return true;
+	}
+	if (!arcIsObject(collection, ARC_LIST)) return false;
+	const ArcList * list = (ArcList *) collection.asObject;
+	return _sumItems(list->items, list->size, sum);
+}
+
+boolean arcMapNumbers(const ArcValue target, const ArcValue collection, const char symbol, const ArcValue operand, const boolean isOperandFirst) {
+	if (!arcIsObject(target, ARC_LIST) || target.asObject == collection.asObject) return false;
+	if (operand.type != ARC_INTEGER && operand.type != ARC_DECIMAL) return false;
+	ArcList * list = (ArcList *) target.asObject;
+	if (arcIsObject(collection, ARC_RANGE)) {
+		const ArcRange * range = (ArcRange *) collection.asObject;
+		const int64_t length = range->start < range->end ? range->end - range->start : 0;
+		if (length < 0 || INT32_MAX - list->size < length) return false;
+		_reserve(list, list->size + length);
+		ArcValue * output = list->items + list->size;
+		for (int64_t k = 0; k < length; ++k) {
+			const ArcValue item = arcInteger(range->start + k);
+			output[k] = isOperandFirst ? _combine(symbol, operand, item) : _combine(symbol, item, operand);
+		}
+		list->size += length;
+		return true;
+	}
+	if (!arcIsObject(collection, ARC_LIST)) return false;
+	const ArcList * source = (ArcList *) collection.asObject;
+	if (source->size == 0) return true;
+	const ArcValueType type = source->items[0].type;
+	if ((type != ARC_INTEGER && type != ARC_DECIMAL) || !_hasType(source->items, source->size, type)) return false;
+	if (INT32_MAX - list->size < source->size) return false;
+	_reserve(list, list->size + source->size);
+	_mapItems(list->items + list->size, source->items, source->size, symbol, operand, isOperandFirst);
+	list->size += source->size;
+	return true;
+}
+
+/* ------------------------------- Natives ------------------------------ */
+
+/** The seconds elapsed since an arbitrary point, to measure durations. */
+ArcValue arcClock(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("clock", count, 0, 0);
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return arcDecimal(now.tv_sec + now.tv_nsec / 1e9);
+}
+
+ArcValue arcGet(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("get", count, 2, 2);
+	const ArcValue collection = arguments[0];
+	if (arcIsObject(collection, ARC_LIST)) {
+		const ArcList * list = (ArcList *) collection.asObject;
+		return list->items[_expectIndex("get", arguments[1], list->size)];
+	}
+	if (arcIsObject(collection, ARC_STRING)) {
+		const ArcString * string = (ArcString *) collection.asObject;
+		return arcString(&arcCharacters(string)[_expectIndex("get", arguments[1], string->length)], 1);
+	}
+	arcError("Function 'get' expects a list or a string, but it receives a %s.", arcTypeName(collection));
+}
+
+ArcValue arcList(ArcValue self, int count, ArcValue * arguments) {
+	ArcList * list = arcAllocate(ARC_LIST, sizeof(ArcList));
+	list->capacity = count < 4 ? 4 : count;
+	list->items = malloc(list->capacity * sizeof(ArcValue));
+	for (int k = 0; k < count; ++k) {
+		_append(list, arguments[k]);
+	}
+	return arcObject(list);
+}
+
+ArcValue arcPrint(ArcValue self, int count, ArcValue * arguments) {
+	for (int k = 0; k < count; ++k) {
+		if (0 < k) fputc(' ', stdout);
+		_printValue(stdout, arguments[k]);
+	}
+	fputc('\n', stdout);
+	return arcNil();
+}
+
+ArcValue arcPush(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("push", count, 2, 2);
+	if (!arcIsObject(arguments[0], ARC_LIST)) {
+		arcError("Function 'push' expects a list, but it receives a %s.", arcTypeName(arguments[0]));
+	}
+	_append((ArcList *) arguments[0].asObject, arguments[1]);
+	return arguments[0];
+}
+
+ArcValue arcRange(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("range", count, 1, 2);
+	for (int k = 0; k < count; ++k) {
+		if (arguments[k].type != ARC_INTEGER) {
+			arcError("Function 'range' expects integers, but it receives a %s.", arcTypeName(arguments[k]));
+		}
+	}
+	ArcRange * range = arcAllocate(ARC_RANGE, sizeof(ArcRange));
+	range->start = count == 1 ? 0 : arguments[0].asInteger;
+	range->end = arguments[count - 1].asInteger;
+	return arcObject(range);
+}
+
+ArcValue arcSet(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("set", count, 3, 3);
+	if (!arcIsObject(arguments[0], ARC_LIST)) {
+		arcError("Function 'set' expects a list, but it receives a %s.", arcTypeName(arguments[0]));
+	}
+	ArcList * list = (ArcList *) arguments[0].asObject;
+	list->items[_expectIndex("set", arguments[1], list->size)] = arguments[2];
+	return arguments[2];
+}
+
+ArcValue arcSize(ArcValue self, int count, ArcValue * arguments) {
+	_expectBetween("size", count, 1, 1);
+	const ArcValue collection = arguments[0];
+	if (arcIsObject(collection, ARC_LIST)) {
+		return arcInteger(((ArcList *) collection.asObject)->size);
+	}
+	if (arcIsObject(collection, ARC_STRING)) {
+		return arcInteger(((ArcString *) collection.asObject)->length);
+	}
+	if (arcIsObject(collection, ARC_RANGE)) {
+		const ArcRange * range = (ArcRange *) collection.asObject;
+		return arcInteger(range->start < range->end ? range->end - range->start : 0);
+	}
+	arcError("Function 'size' expects a collection, but it receives a %s.", arcTypeName(collection));
+}
@@ -0,0 +1,437 @@
+#ifndef ARCANA_RUNTIME_HEADER
+#define ARCANA_RUNTIME_HEADER
+
+#include "../../../shared/Type.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The runtime of the programs that the transpiler translates to C. It
+ * mirrors the values and the semantics of the virtual machine, so a program
+ * prints the same output in both backends. The fast paths are inline, and
+ * everything else lives in "ArcanaRuntime.c", which every generated program
+ * links with.
+ */
+
+#if defined(__GNUC__)
+#define ARC_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#define ARC_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#define ARC_NORETURN __attribute__((noreturn))
+#define ARC_UNREACHABLE() __builtin_unreachable()
+#else
+#define ARC_LIKELY(condition) (condition)
+#define ARC_UNLIKELY(condition) (condition)
+#define ARC_NORETURN
+#define ARC_UNREACHABLE() abort()
+#endif
+
+/** Globals start undefined, until the program assigns them. */
+typedef enum {
+	ARC_UNDEFINED = 0,
+	ARC_NIL,
+	ARC_BOOLEAN,
+	ARC_INTEGER,
+	ARC_DECIMAL,
+	ARC_OBJECT
+} ArcValueType;
+
+typedef enum {
+	ARC_STRING,
+	ARC_LIST,
+	ARC_RANGE,
+	ARC_CELL,
+	ARC_CLOSURE,
+	ARC_INSTANCE,
+	ARC_BOUND_METHOD,
+	ARC_NATIVE
+} ArcObjectType;
+
+typedef struct {
+	ArcObjectType type;
+} ArcObject;
+
+typedef struct {
+	ArcValueType type;
+	union {
+		boolean asBoolean;
+		int64_t asInteger;
+		double asDecimal;
+		ArcObject * asObject;
+	};
+} ArcValue;
+
+/**
+ * Every function of a program has the same entry: the callee (the closure,
+ * or the receiver of a method), and its arguments.
+ */
+typedef ArcValue (*ArcFunction)(ArcValue self, int count, ArcValue * arguments);
+
+/**
+ * The characters of a string are inline, except in the strings that appends
+ * build: those are a prefix of the characters of a buffer (the base), which
+ * has room for more, so an append to the longest prefix fills it in place.
+ * The characters of a prefix aren't terminated.
+ */
+typedef struct ArcString {
+	ArcObject header;
+	int length;
+	int capacity;
+	struct ArcString * base;
+	char characters[];
+} ArcString;
+
+typedef struct {
+	ArcObject header;
+	ArcValue * items;
+	int size;
+	int capacity;
+} ArcList;
+
+/** The integers in [start, end). */
+typedef struct {
+	ArcObject header;
+	int64_t start;
+	int64_t end;
+} ArcRange;
+
+/** A variable shared between a function and the lambdas that capture it. */
+typedef struct {
+	ArcObject header;
+	ArcValue value;
+} ArcCell;
+
+/**
+ * A lambda or a native function. The closures of lambdas that capture
+ * variables are flat environments: structures that start with the closure,
+ * and then hold a copy of each captured value (or its cell, if the variable
+ * is assigned after the closure is created).
+ */
+typedef struct {
+	ArcObject header;
+	ArcFunction function;
+	const char * name;
+} ArcClosure;
+
+typedef struct {
+	ArcFunction function;
+	const char * name;
+} ArcMethod;
+
+/**
+ * The class of an instance. Every class has a table of methods, which starts
+ * with this structure and then has the methods of the parent class (in the
+ * same order), and the new ones.
+ */
+typedef struct {
+	const char * name;
+	int fieldCount;
+} ArcClass;
+
+/** An instance starts with this structure, and then has its fields. */
+typedef struct {
+	ArcObject header;
+	const ArcClass * class;
+} ArcInstance;
+
+typedef struct {
+	ArcObject header;
+	ArcValue receiver;
+	ArcMethod method;
+} ArcBoundMethod;
+
+/** The fields of an instance, through the structure of the given class. */
+#define ARC_FIELDS(type, value) ((type##_Instance *) (value).asObject)
+
+/** The table of methods of an instance, through the one of the given class. */
+#define ARC_VTABLE(type, value) ((const type##_Vtable *) ((ArcInstance *) (value).asObject)->class)
+
+/* ------------------------------- Errors ------------------------------- */
+
+/** Reports an error of the running program, and stops it. */
+ARC_NORETURN void arcError(const char * format, ...);
+
+ARC_NORETURN void arcOperatorError(const char * symbol, const ArcValue left, const ArcValue right);
+
+/* ---------------------------- Construction ---------------------------- */
+
+void * arcAllocate(const ArcObjectType type, const size_t size);
+
+ArcValue arcString(const char * characters, const int length);
+
+ArcValue arcLiteral(const char * characters);
+
+ArcValue arcClosure(ArcFunction function, const char * name);
+
+ArcValue arcNative(ArcFunction function, const char * name);
+
+ArcValue arcInstance(const ArcClass * class, const size_t size);
+
+ArcValue arcBind(const ArcValue receiver, const ArcMethod method);
+
+ArcCell * arcCell(const ArcValue value);
+
+/* ----------------------------- Operations ----------------------------- */
+
+ArcValue arcArithmeticSlow(const char symbol, const ArcValue left, const ArcValue right);
+
+/**
+ * The sum of the parts, from left to right, where the parts after the first
+ * string are concatenated at once, into a single new string.
+ */
+ArcValue arcJoin(const int count, ArcValue * parts);
+
+/**
+ * Like "arcJoin", but the string is a prefix of a buffer with room for more,
+ * which the next append to it fills in place (if the first string, after the
+ * empty ones, is the longest prefix of its buffer).
+ */
+ArcValue arcAppend(const int count, ArcValue * parts);
+
+boolean arcLessSlow(const char * symbol, const ArcValue left, const ArcValue right, const boolean orEqual);
+
+boolean arcEqualSlow(const ArcValue left, const ArcValue right);
+
+boolean arcTruthySlow(const ArcValue value);
+
+ArcValue arcCallSlow(const ArcValue callee, const int count, ArcValue * arguments);
+
+const char * arcTypeName(const ArcValue value);
+
+void arcExpectIterable(const ArcValue collection);
+
+ArcValue arcElementSlow(const ArcValue collection, const int64_t index);
+
+/* ------------------------------- Kernels ------------------------------ */
+
+/**
+ * A kernel runs a whole for-in loop that the transpiler recognizes, over the
+ * items of a list or a range. It only runs if every item is a number of the
+ * same type (and returns false otherwise, without any effect), so the loop
+ * then runs as usual. Sums of integers wrap around, so the kernels add them
+ * in any order, but decimals are only combined item by item, since their
+ * sums depend on the order.
+ */
+
+/**
+ * The sum of the integers of the collection, for the loops that only add
+ * (or subtract) every item to an integer.
+ */
+boolean arcSumIntegers(const ArcValue collection, int64_t * sum);
+
+/**
+ * Appends each item of the collection, combined with the operand by the
+ * operator ('+', '-' or '*'), to the target, for the loops that only push
+ * those results into another list.
+ */
+boolean arcMapNumbers(const ArcValue target, const ArcValue collection, const char symbol, const ArcValue operand, const boolean isOperandFirst);
+
+/* ------------------------------- Natives ------------------------------ */
+
+ArcValue arcClock(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcGet(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcList(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcPrint(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcPush(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcRange(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcSet(ArcValue self, int count, ArcValue * arguments);
+
+ArcValue arcSize(ArcValue self, int count, ArcValue * arguments);
+
+/* ------------------------------ Fast paths ---------------------------- */
+
+static inline ArcValue arcNil(void) {
+	ArcValue value;
+	value.type = ARC_NIL;
+	value.asInteger = 0;
+	return value;
+}
+
+static inline ArcValue arcBoolean(const boolean asBoolean) {
+	ArcValue value;
+	value.type = ARC_BOOLEAN;
+	value.asInteger = 0;
+	value.asBoolean = asBoolean;
+	return value;
+}
+
+static inline ArcValue arcInteger(const int64_t asInteger) {
+	ArcValue value;
+	value.type = ARC_INTEGER;
+	value.asInteger = asInteger;
+	return value;
+}
+
+static inline ArcValue arcDecimal(const double asDecimal) {
+	ArcValue value;
+	value.type = ARC_DECIMAL;
+	value.asDecimal = asDecimal;
+	return value;
+}
+
+static inline ArcValue arcObject(void * asObject) {
+	ArcValue value;
+	value.type = ARC_OBJECT;
+	value.asObject = asObject;
+	return value;
+}
+
+static inline boolean arcIsObject(const ArcValue value, const ArcObjectType type) {
+	return (value.type == ARC_OBJECT && value.asObject->type == type) ? true : false;
+}
+
+/**
+ * An instance in the given memory (zeroed, and as large as the instances of
+ * the class) instead of the heap, e.g., in the frame of the caller.
+ */
+static inline const char * arcCharacters(const ArcString * string) {
+	return string->base == NULL ? string->characters : string->base->characters;
+}
+
+static inline ArcValue arcScopedInstance(void * memory, const ArcClass * class) {
+	ArcInstance * instance = memory;
+	instance->header.type = ARC_INSTANCE;
+	instance->class = class;
+	return arcObject(instance);
+}
+
+/** The value of a global, which must be defined. */
+static inline ArcValue arcGlobal(const ArcValue value, const char * name) {
+	if (ARC_UNLIKELY(value.type == ARC_UNDEFINED)) {
+		arcError("Variable '%s' is not defined.", name);
+	}
+	return value;
+}
+
+static inline void arcExpectArguments(const char * name, const int count, const int maximum) {
+	if (ARC_UNLIKELY(maximum < count)) {
+		arcError("Function '%s' expects at most %d argument(s), but it receives %d.", name, maximum, count);
+	}
+}
+
+static inline void arcExpectFields(const ArcClass * class, const int count) {
+	if (ARC_UNLIKELY(class->fieldCount < count)) {
+		arcError("Class '%s' has %d field(s), but it receives %d argument(s).", class->name, class->fieldCount, count);
+	}
+}
+
+/** The arithmetic of integers wraps around. */
+static inline int64_t arcAddIntegers(const int64_t x, const int64_t y) {
+	return (int64_t) ((uint64_t) x + (uint64_t) y);
+}
+
+static inline int64_t arcSubtractIntegers(const int64_t x, const int64_t y) {
+	return (int64_t) ((uint64_t) x - (uint64_t) y);
+}
+
+static inline int64_t arcMultiplyIntegers(const int64_t x, const int64_t y) {
+	return (int64_t) ((uint64_t) x * (uint64_t) y);
+}
+
+static inline int64_t arcDivideIntegers(const int64_t x, const int64_t y) {
+	if (ARC_UNLIKELY(y == 0)) {
+		arcError("Integer division by zero.");
+	}
+	return y == -1 ? (int64_t) (0 - (uint64_t) x) : x / y;
+}
+
+static inline ArcValue arcAdd(const ArcValue left, const ArcValue right) {
+	if (ARC_LIKELY(left.type == ARC_INTEGER && right.type == ARC_INTEGER)) {
+		return arcInteger(arcAddIntegers(left.asInteger, right.asInteger));
+	}
+	return arcArithmeticSlow('+', left, right);
+}
+
+static inline ArcValue arcSubtract(const ArcValue left, const ArcValue right) {
+	if (ARC_LIKELY(left.type == ARC_INTEGER && right.type == ARC_INTEGER)) {
+		return arcInteger(arcSubtractIntegers(left.asInteger, right.asInteger));
+	}
+	return arcArithmeticSlow('-', left, right);
+}
+
+static inline ArcValue arcMultiply(const ArcValue left, const ArcValue right) {
+	if (ARC_LIKELY(left.type == ARC_INTEGER && right.type == ARC_INTEGER)) {
+		return arcInteger(arcMultiplyIntegers(left.asInteger, right.asInteger));
+	}
+	return arcArithmeticSlow('*', left, right);
+}
+
+static inline ArcValue arcDivide(const ArcValue left, const ArcValue right) {
+	if (ARC_LIKELY(left.type == ARC_INTEGER && right.type == ARC_INTEGER)) {
+		return arcInteger(arcDivideIntegers(left.asInteger, right.asInteger));
+	}
+	return arcArithmeticSlow('/', left, right);
+}
+
+/** Whether "left < right" (or "left <= right"), for numbers or strings. */
+static inline boolean arcLess(const char * symbol, const ArcValue left, const ArcValue right, const boolean orEqual) {
+	if (ARC_LIKELY(left.type == ARC_INTEGER && right.type == ARC_INTEGER)) {
+		return (orEqual ? left.asInteger <= right.asInteger : left.asInteger < right.asInteger) ? true : false;
+	}
+	return arcLessSlow(symbol, left, right, orEqual);
+}
+
+static inline boolean arcEqual(const ArcValue left, const ArcValue right) {
+	if (left.type == ARC_INTEGER && right.type == ARC_INTEGER) {
+		return left.asInteger == right.asInteger ? true : false;
+	}
+	return arcEqualSlow(left, right);
+}
+
+static inline boolean arcTruthy(const ArcValue value) {
+	if (value.type == ARC_BOOLEAN) {
+		return value.asBoolean;
+	}
+	return arcTruthySlow(value);
+}
+
+static inline ArcValue arcCall(const ArcValue callee, const int count, ArcValue * arguments) {
+	if (ARC_LIKELY(arcIsObject(callee, ARC_CLOSURE) || arcIsObject(callee, ARC_NATIVE))) {
+		return ((ArcClosure *) callee.asObject)->function(callee, count, arguments);
+	}
+	return arcCallSlow(callee, count, arguments);
+}
+
+/** How many items a for-in loop visits, at least until it changes. */
+static inline int64_t arcLength(const ArcValue collection) {
+	switch (collection.asObject->type) {
+		case ARC_LIST:
+			return ((ArcList *) collection.asObject)->size;
+		case ARC_RANGE: {
+			const ArcRange * range = (ArcRange *) collection.asObject;
+			return range->start < range->end ? range->end - range->start : 0;
+		}
+		default:
+			return ((ArcString *) collection.asObject)->length;
+	}
+}
+
+static inline ArcValue arcElement(const ArcValue collection, const int64_t index) {
+	if (ARC_LIKELY(collection.asObject->type == ARC_LIST)) {
+		return ((ArcList *) collection.asObject)->items[index];
+	}
+	if (collection.asObject->type == ARC_RANGE) {
+		return arcInteger(((ArcRange *) collection.asObject)->start + index);
+	}
+	return arcElementSlow(collection, index);
+}
+
+/**
+ * The items of a list, or NULL for ranges and strings. A for-in loop that
+ * can't grow the list counts up to its length, and reads them unchecked.
+ */
+static inline const ArcValue * arcItems(const ArcValue collection) {
+	return collection.asObject->type == ARC_LIST ? ((ArcList *) collection.asObject)->items : NULL;
+}
+
+/** Runs before the program, and flushes its output when it ends. */
+void arcStart(void);
+
+#endif
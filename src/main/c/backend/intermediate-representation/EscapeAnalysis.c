@@ -0,0 +1,300 @@
+#include "EscapeAnalysis.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeEscapeAnalysisModule() {
+	_logger = createLogger("EscapeAnalysis");
+}
+
+void shutdownEscapeAnalysisModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** The classes of the program, in order (the first one of each name). */
+typedef struct {
+	Class ** classes;
+	int classCount;
+	int classCapacity;
+} Classes;
+
+/** The methods of the lineage of a class, and whether its instance escapes. */
+typedef struct {
+	const char ** methods;
+	int methodCount;
+	boolean escapes;
+} Scan;
+
+/* PRIVATE FUNCTIONS */
+
+static VisitAction _collectClass(void * state, void * node);
+static Class * _findClass(const Classes * classes, const char * name);
+static boolean _isMethod(const Scan * scan, const char * name);
+static Lambda * _memberLambda(Instruction * instruction);
+static const char * _memberName(Instruction * instruction);
+static void _scanBlock(Scan * scan, Block * block, const boolean isBody);
+static void _scanExpression(Scan * scan, Expression * expression);
+static void _scanFactor(Scan * scan, Factor * factor);
+static void _scanInstruction(Scan * scan, Instruction * instruction, const boolean isBody);
+static void _scanLambda(Scan * scan, Lambda * lambda);
+static void _scanName(Scan * scan, const char * name);
+static void _scanWrite(Scan * scan, const char * name);
+
+static VisitAction _collectClass(void * state, void * node) {
+	Classes * classes = state;
+	Class * class = ((Instruction *) node)->class;
+	if (_findClass(classes, class->object->name) != NULL) return VISIT_CHILDREN;
+	if (classes->classCount == classes->classCapacity) {
+		classes->classCapacity = classes->classCapacity == 0 ? 8 : 2 * classes->classCapacity;
+		classes->classes = realloc(classes->classes, classes->classCapacity * sizeof(Class *));
+	}
+	classes->classes[classes->classCount++] = class;
+	return VISIT_CHILDREN;
+}
+
+static Class * _findClass(const Classes * classes, const char * name) {
+	for (int k = 0; k < classes->classCount; ++k) {
+		if (strcmp(classes->classes[k]->object->name, name) == 0) return classes->classes[k];
+	}
+	return NULL;
+}
+
+static boolean _isMethod(const Scan * scan, const char * name) {
+	for (int k = 0; k < scan->methodCount; ++k) {
+		if (strcmp(scan->methods[k], name) == 0) return true;
+	}
+	return false;
+}
+
+/** The name that a class-body instruction defines, if it's a member. */
+static const char * _memberName(Instruction * instruction) {
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		return instruction->variableDeclaration->name;
+	}
+	if (instruction->type == INSTRUCTION_ASSIGNMENT && instruction->assignment->assignmentOperator == ASSIGN_TYPE) {
+		return instruction->assignment->name;
+	}
+	return NULL;
+}
+
+/** The lambda literal that defines a member, if it's a method. */
+static Lambda * _memberLambda(Instruction * instruction) {
+	Expression * expression = NULL;
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		expression = instruction->variableDeclaration->expression;
+	}
+	else if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+		expression = instruction->assignment->expression;
+	}
+	return (expression != NULL && expression->type == LAMBDA) ? expression->lambda : NULL;
+}
+
+/* --------------------------------- Scans -------------------------------- */
+
+/** A read of a name as a value: "this", or a method bound to the instance. */
+static void _scanName(Scan * scan, const char * name) {
+	if (strcmp(name, "this") == 0 || _isMethod(scan, name)) {
+		scan->escapes = true;
+	}
+}
+
+static void _scanWrite(Scan * scan, const char * name) {
+	if (strcmp(name, "this") == 0) {
+		scan->escapes = true;
+	}
+}
+
+/**
+ * The instructions of a body run in the initializer, so a "return" with a
+ * value there replaces the instance as the result of the construction.
+ */
+static void _scanBlock(Scan * scan, Block * block, const boolean isBody) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL && !scan->escapes; node = node->next) {
+		_scanInstruction(scan, node->data, isBody);
+	}
+}
+
+static void _scanInstruction(Scan * scan, Instruction * instruction, const boolean isBody) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			_scanWrite(scan, instruction->assignment->name);
+			_scanExpression(scan, instruction->assignment->expression);
+			break;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			_scanWrite(scan, instruction->variableDeclaration->name);
+			_scanExpression(scan, instruction->variableDeclaration->expression);
+			break;
+		case INSTRUCTION_EXPRESSION:
+			_scanExpression(scan, instruction->expression);
+			break;
+		case INSTRUCTION_BLOCK:
+			_scanBlock(scan, instruction->block, isBody);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+				_scanExpression(scan, conditional->expression);
+				_scanBlock(scan, conditional->block, isBody);
+			}
+			break;
+		case INSTRUCTION_LOOP:
+			_scanExpression(scan, instruction->loop->expression);
+			if (instruction->loop->collectionName != NULL) {
+				_scanName(scan, instruction->loop->collectionName);
+			}
+			if (instruction->loop->itemName != NULL) {
+				_scanWrite(scan, instruction->loop->itemName);
+			}
+			_scanBlock(scan, instruction->loop->block, isBody);
+			break;
+		case INSTRUCTION_RETURN: {
+			Instruction * returned = instruction->returnInstruction;
+			if (returned == NULL) break;
+			if (isBody && returned->type == INSTRUCTION_EXPRESSION) {
+				scan->escapes = true;
+			}
+			_scanInstruction(scan, returned, isBody);
+			break;
+		}
+		case INSTRUCTION_CLASS:
+		case INSTRUCTION_INTERFACE:
+		case INSTRUCTION_PASS:
+			break;
+	}
+}
+
+static void _scanExpression(Scan * scan, Expression * expression) {
+	if (expression == NULL) return;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			_scanExpression(scan, expression->leftExpression);
+			_scanExpression(scan, expression->rightExpression);
+			break;
+		case FACTOR:
+			_scanFactor(scan, expression->factor);
+			break;
+		case FUNCTION_CALL:
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					_scanExpression(scan, node->data);
+				}
+			}
+			break;
+		case LAMBDA:
+			_scanLambda(scan, expression->lambda);
+			break;
+		default:
+			_scanFactor(scan, expression->leftFactor);
+			_scanFactor(scan, expression->rightFactor);
+			break;
+	}
+}
+
+static void _scanFactor(Scan * scan, Factor * factor) {
+	switch (factor->type) {
+		case VARIABLE_TYPE:
+			_scanName(scan, factor->variable);
+			break;
+		case INCREMENT_TYPE:
+		case DECREMENT_TYPE:
+			_scanWrite(scan, factor->variable);
+			break;
+		case EXPRESSION:
+			_scanExpression(scan, factor->expression);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * A lambda that never outlives the frame that creates it can hold the
+ * instance, but an escaping one (or one not analyzed yet) can't.
+ */
+static void _scanLambda(Scan * scan, Lambda * lambda) {
+	if (lambda->captureType == CAPTURE_UNKNOWN) {
+		scan->escapes = true;
+		return;
+	}
+	if (lambda->captureType == CAPTURE_ESCAPING && lambda->captureList != NULL) {
+		for (Node * node = lambda->captureList->first; node != NULL; node = node->next) {
+			if (strcmp(((Capture *) node->data)->name, "this") == 0) {
+				scan->escapes = true;
+			}
+		}
+	}
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			_scanExpression(scan, ((VariableDeclaration *) node->data)->expression);
+		}
+	}
+	_scanBlock(scan, lambda->block, false);
+}
+
+/* PUBLIC FUNCTIONS */
+
+int analyzeEscapes(Program * program) {
+	Classes classes;
+	memset(&classes, 0, sizeof(Classes));
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "escapes";
+	visitor.pre[CLASS_NODE] = _collectClass;
+	visitor.state = &classes;
+	Visitor * visitors[] = { &visitor };
+	walkProgram(program, visitors, 1);
+
+	Class ** lineage = calloc(classes.classCount + 1, sizeof(Class *));
+	int scoped = 0;
+	for (int k = 0; k < classes.classCount; ++k) {
+		int lineageSize = 0;
+		for (Class * ancestor = classes.classes[k]; ancestor != NULL && lineageSize <= classes.classCount;) {
+			lineage[lineageSize++] = ancestor;
+			ancestor = ancestor->inherits == NULL ? NULL : _findClass(&classes, ancestor->inherits->name);
+		}
+		Scan scan;
+		memset(&scan, 0, sizeof(Scan));
+		// A cycle of ancestors never stops, so its instances aren't scoped.
+		scan.escapes = classes.classCount < lineageSize ? true : false;
+		for (int m = 0; m < lineageSize && !scan.escapes; ++m) {
+			if (lineage[m]->block == NULL) continue;
+			for (Node * node = lineage[m]->block->first; node != NULL; node = node->next) {
+				const char * name = _memberName(node->data);
+				if (name == NULL || _memberLambda(node->data) == NULL) continue;
+				scan.methods = realloc(scan.methods, (scan.methodCount + 1) * sizeof(const char *));
+				scan.methods[scan.methodCount++] = name;
+			}
+		}
+		for (int m = 0; m < lineageSize && !scan.escapes; ++m) {
+			if (lineage[m]->block == NULL) continue;
+			for (Node * node = lineage[m]->block->first; node != NULL && !scan.escapes; node = node->next) {
+				Lambda * method = _memberName(node->data) == NULL ? NULL : _memberLambda(node->data);
+				if (method == NULL) {
+					_scanInstruction(&scan, node->data, true);
+					continue;
+				}
+				if (method->variableDeclarationList != NULL) {
+					for (Node * parameter = method->variableDeclarationList->first; parameter != NULL; parameter = parameter->next) {
+						_scanExpression(&scan, ((VariableDeclaration *) parameter->data)->expression);
+					}
+				}
+				_scanBlock(&scan, method->block, false);
+			}
+		}
+		classes.classes[k]->hasScopedInstances = scan.escapes ? false : true;
+		if (!scan.escapes) {
+			scoped += 1;
+		}
+		free(scan.methods);
+	}
+	logDebugging(_logger, "Found %d class(es) with scoped instances, out of %d.", scoped, classes.classCount);
+	free(lineage);
+	free(classes.classes);
+	return scoped;
+}
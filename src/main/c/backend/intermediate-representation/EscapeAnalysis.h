@@ -0,0 +1,37 @@
+#ifndef ESCAPE_ANALYSIS_HEADER
+#define ESCAPE_ANALYSIS_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/Visitor.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeEscapeAnalysisModule();
+
+/** Shutdown module's internal state. */
+void shutdownEscapeAnalysisModule();
+
+/**
+ * Finds the classes whose instances can't outlive their initializer, and
+ * sets their "hasScopedInstances" field. Only the code of a class can reach
+ * its instance (there's no member access), so the instance escapes only if
+ * the bodies or the methods of the class (or of any ancestor):
+ *
+ *	- read or assign "this",
+ *	- read a method as a value (which binds it to the instance),
+ *	- create an escaping lambda that captures "this", or
+ *	- return a value from a body (then the construction isn't the instance).
+ *
+ * A construction whose result is discarded can place a scoped instance in
+ * the frame of its caller, because nothing reaches it once the initializer
+ * returns. It needs the captures of the lambdas, so it runs after any pass
+ * that changes them.
+ *
+ * @return The amount of classes with scoped instances.
+ */
+int analyzeEscapes(Program * program);
+
+#endif
@@ -0,0 +1,1028 @@
+#include "Inliner.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeInlinerModule() {
+	_logger = createLogger("Inliner");
+}
+
+void shutdownInlinerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+typedef enum {
+	GLOBAL_SYMBOL,
+	LOCAL_SYMBOL,
+	PARAMETER_SYMBOL,
+	FIELD_SYMBOL
+} SymbolKind;
+
+typedef struct Frame Frame;
+typedef struct Scope Scope;
+typedef struct Summary Summary;
+typedef struct Symbol Symbol;
+
+/**
+ * A declared name, resolved like in the capture analysis. Definitions are
+ * the initializations, and writes are every other assignment, increment or
+ * decrement. The summary is the one of the lambda literal of its last
+ * definition, if any. The type is the one of the class of a member.
+ */
+struct Symbol {
+	const char * name;
+	SymbolKind kind;
+	Scope * scope;
+	const TypeSignature * type;
+	int definitions;
+	int writes;
+	boolean isInitializing;
+	Summary * summary;
+	Symbol * next;
+	Symbol * allocated;
+};
+
+/** The type of a class (or interface) scope comes from the signatures. */
+struct Scope {
+	Scope * parent;
+	const TypeSignature * type;
+	Symbol * symbols;
+};
+
+/** A name that the body of a lambda reads, and the symbol it resolves to. */
+typedef struct {
+	const char * name;
+	Symbol * symbol;
+} Reference;
+
+/**
+ * What a call needs to know about its callee, from the body of the callee
+ * alone. The result is the expression of its only "return", or NULL if the
+ * obstacle prevents inlining it anywhere.
+ */
+struct Summary {
+	Lambda * lambda;
+	const char * name;
+	Expression * result;
+	const char * obstacle;
+	int cost;
+	int parameterCount;
+	Symbol ** parameters;
+	int * uses;
+	boolean * isCalled;
+	boolean hasCalls;
+	boolean hasIncrements;
+	Reference * references;
+	int referenceCount;
+	int referenceCapacity;
+	Summary * allocated;
+};
+
+/** The code being walked: the top-level code, a class body, or a lambda. */
+struct Frame {
+	const char * name;
+	Summary * summary;
+	Frame * parent;
+};
+
+/**
+ * A call whose callee is a symbol. The obstacle (and the mismatching name)
+ * are found while the scope of the call is still available. The parent is
+ * the innermost call whose arguments contain this one.
+ */
+typedef struct {
+	Expression * expression;
+	Symbol * callee;
+	Summary * summary;
+	const char * caller;
+	Symbol ** arguments;
+	int argumentCount;
+	int parent;
+	const char * obstacle;
+	const char * mismatch;
+	boolean isDeferred;
+} Site;
+
+typedef struct {
+	Scope * scope;
+	Frame * frame;
+	int site;
+	Symbol * symbols;
+	Summary * summaries;
+	Site * sites;
+	int siteCount;
+	int siteCapacity;
+	const SignatureTable * signatures;
+} Inlining;
+
+/** The expressions that replace the parameters of an inlined body. */
+typedef struct {
+	Summary * summary;
+	Expression ** arguments;
+} Instance;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addReference(Summary * summary, const char * name, Symbol * symbol);
+static int _addSite(Inlining * inlining, Expression * expression, Symbol * callee);
+static Factor * _argumentFactor(Expression * expression);
+static int _argumentCost(Expression * expression);
+static const char * _checkArguments(Site * site, Expression ** arguments, int * cost);
+static const char * _checkSite(Inlining * inlining, Site * site, Expression ** arguments, int * cost, const char ** detail);
+static Symbol * _declare(Inlining * inlining, const char * name, SymbolKind kind);
+static void _declareMembers(Inlining * inlining, const TypeSignature * type);
+static int _expressionCost(const Expression * expression);
+static int _factorCost(const Factor * factor);
+static void _finishSummary(Summary * summary);
+static boolean _hasCall(const Summary * summary, const Expression * expression);
+static boolean _hasLambda(const Expression * expression);
+static void _inline(Site * site, Expression ** arguments);
+static int _inlineSites(Inlining * inlining, Emitter * report, Emitter * kept, const int budget);
+static Scope * _innermostClass(Scope * scope);
+static Expression * _instantiateExpression(const Expression * expression, const Instance * instance);
+static Factor * _instantiateFactor(const Factor * factor, const Instance * instance);
+static boolean _isImmutable(const Symbol * symbol);
+static boolean _isPure(const Expression * expression);
+static boolean _isPureCallee(const Symbol * symbol);
+static Symbol * _lookup(Scope * scope, const char * name);
+static SymbolKind _newSymbolKind(Inlining * inlining);
+static const char * _overrider(Inlining * inlining, Symbol * symbol);
+static int _parameterIndex(const Summary * summary, const char * name);
+static void _popScope(Inlining * inlining);
+static void _pushScope(Inlining * inlining, const TypeSignature * type);
+static void _releaseInlining(Inlining * inlining);
+static Symbol * _resolve(Inlining * inlining, const char * name);
+static void _use(Inlining * inlining, const char * name, Symbol * symbol, const boolean isCall);
+static void _walkBlock(Inlining * inlining, Block * block);
+static void _walkCall(Inlining * inlining, Expression * expression);
+static void _walkClass(Inlining * inlining, const char * name, Block * block, const TypeSignature * type);
+static void _walkDefinition(Inlining * inlining, Symbol * symbol, Expression * expression);
+static Summary * _walkExpression(Inlining * inlining, Expression * expression, const char * name);
+static void _walkFactor(Inlining * inlining, Factor * factor);
+static void _walkInstruction(Inlining * inlining, Instruction * instruction);
+static Summary * _walkLambda(Inlining * inlining, Lambda * lambda, const char * name);
+static void _walkScopedBlock(Inlining * inlining, Block * block);
+
+/* ------------------------------- Symbols -------------------------------- */
+
+static void _pushScope(Inlining * inlining, const TypeSignature * type) {
+	Scope * scope = calloc(1, sizeof(Scope));
+	scope->parent = inlining->scope;
+	scope->type = type;
+	inlining->scope = scope;
+}
+
+/** The symbols outlive their scope, because the sites refer to them. */
+static void _popScope(Inlining * inlining) {
+	Scope * scope = inlining->scope;
+	inlining->scope = scope->parent;
+	free(scope);
+}
+
+static Symbol * _declare(Inlining * inlining, const char * name, SymbolKind kind) {
+	Symbol * symbol = calloc(1, sizeof(Symbol));
+	symbol->name = name;
+	symbol->kind = kind;
+	symbol->scope = inlining->scope;
+	symbol->type = inlining->scope->type;
+	symbol->next = inlining->scope->symbols;
+	inlining->scope->symbols = symbol;
+	symbol->allocated = inlining->symbols;
+	inlining->symbols = symbol;
+	return symbol;
+}
+
+static SymbolKind _newSymbolKind(Inlining * inlining) {
+	if (inlining->scope->type != NULL) return FIELD_SYMBOL;
+	if (inlining->scope->parent == NULL) return GLOBAL_SYMBOL;
+	return LOCAL_SYMBOL;
+}
+
+static Symbol * _lookup(Scope * scope, const char * name) {
+	for (Symbol * symbol = scope->symbols; symbol != NULL; symbol = symbol->next) {
+		if (strcmp(symbol->name, name) == 0) return symbol;
+	}
+	return NULL;
+}
+
+/**
+ * Resolves a name from the innermost scope outwards. Methods can't capture
+ * the variables of the code that declares their class, so past a class only
+ * globals are visible. Returns NULL for unresolved names.
+ */
+static Symbol * _resolve(Inlining * inlining, const char * name) {
+	boolean isOutsideClass = false;
+	for (Scope * scope = inlining->scope; scope != NULL; scope = scope->parent) {
+		Symbol * symbol = _lookup(scope, name);
+		if (symbol != NULL && (!isOutsideClass || symbol->kind == GLOBAL_SYMBOL)) return symbol;
+		if (scope->type != NULL) {
+			isOutsideClass = true;
+		}
+	}
+	return NULL;
+}
+
+static Scope * _innermostClass(Scope * scope) {
+	while (scope != NULL && scope->type == NULL) {
+		scope = scope->parent;
+	}
+	return scope;
+}
+
+/** Declares the members of a class before its body, like the analysis does. */
+static void _declareMembers(Inlining * inlining, const TypeSignature * type) {
+	if (type == NULL) return;
+	for (int k = 0; k < type->memberCount; ++k) {
+		if (_lookup(inlining->scope, type->members[k]) == NULL) {
+			_declare(inlining, type->members[k], FIELD_SYMBOL);
+		}
+	}
+}
+
+/**
+ * Records a read (or a call) of a name in the summary of the current lambda:
+ * a use of a parameter, or a reference to any other symbol.
+ */
+static void _use(Inlining * inlining, const char * name, Symbol * symbol, const boolean isCall) {
+	Summary * summary = inlining->frame->summary;
+	if (summary == NULL) return;
+	for (int k = 0; k < summary->parameterCount; ++k) {
+		if (symbol != NULL && symbol == summary->parameters[k]) {
+			summary->uses[k] += 1;
+			summary->isCalled[k] = isCall ? true : summary->isCalled[k];
+			return;
+		}
+	}
+	_addReference(summary, name, symbol);
+}
+
+static void _addReference(Summary * summary, const char * name, Symbol * symbol) {
+	for (int k = 0; k < summary->referenceCount; ++k) {
+		if (strcmp(summary->references[k].name, name) == 0) return;
+	}
+	if (summary->referenceCount == summary->referenceCapacity) {
+		summary->referenceCapacity = summary->referenceCapacity == 0 ? 8 : 2 * summary->referenceCapacity;
+		summary->references = realloc(summary->references, summary->referenceCapacity * sizeof(Reference));
+	}
+	summary->references[summary->referenceCount].name = name;
+	summary->references[summary->referenceCount].symbol = symbol;
+	summary->referenceCount += 1;
+}
+
+/* -------------------------------- Costs --------------------------------- */
+
+static int _expressionCost(const Expression * expression) {
+	int cost = 1;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return cost + _expressionCost(expression->leftExpression) + _expressionCost(expression->rightExpression);
+		case FACTOR:
+			return _factorCost(expression->factor);
+		case FUNCTION_CALL:
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					cost += _expressionCost(node->data);
+				}
+			}
+			return cost;
+		case LAMBDA:
+			return INT_MAX / 2;
+		default:
+			return cost + _factorCost(expression->leftFactor) + _factorCost(expression->rightFactor);
+	}
+}
+
+static int _factorCost(const Factor * factor) {
+	return factor->type == EXPRESSION ? _expressionCost(factor->expression) : 1;
+}
+
+/**
+ * Whether the expression calls anything but the parameters of the summary
+ * (the callers know what their arguments call).
+ */
+static boolean _hasCall(const Summary * summary, const Expression * expression) {
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return (_hasCall(summary, expression->leftExpression) || _hasCall(summary, expression->rightExpression)) ? true : false;
+		case FACTOR:
+			return (expression->factor->type == EXPRESSION && _hasCall(summary, expression->factor->expression)) ? true : false;
+		case FUNCTION_CALL:
+			if (_parameterIndex(summary, expression->functionCall->name) < 0) return true;
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					if (_hasCall(summary, node->data)) return true;
+				}
+			}
+			return false;
+		case LAMBDA:
+			return true;
+		default:
+			return ((expression->leftFactor->type == EXPRESSION && _hasCall(summary, expression->leftFactor->expression))
+				|| (expression->rightFactor->type == EXPRESSION && _hasCall(summary, expression->rightFactor->expression))) ? true : false;
+	}
+}
+
+static boolean _hasLambda(const Expression * expression) {
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return (_hasLambda(expression->leftExpression) || _hasLambda(expression->rightExpression)) ? true : false;
+		case FACTOR:
+			return (expression->factor->type == EXPRESSION && _hasLambda(expression->factor->expression)) ? true : false;
+		case FUNCTION_CALL:
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					if (_hasLambda(node->data)) return true;
+				}
+			}
+			return false;
+		case LAMBDA:
+			return true;
+		default:
+			return ((expression->leftFactor->type == EXPRESSION && _hasLambda(expression->leftFactor->expression))
+				|| (expression->rightFactor->type == EXPRESSION && _hasLambda(expression->rightFactor->expression))) ? true : false;
+	}
+}
+
+/** Whether the expression has no effects: no calls, lambdas or increments. */
+static boolean _isPure(const Expression * expression) {
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return (_isPure(expression->leftExpression) && _isPure(expression->rightExpression)) ? true : false;
+		case FACTOR:
+			switch (expression->factor->type) {
+				case INCREMENT_TYPE:
+				case DECREMENT_TYPE:
+					return false;
+				case EXPRESSION:
+					return _isPure(expression->factor->expression);
+				default:
+					return true;
+			}
+		case FUNCTION_CALL:
+		case LAMBDA:
+			return false;
+		default: {
+			const Factor * factors[] = { expression->leftFactor, expression->rightFactor };
+			for (int k = 0; k < 2; ++k) {
+				if (factors[k]->type == INCREMENT_TYPE || factors[k]->type == DECREMENT_TYPE) return false;
+				if (factors[k]->type == EXPRESSION && !_isPure(factors[k]->expression)) return false;
+			}
+			return true;
+		}
+	}
+}
+
+/** The constant or the variable that the argument is, or NULL. */
+static Factor * _argumentFactor(Expression * expression) {
+	while (expression->type == FACTOR && expression->factor->type == EXPRESSION) {
+		expression = expression->factor->expression;
+	}
+	if (expression->type != FACTOR) return NULL;
+	if (expression->factor->type == CONSTANT || expression->factor->type == VARIABLE_TYPE) {
+		return expression->factor;
+	}
+	return NULL;
+}
+
+static int _argumentCost(Expression * expression) {
+	return _argumentFactor(expression) != NULL ? 1 : _expressionCost(expression);
+}
+
+/**
+ * The shape of the body decides whether the lambda can be inlined at all, so
+ * every call of every unit can reuse that decision.
+ */
+static void _finishSummary(Summary * summary) {
+	Lambda * lambda = summary->lambda;
+	Block * block = lambda->block;
+	Instruction * instruction = (block != NULL && block->size == 1) ? block->first->data : NULL;
+	if (instruction == NULL || instruction->type != INSTRUCTION_RETURN
+		|| instruction->returnInstruction == NULL || instruction->returnInstruction->type != INSTRUCTION_EXPRESSION) {
+		summary->obstacle = "its body isn't a single return";
+		return;
+	}
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			if (((VariableDeclaration *) node->data)->expression != NULL) {
+				summary->obstacle = "it has default values";
+				return;
+			}
+		}
+	}
+	Expression * result = instruction->returnInstruction->expression;
+	if (_hasLambda(result)) {
+		summary->obstacle = "it creates a lambda";
+		return;
+	}
+	if (summary->hasIncrements) {
+		summary->obstacle = "it increments a variable";
+		return;
+	}
+	summary->result = result;
+	summary->cost = _expressionCost(result);
+	summary->hasCalls = _hasCall(summary, result);
+}
+
+/* -------------------------------- Walks --------------------------------- */
+
+static void _walkBlock(Inlining * inlining, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_walkInstruction(inlining, node->data);
+	}
+}
+
+static void _walkScopedBlock(Inlining * inlining, Block * block) {
+	_pushScope(inlining, NULL);
+	_walkBlock(inlining, block);
+	_popScope(inlining);
+}
+
+static void _walkDefinition(Inlining * inlining, Symbol * symbol, Expression * expression) {
+	symbol->isInitializing = true;
+	Summary * summary = _walkExpression(inlining, expression, symbol->name);
+	symbol->isInitializing = false;
+	symbol->summary = summary;
+	symbol->definitions += 1;
+}
+
+static void _walkInstruction(Inlining * inlining, Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT: {
+			AssignmentOperation * assignment = instruction->assignment;
+			Symbol * symbol = _resolve(inlining, assignment->name);
+			if (assignment->assignmentOperator != ASSIGN_TYPE) {
+				if (symbol != NULL) symbol->writes += 1;
+				_use(inlining, assignment->name, symbol, false);
+				_walkExpression(inlining, assignment->expression, NULL);
+			}
+			else if (symbol == NULL) {
+				_walkDefinition(inlining, _declare(inlining, assignment->name, _newSymbolKind(inlining)), assignment->expression);
+			}
+			else if (inlining->scope->type != NULL && _lookup(inlining->scope, assignment->name) == symbol) {
+				_walkDefinition(inlining, symbol, assignment->expression);
+			}
+			else {
+				symbol->writes += 1;
+				_walkExpression(inlining, assignment->expression, assignment->name);
+			}
+			break;
+		}
+		case INSTRUCTION_VARIABLE_DECLARATION: {
+			VariableDeclaration * variableDeclaration = instruction->variableDeclaration;
+			Symbol * symbol = inlining->scope->type != NULL ? _lookup(inlining->scope, variableDeclaration->name) : NULL;
+			if (symbol == NULL) {
+				symbol = _declare(inlining, variableDeclaration->name, _newSymbolKind(inlining));
+			}
+			if (variableDeclaration->expression != NULL) {
+				_walkDefinition(inlining, symbol, variableDeclaration->expression);
+			}
+			break;
+		}
+		case INSTRUCTION_EXPRESSION:
+			_walkExpression(inlining, instruction->expression, NULL);
+			break;
+		case INSTRUCTION_BLOCK:
+			_walkScopedBlock(inlining, instruction->block);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+				_walkExpression(inlining, conditional->expression, NULL);
+				_walkScopedBlock(inlining, conditional->block);
+			}
+			break;
+		case INSTRUCTION_LOOP: {
+			Loop * loop = instruction->loop;
+			_walkExpression(inlining, loop->expression, NULL);
+			if (loop->collectionName != NULL) {
+				_use(inlining, loop->collectionName, _resolve(inlining, loop->collectionName), false);
+			}
+			_pushScope(inlining, NULL);
+			if (loop->itemName != NULL) {
+				_declare(inlining, loop->itemName, LOCAL_SYMBOL)->definitions = 1;
+			}
+			_walkBlock(inlining, loop->block);
+			_popScope(inlining);
+			break;
+		}
+		case INSTRUCTION_CLASS:
+			_walkClass(inlining, instruction->class->object->name, instruction->class->block,
+				findClassSignature(inlining->signatures, instruction->class));
+			break;
+		case INSTRUCTION_INTERFACE:
+			_walkClass(inlining, instruction->interface->object->name, instruction->interface->block,
+				findInterfaceSignature(inlining->signatures, instruction->interface));
+			break;
+		case INSTRUCTION_RETURN:
+			if (instruction->returnInstruction == NULL) break;
+			if (instruction->returnInstruction->type == INSTRUCTION_EXPRESSION) {
+				_walkExpression(inlining, instruction->returnInstruction->expression, NULL);
+			}
+			else {
+				_walkInstruction(inlining, instruction->returnInstruction);
+			}
+			break;
+		case INSTRUCTION_PASS:
+			break;
+	}
+}
+
+/**
+ * A class without a signature (e.g., one declared twice) still needs a class
+ * scope, so its members never resolve outside of it.
+ */
+static void _walkClass(Inlining * inlining, const char * name, Block * block, const TypeSignature * type) {
+	static const TypeSignature unknown = { 0 };
+	Frame frame = { name, NULL, inlining->frame };
+	inlining->frame = &frame;
+	_pushScope(inlining, type == NULL ? &unknown : type);
+	_declareMembers(inlining, type);
+	_walkBlock(inlining, block);
+	_popScope(inlining);
+	inlining->frame = frame.parent;
+}
+
+/**
+ * Walks an expression. Returns the summary of the lambda if the expression
+ * is a lambda literal, or NULL otherwise.
+ */
+static Summary * _walkExpression(Inlining * inlining, Expression * expression, const char * name) {
+	if (expression == NULL) return NULL;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			_walkExpression(inlining, expression->leftExpression, NULL);
+			_walkExpression(inlining, expression->rightExpression, NULL);
+			return NULL;
+		case FACTOR:
+			_walkFactor(inlining, expression->factor);
+			return NULL;
+		case FUNCTION_CALL:
+			_walkCall(inlining, expression);
+			return NULL;
+		case LAMBDA:
+			return _walkLambda(inlining, expression->lambda, name);
+		default:
+			_walkFactor(inlining, expression->leftFactor);
+			_walkFactor(inlining, expression->rightFactor);
+			return NULL;
+	}
+}
+
+static void _walkFactor(Inlining * inlining, Factor * factor) {
+	Symbol * symbol;
+	switch (factor->type) {
+		case VARIABLE_TYPE:
+			_use(inlining, factor->variable, _resolve(inlining, factor->variable), false);
+			break;
+		case INCREMENT_TYPE:
+		case DECREMENT_TYPE:
+			symbol = _resolve(inlining, factor->variable);
+			if (symbol != NULL) {
+				symbol->writes += 1;
+			}
+			if (inlining->frame->summary != NULL) {
+				inlining->frame->summary->hasIncrements = true;
+			}
+			_use(inlining, factor->variable, symbol, false);
+			break;
+		case EXPRESSION:
+			_walkExpression(inlining, factor->expression, NULL);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Records the call as a site if its callee is a symbol, in pre-order, and
+ * checks the names of the callee from the scope of the call. Code of a class
+ * may run before the definitions of the top-level code (e.g., if the class
+ * is instantiated first), so it only inlines methods of its own class.
+ */
+static void _walkCall(Inlining * inlining, Expression * expression) {
+	FunctionCall * functionCall = expression->functionCall;
+	Symbol * callee = _resolve(inlining, functionCall->name);
+	_use(inlining, functionCall->name, callee, true);
+	const int parent = inlining->site;
+	const int index = callee == NULL ? -1 : _addSite(inlining, expression, callee);
+	if (0 <= index) {
+		Site * site = &inlining->sites[index];
+		site->parent = parent;
+		Scope * class = _innermostClass(inlining->scope);
+		if (callee->isInitializing) {
+			site->obstacle = "it's recursive";
+		}
+		else if (callee->summary == NULL) {
+			site->obstacle = "it's defined after the call";
+		}
+		else if (callee->kind == FIELD_SYMBOL ? callee->scope != class : class != NULL) {
+			site->obstacle = callee->kind == FIELD_SYMBOL
+				? "it's a member of another class"
+				: "the code of a class may run before its definition";
+		}
+		else {
+			for (int k = 0; k < callee->summary->referenceCount; ++k) {
+				const Reference * reference = &callee->summary->references[k];
+				if (_resolve(inlining, reference->name) != reference->symbol) {
+					site->mismatch = reference->name;
+					break;
+				}
+			}
+		}
+	}
+	if (functionCall->expressionList == NULL) return;
+	inlining->site = index < 0 ? parent : index;
+	int count = 0;
+	for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next, ++count) {
+		_walkExpression(inlining, node->data, NULL);
+		Factor * factor = _argumentFactor(node->data);
+		if (0 <= index && factor != NULL && factor->type == VARIABLE_TYPE) {
+			inlining->sites[index].arguments[count] = _resolve(inlining, factor->variable);
+		}
+	}
+	inlining->site = parent;
+}
+
+static int _addSite(Inlining * inlining, Expression * expression, Symbol * callee) {
+	if (inlining->siteCount == inlining->siteCapacity) {
+		inlining->siteCapacity = inlining->siteCapacity == 0 ? 64 : 2 * inlining->siteCapacity;
+		inlining->sites = realloc(inlining->sites, inlining->siteCapacity * sizeof(Site));
+	}
+	Site * site = &inlining->sites[inlining->siteCount];
+	memset(site, 0, sizeof(Site));
+	site->expression = expression;
+	site->callee = callee;
+	site->summary = callee->summary;
+	site->caller = inlining->frame->name;
+	ExpressionList * arguments = expression->functionCall->expressionList;
+	site->argumentCount = arguments == NULL ? 0 : arguments->size;
+	site->arguments = calloc(site->argumentCount + 1, sizeof(Symbol *));
+	return inlining->siteCount++;
+}
+
+/** The parameters and the body of a lambda share the same scope. */
+static Summary * _walkLambda(Inlining * inlining, Lambda * lambda, const char * name) {
+	Summary * summary = calloc(1, sizeof(Summary));
+	summary->lambda = lambda;
+	summary->name = name == NULL ? "<lambda>" : name;
+	summary->allocated = inlining->summaries;
+	inlining->summaries = summary;
+	summary->parameterCount = lambda->variableDeclarationList == NULL ? 0 : lambda->variableDeclarationList->size;
+	summary->parameters = calloc(summary->parameterCount + 1, sizeof(Symbol *));
+	summary->uses = calloc(summary->parameterCount + 1, sizeof(int));
+	summary->isCalled = calloc(summary->parameterCount + 1, sizeof(boolean));
+
+	Frame frame = { summary->name, summary, inlining->frame };
+	inlining->frame = &frame;
+	_pushScope(inlining, NULL);
+	if (lambda->variableDeclarationList != NULL) {
+		int index = 0;
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			Symbol * symbol = _declare(inlining, parameter->name, PARAMETER_SYMBOL);
+			summary->parameters[index++] = symbol;
+			_walkExpression(inlining, parameter->expression, parameter->name);
+			symbol->definitions = 1;
+		}
+	}
+	_walkBlock(inlining, lambda->block);
+	_popScope(inlining);
+	inlining->frame = frame.parent;
+	_finishSummary(summary);
+	return summary;
+}
+
+/* ------------------------------- Inlining ------------------------------- */
+
+/** A local that never changes after its only definition. */
+static boolean _isImmutable(const Symbol * symbol) {
+	return (symbol != NULL && (symbol->kind == LOCAL_SYMBOL || symbol->kind == PARAMETER_SYMBOL)
+		&& symbol->definitions == 1 && symbol->writes == 0) ? true : false;
+}
+
+/**
+ * Whether calling the variable has no effects: it's a local or a global
+ * bound to a lambda whose body only computes an expression, without calls.
+ */
+static boolean _isPureCallee(const Symbol * symbol) {
+	if (symbol == NULL || symbol->kind == FIELD_SYMBOL || symbol->definitions != 1 || symbol->writes != 0 || symbol->summary == NULL) return false;
+	const Summary * summary = symbol->summary;
+	if (summary->result == NULL || summary->hasCalls) return false;
+	for (int k = 0; k < summary->parameterCount; ++k) {
+		if (summary->isCalled[k]) return false;
+	}
+	return true;
+}
+
+/**
+ * The class that overrides the method of the symbol, if any: every class
+ * that descends from the class of the method, and declares it again.
+ */
+static const char * _overrider(Inlining * inlining, Symbol * symbol) {
+	const TypeSignature * owner = symbol->type;
+	const SignatureTable * signatures = inlining->signatures;
+	if (owner->name == NULL) return "an unknown class";
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		const TypeSignature * type = &signatures->types[k];
+		if (type == owner || type->class == NULL) continue;
+		boolean isDescendant = false;
+		const char * parent = type->parent;
+		for (int depth = 0; parent != NULL && !isDescendant && depth < signatures->typeCount; ++depth) {
+			if (strcmp(parent, owner->name) == 0) {
+				isDescendant = true;
+				break;
+			}
+			const TypeSignature * ancestor = NULL;
+			for (int j = 0; j < signatures->typeCount; ++j) {
+				if (signatures->types[j].class != NULL && strcmp(signatures->types[j].name, parent) == 0) {
+					ancestor = &signatures->types[j];
+				}
+			}
+			parent = ancestor == NULL ? NULL : ancestor->parent;
+		}
+		if (!isDescendant) continue;
+		for (int j = 0; j < type->ownMemberCount; ++j) {
+			if (strcmp(type->members[j], symbol->name) == 0) return type->name;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * An argument replaces every use of its parameter. A constant or a variable
+ * can be evaluated any amount of times, unless the callee may change that
+ * variable while it runs (through its calls). Any other argument must be
+ * pure, and used exactly once, by a callee without effects, so nothing
+ * observes that it's evaluated later. A called parameter needs a variable,
+ * which becomes the new callee.
+ */
+static const char * _checkArguments(Site * site, Expression ** arguments, int * cost) {
+	Summary * summary = site->summary;
+	boolean hasEffects = summary->hasCalls;
+	for (int k = 0; k < summary->parameterCount; ++k) {
+		if (summary->isCalled[k] && !_isPureCallee(site->arguments[k])) {
+			hasEffects = true;
+		}
+	}
+	*cost = summary->cost;
+	for (int k = 0; k < summary->parameterCount; ++k) {
+		Factor * factor = _argumentFactor(arguments[k]);
+		if (summary->isCalled[k] && (factor == NULL || factor->type != VARIABLE_TYPE)) {
+			return "it calls a parameter whose argument isn't a variable";
+		}
+		if (factor == NULL) {
+			if (summary->uses[k] != 1) return "an argument with effects isn't used exactly once";
+			if (hasEffects || !_isPure(arguments[k])) return "an argument with effects would run later";
+		}
+		else if (factor->type == VARIABLE_TYPE) {
+			Symbol * symbol = site->arguments[k];
+			if (summary->uses[k] == 0 && symbol == NULL) return "an unused argument may be undefined";
+			if (hasEffects && !_isImmutable(symbol)) return "its calls may change an argument";
+		}
+		*cost += summary->uses[k] * (_argumentCost(arguments[k]) - 1);
+	}
+	return NULL;
+}
+
+/**
+ * The reason to keep the call, or NULL. The detail names the class that
+ * overrides the callee, or the name that resolves to another symbol.
+ */
+static const char * _checkSite(Inlining * inlining, Site * site, Expression ** arguments, int * cost, const char ** detail) {
+	Symbol * callee = site->callee;
+	if (site->obstacle != NULL) return site->obstacle;
+	if (callee->definitions != 1 || callee->writes != 0) return "it's assigned more than once";
+	if (callee->kind == FIELD_SYMBOL && (*detail = _overrider(inlining, callee)) != NULL) return "a subclass overrides it";
+	if (site->summary->obstacle != NULL) return site->summary->obstacle;
+	if (site->argumentCount != site->summary->parameterCount) return "the amount of arguments differs";
+	if (site->mismatch != NULL) {
+		*detail = site->mismatch;
+		return "a name of its body resolves to another symbol here";
+	}
+	return _checkArguments(site, arguments, cost);
+}
+
+static int _parameterIndex(const Summary * summary, const char * name) {
+	for (int k = 0; k < summary->parameterCount; ++k) {
+		if (strcmp(summary->parameters[k]->name, name) == 0) return k;
+	}
+	return -1;
+}
+
+/**
+ * Clones an expression of an inlined body (or an argument, without an
+ * instance), with the arguments in place of the parameters. The bodies have
+ * no lambdas, and the arguments that get cloned are pure.
+ */
+static Expression * _instantiateExpression(const Expression * expression, const Instance * instance) {
+	Expression * clone = calloc(1, sizeof(Expression));
+	clone->type = expression->type;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			clone->leftExpression = _instantiateExpression(expression->leftExpression, instance);
+			clone->rightExpression = _instantiateExpression(expression->rightExpression, instance);
+			break;
+		case FACTOR:
+			clone->factor = _instantiateFactor(expression->factor, instance);
+			break;
+		case FUNCTION_CALL: {
+			const FunctionCall * functionCall = expression->functionCall;
+			const int index = instance == NULL ? -1 : _parameterIndex(instance->summary, functionCall->name);
+			const char * name = index < 0 ? functionCall->name : _argumentFactor(instance->arguments[index])->variable;
+			clone->functionCall = calloc(1, sizeof(FunctionCall));
+			clone->functionCall->name = strdup(name);
+			if (functionCall->expressionList != NULL) {
+				for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next) {
+					clone->functionCall->expressionList = ListSemanticAction(clone->functionCall->expressionList,
+						_instantiateExpression(node->data, instance));
+				}
+			}
+			break;
+		}
+		default:
+			clone->leftFactor = _instantiateFactor(expression->leftFactor, instance);
+			clone->rightFactor = _instantiateFactor(expression->rightFactor, instance);
+			break;
+	}
+	return clone;
+}
+
+static Factor * _instantiateFactor(const Factor * factor, const Instance * instance) {
+	Factor * clone = calloc(1, sizeof(Factor));
+	clone->type = factor->type;
+	switch (factor->type) {
+		case CONSTANT:
+			clone->constant = calloc(1, sizeof(Constant));
+			*clone->constant = *factor->constant;
+			if (factor->constant->type == C_STRING_TYPE) {
+				clone->constant->stringValue = strdup(factor->constant->stringValue);
+			}
+			break;
+		case EXPRESSION:
+			clone->expression = _instantiateExpression(factor->expression, instance);
+			break;
+		default: {
+			const int index = instance == NULL ? -1 : _parameterIndex(instance->summary, factor->variable);
+			if (index < 0) {
+				clone->variable = strdup(factor->variable);
+				break;
+			}
+			Factor * argument = _argumentFactor(instance->arguments[index]);
+			free(clone);
+			if (argument != NULL) return _instantiateFactor(argument, NULL);
+			clone = calloc(1, sizeof(Factor));
+			clone->type = EXPRESSION;
+			clone->expression = _instantiateExpression(instance->arguments[index], NULL);
+			break;
+		}
+	}
+	return clone;
+}
+
+/** Replaces the call with its instantiated body, in place. */
+static void _inline(Site * site, Expression ** arguments) {
+	Instance instance = { site->summary, arguments };
+	Expression * body = _instantiateExpression(site->summary->result, &instance);
+	releaseFunctionCall(site->expression->functionCall);
+	*site->expression = *body;
+	free(body);
+}
+
+/**
+ * Inlines the sites in reverse pre-order: the arguments of a call before the
+ * call (which is deferred to the next round, because its arguments changed),
+ * and the calls of a body after the calls that clone it.
+ */
+static int _inlineSites(Inlining * inlining, Emitter * report, Emitter * kept, const int budget) {
+	int inlined = 0;
+	for (int k = inlining->siteCount - 1; 0 <= k; --k) {
+		Site * site = &inlining->sites[k];
+		if (site->isDeferred || site->callee->summary == NULL) continue;
+		if (site->summary == NULL) {
+			site->summary = site->callee->summary;
+		}
+		Expression ** arguments = calloc(site->argumentCount + 1, sizeof(Expression *));
+		if (site->expression->functionCall->expressionList != NULL) {
+			int index = 0;
+			for (Node * node = site->expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+				arguments[index++] = node->data;
+			}
+		}
+		int cost = 0;
+		const char * detail = NULL;
+		const char * reason = _checkSite(inlining, site, arguments, &cost, &detail);
+		if (reason == NULL && budget < cost) {
+			if (kept != NULL) {
+				emit(kept, "kept %s in %s: its cost (%d) exceeds the budget (%d)\n", site->callee->name, site->caller, cost, budget);
+			}
+		}
+		else if (reason != NULL) {
+			if (kept != NULL) {
+				emit(kept, "kept %s in %s: %s", site->callee->name, site->caller, reason);
+				emit(kept, detail == NULL ? "\n" : " (%s)\n", detail);
+			}
+		}
+		else {
+			if (report != NULL) {
+				emit(report, "inlined %s into %s: its cost (%d) is within the budget (%d)\n", site->callee->name, site->caller, cost, budget);
+			}
+			logDebugging(_logger, "Inlined '%s' into '%s' (cost %d).", site->callee->name, site->caller, cost);
+			_inline(site, arguments);
+			for (int parent = site->parent; 0 <= parent; parent = inlining->sites[parent].parent) {
+				inlining->sites[parent].isDeferred = true;
+			}
+			++inlined;
+		}
+		free(arguments);
+	}
+	return inlined;
+}
+
+static void _releaseInlining(Inlining * inlining) {
+	Symbol * symbol = inlining->symbols;
+	while (symbol != NULL) {
+		Symbol * next = symbol->allocated;
+		free(symbol);
+		symbol = next;
+	}
+	Summary * summary = inlining->summaries;
+	while (summary != NULL) {
+		Summary * next = summary->allocated;
+		free(summary->parameters);
+		free(summary->uses);
+		free(summary->isCalled);
+		free(summary->references);
+		free(summary);
+		summary = next;
+	}
+	for (int k = 0; k < inlining->siteCount; ++k) {
+		free(inlining->sites[k].arguments);
+	}
+	free(inlining->sites);
+}
+
+/* PUBLIC FUNCTIONS */
+
+int inlineCalls(Program * program, Emitter * report) {
+	if (program == NULL || program->block == NULL) return 0;
+	const int budget = getIntegerOrDefault("INLINING_BUDGET", 16);
+	SignatureTable * signatures = createSignatureTable();
+	Visitor signaturesVisitor;
+	initializeSignaturesVisitor(&signaturesVisitor, signatures);
+	Visitor * visitors[] = { &signaturesVisitor };
+	walkProgram(program, visitors, 1);
+	signaturesVisitor.finish(signaturesVisitor.state);
+
+	// Only the decisions of the last round are final, so the calls it keeps
+	// are buffered until then.
+	Emitter * kept = report == NULL ? NULL : createEmitter(-1);
+	int total = 0;
+	int rounds = 0;
+	for (int inlined = 1; 0 < inlined && rounds < MAXIMUM_INLINING_ROUNDS; ++rounds) {
+		Inlining inlining = { 0 };
+		Frame frame = { "program", NULL, NULL };
+		inlining.frame = &frame;
+		inlining.site = -1;
+		inlining.signatures = signatures;
+		if (kept != NULL) {
+			clearEmitter(kept);
+		}
+		_pushScope(&inlining, NULL);
+		_walkBlock(&inlining, program->block);
+		_popScope(&inlining);
+		inlined = _inlineSites(&inlining, report, kept, budget);
+		_releaseInlining(&inlining);
+		total += inlined;
+	}
+	if (kept != NULL) {
+		emitEmitter(report, kept);
+		destroyEmitter(kept);
+	}
+	if (0 < total) {
+		analyzeCaptures(program, signatures);
+	}
+	releaseSignatureTable(signatures);
+	logDebugging(_logger, "Inlined %d call(s) in %d round(s).", total, rounds);
+	return total;
+}
@@ -0,0 +1,51 @@
+#ifndef INLINER_HEADER
+#define INLINER_HEADER
+
+#include "../../frontend/semantic-analysis/CaptureAnalysis.h"
+#include "../../frontend/semantic-analysis/Signatures.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/BisonActions.h"
+#include "../../frontend/syntactic-analysis/Visitor.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../Emitter.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The most rounds of inlining, so inlined bodies can inline their calls too. */
+#define MAXIMUM_INLINING_ROUNDS 4
+
+/** Initialize module's internal state. */
+void initializeInlinerModule();
+
+/** Shutdown module's internal state. */
+void shutdownInlinerModule();
+
+/**
+ * Replaces the calls whose callee is statically bound to a small lambda with
+ * the body of that lambda. A callee is bound if it's a local, a global or a
+ * method (of the class of the call, and never overridden) assigned exactly
+ * once, to a lambda literal, before the call.
+ *
+ * Every lambda gets a summary computed from its own body: whether it's a
+ * single "return" of an expression without lambdas or increments, its cost
+ * (the amount of nodes of that expression), the uses of each parameter, and
+ * the symbols of the other names it reads. A call inlines its callee if:
+ *
+ *	- every name of the callee resolves to the same symbol at the call,
+ *	- every argument is evaluated exactly once, or it's a constant or a
+ *	  variable that the callee can't change while it runs, and
+ *	- the cost, with the arguments in place of the parameters, is within
+ *	  "INLINING_BUDGET".
+ *
+ * Calls to parameters become calls to the variables passed to them, so the
+ * next round can inline those too. Then the captures are analyzed again. If
+ * the emitter isn't NULL, it also writes each decision, and its reason.
+ *
+ * @return The amount of inlined calls.
+ */
+int inlineCalls(Program * program, Emitter * report);
+
+#endif
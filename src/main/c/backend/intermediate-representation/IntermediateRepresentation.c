@@ -0,0 +1,1390 @@
+#include "IntermediateRepresentation.h"
+
+/* MODULE INTERNAL STATE */
+
+static const char * const _opcodeNames[IR_OPCODE_COUNT] = {
+#define OPCODE(name) [IR_##name] = #name,
+	IR_OPCODES(OPCODE)
+#undef OPCODE
+};
+static const char * const _typeNames[] = { "none", "integer", "decimal", "boolean", "string", "any" };
+
+/** The incoming definition of a join whose predecessors disagree. */
+static IrValue _conflict;
+static Logger * _logger = NULL;
+
+void initializeIntermediateRepresentationModule() {
+	_logger = createLogger("IntermediateRepresentation");
+}
+
+void shutdownIntermediateRepresentationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The state of the function under construction. While a lambda is lowered,
+ * the state of the enclosing function is saved, and restored afterwards.
+ * Unsafe names are the ones that may also be globals or members.
+ */
+typedef struct {
+	IrProgram * program;
+	IrFunction ** last;
+	IrFunction * function;
+	IrBlock * current;
+	IrScope * scope;
+	IrStatement * statement;
+	IrLoop * loop;
+	int order;
+	int parentSite;
+	const char ** boxedNames;
+	int boxedCount;
+	int boxedCapacity;
+	const char ** unsafeNames;
+	int unsafeCount;
+	int unsafeCapacity;
+} Lowering;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addName(const char *** names, int * count, int * capacity, const char * name);
+static void _addOperand(IrValue * value, IrValue * operand);
+static IrValue * _addPhiOperands(Lowering * lowering, const int variable, IrValue * phi);
+static void _append(IrBlock * block, IrValue * value);
+static IrType _arithmeticType(const IrOpcode opcode, const IrType left, const IrType right);
+static void _assign(Lowering * lowering, IrSymbol * symbol, const char * name, IrValue * value);
+static VisitAction _collectBoxedNames(void * state, void * node);
+static VisitAction _collectMembers(void * state, void * node);
+static int _compareNames(const void * left, const void * right);
+static void _computeDominators(IrFunction * function);
+static void _computeOrder(IrFunction * function);
+static void _computeReaching(IrFunction * function, const int variable);
+static IrSymbol * _declare(Lowering * lowering, const char * name, IrStatement * declaration);
+static IrValue * _defaultValue(Lowering * lowering, const VariableType type);
+static void _dumpFunction(Emitter * emitter, IrFunction * function);
+static void _dumpValue(Emitter * emitter, IrFunction * function, IrValue * value, const char * note);
+static IrValue * _emitValue(Lowering * lowering, const IrOpcode opcode, IrValue * left, IrValue * right);
+static void _finishSite(Lowering * lowering, const int site, IrValue * value);
+static void * _grow(void * array, int * capacity, const int count, const size_t size);
+static boolean _hasName(const char ** names, const int count, const char * name);
+static IrBlock * _intersect(IrBlock * a, IrBlock * b);
+static boolean _isConstantlyTrue(Expression * expression);
+static boolean _isDead(Lowering * lowering, IrBlock * block);
+static boolean _isNumeric(const IrType type);
+static IrType _join(const IrType left, const IrType right);
+static IrValue * _lastDefinition(IrBlock * block, const int variable, const int position);
+static void _link(Lowering * lowering, IrBlock * target);
+static void _linkBlocks(IrBlock * source, IrBlock * target);
+static void _lowerBlock(Lowering * lowering, Block * block);
+static void _lowerClass(Lowering * lowering, Class * class);
+static void _lowerConditional(Lowering * lowering, Conditional * conditional);
+static IrValue * _lowerConstant(Lowering * lowering, Constant * constant);
+static IrValue * _lowerDefinition(Lowering * lowering, const char * name, Expression * expression);
+static IrValue * _lowerExpression(Lowering * lowering, Expression * expression);
+static IrValue * _lowerFactor(Lowering * lowering, Factor * factor);
+static IrFunction * _lowerFunction(Lowering * lowering, const char * name, Lambda * lambda, Block * block, IrScope * parent);
+static IrValue * _lowerIncrement(Lowering * lowering, const char * name, const IrOpcode opcode);
+static void _lowerInstruction(Lowering * lowering, Instruction * instruction, Block * list);
+static void _lowerLoop(Lowering * lowering, Loop * loop);
+static IrValue * _lowerName(Lowering * lowering, const char * name, const IrSiteType type, Factor * factor);
+static IrValue * _lowerOperation(Lowering * lowering, Expression * expression);
+static void _lowerScopedBlock(Lowering * lowering, Block * block);
+static IrBlock * _newBlock(IrFunction * function, const boolean isSealed);
+static IrValue * _newPhi(IrFunction * function, IrBlock * block, const int variable);
+static int _newSite(Lowering * lowering, const IrSiteType type, Expression * expression, Factor * factor);
+static IrValue * _newValue(IrFunction * function, const IrOpcode opcode);
+static void _popScope(Lowering * lowering);
+static void _prepareBoxedNames(Lowering * lowering, Block * block);
+static void _pushScope(Lowering * lowering);
+static IrValue * _readVariable(Lowering * lowering, const int variable, IrBlock * block);
+static IrValue * _readVariableRecursively(Lowering * lowering, const int variable, IrBlock * block);
+static void _releaseFunction(IrFunction * function);
+static void _removeTrivialPhis(IrFunction * function);
+static IrSymbol * _resolve(Lowering * lowering, const char * name);
+static void _sealBlock(Lowering * lowering, IrBlock * block);
+static VisitAction _skipClass(void * state, void * node);
+static void _terminate(Lowering * lowering, IrBlock * target);
+static IrValue * _through(IrValue * value);
+static IrValue * _tryRemoveTrivialPhi(IrFunction * function, IrValue * phi);
+static IrType _typeOf(IrValue * value);
+static IrValue * _undefined(IrFunction * function, IrBlock * block, const int variable);
+static void _writeVariable(IrFunction * function, const int variable, IrBlock * block, IrValue * value);
+
+/**
+ * Doubles the capacity of a dynamic array if it's full.
+ */
+static void * _grow(void * array, int * capacity, const int count, const size_t size) {
+	if (count < *capacity) return array;
+	*capacity = *capacity == 0 ? 8 : 2 * *capacity;
+	return realloc(array, *capacity * size);
+}
+
+static void _addName(const char *** names, int * count, int * capacity, const char * name) {
+	*names = _grow(*names, capacity, *count, sizeof(const char *));
+	(*names)[(*count)++] = name;
+}
+
+static int _compareNames(const void * left, const void * right) {
+	return strcmp(*(const char * const *) left, *(const char * const *) right);
+}
+
+/**
+ * Whether the sorted array has the name.
+ */
+static boolean _hasName(const char ** names, const int count, const char * name) {
+	return (count != 0 && bsearch(&name, names, count, sizeof(const char *), _compareNames) != NULL) ? true : false;
+}
+
+/* ------------------------------ Structure ------------------------------- */
+
+static IrBlock * _newBlock(IrFunction * function, const boolean isSealed) {
+	function->blocks = _grow(function->blocks, &function->blockCapacity, function->blockCount, sizeof(IrBlock *));
+	IrBlock * block = calloc(1, sizeof(IrBlock));
+	block->id = function->blockCount;
+	block->isSealed = isSealed;
+	block->order = -1;
+	function->blocks[function->blockCount++] = block;
+	return block;
+}
+
+static IrValue * _newValue(IrFunction * function, const IrOpcode opcode) {
+	function->values = _grow(function->values, &function->valueCapacity, function->valueCount, sizeof(IrValue *));
+	IrValue * value = calloc(1, sizeof(IrValue));
+	value->id = function->valueCount;
+	value->opcode = opcode;
+	value->variable = -1;
+	function->values[function->valueCount++] = value;
+	return value;
+}
+
+static void _addOperand(IrValue * value, IrValue * operand) {
+	value->operands = _grow(value->operands, &value->operandCapacity, value->operandCount, sizeof(IrValue *));
+	value->operands[value->operandCount++] = operand;
+}
+
+static void _append(IrBlock * block, IrValue * value) {
+	block->values = _grow(block->values, &block->valueCapacity, block->valueCount, sizeof(IrValue *));
+	block->values[block->valueCount++] = value;
+	value->block = block;
+}
+
+static void _linkBlocks(IrBlock * source, IrBlock * target) {
+	for (int k = 0; k < source->successorCount; ++k) {
+		if (source->successors[k] == target) return;
+	}
+	source->successors = _grow(source->successors, &source->successorCapacity, source->successorCount, sizeof(IrBlock *));
+	source->successors[source->successorCount++] = target;
+	target->predecessors = _grow(target->predecessors, &target->predecessorCapacity, target->predecessorCount, sizeof(IrBlock *));
+	target->predecessors[target->predecessorCount++] = source;
+}
+
+/**
+ * A block without predecessors (other than the entry) only follows a
+ * "return" or a "pass", so it never runs.
+ */
+static boolean _isDead(Lowering * lowering, IrBlock * block) {
+	return (block->id != 0 && block->predecessorCount == 0) ? true : false;
+}
+
+/**
+ * Jumps from the current block to the target, unless the current block is
+ * dead (so its undefined variables don't reach the target).
+ */
+static void _link(Lowering * lowering, IrBlock * target) {
+	if (!_isDead(lowering, lowering->current)) {
+		_linkBlocks(lowering->current, target);
+	}
+}
+
+/**
+ * Jumps to the target (if any), and continues in a new block without
+ * predecessors.
+ */
+static void _terminate(Lowering * lowering, IrBlock * target) {
+	if (target != NULL) {
+		_link(lowering, target);
+	}
+	lowering->current = _newBlock(lowering->function, true);
+}
+
+static IrValue * _emitValue(Lowering * lowering, const IrOpcode opcode, IrValue * left, IrValue * right) {
+	IrValue * value = _newValue(lowering->function, opcode);
+	if (left != NULL) {
+		_addOperand(value, left);
+	}
+	if (right != NULL) {
+		_addOperand(value, right);
+	}
+	_append(lowering->current, value);
+	return value;
+}
+
+static int _newSite(Lowering * lowering, const IrSiteType type, Expression * expression, Factor * factor) {
+	IrFunction * function = lowering->function;
+	function->sites = _grow(function->sites, &function->siteCapacity, function->siteCount, sizeof(IrSite));
+	IrSite * site = &function->sites[function->siteCount];
+	memset(site, 0, sizeof(IrSite));
+	site->type = type;
+	site->expression = expression;
+	site->factor = factor;
+	site->variable = -1;
+	site->statement = lowering->statement;
+	site->scope = lowering->scope;
+	site->order = ++lowering->order;
+	site->block = lowering->current;
+	site->position = lowering->current->valueCount;
+	site->parent = lowering->parentSite;
+	return function->siteCount++;
+}
+
+static void _finishSite(Lowering * lowering, const int site, IrValue * value) {
+	IrSite * finished = &lowering->function->sites[site];
+	finished->value = value;
+	finished->endPosition = lowering->current->valueCount;
+	finished->end = lowering->function->siteCount;
+}
+
+/* ------------------------------- Scopes -------------------------------- */
+
+static void _pushScope(Lowering * lowering) {
+	IrScope * scope = calloc(1, sizeof(IrScope));
+	scope->parent = lowering->scope;
+	scope->function = lowering->function;
+	scope->allocated = lowering->function->scopes;
+	lowering->function->scopes = scope;
+	lowering->scope = scope;
+}
+
+static void _popScope(Lowering * lowering) {
+	lowering->scope = lowering->scope->parent;
+}
+
+static IrSymbol * _resolve(Lowering * lowering, const char * name) {
+	for (IrScope * scope = lowering->scope; scope != NULL; scope = scope->parent) {
+		for (IrSymbol * symbol = scope->symbols; symbol != NULL; symbol = symbol->next) {
+			if (strcmp(symbol->name, name) == 0) return symbol;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Declares a name in the current scope. Names declared in the outermost
+ * scope of the program are globals, and names that an inner lambda captures
+ * live in cells, so only the rest become SSA variables.
+ */
+static IrSymbol * _declare(Lowering * lowering, const char * name, IrStatement * declaration) {
+	IrFunction * function = lowering->function;
+	IrSymbol * symbol = calloc(1, sizeof(IrSymbol));
+	symbol->name = name;
+	symbol->owner = function;
+	symbol->variable = -1;
+	symbol->order = lowering->statement == NULL ? ++lowering->order : lowering->statement->order;
+	symbol->next = lowering->scope->symbols;
+	lowering->scope->symbols = symbol;
+	const boolean isGlobal = (function->isProgram && lowering->scope == function->scope) ? true : false;
+	if (isGlobal || _hasName(lowering->unsafeNames, lowering->unsafeCount, name)) return symbol;
+	for (int k = 0; k < lowering->boxedCount; ++k) {
+		if (strcmp(lowering->boxedNames[k], name) == 0) return symbol;
+	}
+	function->variables = _grow(function->variables, &function->variableCapacity, function->variableCount, sizeof(IrVariable));
+	IrVariable * variable = &function->variables[function->variableCount];
+	memset(variable, 0, sizeof(IrVariable));
+	variable->name = name;
+	variable->symbol = symbol;
+	variable->declaration = declaration;
+	symbol->variable = function->variableCount++;
+	return symbol;
+}
+
+static VisitAction _collectBoxedNames(void * state, void * node) {
+	Lowering * lowering = state;
+	Lambda * lambda = ((Expression *) node)->lambda;
+	if (lambda->captureList != NULL) {
+		for (Node * capture = lambda->captureList->first; capture != NULL; capture = capture->next) {
+			_addName(&lowering->boxedNames, &lowering->boxedCount, &lowering->boxedCapacity, ((Capture *) capture->data)->name);
+		}
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+static VisitAction _skipClass(void * state, void * node) {
+	return VISIT_SKIP_CHILDREN;
+}
+
+/**
+ * Collects the names captured by the lambdas created directly in the block,
+ * like the bytecode compiler does to decide which locals live in cells.
+ */
+static void _prepareBoxedNames(Lowering * lowering, Block * block) {
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "boxed names";
+	visitor.pre[LAMBDA_NODE] = _collectBoxedNames;
+	visitor.pre[CLASS_NODE] = _skipClass;
+	visitor.pre[INTERFACE_NODE] = _skipClass;
+	visitor.state = lowering;
+	Visitor * visitors[] = { &visitor };
+	walkBlock(block, visitors, 1);
+}
+
+/**
+ * Collects the name and the members of a class, which a method may reach
+ * without declaring them.
+ */
+static VisitAction _collectMembers(void * state, void * node) {
+	Lowering * lowering = state;
+	Class * class = ((Instruction *) node)->class;
+	_addName(&lowering->unsafeNames, &lowering->unsafeCount, &lowering->unsafeCapacity, class->object->name);
+	if (class->block != NULL) {
+		for (Node * member = class->block->first; member != NULL; member = member->next) {
+			Instruction * instruction = member->data;
+			if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+				_addName(&lowering->unsafeNames, &lowering->unsafeCount, &lowering->unsafeCapacity, instruction->assignment->name);
+			}
+			else if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+				_addName(&lowering->unsafeNames, &lowering->unsafeCount, &lowering->unsafeCapacity, instruction->variableDeclaration->name);
+			}
+		}
+	}
+	return VISIT_CHILDREN;
+}
+
+/* ------------------------------ SSA form -------------------------------- */
+
+static void _writeVariable(IrFunction * function, const int variable, IrBlock * block, IrValue * value) {
+	IrVariable * written = &function->variables[variable];
+	if (written->definitionCapacity <= block->id) {
+		const int capacity = function->blockCapacity;
+		written->definitions = realloc(written->definitions, capacity * sizeof(IrValue *));
+		memset(written->definitions + written->definitionCapacity, 0, (capacity - written->definitionCapacity) * sizeof(IrValue *));
+		written->definitionCapacity = capacity;
+	}
+	written->definitions[block->id] = value;
+}
+
+static IrValue * _readVariable(Lowering * lowering, const int variable, IrBlock * block) {
+	IrVariable * read = &lowering->function->variables[variable];
+	if (block->id < read->definitionCapacity && read->definitions[block->id] != NULL) {
+		return read->definitions[block->id];
+	}
+	return _readVariableRecursively(lowering, variable, block);
+}
+
+static IrValue * _newPhi(IrFunction * function, IrBlock * block, const int variable) {
+	IrValue * phi = _newValue(function, IR_PHI);
+	phi->variable = variable;
+	phi->block = block;
+	block->phis = _grow(block->phis, &block->phiCapacity, block->phiCount, sizeof(IrValue *));
+	block->phis[block->phiCount++] = phi;
+	return phi;
+}
+
+static IrValue * _undefined(IrFunction * function, IrBlock * block, const int variable) {
+	IrValue * value = _newPhi(function, block, variable);
+	value->opcode = IR_UNDEFINED;
+	value->type = IR_ANY_TYPE;
+	return value;
+}
+
+/**
+ * The definition of a variable at the end of a block without its own
+ * definition. Unsealed blocks get an incomplete phi, completed when all of
+ * their predecessors are known.
+ */
+static IrValue * _readVariableRecursively(Lowering * lowering, const int variable, IrBlock * block) {
+	IrFunction * function = lowering->function;
+	IrValue * value;
+	if (!block->isSealed) {
+		value = _newPhi(function, block, variable);
+		block->incompletePhis = _grow(block->incompletePhis, &block->incompletePhiCapacity, block->incompletePhiCount, sizeof(IrValue *));
+		block->incompletePhis[block->incompletePhiCount++] = value;
+	}
+	else if (block->predecessorCount == 1) {
+		value = _readVariable(lowering, variable, block->predecessors[0]);
+	}
+	else if (block->predecessorCount == 0) {
+		value = _undefined(function, block, variable);
+	}
+	else {
+		value = _newPhi(function, block, variable);
+		_writeVariable(function, variable, block, value);
+		value = _addPhiOperands(lowering, variable, value);
+	}
+	_writeVariable(function, variable, block, value);
+	return value;
+}
+
+static IrValue * _addPhiOperands(Lowering * lowering, const int variable, IrValue * phi) {
+	for (int k = 0; k < phi->block->predecessorCount; ++k) {
+		_addOperand(phi, _readVariable(lowering, variable, phi->block->predecessors[k]));
+	}
+	return _tryRemoveTrivialPhi(lowering->function, phi);
+}
+
+/**
+ * The value that a removed phi stands for. The copies of the assignments
+ * aren't followed, so every definition of the source code stays reachable
+ * from the phis that merge it.
+ */
+static IrValue * _through(IrValue * value) {
+	while (value->opcode == IR_COPY && value->statement == NULL && value->variable != -1) {
+		value = value->operands[0];
+	}
+	return value;
+}
+
+/**
+ * A phi that merges a single value (besides itself) becomes a copy of it.
+ */
+static IrValue * _tryRemoveTrivialPhi(IrFunction * function, IrValue * phi) {
+	IrValue * same = NULL;
+	for (int k = 0; k < phi->operandCount; ++k) {
+		IrValue * operand = _through(phi->operands[k]);
+		if (operand == same || operand == phi) continue;
+		if (same != NULL) return phi;
+		same = operand;
+	}
+	if (same == NULL) {
+		same = _undefined(function, phi->block, phi->variable);
+	}
+	phi->opcode = IR_COPY;
+	phi->operands[0] = same;
+	phi->operandCount = 1;
+	return phi;
+}
+
+static void _sealBlock(Lowering * lowering, IrBlock * block) {
+	for (int k = 0; k < block->incompletePhiCount; ++k) {
+		IrValue * phi = block->incompletePhis[k];
+		_addPhiOperands(lowering, phi->variable, phi);
+	}
+	block->incompletePhiCount = 0;
+	block->isSealed = true;
+}
+
+/**
+ * Removing a phi may turn the phis that use it into trivial ones.
+ */
+static void _removeTrivialPhis(IrFunction * function) {
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int b = 0; b < function->blockCount; ++b) {
+			IrBlock * block = function->blocks[b];
+			for (int k = 0; k < block->phiCount; ++k) {
+				IrValue * phi = block->phis[k];
+				if (phi->opcode == IR_PHI && _tryRemoveTrivialPhi(function, phi)->opcode == IR_COPY) {
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+/* ------------------------------- Lowering ------------------------------- */
+
+static void _assign(Lowering * lowering, IrSymbol * symbol, const char * name, IrValue * value) {
+	if (symbol != NULL && symbol->owner == lowering->function && symbol->variable != -1) {
+		IrValue * copy = _emitValue(lowering, IR_COPY, value, NULL);
+		copy->variable = symbol->variable;
+		copy->statement = lowering->statement;
+		_writeVariable(lowering->function, symbol->variable, lowering->current, copy);
+	}
+	else {
+		_emitValue(lowering, IR_STORE, value, NULL)->name = name;
+	}
+}
+
+/**
+ * Reads a name: an SSA variable (recorded as a site), or a load.
+ */
+static IrValue * _lowerName(Lowering * lowering, const char * name, const IrSiteType type, Factor * factor) {
+	IrSymbol * symbol = _resolve(lowering, name);
+	if (symbol != NULL && symbol->owner == lowering->function && symbol->variable != -1) {
+		const int site = _newSite(lowering, type, NULL, factor);
+		IrValue * value = _readVariable(lowering, symbol->variable, lowering->current);
+		lowering->function->sites[site].variable = symbol->variable;
+		_finishSite(lowering, site, value);
+		return value;
+	}
+	IrValue * value = _emitValue(lowering, IR_LOAD, NULL, NULL);
+	value->name = name;
+	return value;
+}
+
+static IrValue * _lowerConstant(Lowering * lowering, Constant * constant) {
+	IrValue * value = _emitValue(lowering, IR_CONSTANT, NULL, NULL);
+	switch (constant->type) {
+		case C_INT_TYPE:
+			value->type = IR_INTEGER_TYPE;
+			value->integer = constant->intValue;
+			break;
+		case C_DOUBLE_TYPE:
+			value->type = IR_DECIMAL_TYPE;
+			value->decimal = constant->doubleValue;
+			break;
+		case C_FLOAT_TYPE:
+			value->type = IR_DECIMAL_TYPE;
+			value->decimal = constant->floatValue;
+			break;
+		case C_BOOLEAN_TYPE:
+			value->type = IR_BOOLEAN_TYPE;
+			value->truth = constant->booleanValue;
+			break;
+		case C_CHAR_TYPE:
+		case C_STRING_TYPE:
+			value->type = IR_STRING_TYPE;
+			value->literal = constant;
+			break;
+	}
+	return value;
+}
+
+/**
+ * The initial value of a declaration without expression, as the bytecode
+ * compiler chooses it.
+ */
+static IrValue * _defaultValue(Lowering * lowering, const VariableType type) {
+	IrValue * value = _emitValue(lowering, IR_CONSTANT, NULL, NULL);
+	switch (type) {
+		case V_INT:
+		case V_LONG:
+		case V_SHORT:
+			value->type = IR_INTEGER_TYPE;
+			break;
+		case V_DOUBLE:
+		case V_FLOAT:
+			value->type = IR_DECIMAL_TYPE;
+			break;
+		case V_BOOLEAN:
+			value->type = IR_BOOLEAN_TYPE;
+			break;
+		case V_CHAR:
+		case V_STRING:
+			value->type = IR_STRING_TYPE;
+			break;
+		default:
+			value->opcode = IR_UNDEFINED;
+			value->type = IR_ANY_TYPE;
+			break;
+	}
+	return value;
+}
+
+/**
+ * The previous value of the variable is the value of the increment.
+ */
+static IrValue * _lowerIncrement(Lowering * lowering, const char * name, const IrOpcode opcode) {
+	IrValue * previous = _lowerName(lowering, name, IR_READ_SITE, NULL);
+	IrValue * one = _emitValue(lowering, IR_CONSTANT, NULL, NULL);
+	one->type = IR_INTEGER_TYPE;
+	one->integer = 1;
+	_assign(lowering, _resolve(lowering, name), name, _emitValue(lowering, opcode, previous, one));
+	return previous;
+}
+
+static IrValue * _lowerFactor(Lowering * lowering, Factor * factor) {
+	switch (factor->type) {
+		case VARIABLE_TYPE:
+			return _lowerName(lowering, factor->variable, IR_VARIABLE_SITE, factor);
+		case INCREMENT_TYPE:
+			return _lowerIncrement(lowering, factor->variable, IR_ADD);
+		case DECREMENT_TYPE:
+			return _lowerIncrement(lowering, factor->variable, IR_SUBTRACT);
+		case CONSTANT:
+			return _lowerConstant(lowering, factor->constant);
+		default:
+			return _lowerExpression(lowering, factor->expression);
+	}
+}
+
+/**
+ * Arithmetic and comparisons. A "greater" comparison is a "less" comparison
+ * with its operands swapped (after evaluating them in order).
+ */
+static IrValue * _lowerOperation(Lowering * lowering, Expression * expression) {
+	IrValue * left;
+	IrValue * right;
+	if (expression->type == ADDITION || expression->type == SUBTRACTION || expression->type == MULTIPLICATION || expression->type == DIVISION) {
+		left = _lowerExpression(lowering, expression->leftExpression);
+		right = _lowerExpression(lowering, expression->rightExpression);
+	}
+	else {
+		left = _lowerFactor(lowering, expression->leftFactor);
+		right = _lowerFactor(lowering, expression->rightFactor);
+	}
+	switch (expression->type) {
+		case ADDITION: return _emitValue(lowering, IR_ADD, left, right);
+		case SUBTRACTION: return _emitValue(lowering, IR_SUBTRACT, left, right);
+		case MULTIPLICATION: return _emitValue(lowering, IR_MULTIPLY, left, right);
+		case DIVISION: return _emitValue(lowering, IR_DIVIDE, left, right);
+		case LESS_TYPE: return _emitValue(lowering, IR_LESS, left, right);
+		case GREATER_TYPE: return _emitValue(lowering, IR_LESS, right, left);
+		case LESS_EQUAL_TYPE: return _emitValue(lowering, IR_LESS_EQUAL, left, right);
+		case GREATER_EQUAL_TYPE: return _emitValue(lowering, IR_LESS_EQUAL, right, left);
+		case EQUAL_EQUAL_TYPE: return _emitValue(lowering, IR_EQUAL, left, right);
+		default: return _emitValue(lowering, IR_NOT_EQUAL, left, right);
+	}
+}
+
+static IrValue * _lowerExpression(Lowering * lowering, Expression * expression) {
+	switch (expression->type) {
+		case FACTOR:
+			return _lowerFactor(lowering, expression->factor);
+		case FUNCTION_CALL: {
+			FunctionCall * functionCall = expression->functionCall;
+			IrValue * callee = _lowerName(lowering, functionCall->name, IR_READ_SITE, NULL);
+			IrValue ** arguments = NULL;
+			int argumentCount = 0;
+			int argumentCapacity = 0;
+			if (functionCall->expressionList != NULL) {
+				for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next) {
+					arguments = _grow(arguments, &argumentCapacity, argumentCount, sizeof(IrValue *));
+					arguments[argumentCount++] = _lowerExpression(lowering, node->data);
+				}
+			}
+			IrValue * call = _emitValue(lowering, IR_CALL, callee, NULL);
+			call->name = functionCall->name;
+			for (int k = 0; k < argumentCount; ++k) {
+				_addOperand(call, arguments[k]);
+			}
+			free(arguments);
+			return call;
+		}
+		case LAMBDA:
+			return _lowerDefinition(lowering, "lambda", expression);
+		default: {
+			const int site = _newSite(lowering, IR_EXPRESSION_SITE, expression, NULL);
+			const int parent = lowering->parentSite;
+			lowering->parentSite = site;
+			IrValue * value = _lowerOperation(lowering, expression);
+			lowering->parentSite = parent;
+			_finishSite(lowering, site, value);
+			return value;
+		}
+	}
+}
+
+/**
+ * The value assigned to a name. A lambda is lowered as a new function
+ * (named after the variable), that sees the names declared so far.
+ */
+static IrValue * _lowerDefinition(Lowering * lowering, const char * name, Expression * expression) {
+	if (expression->type != LAMBDA) {
+		return _lowerExpression(lowering, expression);
+	}
+	IrFunction * function = _lowerFunction(lowering, name, expression->lambda, expression->lambda->block, lowering->scope);
+	IrValue * value = _emitValue(lowering, IR_LAMBDA, NULL, NULL);
+	value->name = function->name;
+	return value;
+}
+
+static void _lowerBlock(Lowering * lowering, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_lowerInstruction(lowering, node->data, block);
+	}
+}
+
+static void _lowerScopedBlock(Lowering * lowering, Block * block) {
+	_pushScope(lowering);
+	_lowerBlock(lowering, block);
+	_popScope(lowering);
+}
+
+/**
+ * Every condition of an if/else-if chain is evaluated in its own block, and
+ * branches to the next condition (or to the join) when it's false.
+ */
+static void _lowerConditional(Lowering * lowering, Conditional * conditional) {
+	IrFunction * function = lowering->function;
+	IrBlock * join = _newBlock(function, false);
+	boolean hasElse = false;
+	for (; conditional != NULL; conditional = conditional->nextConditional) {
+		if (conditional->expression == NULL) {
+			_lowerScopedBlock(lowering, conditional->block);
+			_link(lowering, join);
+			hasElse = true;
+			break;
+		}
+		_emitValue(lowering, IR_BRANCH, _lowerExpression(lowering, conditional->expression), NULL);
+		IrBlock * branch = _newBlock(function, true);
+		IrBlock * otherwise = _newBlock(function, true);
+		_link(lowering, branch);
+		_link(lowering, otherwise);
+		lowering->current = branch;
+		_lowerScopedBlock(lowering, conditional->block);
+		_link(lowering, join);
+		lowering->current = otherwise;
+	}
+	if (!hasElse) {
+		_link(lowering, join);
+	}
+	_sealBlock(lowering, join);
+	lowering->current = join;
+}
+
+static boolean _isConstantlyTrue(Expression * expression) {
+	if (expression == NULL || expression->type != FACTOR || expression->factor->type != CONSTANT) return false;
+	Constant * constant = expression->factor->constant;
+	switch (constant->type) {
+		case C_BOOLEAN_TYPE: return constant->booleanValue;
+		case C_INT_TYPE: return constant->intValue != 0 ? true : false;
+		default: return false;
+	}
+}
+
+/**
+ * Loops evaluate their condition in a header block, which is also the target
+ * of every "pass" of the body. A for-in loop reads its collection once, in
+ * the preheader, and its header takes the next item.
+ */
+static void _lowerLoop(Lowering * lowering, Loop * loop) {
+	IrFunction * function = lowering->function;
+	IrLoop * irLoop = calloc(1, sizeof(IrLoop));
+	function->loops = _grow(function->loops, &function->loopCapacity, function->loopCount, sizeof(IrLoop *));
+	function->loops[function->loopCount++] = irLoop;
+	irLoop->statement = lowering->statement;
+	irLoop->parent = lowering->loop;
+	IrValue * collection = NULL;
+	if (loop->type == FOR_LOOP) {
+		collection = _lowerName(lowering, loop->collectionName, IR_READ_SITE, NULL);
+	}
+	irLoop->preheader = lowering->current;
+	irLoop->header = _newBlock(function, false);
+	_link(lowering, irLoop->header);
+	lowering->current = irLoop->header;
+	IrValue * condition = loop->type == FOR_LOOP
+		? _emitValue(lowering, IR_ITERATE, collection, NULL)
+		: _lowerExpression(lowering, loop->expression);
+	_emitValue(lowering, IR_BRANCH, condition, NULL);
+	IrBlock * body = _newBlock(function, true);
+	_link(lowering, body);
+	lowering->current = body;
+
+	lowering->loop = irLoop;
+	_pushScope(lowering);
+	if (loop->type == FOR_LOOP) {
+		_assign(lowering, _declare(lowering, loop->itemName, NULL), loop->itemName, condition);
+	}
+	_lowerBlock(lowering, loop->block);
+	_popScope(lowering);
+	lowering->loop = irLoop->parent;
+	_link(lowering, irLoop->header);
+	_sealBlock(lowering, irLoop->header);
+
+	irLoop->exit = _newBlock(function, false);
+	lowering->current = irLoop->header;
+	if (loop->type == FOR_LOOP || !_isConstantlyTrue(loop->expression)) {
+		_link(lowering, irLoop->exit);
+	}
+	_sealBlock(lowering, irLoop->exit);
+	lowering->current = irLoop->exit;
+}
+
+/**
+ * Methods are functions without enclosing scope, because they can't capture
+ * variables. The initializers of the fields aren't lowered.
+ */
+static void _lowerClass(Lowering * lowering, Class * class) {
+	if (class->block == NULL) return;
+	for (Node * node = class->block->first; node != NULL; node = node->next) {
+		Instruction * instruction = node->data;
+		if (instruction->type == INSTRUCTION_ASSIGNMENT && instruction->assignment->expression != NULL
+			&& instruction->assignment->expression->type == LAMBDA) {
+			Lambda * lambda = instruction->assignment->expression->lambda;
+			_lowerFunction(lowering, instruction->assignment->name, lambda, lambda->block, NULL);
+		}
+		else if (instruction->type == INSTRUCTION_CLASS) {
+			_lowerClass(lowering, instruction->class);
+		}
+	}
+}
+
+static void _lowerInstruction(Lowering * lowering, Instruction * instruction, Block * list) {
+	IrFunction * function = lowering->function;
+	IrStatement * statement = calloc(1, sizeof(IrStatement));
+	function->statements = _grow(function->statements, &function->statementCapacity, function->statementCount, sizeof(IrStatement *));
+	statement->id = function->statementCount;
+	function->statements[function->statementCount++] = statement;
+	statement->instruction = instruction;
+	statement->list = list;
+	statement->scope = lowering->scope;
+	statement->order = ++lowering->order;
+	statement->block = lowering->current;
+	statement->position = lowering->current->valueCount;
+	statement->isSimple = (list != NULL && (instruction->type == INSTRUCTION_ASSIGNMENT
+		|| instruction->type == INSTRUCTION_VARIABLE_DECLARATION || instruction->type == INSTRUCTION_EXPRESSION)) ? true : false;
+	IrStatement * enclosing = lowering->statement;
+	lowering->statement = statement;
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT: {
+			static const IrOpcode opcodes[] = { [ADD_ASSIGN_TYPE] = IR_ADD, [SUB_ASSIGN_TYPE] = IR_SUBTRACT, [MUL_ASSIGN_TYPE] = IR_MULTIPLY };
+			AssignmentOperation * assignment = instruction->assignment;
+			IrSymbol * symbol = _resolve(lowering, assignment->name);
+			if (assignment->assignmentOperator == ASSIGN_TYPE) {
+				if (symbol == NULL) {
+					symbol = _declare(lowering, assignment->name, statement);
+				}
+				_assign(lowering, symbol, assignment->name, _lowerDefinition(lowering, assignment->name, assignment->expression));
+			}
+			else if (symbol != NULL && symbol->owner == function && symbol->variable != -1) {
+				// The register of a local is read after evaluating the expression.
+				IrValue * right = _lowerExpression(lowering, assignment->expression);
+				IrValue * left = _lowerName(lowering, assignment->name, IR_READ_SITE, NULL);
+				_assign(lowering, symbol, assignment->name, _emitValue(lowering, opcodes[assignment->assignmentOperator], left, right));
+			}
+			else {
+				IrValue * left = _lowerName(lowering, assignment->name, IR_READ_SITE, NULL);
+				IrValue * right = _lowerExpression(lowering, assignment->expression);
+				_assign(lowering, symbol, assignment->name, _emitValue(lowering, opcodes[assignment->assignmentOperator], left, right));
+			}
+			break;
+		}
+		case INSTRUCTION_VARIABLE_DECLARATION: {
+			VariableDeclaration * variableDeclaration = instruction->variableDeclaration;
+			IrSymbol * symbol = _declare(lowering, variableDeclaration->name, statement);
+			IrValue * value = variableDeclaration->expression == NULL
+				? _defaultValue(lowering, variableDeclaration->type)
+				: _lowerDefinition(lowering, variableDeclaration->name, variableDeclaration->expression);
+			_assign(lowering, symbol, variableDeclaration->name, value);
+			break;
+		}
+		case INSTRUCTION_EXPRESSION:
+			_lowerExpression(lowering, instruction->expression);
+			break;
+		case INSTRUCTION_BLOCK:
+			_lowerScopedBlock(lowering, instruction->block);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			_lowerConditional(lowering, instruction->conditional);
+			break;
+		case INSTRUCTION_LOOP:
+			_lowerLoop(lowering, instruction->loop);
+			break;
+		case INSTRUCTION_CLASS:
+			_lowerClass(lowering, instruction->class);
+			break;
+		case INSTRUCTION_INTERFACE:
+			break;
+		case INSTRUCTION_RETURN: {
+			Instruction * returned = instruction->returnInstruction;
+			IrValue * value = NULL;
+			if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION) {
+				value = _lowerExpression(lowering, returned->expression);
+			}
+			else if (returned != NULL) {
+				_lowerInstruction(lowering, returned, NULL);
+			}
+			_emitValue(lowering, IR_RETURN, value, NULL);
+			_terminate(lowering, NULL);
+			break;
+		}
+		case INSTRUCTION_PASS:
+			if (lowering->loop != NULL) {
+				_terminate(lowering, lowering->loop->header);
+			}
+			break;
+	}
+	lowering->statement = enclosing;
+	statement->endPosition = statement->isSimple ? lowering->current->valueCount : statement->position;
+}
+
+static IrFunction * _lowerFunction(Lowering * lowering, const char * name, Lambda * lambda, Block * block, IrScope * parent) {
+	IrFunction * function = calloc(1, sizeof(IrFunction));
+	function->name = name;
+	function->lambda = lambda;
+	function->isProgram = lambda == NULL ? true : false;
+	*lowering->last = function;
+	lowering->last = &function->next;
+	lowering->program->functionCount += 1;
+
+	const Lowering enclosing = *lowering;
+	lowering->function = function;
+	lowering->statement = NULL;
+	lowering->loop = NULL;
+	lowering->order = 0;
+	lowering->parentSite = -1;
+	lowering->boxedNames = NULL;
+	lowering->boxedCount = 0;
+	lowering->boxedCapacity = 0;
+	lowering->scope = parent;
+	_prepareBoxedNames(lowering, block);
+	_pushScope(lowering);
+	function->scope = lowering->scope;
+	lowering->current = _newBlock(function, true);
+	if (lambda != NULL && lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			IrSymbol * symbol = _declare(lowering, parameter->name, NULL);
+			IrValue * value = _emitValue(lowering, IR_PARAMETER, NULL, NULL);
+			value->name = parameter->name;
+			if (symbol->variable == -1) {
+				_emitValue(lowering, IR_STORE, value, NULL)->name = parameter->name;
+			}
+			else {
+				value->variable = symbol->variable;
+				_writeVariable(function, symbol->variable, lowering->current, value);
+			}
+		}
+	}
+	_lowerBlock(lowering, block);
+	_removeTrivialPhis(function);
+	free(lowering->boxedNames);
+	IrFunction ** last = lowering->last;
+	*lowering = enclosing;
+	lowering->last = last;
+
+	_computeOrder(function);
+	_computeDominators(function);
+	inferTypes(function);
+	logDebugging(_logger, "IR of '%s': %d block(s), %d value(s), %d SSA variable(s).",
+		name, function->blockCount, function->valueCount, function->variableCount);
+	return function;
+}
+
+/* ------------------------------- Analyses ------------------------------- */
+
+/**
+ * Numbers the reachable blocks in reverse post-order, with an iterative
+ * depth-first search from the entry.
+ */
+static void _computeOrder(IrFunction * function) {
+	IrBlock ** stack = calloc(function->blockCount, sizeof(IrBlock *));
+	int * next = calloc(function->blockCount, sizeof(int));
+	IrBlock ** postorder = calloc(function->blockCount, sizeof(IrBlock *));
+	int depth = 0;
+	int count = 0;
+	stack[depth++] = function->blocks[0];
+	function->blocks[0]->order = -2;
+	while (0 < depth) {
+		IrBlock * block = stack[depth - 1];
+		if (next[block->id] < block->successorCount) {
+			IrBlock * successor = block->successors[next[block->id]++];
+			if (successor->order == -1) {
+				successor->order = -2;
+				stack[depth++] = successor;
+			}
+		}
+		else {
+			postorder[count++] = block;
+			--depth;
+		}
+	}
+	function->order = calloc(count, sizeof(IrBlock *));
+	function->orderCount = count;
+	for (int k = 0; k < count; ++k) {
+		function->order[k] = postorder[count - 1 - k];
+		function->order[k]->order = k;
+	}
+	free(postorder);
+	free(next);
+	free(stack);
+}
+
+static IrBlock * _intersect(IrBlock * a, IrBlock * b) {
+	while (a != b) {
+		while (a->order > b->order) a = a->dominator;
+		while (b->order > a->order) b = b->dominator;
+	}
+	return a;
+}
+
+/**
+ * The immediate dominators, with the algorithm of Cooper, Harvey and
+ * Kennedy ("A Simple, Fast Dominance Algorithm").
+ */
+static void _computeDominators(IrFunction * function) {
+	IrBlock * entry = function->blocks[0];
+	entry->dominator = entry;
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int k = 1; k < function->orderCount; ++k) {
+			IrBlock * block = function->order[k];
+			IrBlock * dominator = NULL;
+			for (int p = 0; p < block->predecessorCount; ++p) {
+				IrBlock * predecessor = block->predecessors[p];
+				if (predecessor->order < 0 || predecessor->dominator == NULL) continue;
+				dominator = dominator == NULL ? predecessor : _intersect(predecessor, dominator);
+			}
+			if (dominator != block->dominator) {
+				block->dominator = dominator;
+				changed = true;
+			}
+		}
+	}
+}
+
+static boolean _isNumeric(const IrType type) {
+	return (type == IR_INTEGER_TYPE || type == IR_DECIMAL_TYPE) ? true : false;
+}
+
+static IrType _join(const IrType left, const IrType right) {
+	if (left == IR_NO_TYPE) return right;
+	if (right == IR_NO_TYPE || left == right) return left;
+	return IR_ANY_TYPE;
+}
+
+/**
+ * Integers stay integers, mixing them with decimals produces decimals, and
+ * adding anything to a string concatenates them.
+ */
+static IrType _arithmeticType(const IrOpcode opcode, const IrType left, const IrType right) {
+	if (opcode == IR_ADD && (left == IR_STRING_TYPE || right == IR_STRING_TYPE)) return IR_STRING_TYPE;
+	if (left == IR_NO_TYPE || right == IR_NO_TYPE) return IR_NO_TYPE;
+	if (left == IR_INTEGER_TYPE && right == IR_INTEGER_TYPE) return IR_INTEGER_TYPE;
+	if (_isNumeric(left) && _isNumeric(right)) return IR_DECIMAL_TYPE;
+	return IR_ANY_TYPE;
+}
+
+static IrType _typeOf(IrValue * value) {
+	switch (value->opcode) {
+		case IR_CONSTANT:
+			return value->type;
+		case IR_COPY:
+			return value->operands[0]->type;
+		case IR_PHI: {
+			IrType type = IR_NO_TYPE;
+			for (int k = 0; k < value->operandCount; ++k) {
+				type = _join(type, value->operands[k]->type);
+			}
+			return type;
+		}
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_DIVIDE:
+			return _arithmeticType(value->opcode, value->operands[0]->type, value->operands[1]->type);
+		case IR_LESS:
+		case IR_LESS_EQUAL:
+		case IR_EQUAL:
+		case IR_NOT_EQUAL:
+			return IR_BOOLEAN_TYPE;
+		default:
+			return IR_ANY_TYPE;
+	}
+}
+
+static IrValue * _lastDefinition(IrBlock * block, const int variable, const int position) {
+	for (int k = position - 1; 0 <= k; --k) {
+		if (block->values[k]->variable == variable) return block->values[k];
+	}
+	for (int k = 0; k < block->phiCount; ++k) {
+		if (block->phis[k]->variable == variable) return block->phis[k];
+	}
+	return NULL;
+}
+
+/**
+ * The definitions of a variable that reach the start of every block, as a
+ * forward data-flow problem: a join only has a definition if every
+ * predecessor brings the same value.
+ */
+static void _computeReaching(IrFunction * function, const int variable) {
+	IrValue ** incoming = calloc(function->blockCount, sizeof(IrValue *));
+	IrValue ** outgoing = calloc(function->blockCount, sizeof(IrValue *));
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int k = 0; k < function->orderCount; ++k) {
+			IrBlock * block = function->order[k];
+			IrValue * in = k == 0 ? &_conflict : NULL;
+			for (int p = 0; p < block->predecessorCount; ++p) {
+				IrValue * definition = outgoing[block->predecessors[p]->id];
+				if (block->predecessors[p]->order < 0 || definition == NULL) continue;
+				if (in == NULL) {
+					in = definition;
+				}
+				else if (in != &_conflict && (definition == &_conflict || valueOf(in) != valueOf(definition))) {
+					in = &_conflict;
+				}
+			}
+			IrValue * last = _lastDefinition(block, variable, block->valueCount);
+			IrValue * out = last != NULL ? last : in;
+			if (incoming[block->id] != in || outgoing[block->id] != out) {
+				incoming[block->id] = in;
+				outgoing[block->id] = out;
+				changed = true;
+			}
+		}
+	}
+	free(outgoing);
+	function->variables[variable].reaching = incoming;
+}
+
+/* PUBLIC FUNCTIONS */
+
+IrProgram * lowerProgram(Program * program) {
+	IrProgram * irProgram = calloc(1, sizeof(IrProgram));
+	Lowering lowering;
+	memset(&lowering, 0, sizeof(Lowering));
+	lowering.program = irProgram;
+	lowering.last = &irProgram->first;
+	if (program->block != NULL) {
+		for (Node * node = program->block->first; node != NULL; node = node->next) {
+			Instruction * instruction = node->data;
+			if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+				_addName(&lowering.unsafeNames, &lowering.unsafeCount, &lowering.unsafeCapacity, instruction->assignment->name);
+			}
+			else if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+				_addName(&lowering.unsafeNames, &lowering.unsafeCount, &lowering.unsafeCapacity, instruction->variableDeclaration->name);
+			}
+		}
+	}
+	_addName(&lowering.unsafeNames, &lowering.unsafeCount, &lowering.unsafeCapacity, "this");
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "members";
+	visitor.pre[CLASS_NODE] = _collectMembers;
+	visitor.state = &lowering;
+	Visitor * visitors[] = { &visitor };
+	walkProgram(program, visitors, 1);
+	qsort(lowering.unsafeNames, lowering.unsafeCount, sizeof(const char *), _compareNames);
+
+	_lowerFunction(&lowering, "program", NULL, program->block, NULL);
+	free(lowering.unsafeNames);
+	return irProgram;
+}
+
+static void _releaseFunction(IrFunction * function) {
+	for (int k = 0; k < function->blockCount; ++k) {
+		IrBlock * block = function->blocks[k];
+		free(block->phis);
+		free(block->values);
+		free(block->predecessors);
+		free(block->successors);
+		free(block->incompletePhis);
+		free(block);
+	}
+	for (int k = 0; k < function->valueCount; ++k) {
+		free(function->values[k]->operands);
+		free(function->values[k]);
+	}
+	for (int k = 0; k < function->variableCount; ++k) {
+		free(function->variables[k].definitions);
+		free(function->variables[k].reaching);
+	}
+	for (int k = 0; k < function->statementCount; ++k) {
+		free(function->statements[k]);
+	}
+	for (int k = 0; k < function->loopCount; ++k) {
+		free(function->loops[k]);
+	}
+	while (function->scopes != NULL) {
+		IrScope * scope = function->scopes;
+		function->scopes = scope->allocated;
+		while (scope->symbols != NULL) {
+			IrSymbol * symbol = scope->symbols;
+			scope->symbols = symbol->next;
+			free(symbol);
+		}
+		free(scope);
+	}
+	free(function->blocks);
+	free(function->values);
+	free(function->variables);
+	free(function->statements);
+	free(function->sites);
+	free(function->loops);
+	free(function->order);
+	free(function);
+}
+
+void releaseIrProgram(IrProgram * program) {
+	if (program == NULL) return;
+	while (program->first != NULL) {
+		IrFunction * function = program->first;
+		program->first = function->next;
+		_releaseFunction(function);
+	}
+	free(program);
+}
+
+boolean dominates(const IrBlock * a, const IrBlock * b) {
+	if (a->order < 0 || b->order < 0) return false;
+	while (b != a) {
+		if (b->dominator == b) return false;
+		b = b->dominator;
+	}
+	return true;
+}
+
+boolean isOperation(const IrOpcode opcode) {
+	switch (opcode) {
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_DIVIDE:
+		case IR_LESS:
+		case IR_LESS_EQUAL:
+		case IR_EQUAL:
+		case IR_NOT_EQUAL:
+			return true;
+		default:
+			return false;
+	}
+}
+
+IrValue * valueOf(IrValue * value) {
+	while (value->forward != NULL) {
+		value = value->forward;
+	}
+	return value;
+}
+
+boolean isMovable(IrValue * value) {
+	switch (value->opcode) {
+		case IR_CONSTANT:
+		case IR_EQUAL:
+		case IR_NOT_EQUAL:
+			return true;
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_LESS:
+		case IR_LESS_EQUAL:
+			return (_isNumeric(value->operands[0]->type) && _isNumeric(value->operands[1]->type)) ? true : false;
+		case IR_DIVIDE: {
+			if (!_isNumeric(value->operands[0]->type) || !_isNumeric(value->operands[1]->type)) return false;
+			if (value->operands[0]->type == IR_DECIMAL_TYPE || value->operands[1]->type == IR_DECIMAL_TYPE) return true;
+			IrValue * divisor = valueOf(value->operands[1]);
+			return (divisor->opcode == IR_CONSTANT && divisor->integer != 0) ? true : false;
+		}
+		default:
+			return false;
+	}
+}
+
+boolean isInLoop(const IrLoop * loop, const IrBlock * block) {
+	return (loop->header->id <= block->id && block->id < loop->exit->id) ? true : false;
+}
+
+IrValue * reachingDefinition(IrFunction * function, const int variable, IrBlock * block, const int position) {
+	IrValue * last = _lastDefinition(block, variable, position);
+	if (last != NULL || block->order < 0) return last;
+	if (function->variables[variable].reaching == NULL) {
+		_computeReaching(function, variable);
+	}
+	IrValue * in = function->variables[variable].reaching[block->id];
+	return in == &_conflict ? NULL : in;
+}
+
+IrSymbol * resolveSymbol(IrScope * scope, const char * name, const int order) {
+	for (; scope != NULL; scope = scope->parent) {
+		for (IrSymbol * symbol = scope->symbols; symbol != NULL; symbol = symbol->next) {
+			if (symbol->order < order && strcmp(symbol->name, name) == 0) return symbol;
+		}
+	}
+	return NULL;
+}
+
+void inferTypes(IrFunction * function) {
+	for (int k = 0; k < function->valueCount; ++k) {
+		IrValue * value = function->values[k];
+		if (value->opcode != IR_CONSTANT) {
+			value->type = (value->block != NULL && 0 <= value->block->order) ? IR_NO_TYPE : IR_ANY_TYPE;
+		}
+	}
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int b = 0; b < function->orderCount; ++b) {
+			IrBlock * block = function->order[b];
+			for (int k = 0; k < block->phiCount + block->valueCount; ++k) {
+				IrValue * value = k < block->phiCount ? block->phis[k] : block->values[k - block->phiCount];
+				const IrType type = _typeOf(value);
+				if (type != value->type) {
+					value->type = type;
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+const char * irOpcodeName(const IrOpcode opcode) {
+	return opcode < IR_OPCODE_COUNT ? _opcodeNames[opcode] : "?";
+}
+
+/* --------------------------------- Dump --------------------------------- */
+
+static void _dumpValue(Emitter * emitter, IrFunction * function, IrValue * value, const char * note) {
+	emit(emitter, "\t\tv%d = %s", value->id, irOpcodeName(value->opcode));
+	for (int k = 0; k < value->operandCount; ++k) {
+		emit(emitter, "%s v%d", k == 0 ? "" : ",", valueOf(value->operands[k])->id);
+	}
+	if (value->opcode == IR_CONSTANT) {
+		switch (value->type) {
+			case IR_INTEGER_TYPE: emit(emitter, " %lld", (long long) value->integer); break;
+			case IR_DECIMAL_TYPE: emit(emitter, " %.17g", value->decimal); break;
+			case IR_BOOLEAN_TYPE: emit(emitter, " %s", value->truth ? "true" : "false"); break;
+			default:
+				if (value->literal != NULL && value->literal->type == C_STRING_TYPE) {
+					emit(emitter, " \"%s\"", value->literal->stringValue);
+				}
+				else if (value->literal != NULL) {
+					emit(emitter, " '%c'", value->literal->charValue);
+				}
+				else {
+					emit(emitter, " \"\"");
+				}
+				break;
+		}
+	}
+	if (value->name != NULL) {
+		emit(emitter, " %s", value->name);
+	}
+	if (value->variable != -1) {
+		emit(emitter, " [%s]", function->variables[value->variable].name);
+	}
+	emitLine(emitter, 0, " : %s%s", _typeNames[value->type], note);
+}
+
+/**
+ * Values replaced by others (or dead) aren't written, and the ones hoisted
+ * out of a loop are written at the end of its preheader.
+ */
+static void _dumpFunction(Emitter * emitter, IrFunction * function) {
+	emitLine(emitter, 0, "function %s (%d block(s), %d SSA variable(s))", function->name, function->blockCount, function->variableCount);
+	for (int b = 0; b < function->orderCount; ++b) {
+		IrBlock * block = function->order[b];
+		emit(emitter, "\tblock %d", block->id);
+		for (int k = 0; k < block->predecessorCount; ++k) {
+			emit(emitter, "%s%d", k == 0 ? " <- " : ", ", block->predecessors[k]->id);
+		}
+		if (block->dominator != NULL && block->dominator != block) {
+			emit(emitter, " (dominator %d)", block->dominator->id);
+		}
+		emitLine(emitter, 0, ":");
+		for (int k = 0; k < block->phiCount + block->valueCount; ++k) {
+			IrValue * value = k < block->phiCount ? block->phis[k] : block->values[k - block->phiCount];
+			if (value->isLive && value->forward == NULL && value->invariantIn == NULL) {
+				_dumpValue(emitter, function, value, "");
+			}
+		}
+		for (int l = 0; l < function->loopCount; ++l) {
+			if (function->loops[l]->preheader != block) continue;
+			for (int k = 0; k < function->valueCount; ++k) {
+				IrValue * value = function->values[k];
+				if (value->invariantIn == function->loops[l] && value->isLive && value->forward == NULL) {
+					_dumpValue(emitter, function, value, " (hoisted)");
+				}
+			}
+		}
+		for (int k = 0; k < block->successorCount; ++k) {
+			emit(emitter, "%s%d", k == 0 ? "\t\t-> " : ", ", block->successors[k]->id);
+		}
+		if (0 < block->successorCount) {
+			emitLine(emitter, 0, "");
+		}
+	}
+}
+
+void dumpIrProgram(Emitter * emitter, IrProgram * program) {
+	for (IrFunction * function = program->first; function != NULL; function = function->next) {
+		_dumpFunction(emitter, function);
+	}
+}
@@ -0,0 +1,311 @@
+#ifndef INTERMEDIATE_REPRESENTATION_HEADER
+#define INTERMEDIATE_REPRESENTATION_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/Visitor.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../Emitter.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeIntermediateRepresentationModule();
+
+/** Shutdown module's internal state. */
+void shutdownIntermediateRepresentationModule();
+
+/**
+ * The instructions of the IR, as OPCODE(name). Every instruction produces a
+ * value, even the ones executed only for their effects. A "greater" is a
+ * "less" with its operands swapped.
+ */
+#define IR_OPCODES(OPCODE) \
+	OPCODE(CONSTANT)		/* a literal */ \
+	OPCODE(PARAMETER)		/* the argument of a parameter (or its default) */ \
+	OPCODE(UNDEFINED)		/* a variable without definition, or nil */ \
+	OPCODE(PHI)				/* one operand per predecessor of the block */ \
+	OPCODE(COPY)			/* operand 0 */ \
+	OPCODE(ADD)				/* operand 0 + operand 1 */ \
+	OPCODE(SUBTRACT)		/* operand 0 - operand 1 */ \
+	OPCODE(MULTIPLY)		/* operand 0 * operand 1 */ \
+	OPCODE(DIVIDE)			/* operand 0 / operand 1 */ \
+	OPCODE(LESS)			/* operand 0 < operand 1 */ \
+	OPCODE(LESS_EQUAL)		/* operand 0 <= operand 1 */ \
+	OPCODE(EQUAL)			/* operand 0 == operand 1 */ \
+	OPCODE(NOT_EQUAL)		/* operand 0 != operand 1 */ \
+	OPCODE(LOAD)			/* the variable "name", outside of the function */ \
+	OPCODE(STORE)			/* the variable "name" = operand 0 */ \
+	OPCODE(CALL)			/* operand 0(operand 1, ..., operand N) */ \
+	OPCODE(LAMBDA)			/* a new closure of the function "name" */ \
+	OPCODE(ITERATE)			/* the next item of operand 0 (if any) */ \
+	OPCODE(BRANCH)			/* to successor 0 if operand 0 is truthy, or to successor 1 */ \
+	OPCODE(RETURN)			/* operand 0 */
+
+typedef enum {
+#define OPCODE(name) IR_##name,
+	IR_OPCODES(OPCODE)
+#undef OPCODE
+	IR_OPCODE_COUNT
+} IrOpcode;
+
+/**
+ * The types that a value may have at runtime, as a lattice: "no type" is the
+ * bottom (a value not computed yet), and "any type" the top.
+ */
+typedef enum {
+	IR_NO_TYPE,
+	IR_INTEGER_TYPE,
+	IR_DECIMAL_TYPE,
+	IR_BOOLEAN_TYPE,
+	IR_STRING_TYPE,
+	IR_ANY_TYPE
+} IrType;
+
+typedef struct IrBlock IrBlock;
+typedef struct IrFunction IrFunction;
+typedef struct IrLoop IrLoop;
+typedef struct IrScope IrScope;
+typedef struct IrStatement IrStatement;
+typedef struct IrSymbol IrSymbol;
+typedef struct IrValue IrValue;
+
+/**
+ * An SSA value. The definitions of a variable are the values that carry its
+ * index: the copies of the assignments, the phis, the parameters, and the
+ * undefined values. The passes never rewrite the operands: a value that
+ * turns out to be equal to another one forwards to it instead (see
+ * "valueOf"), so the operands keep the data flow of the source code.
+ */
+struct IrValue {
+	int id;
+	IrOpcode opcode;
+	IrType type;
+	IrBlock * block;
+	IrValue ** operands;
+	int operandCount;
+	int operandCapacity;
+	int variable;
+	const char * name;
+	int64_t integer;
+	double decimal;
+	boolean truth;
+	const Constant * literal;
+	IrStatement * statement;
+	IrValue * forward;
+	IrLoop * invariantIn;
+	boolean isLive;
+};
+
+/**
+ * A basic block. Phis (and the undefined values of the variables read before
+ * any definition) are kept apart from the rest, because they're created on
+ * demand, but they belong to the start of the block. The order is the
+ * reverse post-order number of the block, or -1 if it's unreachable.
+ */
+struct IrBlock {
+	int id;
+	IrValue ** phis;
+	int phiCount;
+	int phiCapacity;
+	IrValue ** values;
+	int valueCount;
+	int valueCapacity;
+	IrBlock ** predecessors;
+	int predecessorCount;
+	int predecessorCapacity;
+	IrBlock ** successors;
+	int successorCount;
+	int successorCapacity;
+	IrValue ** incompletePhis;
+	int incompletePhiCount;
+	int incompletePhiCapacity;
+	boolean isSealed;
+	int order;
+	IrBlock * dominator;
+};
+
+/**
+ * A while or a for-in loop. Its blocks are the ones created while lowering
+ * it, so they're numbered from the header to the exit (excluded). The
+ * preheader is the block that enters the loop.
+ */
+struct IrLoop {
+	IrStatement * statement;
+	IrBlock * preheader;
+	IrBlock * header;
+	IrBlock * exit;
+	IrLoop * parent;
+};
+
+/**
+ * A local variable kept in SSA form. Variables captured by an inner lambda,
+ * globals and members are accessed with loads and stores instead.
+ */
+typedef struct {
+	const char * name;
+	IrSymbol * symbol;
+	IrStatement * declaration;
+	IrValue ** definitions;
+	int definitionCapacity;
+	IrValue ** reaching;
+} IrVariable;
+
+/**
+ * A declared name, visible from the sites of its scope (and inner scopes)
+ * whose order is greater. The variable is -1 for names that aren't in SSA
+ * form.
+ */
+struct IrSymbol {
+	const char * name;
+	IrFunction * owner;
+	int variable;
+	int order;
+	IrSymbol * next;
+};
+
+struct IrScope {
+	IrScope * parent;
+	IrFunction * function;
+	IrSymbol * symbols;
+	IrScope * allocated;
+};
+
+/**
+ * An instruction of the source code, at the position of the block where it
+ * starts (the amount of values before it). Simple statements (assignments,
+ * declarations and expressions in a list) create values of a single block,
+ * up to the end position.
+ */
+struct IrStatement {
+	int id;
+	Instruction * instruction;
+	Block * list;
+	IrScope * scope;
+	int order;
+	IrBlock * block;
+	int position;
+	int endPosition;
+	boolean isSimple;
+};
+
+typedef enum {
+	IR_EXPRESSION_SITE,
+	IR_VARIABLE_SITE,
+	IR_READ_SITE
+} IrSiteType;
+
+/**
+ * A node of the source code that computes a value: an arithmetic expression
+ * or a comparison, or a read of an SSA variable. Read sites are the reads
+ * that can't be replaced: increments, compound assignments, callees and
+ * collections. Sites are numbered in pre-order, so the descendants of a
+ * site follow it, up to its end.
+ */
+typedef struct {
+	IrSiteType type;
+	Expression * expression;
+	Factor * factor;
+	IrValue * value;
+	int variable;
+	IrStatement * statement;
+	IrScope * scope;
+	int order;
+	IrBlock * block;
+	int position;
+	int endPosition;
+	int parent;
+	int end;
+} IrSite;
+
+/**
+ * The IR of a single function: the top-level code of the program, a lambda,
+ * or a method. Functions of the same program are chained in source order.
+ */
+struct IrFunction {
+	const char * name;
+	Lambda * lambda;
+	boolean isProgram;
+	IrScope * scope;
+	IrBlock ** blocks;
+	int blockCount;
+	int blockCapacity;
+	IrValue ** values;
+	int valueCount;
+	int valueCapacity;
+	IrVariable * variables;
+	int variableCount;
+	int variableCapacity;
+	IrStatement ** statements;
+	int statementCount;
+	int statementCapacity;
+	IrSite * sites;
+	int siteCount;
+	int siteCapacity;
+	IrLoop ** loops;
+	int loopCount;
+	int loopCapacity;
+	IrBlock ** order;
+	int orderCount;
+	IrScope * scopes;
+	IrFunction * next;
+};
+
+typedef struct {
+	IrFunction * first;
+	int functionCount;
+} IrProgram;
+
+/**
+ * Lowers every function of the program to SSA form, with the algorithm of
+ * Braun et al. ("Simple and Efficient Construction of Static Single
+ * Assignment Form"), and computes the reverse post-order, the dominators and
+ * the types of every function.
+ *
+ * Names resolve like in the bytecode compiler, but conservatively: a name
+ * that may also be a global or a member is never in SSA form.
+ */
+IrProgram * lowerProgram(Program * program);
+
+/** Releases the IR, which doesn't own any node of the AST. */
+void releaseIrProgram(IrProgram * program);
+
+/** Whether the block "a" dominates the block "b". */
+boolean dominates(const IrBlock * a, const IrBlock * b);
+
+/** Whether the opcode is an arithmetic operation or a comparison. */
+boolean isOperation(const IrOpcode opcode);
+
+/** The value after following every forward. */
+IrValue * valueOf(IrValue * value);
+
+/**
+ * Whether the value can be computed anywhere its operands are available:
+ * it has no effects, and it never fails.
+ */
+boolean isMovable(IrValue * value);
+
+/** Whether the loop contains the block. */
+boolean isInLoop(const IrLoop * loop, const IrBlock * block);
+
+/**
+ * The definition of the variable that reaches the position of the block, or
+ * NULL if the definitions of its predecessors have different values.
+ */
+IrValue * reachingDefinition(IrFunction * function, const int variable, IrBlock * block, const int position);
+
+/** The symbol that the name resolves to, at the order of the scope. */
+IrSymbol * resolveSymbol(IrScope * scope, const char * name, const int order);
+
+/** Recomputes the types of every value, from the constants. */
+void inferTypes(IrFunction * function);
+
+/** Writes the live values of every function, with their forwards applied. */
+void dumpIrProgram(Emitter * emitter, IrProgram * program);
+
+/** The name of the opcode, for the dump. */
+const char * irOpcodeName(const IrOpcode opcode);
+
+#endif
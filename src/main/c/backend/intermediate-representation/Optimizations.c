@@ -0,0 +1,371 @@
+#include "Optimizations.h"
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _fold(IrValue * value, IrValue * left, IrValue * right);
+static boolean _foldComparison(IrValue * value, IrValue * left, IrValue * right);
+static uint64_t _hashOperand(IrValue * operand);
+static boolean _isCommutative(const IrOpcode opcode);
+static boolean _isConstantInteger(IrValue * value, const int64_t integer);
+static void _makeBoolean(IrValue * value, const boolean truth);
+static void _makeDecimal(IrValue * value, const double decimal);
+static void _makeInteger(IrValue * value, const int64_t integer);
+static void _markLive(IrValue *** worklist, int * count, int * capacity, IrValue * value);
+static boolean _sameConstant(IrValue * left, IrValue * right);
+static boolean _sameOperand(IrValue * left, IrValue * right);
+static boolean _sameValue(IrValue * left, IrValue * right);
+static boolean _simplify(IrValue * value, IrValue * left, IrValue * right);
+static const char * _stringOf(IrValue * constant, char * character);
+
+static boolean _isCommutative(const IrOpcode opcode) {
+	return (opcode == IR_ADD || opcode == IR_MULTIPLY || opcode == IR_EQUAL || opcode == IR_NOT_EQUAL) ? true : false;
+}
+
+/**
+ * The text of a string constant. A character is a string of length 1, and
+ * the default value of a string is empty.
+ */
+static const char * _stringOf(IrValue * constant, char * character) {
+	if (constant->literal == NULL) return "";
+	if (constant->literal->type == C_STRING_TYPE) return constant->literal->stringValue;
+	character[0] = constant->literal->charValue;
+	character[1] = '\0';
+	return character;
+}
+
+static boolean _sameConstant(IrValue * left, IrValue * right) {
+	if (left->type != right->type) return false;
+	switch (left->type) {
+		case IR_INTEGER_TYPE:
+			return left->integer == right->integer ? true : false;
+		case IR_DECIMAL_TYPE:
+			return memcmp(&left->decimal, &right->decimal, sizeof(double)) == 0 ? true : false;
+		case IR_BOOLEAN_TYPE:
+			return left->truth == right->truth ? true : false;
+		default: {
+			char leftCharacter[2];
+			char rightCharacter[2];
+			return strcmp(_stringOf(left, leftCharacter), _stringOf(right, rightCharacter)) == 0 ? true : false;
+		}
+	}
+}
+
+/**
+ * Constants are compared by content, because every literal of the source
+ * code is a different value.
+ */
+static boolean _sameOperand(IrValue * left, IrValue * right) {
+	left = valueOf(left);
+	right = valueOf(right);
+	if (left == right) return true;
+	return (left->opcode == IR_CONSTANT && right->opcode == IR_CONSTANT && _sameConstant(left, right)) ? true : false;
+}
+
+static boolean _sameValue(IrValue * left, IrValue * right) {
+	if (left->opcode != right->opcode) return false;
+	if (_sameOperand(left->operands[0], right->operands[0]) && _sameOperand(left->operands[1], right->operands[1])) return true;
+	return (_isCommutative(left->opcode)
+		&& _sameOperand(left->operands[0], right->operands[1]) && _sameOperand(left->operands[1], right->operands[0])) ? true : false;
+}
+
+static uint64_t _hashOperand(IrValue * operand) {
+	operand = valueOf(operand);
+	if (operand->opcode != IR_CONSTANT) return (uint64_t) operand->id * 0x9E3779B97F4A7C15ULL;
+	uint64_t bits = 0;
+	switch (operand->type) {
+		case IR_INTEGER_TYPE: bits = (uint64_t) operand->integer; break;
+		case IR_DECIMAL_TYPE: memcpy(&bits, &operand->decimal, sizeof(double)); break;
+		case IR_BOOLEAN_TYPE: bits = operand->truth; break;
+		default: break;
+	}
+	return (bits ^ (uint64_t) operand->type << 56) * 0xC2B2AE3D27D4EB4FULL;
+}
+
+static void _makeInteger(IrValue * value, const int64_t integer) {
+	value->opcode = IR_CONSTANT;
+	value->type = IR_INTEGER_TYPE;
+	value->integer = integer;
+	value->operandCount = 0;
+}
+
+static void _makeDecimal(IrValue * value, const double decimal) {
+	value->opcode = IR_CONSTANT;
+	value->type = IR_DECIMAL_TYPE;
+	value->decimal = decimal;
+	value->operandCount = 0;
+}
+
+static void _makeBoolean(IrValue * value, const boolean truth) {
+	value->opcode = IR_CONSTANT;
+	value->type = IR_BOOLEAN_TYPE;
+	value->truth = truth;
+	value->operandCount = 0;
+}
+
+static boolean _isConstantInteger(IrValue * value, const int64_t integer) {
+	return (value->opcode == IR_CONSTANT && value->type == IR_INTEGER_TYPE && value->integer == integer) ? true : false;
+}
+
+static boolean _foldComparison(IrValue * value, IrValue * left, IrValue * right) {
+	const boolean areNumbers = ((left->type == IR_INTEGER_TYPE || left->type == IR_DECIMAL_TYPE)
+		&& (right->type == IR_INTEGER_TYPE || right->type == IR_DECIMAL_TYPE)) ? true : false;
+	if (value->opcode == IR_EQUAL || value->opcode == IR_NOT_EQUAL) {
+		boolean isEqual;
+		if (left->type == IR_INTEGER_TYPE && right->type == IR_INTEGER_TYPE) {
+			isEqual = left->integer == right->integer ? true : false;
+		}
+		else if (areNumbers) {
+			const double x = left->type == IR_INTEGER_TYPE ? (double) left->integer : left->decimal;
+			const double y = right->type == IR_INTEGER_TYPE ? (double) right->integer : right->decimal;
+			isEqual = x == y ? true : false;
+		}
+		else if (left->type != right->type) {
+			isEqual = false;
+		}
+		else {
+			isEqual = _sameConstant(left, right);
+		}
+		_makeBoolean(value, value->opcode == IR_EQUAL ? isEqual : !isEqual);
+		return true;
+	}
+	if (!areNumbers) return false;
+	int comparison;
+	if (left->type == IR_INTEGER_TYPE && right->type == IR_INTEGER_TYPE) {
+		comparison = left->integer < right->integer ? -1 : (left->integer == right->integer ? 0 : 1);
+	}
+	else {
+		const double x = left->type == IR_INTEGER_TYPE ? (double) left->integer : left->decimal;
+		const double y = right->type == IR_INTEGER_TYPE ? (double) right->integer : right->decimal;
+		if (x != x || y != y) {
+			_makeBoolean(value, false);
+			return true;
+		}
+		comparison = x < y ? -1 : (x == y ? 0 : 1);
+	}
+	_makeBoolean(value, (value->opcode == IR_LESS ? comparison < 0 : comparison <= 0) ? true : false);
+	return true;
+}
+
+/**
+ * Folds an operation of two constants, like the virtual machine computes it
+ * (integers wrap around). Operations that would fail at runtime aren't
+ * folded, so they still fail.
+ */
+static boolean _fold(IrValue * value, IrValue * left, IrValue * right) {
+	if (value->opcode != IR_ADD && value->opcode != IR_SUBTRACT && value->opcode != IR_MULTIPLY && value->opcode != IR_DIVIDE) {
+		return _foldComparison(value, left, right);
+	}
+	if (left->type == IR_INTEGER_TYPE && right->type == IR_INTEGER_TYPE) {
+		const uint64_t x = left->integer;
+		const uint64_t y = right->integer;
+		switch (value->opcode) {
+			case IR_ADD: _makeInteger(value, (int64_t) (x + y)); return true;
+			case IR_SUBTRACT: _makeInteger(value, (int64_t) (x - y)); return true;
+			case IR_MULTIPLY: _makeInteger(value, (int64_t) (x * y)); return true;
+			default:
+				if (right->integer == 0) return false;
+				_makeInteger(value, right->integer == -1 ? (int64_t) (0 - x) : left->integer / right->integer);
+				return true;
+		}
+	}
+	if ((left->type != IR_INTEGER_TYPE && left->type != IR_DECIMAL_TYPE) || (right->type != IR_INTEGER_TYPE && right->type != IR_DECIMAL_TYPE)) {
+		return false;
+	}
+	const double x = left->type == IR_INTEGER_TYPE ? (double) left->integer : left->decimal;
+	const double y = right->type == IR_INTEGER_TYPE ? (double) right->integer : right->decimal;
+	switch (value->opcode) {
+		case IR_ADD: _makeDecimal(value, x + y); break;
+		case IR_SUBTRACT: _makeDecimal(value, x - y); break;
+		case IR_MULTIPLY: _makeDecimal(value, x * y); break;
+		default: _makeDecimal(value, x / y); break;
+	}
+	return true;
+}
+
+/**
+ * The identities that hold for every integer. Decimals have none of them
+ * (e.g., "x * 0" is not 0 if x is NaN).
+ */
+static boolean _simplify(IrValue * value, IrValue * left, IrValue * right) {
+	if (left->type != IR_INTEGER_TYPE || right->type != IR_INTEGER_TYPE) return false;
+	switch (value->opcode) {
+		case IR_ADD:
+			if (_isConstantInteger(right, 0)) value->forward = left;
+			else if (_isConstantInteger(left, 0)) value->forward = right;
+			else return false;
+			return true;
+		case IR_SUBTRACT:
+			if (_isConstantInteger(right, 0)) value->forward = left;
+			else if (left == right) _makeInteger(value, 0);
+			else return false;
+			return true;
+		case IR_MULTIPLY:
+			if (_isConstantInteger(right, 1)) value->forward = left;
+			else if (_isConstantInteger(left, 1)) value->forward = right;
+			else if (_isConstantInteger(left, 0) || _isConstantInteger(right, 0)) _makeInteger(value, 0);
+			else return false;
+			return true;
+		case IR_DIVIDE:
+			if (!_isConstantInteger(right, 1)) return false;
+			value->forward = left;
+			return true;
+		default:
+			if (left != right) return false;
+			_makeBoolean(value, value->opcode == IR_LESS ? false : (value->opcode != IR_NOT_EQUAL));
+			return true;
+	}
+}
+
+static void _markLive(IrValue *** worklist, int * count, int * capacity, IrValue * value) {
+	value = valueOf(value);
+	if (value->isLive) return;
+	value->isLive = true;
+	if (*count == *capacity) {
+		*capacity = *capacity == 0 ? 8 : 2 * *capacity;
+		*worklist = realloc(*worklist, *capacity * sizeof(IrValue *));
+	}
+	(*worklist)[(*count)++] = value;
+}
+
+/* PUBLIC FUNCTIONS */
+
+int propagateCopies(IrFunction * function) {
+	int count = 0;
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int k = 0; k < function->valueCount; ++k) {
+			IrValue * value = function->values[k];
+			if (value->forward != NULL) continue;
+			IrValue * same = NULL;
+			if (value->opcode == IR_COPY) {
+				same = valueOf(value->operands[0]);
+			}
+			else if (value->opcode == IR_PHI) {
+				for (int o = 0; o < value->operandCount; ++o) {
+					IrValue * operand = valueOf(value->operands[o]);
+					if (operand == value || operand == same) continue;
+					if (same != NULL) {
+						same = NULL;
+						break;
+					}
+					same = operand;
+				}
+			}
+			if (same != NULL && same != value) {
+				value->forward = same;
+				changed = true;
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+int numberValues(IrFunction * function) {
+	int capacity = 16;
+	while (capacity < 2 * function->valueCount) {
+		capacity *= 2;
+	}
+	IrValue ** table = calloc(capacity, sizeof(IrValue *));
+	int count = 0;
+	for (int b = 0; b < function->orderCount; ++b) {
+		IrBlock * block = function->order[b];
+		for (int k = 0; k < block->valueCount; ++k) {
+			IrValue * value = block->values[k];
+			if (value->forward != NULL || !isOperation(value->opcode)) continue;
+			IrValue * left = valueOf(value->operands[0]);
+			IrValue * right = valueOf(value->operands[1]);
+			if (left->opcode == IR_CONSTANT && right->opcode == IR_CONSTANT && _fold(value, left, right)) {
+				++count;
+				continue;
+			}
+			if (_simplify(value, left, right)) {
+				++count;
+				continue;
+			}
+			const uint64_t hash = (uint64_t) value->opcode * 0xFF51AFD7ED558CCDULL + _hashOperand(left) + _hashOperand(right);
+			int slot = (int) ((hash ^ hash >> 29) & (capacity - 1));
+			for (; table[slot] != NULL; slot = (slot + 1) & (capacity - 1)) {
+				if (_sameValue(table[slot], value) && dominates(table[slot]->block, block)) {
+					value->forward = table[slot];
+					++count;
+					break;
+				}
+			}
+			if (value->forward == NULL) {
+				table[slot] = value;
+			}
+		}
+	}
+	free(table);
+	return count;
+}
+
+int hoistLoopInvariants(IrFunction * function) {
+	int count = 0;
+	for (int l = 0; l < function->loopCount; ++l) {
+		IrLoop * loop = function->loops[l];
+		if (loop->preheader->order < 0 || loop->header->order < 0) continue;
+		for (int b = 0; b < function->orderCount; ++b) {
+			IrBlock * block = function->order[b];
+			if (!isInLoop(loop, block)) continue;
+			for (int k = 0; k < block->valueCount; ++k) {
+				IrValue * value = block->values[k];
+				if (value->forward != NULL || value->invariantIn != NULL || !isOperation(value->opcode) || !isMovable(value)) continue;
+				boolean isInvariant = true;
+				for (int o = 0; o < value->operandCount && isInvariant; ++o) {
+					IrValue * operand = valueOf(value->operands[o]);
+					isInvariant = (operand->opcode == IR_CONSTANT || operand->invariantIn != NULL || !isInLoop(loop, operand->block)) ? true : false;
+				}
+				if (isInvariant) {
+					value->invariantIn = loop;
+					++count;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+int eliminateDeadCode(IrFunction * function) {
+	IrValue ** worklist = NULL;
+	int count = 0;
+	int capacity = 0;
+	for (int k = 0; k < function->valueCount; ++k) {
+		IrValue * value = function->values[k];
+		value->isLive = false;
+	}
+	for (int k = 0; k < function->valueCount; ++k) {
+		IrValue * value = function->values[k];
+		if (value->block == NULL || value->block->order < 0) continue;
+		switch (value->opcode) {
+			case IR_LOAD:
+			case IR_STORE:
+			case IR_CALL:
+			case IR_LAMBDA:
+			case IR_ITERATE:
+			case IR_BRANCH:
+			case IR_RETURN:
+				_markLive(&worklist, &count, &capacity, value);
+				break;
+			default:
+				break;
+		}
+	}
+	while (0 < count) {
+		IrValue * value = worklist[--count];
+		for (int o = 0; o < value->operandCount; ++o) {
+			_markLive(&worklist, &count, &capacity, value->operands[o]);
+		}
+	}
+	free(worklist);
+	int dead = 0;
+	for (int k = 0; k < function->valueCount; ++k) {
+		IrValue * value = function->values[k];
+		if (!value->isLive && value->forward == NULL && value->block != NULL && 0 <= value->block->order) {
+			++dead;
+		}
+	}
+	return dead;
+}
@@ -0,0 +1,55 @@
+#ifndef OPTIMIZATIONS_HEADER
+#define OPTIMIZATIONS_HEADER
+
+#include "../../shared/Type.h"
+#include "IntermediateRepresentation.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The passes over the IR of a function. None of them rewrites operands or
+ * removes values: they forward values to equivalent ones, turn values into
+ * constants, and mark the invariant and the live values, so the AST can be
+ * rewritten afterwards from the results.
+ */
+
+/**
+ * Copy propagation: forwards every copy to its operand, and every phi whose
+ * operands (other than itself) are a single value to that value.
+ *
+ * @return The amount of forwarded values.
+ */
+int propagateCopies(IrFunction * function);
+
+/**
+ * Global value numbering, in reverse post-order: a value with the same
+ * operation and operands as a value that dominates it forwards to it (even
+ * if it may fail, because that value has been computed without failing). It
+ * also folds the operations whose operands are constants (with the same
+ * semantics as the virtual machine), and simplifies the identities of
+ * integers (e.g., "x + 0" or "x - x").
+ *
+ * @return The amount of forwarded or folded values.
+ */
+int numberValues(IrFunction * function);
+
+/**
+ * Loop-invariant code motion: marks the arithmetic and the comparisons of a
+ * loop whose operands are computed outside of it (or are invariant too), so
+ * they're computed once, before the loop. Only movable values are marked,
+ * because a loop may run no iteration.
+ *
+ * @return The amount of invariant values.
+ */
+int hoistLoopInvariants(IrFunction * function);
+
+/**
+ * Dead-code elimination: marks the values that have effects, and the values
+ * that they use (through the forwards).
+ *
+ * @return The amount of dead values.
+ */
+int eliminateDeadCode(IrFunction * function);
+
+#endif
@@ -0,0 +1,717 @@
+#include "Optimizer.h"
+
+/* MODULE INTERNAL STATE */
+
+static int _temporaryCount = 0;
+static Logger * _logger = NULL;
+
+void initializeOptimizerModule() {
+	_logger = createLogger("Optimizer");
+}
+
+void shutdownOptimizerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** A read of a variable that the rewritten AST adds at a point of the IR. */
+typedef struct {
+	int variable;
+	IrBlock * block;
+	int position;
+} Read;
+
+/** A new variable that holds a value, visible from its scope after its order. */
+typedef struct {
+	const char * name;
+	IrScope * scope;
+	int order;
+} Temporary;
+
+typedef struct {
+	int constants;
+	int copies;
+	int hoisted;
+	int redundant;
+	int removed;
+} Statistics;
+
+/**
+ * The state of the rewrite of a function. Holders are the variables whose
+ * definitions have each value, indexed by value (in compressed rows). Sites
+ * are gone if an enclosing site has been replaced.
+ */
+typedef struct {
+	IrFunction * function;
+	int * holderStart;
+	int * holders;
+	int * occurrences;
+	boolean * isReplaced;
+	boolean * isGone;
+	Temporary * temporaries;
+	Read * reads;
+	int readCount;
+	int readCapacity;
+	Statistics * statistics;
+} Raising;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addRead(Raising * raising, const int variable, IrBlock * block, const int position);
+static boolean _canMaterialize(Raising * raising, const int site, IrStatement * statement);
+static Constant * _cloneConstant(const Constant * constant);
+static Expression * _cloneExpression(const Expression * expression);
+static Factor * _cloneFactor(const Factor * factor);
+static Factor * _constantFactor(IrValue * value);
+static boolean _hasRedundantSite(Raising * raising, const int site, IrValue * value, IrStatement * statement);
+static void _insertBefore(IrStatement * statement, Instruction * instruction);
+static boolean _isAssignedDirectly(IrSite * site);
+static boolean _isPure(IrBlock * block, const int from, const int to);
+static boolean _isRemovable(IrValue * value);
+static boolean _isRemovableRange(IrBlock * block, const int from, const int to);
+static boolean _isPureStatement(IrStatement * statement);
+static boolean _isRootScope(IrFunction * function, IrScope * scope);
+static boolean _isVisible(IrSite * site, IrScope * scope, const int order);
+static void _markDeclaration(IrFunction * function, const int variable, boolean * isLiveStatement, IrStatement *** statements, int * count, int * capacity);
+static void _markReaching(Raising * raising, const Read * read, boolean * isLiveValue, IrValue *** values, int * count, int * capacity);
+static void _markStatement(IrStatement * statement, boolean * isLiveStatement, IrStatement *** statements, int * count, int * capacity);
+static void _markValue(IrValue * value, boolean * isLiveValue, IrValue *** values, int * count, int * capacity);
+static Temporary * _newTemporary(Raising * raising, const int site, IrValue * value, IrStatement * statement);
+static void _raiseFunction(Raising * raising);
+static void _removeDeadStatements(Raising * raising);
+static void _removeInstruction(IrStatement * statement);
+static void _replaceSite(Raising * raising, const int site, Factor * factor);
+static boolean _replaceWithHolder(Raising * raising, const int site, IrValue * value);
+static Factor * _variableFactor(const char * name);
+
+/* ------------------------------- The AST -------------------------------- */
+
+static Constant * _cloneConstant(const Constant * constant) {
+	Constant * clone = calloc(1, sizeof(Constant));
+	*clone = *constant;
+	if (constant->type == C_STRING_TYPE) {
+		clone->stringValue = strdup(constant->stringValue);
+	}
+	return clone;
+}
+
+/**
+ * Clones a pure expression: arithmetic and comparisons of variables and
+ * constants.
+ */
+static Expression * _cloneExpression(const Expression * expression) {
+	Expression * clone = calloc(1, sizeof(Expression));
+	clone->type = expression->type;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			clone->leftExpression = _cloneExpression(expression->leftExpression);
+			clone->rightExpression = _cloneExpression(expression->rightExpression);
+			break;
+		case FACTOR:
+			clone->factor = _cloneFactor(expression->factor);
+			break;
+		default:
+			clone->leftFactor = _cloneFactor(expression->leftFactor);
+			clone->rightFactor = _cloneFactor(expression->rightFactor);
+			break;
+	}
+	return clone;
+}
+
+static Factor * _cloneFactor(const Factor * factor) {
+	Factor * clone = calloc(1, sizeof(Factor));
+	clone->type = factor->type;
+	switch (factor->type) {
+		case CONSTANT:
+			clone->constant = _cloneConstant(factor->constant);
+			break;
+		case EXPRESSION:
+			clone->expression = _cloneExpression(factor->expression);
+			break;
+		default:
+			clone->variable = strdup(factor->variable);
+			break;
+	}
+	return clone;
+}
+
+static Factor * _variableFactor(const char * name) {
+	Factor * factor = calloc(1, sizeof(Factor));
+	factor->type = VARIABLE_TYPE;
+	factor->variable = strdup(name);
+	return factor;
+}
+
+/**
+ * The constant of a value, if the AST can represent it: integers of the
+ * literals of the language, finite decimals, and booleans.
+ */
+static Factor * _constantFactor(IrValue * value) {
+	Constant constant;
+	switch (value->type) {
+		case IR_INTEGER_TYPE:
+			if (value->integer < INT_MIN || INT_MAX < value->integer) return NULL;
+			constant.type = C_INT_TYPE;
+			constant.intValue = (int) value->integer;
+			break;
+		case IR_DECIMAL_TYPE:
+			if (!isfinite(value->decimal)) return NULL;
+			constant.type = C_DOUBLE_TYPE;
+			constant.doubleValue = value->decimal;
+			break;
+		case IR_BOOLEAN_TYPE:
+			constant.type = C_BOOLEAN_TYPE;
+			constant.booleanValue = value->truth;
+			break;
+		default:
+			return NULL;
+	}
+	Factor * factor = calloc(1, sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = _cloneConstant(&constant);
+	return factor;
+}
+
+/**
+ * Replaces the node of a site in place (so its parent doesn't change), and
+ * releases the nodes below it.
+ */
+static void _replaceSite(Raising * raising, const int site, Factor * factor) {
+	IrSite * replaced = &raising->function->sites[site];
+	if (replaced->type == IR_EXPRESSION_SITE) {
+		Expression * expression = replaced->expression;
+		switch (expression->type) {
+			case ADDITION:
+			case DIVISION:
+			case MULTIPLICATION:
+			case SUBTRACTION:
+				releaseExpression(expression->leftExpression);
+				releaseExpression(expression->rightExpression);
+				break;
+			default:
+				releaseFactor(expression->leftFactor);
+				releaseFactor(expression->rightFactor);
+				break;
+		}
+		expression->type = FACTOR;
+		expression->factor = factor;
+	}
+	else {
+		releaseName(replaced->factor->variable);
+		*replaced->factor = *factor;
+		free(factor);
+	}
+	raising->isReplaced[site] = true;
+}
+
+static void _insertBefore(IrStatement * statement, Instruction * instruction) {
+	Node * node = calloc(1, sizeof(Node));
+	node->data = instruction;
+	Node ** link = &statement->list->first;
+	while ((*link)->data != statement->instruction) {
+		link = &(*link)->next;
+	}
+	node->next = *link;
+	*link = node;
+	statement->list->size += 1;
+}
+
+static void _removeInstruction(IrStatement * statement) {
+	Block * list = statement->list;
+	Node * previous = NULL;
+	Node * node = list->first;
+	while (node->data != statement->instruction) {
+		previous = node;
+		node = node->next;
+	}
+	if (previous == NULL) {
+		list->first = node->next;
+	}
+	else {
+		previous->next = node->next;
+	}
+	if (list->last == node) {
+		list->last = previous;
+	}
+	list->size -= 1;
+	free(node);
+	releaseInstruction(statement->instruction);
+}
+
+/* ------------------------------- Raising -------------------------------- */
+
+static boolean _isRootScope(IrFunction * function, IrScope * scope) {
+	return (function->isProgram && scope == function->scope) ? true : false;
+}
+
+/**
+ * Whether the site sees a name declared in the scope at the order.
+ */
+static boolean _isVisible(IrSite * site, IrScope * scope, const int order) {
+	if (site->order <= order) return false;
+	for (IrScope * inner = site->scope; inner != NULL; inner = inner->parent) {
+		if (inner == scope) return true;
+	}
+	return false;
+}
+
+/**
+ * Whether the values computed in the range of the block have no effects,
+ * although they may fail (so a copy of their nodes computes the same).
+ */
+static boolean _isPure(IrBlock * block, const int from, const int to) {
+	for (int k = from; k < to; ++k) {
+		IrValue * value = block->values[k];
+		if (value->opcode != IR_CONSTANT && !isOperation(value->opcode)) return false;
+	}
+	return true;
+}
+
+/**
+ * Whether the node that computes the value can be removed: it has no effects,
+ * and it never fails, or it has already been computed.
+ */
+static boolean _isRemovable(IrValue * value) {
+	if (value->opcode == IR_CONSTANT) return true;
+	return (isOperation(value->opcode) && (value->forward != NULL || isMovable(value))) ? true : false;
+}
+
+static boolean _isRemovableRange(IrBlock * block, const int from, const int to) {
+	for (int k = from; k < to; ++k) {
+		if (!_isRemovable(block->values[k])) return false;
+	}
+	return true;
+}
+
+static boolean _isPureStatement(IrStatement * statement) {
+	for (int k = statement->position; k < statement->endPosition; ++k) {
+		IrValue * value = statement->block->values[k];
+		if (value->opcode == IR_UNDEFINED || (value->opcode == IR_COPY && value->statement == statement)) continue;
+		if (!_isRemovable(value)) return false;
+	}
+	return true;
+}
+
+/**
+ * Whether the site is the whole value of an assignment, whose variable
+ * already holds it.
+ */
+static boolean _isAssignedDirectly(IrSite * site) {
+	if (site->parent != -1) return false;
+	const Instruction * instruction = site->statement->instruction;
+	if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+		return (instruction->assignment->assignmentOperator == ASSIGN_TYPE && instruction->assignment->expression == site->expression) ? true : false;
+	}
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		return instruction->variableDeclaration->expression == site->expression ? true : false;
+	}
+	return false;
+}
+
+static void _addRead(Raising * raising, const int variable, IrBlock * block, const int position) {
+	if (raising->readCount == raising->readCapacity) {
+		raising->readCapacity = raising->readCapacity == 0 ? 8 : 2 * raising->readCapacity;
+		raising->reads = realloc(raising->reads, raising->readCapacity * sizeof(Read));
+	}
+	raising->reads[raising->readCount++] = (Read) { variable, block, position };
+}
+
+/**
+ * Whether a copy of the site computes the same value before the statement:
+ * every variable of the site must resolve to the same symbol there, and hold
+ * the same value.
+ */
+static boolean _canMaterialize(Raising * raising, const int site, IrStatement * statement) {
+	IrFunction * function = raising->function;
+	for (int k = site + 1; k < function->sites[site].end; ++k) {
+		IrSite * inner = &function->sites[k];
+		if (inner->type == IR_READ_SITE) return false;
+		if (inner->type != IR_VARIABLE_SITE) continue;
+		IrSymbol * symbol = function->variables[inner->variable].symbol;
+		if (resolveSymbol(statement->scope, symbol->name, statement->order) != symbol) return false;
+		IrValue * definition = reachingDefinition(function, inner->variable, statement->block, statement->position);
+		if (definition == NULL || valueOf(definition) != valueOf(inner->value)) return false;
+	}
+	return true;
+}
+
+/**
+ * Assigns a copy of the site to a new variable, before the statement.
+ */
+static Temporary * _newTemporary(Raising * raising, const int site, IrValue * value, IrStatement * statement) {
+	IrFunction * function = raising->function;
+	char name[32];
+	snprintf(name, sizeof(name), "%d_t", _temporaryCount++);
+	AssignmentOperation * assignment = calloc(1, sizeof(AssignmentOperation));
+	assignment->name = strdup(name);
+	assignment->expression = _cloneExpression(function->sites[site].expression);
+	assignment->assignmentOperator = ASSIGN_TYPE;
+	Instruction * instruction = calloc(1, sizeof(Instruction));
+	instruction->type = INSTRUCTION_ASSIGNMENT;
+	instruction->assignment = assignment;
+	_insertBefore(statement, instruction);
+	for (int k = site + 1; k < function->sites[site].end; ++k) {
+		if (function->sites[k].type == IR_VARIABLE_SITE) {
+			_addRead(raising, function->sites[k].variable, statement->block, statement->position);
+		}
+	}
+	Temporary * temporary = &raising->temporaries[value->id];
+	temporary->name = assignment->name;
+	temporary->scope = statement->scope;
+	temporary->order = statement->order;
+	return temporary;
+}
+
+/**
+ * Whether a later site has the same value, and would see a new variable
+ * assigned before the statement.
+ */
+static boolean _hasRedundantSite(Raising * raising, const int site, IrValue * value, IrStatement * statement) {
+	IrFunction * function = raising->function;
+	if (raising->occurrences[value->id] < 2) return false;
+	for (int k = function->sites[site].end; k < function->siteCount; ++k) {
+		IrSite * other = &function->sites[k];
+		if (other->type == IR_EXPRESSION_SITE && other->value != NULL && 0 <= other->block->order
+			&& valueOf(other->value) == value && _isVisible(other, statement->scope, statement->order)
+			&& _isRemovableRange(other->block, other->position, other->endPosition)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Replaces the site with a variable that holds its value at that point. A
+ * variable is only replaced with the first variable that holds its value, so
+ * the copies between variables become dead.
+ */
+static boolean _replaceWithHolder(Raising * raising, const int site, IrValue * value) {
+	IrFunction * function = raising->function;
+	IrSite * replaced = &function->sites[site];
+	int end = raising->holderStart[value->id + 1];
+	if (replaced->type == IR_VARIABLE_SITE && raising->holderStart[value->id] < end) {
+		end = raising->holderStart[value->id] + 1;
+	}
+	for (int k = raising->holderStart[value->id]; k < end; ++k) {
+		const int variable = raising->holders[k];
+		if (variable == replaced->variable) continue;
+		IrSymbol * symbol = function->variables[variable].symbol;
+		if (resolveSymbol(replaced->scope, symbol->name, replaced->order) != symbol) continue;
+		IrValue * definition = reachingDefinition(function, variable, replaced->block, replaced->position);
+		if (definition == NULL || valueOf(definition) != value) continue;
+		_addRead(raising, variable, replaced->block, replaced->position);
+		_replaceSite(raising, site, _variableFactor(symbol->name));
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Rewrites the sites in pre-order, so a site is replaced before the sites
+ * below it, which are then gone. A site is only replaced if its nodes can be
+ * removed, and only arithmetic gets a new variable (comparisons are cheaper
+ * in a condition than in a variable).
+ */
+static void _raiseFunction(Raising * raising) {
+	IrFunction * function = raising->function;
+	for (int k = 0; k < function->siteCount; ++k) {
+		IrSite * site = &function->sites[k];
+		if (site->parent != -1 && (raising->isReplaced[site->parent] || raising->isGone[site->parent])) {
+			raising->isGone[k] = true;
+			continue;
+		}
+		if (site->type == IR_READ_SITE || site->block->order < 0) continue;
+		if (site->type == IR_EXPRESSION_SITE && !_isPure(site->block, site->position, site->endPosition)) continue;
+		IrValue * value = valueOf(site->value);
+		if (value->opcode == IR_UNDEFINED) continue;
+		const boolean isRemovable = _isRemovableRange(site->block, site->position, site->endPosition);
+		if (value->opcode == IR_CONSTANT) {
+			Factor * factor = isRemovable ? _constantFactor(value) : NULL;
+			if (factor != NULL) {
+				_replaceSite(raising, k, factor);
+				raising->statistics->constants += 1;
+			}
+			continue;
+		}
+		if (isRemovable && _replaceWithHolder(raising, k, value)) {
+			raising->statistics->copies += 1;
+			continue;
+		}
+		if (site->type != IR_EXPRESSION_SITE || value->opcode == IR_LESS || value->opcode == IR_LESS_EQUAL
+			|| value->opcode == IR_EQUAL || value->opcode == IR_NOT_EQUAL || !isOperation(value->opcode)) {
+			continue;
+		}
+		Temporary * temporary = &raising->temporaries[value->id];
+		if (temporary->name != NULL) {
+			if (isRemovable && _isVisible(site, temporary->scope, temporary->order)) {
+				_replaceSite(raising, k, _variableFactor(temporary->name));
+			}
+			continue;
+		}
+		IrLoop * loop = value->invariantIn;
+		if (loop != NULL && isInLoop(loop, site->block)) {
+			IrStatement * statement = loop->statement;
+			if (isRemovable && isMovable(value) && statement->list != NULL && !_isRootScope(function, statement->scope)
+				&& _canMaterialize(raising, k, statement)) {
+				temporary = _newTemporary(raising, k, value, statement);
+				_replaceSite(raising, k, _variableFactor(temporary->name));
+				raising->statistics->hoisted += 1;
+			}
+			continue;
+		}
+		// The first occurrence moves to the start of its statement, after values that can't fail.
+		IrStatement * statement = site->statement;
+		if (value == site->value && statement->list != NULL && statement->block == site->block && !_isAssignedDirectly(site)
+			&& !_isRootScope(function, statement->scope) && _isRemovableRange(statement->block, statement->position, site->position)
+			&& _hasRedundantSite(raising, k, value, statement) && _canMaterialize(raising, k, statement)) {
+			temporary = _newTemporary(raising, k, value, statement);
+			_replaceSite(raising, k, _variableFactor(temporary->name));
+			raising->statistics->redundant += 1;
+		}
+	}
+}
+
+/* ------------------------- Dead-code elimination ------------------------- */
+
+static void _markValue(IrValue * value, boolean * isLiveValue, IrValue *** values, int * count, int * capacity) {
+	if (isLiveValue[value->id]) return;
+	isLiveValue[value->id] = true;
+	if (*count == *capacity) {
+		*capacity = *capacity == 0 ? 8 : 2 * *capacity;
+		*values = realloc(*values, *capacity * sizeof(IrValue *));
+	}
+	(*values)[(*count)++] = value;
+}
+
+static void _markStatement(IrStatement * statement, boolean * isLiveStatement, IrStatement *** statements, int * count, int * capacity) {
+	if (isLiveStatement[statement->id]) return;
+	isLiveStatement[statement->id] = true;
+	if (*count == *capacity) {
+		*capacity = *capacity == 0 ? 8 : 2 * *capacity;
+		*statements = realloc(*statements, *capacity * sizeof(IrStatement *));
+	}
+	(*statements)[(*count)++] = statement;
+}
+
+/**
+ * The declaration of a variable stays while the variable is used, so no
+ * later assignment declares it instead.
+ */
+static void _markDeclaration(IrFunction * function, const int variable, boolean * isLiveStatement, IrStatement *** statements, int * count, int * capacity) {
+	if (variable != -1 && function->variables[variable].declaration != NULL) {
+		_markStatement(function->variables[variable].declaration, isLiveStatement, statements, count, capacity);
+	}
+}
+
+/**
+ * Marks every definition that reaches a read, walking back on every path.
+ */
+static void _markReaching(Raising * raising, const Read * read, boolean * isLiveValue, IrValue *** values, int * count, int * capacity) {
+	IrFunction * function = raising->function;
+	boolean * isVisited = calloc(function->blockCount, sizeof(boolean));
+	IrBlock ** pending = calloc(function->blockCount + 1, sizeof(IrBlock *));
+	int pendingCount = 0;
+	IrBlock * block = read->block;
+	int position = read->position;
+	while (block != NULL) {
+		IrValue * definition = NULL;
+		for (int k = position - 1; 0 <= k && definition == NULL; --k) {
+			if (block->values[k]->variable == read->variable) {
+				definition = block->values[k];
+			}
+		}
+		for (int k = 0; k < block->phiCount && definition == NULL; ++k) {
+			if (block->phis[k]->variable == read->variable) {
+				definition = block->phis[k];
+			}
+		}
+		if (definition != NULL) {
+			_markValue(definition, isLiveValue, values, count, capacity);
+		}
+		else {
+			for (int k = 0; k < block->predecessorCount; ++k) {
+				IrBlock * predecessor = block->predecessors[k];
+				if (!isVisited[predecessor->id]) {
+					isVisited[predecessor->id] = true;
+					pending[pendingCount++] = predecessor;
+				}
+			}
+		}
+		block = 0 < pendingCount ? pending[--pendingCount] : NULL;
+		position = block == NULL ? 0 : block->valueCount;
+	}
+	free(pending);
+	free(isVisited);
+}
+
+/**
+ * Removes the simple statements without effects, whose definitions are
+ * never read. The roots are the statements with effects, and the reads that
+ * the rewrite added.
+ */
+static void _removeDeadStatements(Raising * raising) {
+	IrFunction * function = raising->function;
+	boolean * isLiveValue = calloc(function->valueCount, sizeof(boolean));
+	boolean * isLiveStatement = calloc(function->statementCount, sizeof(boolean));
+	int * siteStart = calloc(function->statementCount + 1, sizeof(int));
+	int * sites = calloc(function->siteCount + 1, sizeof(int));
+	int * definitionStart = calloc(function->statementCount + 1, sizeof(int));
+	IrValue ** definitions = calloc(function->valueCount + 1, sizeof(IrValue *));
+	for (int k = 0; k < function->siteCount; ++k) {
+		siteStart[function->sites[k].statement->id + 1] += 1;
+	}
+	for (int k = 0; k < function->valueCount; ++k) {
+		if (function->values[k]->statement != NULL && function->values[k]->variable != -1) {
+			definitionStart[function->values[k]->statement->id + 1] += 1;
+		}
+	}
+	for (int k = 0; k < function->statementCount; ++k) {
+		siteStart[k + 1] += siteStart[k];
+		definitionStart[k + 1] += definitionStart[k];
+	}
+	int * siteFill = calloc(function->statementCount, sizeof(int));
+	for (int k = 0; k < function->siteCount; ++k) {
+		const int id = function->sites[k].statement->id;
+		sites[siteStart[id] + siteFill[id]++] = k;
+	}
+	memset(siteFill, 0, function->statementCount * sizeof(int));
+	for (int k = 0; k < function->valueCount; ++k) {
+		IrValue * value = function->values[k];
+		if (value->statement != NULL && value->variable != -1) {
+			definitions[definitionStart[value->statement->id] + siteFill[value->statement->id]++] = value;
+		}
+	}
+	free(siteFill);
+
+	IrValue ** values = NULL;
+	int valueCount = 0;
+	int valueCapacity = 0;
+	IrStatement ** statements = NULL;
+	int statementCount = 0;
+	int statementCapacity = 0;
+	for (int k = 0; k < function->statementCount; ++k) {
+		IrStatement * statement = function->statements[k];
+		if (!statement->isSimple || statement->block->order < 0 || !_isPureStatement(statement)) {
+			_markStatement(statement, isLiveStatement, &statements, &statementCount, &statementCapacity);
+		}
+	}
+	for (int k = 0; k < raising->readCount; ++k) {
+		_markReaching(raising, &raising->reads[k], isLiveValue, &values, &valueCount, &valueCapacity);
+	}
+	while (0 < valueCount || 0 < statementCount) {
+		if (0 < statementCount) {
+			IrStatement * statement = statements[--statementCount];
+			for (int k = siteStart[statement->id]; k < siteStart[statement->id + 1]; ++k) {
+				IrSite * site = &function->sites[sites[k]];
+				if (site->type == IR_EXPRESSION_SITE || raising->isGone[sites[k]] || raising->isReplaced[sites[k]]) continue;
+				_markValue(site->value, isLiveValue, &values, &valueCount, &valueCapacity);
+				_markDeclaration(function, site->variable, isLiveStatement, &statements, &statementCount, &statementCapacity);
+			}
+			for (int k = definitionStart[statement->id]; k < definitionStart[statement->id + 1]; ++k) {
+				_markDeclaration(function, definitions[k]->variable, isLiveStatement, &statements, &statementCount, &statementCapacity);
+			}
+			continue;
+		}
+		IrValue * value = values[--valueCount];
+		if (value->opcode == IR_PHI || (value->opcode == IR_COPY && value->statement == NULL)) {
+			for (int k = 0; k < value->operandCount; ++k) {
+				_markValue(value->operands[k], isLiveValue, &values, &valueCount, &valueCapacity);
+			}
+		}
+		if (value->statement != NULL) {
+			_markStatement(value->statement, isLiveStatement, &statements, &statementCount, &statementCapacity);
+		}
+		_markDeclaration(function, value->variable, isLiveStatement, &statements, &statementCount, &statementCapacity);
+	}
+	for (int k = 0; k < function->statementCount; ++k) {
+		if (!isLiveStatement[k]) {
+			_removeInstruction(function->statements[k]);
+			raising->statistics->removed += 1;
+		}
+	}
+	free(statements);
+	free(values);
+	free(definitions);
+	free(definitionStart);
+	free(sites);
+	free(siteStart);
+	free(isLiveStatement);
+	free(isLiveValue);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void optimizeProgram(Program * program, Emitter * dump) {
+	IrProgram * irProgram = lowerProgram(program);
+	int copies = 0;
+	int numbered = 0;
+	int invariants = 0;
+	int dead = 0;
+	for (IrFunction * function = irProgram->first; function != NULL; function = function->next) {
+		copies += propagateCopies(function);
+		numbered += numberValues(function);
+		inferTypes(function);
+		copies += propagateCopies(function);
+		invariants += hoistLoopInvariants(function);
+		dead += eliminateDeadCode(function);
+	}
+	if (dump != NULL) {
+		dumpIrProgram(dump, irProgram);
+		flushEmitter(dump);
+	}
+	Statistics statistics;
+	memset(&statistics, 0, sizeof(Statistics));
+	for (IrFunction * function = irProgram->first; function != NULL; function = function->next) {
+		Raising raising;
+		memset(&raising, 0, sizeof(Raising));
+		raising.function = function;
+		raising.statistics = &statistics;
+		raising.holderStart = calloc(function->valueCount + 1, sizeof(int));
+		raising.holders = calloc(function->valueCount + 1, sizeof(int));
+		raising.occurrences = calloc(function->valueCount, sizeof(int));
+		raising.isReplaced = calloc(function->siteCount + 1, sizeof(boolean));
+		raising.isGone = calloc(function->siteCount + 1, sizeof(boolean));
+		raising.temporaries = calloc(function->valueCount, sizeof(Temporary));
+		for (int k = 0; k < function->valueCount; ++k) {
+			IrValue * value = function->values[k];
+			if (value->variable != -1 && value->block != NULL && 0 <= value->block->order) {
+				raising.holderStart[valueOf(value)->id + 1] += 1;
+			}
+		}
+		for (int k = 0; k < function->valueCount; ++k) {
+			raising.holderStart[k + 1] += raising.holderStart[k];
+		}
+		int * fill = calloc(function->valueCount + 1, sizeof(int));
+		for (int k = 0; k < function->valueCount; ++k) {
+			IrValue * value = function->values[k];
+			if (value->variable != -1 && value->block != NULL && 0 <= value->block->order) {
+				const int id = valueOf(value)->id;
+				raising.holders[raising.holderStart[id] + fill[id]++] = value->variable;
+			}
+		}
+		free(fill);
+		for (int k = 0; k < function->siteCount; ++k) {
+			if (function->sites[k].type == IR_EXPRESSION_SITE) {
+				raising.occurrences[valueOf(function->sites[k].value)->id] += 1;
+			}
+		}
+		_raiseFunction(&raising);
+		_removeDeadStatements(&raising);
+		free(raising.reads);
+		free(raising.temporaries);
+		free(raising.isGone);
+		free(raising.isReplaced);
+		free(raising.occurrences);
+		free(raising.holders);
+		free(raising.holderStart);
+	}
+	logDebugging(_logger, "IR of %d function(s): %d copies propagated, %d values numbered or folded, %d invariant(s), %d dead value(s).",
+		irProgram->functionCount, copies, numbered, invariants, dead);
+	logDebugging(_logger, "AST: %d constant(s), %d copies, %d hoisted, %d redundant, %d statement(s) removed.",
+		statistics.constants, statistics.copies, statistics.hoisted, statistics.redundant, statistics.removed);
+	releaseIrProgram(irProgram);
+}
@@ -0,0 +1,43 @@
+#ifndef OPTIMIZER_HEADER
+#define OPTIMIZER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../Emitter.h"
+#include "IntermediateRepresentation.h"
+#include "Optimizations.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeOptimizerModule();
+
+/** Shutdown module's internal state. */
+void shutdownOptimizerModule();
+
+/**
+ * Optimizes an analyzed program before any backend runs: lowers it to SSA
+ * form, runs copy propagation, global value numbering (with constant
+ * folding), loop-invariant code motion and dead-code elimination over every
+ * function, and then rewrites the AST from the results, so every backend
+ * consumes the optimized program:
+ *
+ *	- expressions with a constant value become constants,
+ *	- expressions (and variables) whose value is already held by another
+ *	  variable read that variable instead,
+ *	- invariant arithmetic is computed once, in a new variable assigned
+ *	  before the loop, and redundant arithmetic in a new variable assigned
+ *	  before its first occurrence, and
+ *	- assignments, declarations and expressions without effects, whose
+ *	  values are never read, are removed.
+ *
+ * The new variables are named "<n>_t", which no identifier can collide with.
+ * If the emitter isn't NULL, it also writes the optimized IR to it.
+ */
+void optimizeProgram(Program * program, Emitter * dump);
+
+#endif
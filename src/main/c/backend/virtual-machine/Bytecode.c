@@ -0,0 +1,235 @@
+#include "Bytecode.h"
+
+/* MODULE INTERNAL STATE */
+
+static const char * const _names[OPCODE_COUNT] = {
+#define OPCODE(name, format) [OP_##name] = #name,
+	OPCODES(OPCODE)
+#undef OPCODE
+};
+
+static const OperandFormat _formats[OPCODE_COUNT] = {
+#define OPCODE(name, format) [OP_##name] = FORMAT_##format,
+	OPCODES(OPCODE)
+#undef OPCODE
+};
+
+static const struct {
+	Opcode superinstruction;
+	Opcode first;
+	Opcode second;
+} _superinstructions[] = {
+#define SUPERINSTRUCTION(unused, name, first, second, format) { OP_##name, OP_##first, OP_##second },
+	SUPERINSTRUCTIONS(SUPERINSTRUCTION, _)
+#undef SUPERINSTRUCTION
+	{ OPCODE_COUNT, OPCODE_COUNT, OPCODE_COUNT }
+};
+
+/* PRIVATE FUNCTIONS */
+
+static void _disassembleInstruction(Emitter * emitter, const Prototype * prototype, const int index);
+static void _disassemblePrototype(Emitter * emitter, const Prototype * prototype);
+static Opcode _firstOpcode(const Opcode opcode);
+static void _fusePrototype(Prototype * prototype);
+
+static void _disassembleInstruction(Emitter * emitter, const Prototype * prototype, const int index) {
+	const BytecodeInstruction instruction = prototype->code[index];
+	emit(emitter, "  %4d  %-20s", index, opcodeName(instruction.opcode));
+	switch (opcodeFormat(instruction.opcode)) {
+		case FORMAT_NONE:
+			break;
+		case FORMAT_A:
+			emit(emitter, " %d", instruction.a);
+			break;
+		case FORMAT_AB:
+			emit(emitter, " %d %d", instruction.a, instruction.b);
+			break;
+		case FORMAT_ABC:
+			emit(emitter, " %d %d %d", instruction.a, instruction.b, instruction.c);
+			break;
+		case FORMAT_ABSC:
+			emit(emitter, " %d %d %d", instruction.a, instruction.b, (int8_t) instruction.c);
+			break;
+		case FORMAT_ABX:
+			emit(emitter, " %d %d", instruction.a, instruction.bx);
+			break;
+		case FORMAT_ASBX:
+			if (instruction.opcode == OP_LOADINT || _firstOpcode(instruction.opcode) == OP_LOADINT) {
+				emit(emitter, " %d %d", instruction.a, instruction.sbx);
+			}
+			else {
+				emit(emitter, " %d %d\t; to %d", instruction.a, instruction.sbx, index + 1 + instruction.sbx);
+			}
+			break;
+		case FORMAT_SBX:
+			emit(emitter, " %d\t; to %d", instruction.sbx, index + 1 + instruction.sbx);
+			break;
+	}
+	emitText(emitter, "\n", 1);
+}
+
+static void _disassemblePrototype(Emitter * emitter, const Prototype * prototype) {
+	emit(emitter, "%s: %d parameter(s)%s, %d register(s), %d instruction(s)\n", prototype->name,
+		prototype->parameterCount, prototype->hasReceiver ? " and a receiver" : "", prototype->registerCount, prototype->codeSize);
+	for (int k = 0; k < prototype->constantCount; ++k) {
+		emit(emitter, "  K[%d] = ", k);
+		printValue(emitter, prototype->constants[k]);
+		emitText(emitter, "\n", 1);
+	}
+	for (int k = 0; k < prototype->captureCount; ++k) {
+		emit(emitter, "  C[%d] = %s (%s %s %d)\n", k, prototype->captures[k].name, prototype->captures[k].isShared ? "shared" : "copied",
+			prototype->captures[k].source == CAPTURE_FROM_LOCAL ? "register" : "capture", prototype->captures[k].index);
+	}
+	for (int k = 0; k < prototype->invokeSiteCount; ++k) {
+		emit(emitter, "  S[%d] = %s (slot %d of %s%s)\n", k, prototype->invokeSites[k].name,
+			prototype->invokeSites[k].slot, prototype->invokeSites[k].class->name, prototype->invokeSites[k].method == NULL ? "" : ", direct");
+	}
+	for (int k = 0; k < prototype->codeSize; ++k) {
+		_disassembleInstruction(emitter, prototype, k);
+	}
+	for (int k = 0; k < prototype->prototypeCount; ++k) {
+		_disassemblePrototype(emitter, prototype->prototypes[k]);
+	}
+}
+
+/** The first opcode of a superinstruction, or OPCODE_COUNT if it's not one. */
+static Opcode _firstOpcode(const Opcode opcode) {
+	for (int k = 0; _superinstructions[k].superinstruction != OPCODE_COUNT; ++k) {
+		if (_superinstructions[k].superinstruction == opcode) {
+			return _superinstructions[k].first;
+		}
+	}
+	return OPCODE_COUNT;
+}
+
+/**
+ * The second instruction of a pair may also start another pair, since it
+ * keeps its own opcode for the superinstruction that precedes it.
+ */
+static void _fusePrototype(Prototype * prototype) {
+	for (int k = 0; k + 1 < prototype->codeSize; ++k) {
+		const Opcode superinstruction = superinstructionOf(prototype->code[k].opcode, prototype->code[k + 1].opcode);
+		if (superinstruction != OPCODE_COUNT) {
+			prototype->code[k].opcode = superinstruction;
+		}
+	}
+	for (int k = 0; k < prototype->prototypeCount; ++k) {
+		_fusePrototype(prototype->prototypes[k]);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+const char * opcodeName(const Opcode opcode) {
+	return opcode < OPCODE_COUNT ? _names[opcode] : "?";
+}
+
+OperandFormat opcodeFormat(const Opcode opcode) {
+	return opcode < OPCODE_COUNT ? _formats[opcode] : FORMAT_NONE;
+}
+
+Prototype * createPrototype(const char * name) {
+	Prototype * prototype = calloc(1, sizeof(Prototype));
+	prototype->name = strdup(name);
+	return prototype;
+}
+
+Prototype * findMethod(const ClassDefinition * class, const char * name) {
+	for (int k = 0; k < class->methodCount; ++k) {
+		if (strcmp(class->methods[k].name, name) == 0) {
+			return class->methods[k].prototype;
+		}
+	}
+	return NULL;
+}
+
+void disassembleProgram(Emitter * emitter, const CompiledProgram * program) {
+	_disassemblePrototype(emitter, program->main);
+	for (int k = 0; k < program->classCount; ++k) {
+		const ClassDefinition * class = program->classes[k];
+		emit(emitter, "class %s (%d field(s), %d eternal field(s), %d method(s))\n", class->name, class->fieldCount, class->staticCount, class->methodCount);
+		_disassemblePrototype(emitter, class->initializer);
+		for (int m = 0; m < class->methodCount; ++m) {
+			if (class->methods[m].owner == class) {
+				_disassemblePrototype(emitter, class->methods[m].prototype);
+			}
+		}
+	}
+}
+
+Opcode superinstructionOf(const Opcode first, const Opcode second) {
+	for (int k = 0; _superinstructions[k].superinstruction != OPCODE_COUNT; ++k) {
+		if (_superinstructions[k].first == first && _superinstructions[k].second == second) {
+			return _superinstructions[k].superinstruction;
+		}
+	}
+	return OPCODE_COUNT;
+}
+
+void fuseSuperinstructions(CompiledProgram * program) {
+	program->hasSuperinstructions = true;
+	_fusePrototype(program->main);
+	for (int k = 0; k < program->classCount; ++k) {
+		const ClassDefinition * class = program->classes[k];
+		_fusePrototype(class->initializer);
+		for (int m = 0; m < class->methodCount; ++m) {
+			if (class->methods[m].owner == class) {
+				_fusePrototype(class->methods[m].prototype);
+			}
+		}
+	}
+}
+
+void releasePrototype(Prototype * prototype) {
+	if (prototype == NULL) return;
+	for (int k = 0; k < prototype->prototypeCount; ++k) {
+		releasePrototype(prototype->prototypes[k]);
+	}
+	for (int k = 0; k < prototype->captureCount; ++k) {
+		free(prototype->captures[k].name);
+	}
+	for (int k = 0; k < prototype->invokeSiteCount; ++k) {
+		free(prototype->invokeSites[k].name);
+	}
+	free(prototype->captures);
+	free(prototype->invokeSites);
+	free(prototype->prototypes);
+	free(prototype->constants);
+	free(prototype->code);
+	free(prototype->name);
+	free(prototype);
+}
+
+void releaseCompiledProgram(CompiledProgram * program) {
+	if (program == NULL) return;
+	releasePrototype(program->main);
+	for (int k = 0; k < program->classCount; ++k) {
+		ClassDefinition * class = program->classes[k];
+		for (int m = 0; m < class->methodCount; ++m) {
+			if (class->methods[m].owner == class) {
+				releasePrototype(class->methods[m].prototype);
+			}
+			free(class->methods[m].name);
+		}
+		for (int f = 0; f < class->fieldCount; ++f) {
+			free(class->fieldNames[f]);
+		}
+		for (int f = 0; f < class->staticCount; ++f) {
+			free(class->staticNames[f]);
+		}
+		releasePrototype(class->initializer);
+		free(class->methods);
+		free(class->fieldNames);
+		free(class->staticNames);
+		free(class->staticSlots);
+		free(class->name);
+		free(class);
+	}
+	for (int k = 0; k < program->globalCount; ++k) {
+		free(program->globalNames[k]);
+	}
+	free(program->classes);
+	free(program->globalNames);
+	releaseHeap(&program->literals);
+	free(program);
+}
@@ -0,0 +1,299 @@
+#ifndef BYTECODE_HEADER
+#define BYTECODE_HEADER
+
+#include "../../shared/Type.h"
+#include "Superinstructions.h"
+#include "Value.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The instruction set of the virtual machine, as OPCODE(name, format). R[n]
+ * is a register of the current frame, K[n] a constant, G[n] a global, and
+ * C[n] a capture of the current closure (a copied value, or a shared cell),
+ * and S[n] a call site of a method.
+ * Every jump is relative to the next instruction.
+ */
+#define OPCODES(OPCODE) \
+	OPCODE(MOVE, AB)		/* R[A] = R[B] */ \
+	OPCODE(LOADK, ABX)		/* R[A] = K[Bx] */ \
+	OPCODE(LOADINT, ASBX)	/* R[A] = sBx */ \
+	OPCODE(LOADBOOL, AB)	/* R[A] = B != 0 */ \
+	OPCODE(LOADNIL, A)		/* R[A] = nil */ \
+	OPCODE(GETGLOBAL, ABX)	/* R[A] = G[Bx] */ \
+	OPCODE(SETGLOBAL, ABX)	/* G[Bx] = R[A] */ \
+	OPCODE(BOX, A)			/* R[A] = new cell holding R[A] */ \
+	OPCODE(GETCELL, AB)		/* R[A] = value of the cell R[B] */ \
+	OPCODE(SETCELL, AB)		/* value of the cell R[A] = R[B] */ \
+	OPCODE(GETCAPTURE, AB)	/* R[A] = C[B] */ \
+	OPCODE(GETSHARED, AB)	/* R[A] = value of the cell C[B] */ \
+	OPCODE(SETSHARED, AB)	/* value of the cell C[A] = R[B] */ \
+	OPCODE(GETFIELD, ABC)	/* R[A] = field C of R[B] */ \
+	OPCODE(SETFIELD, ABC)	/* field B of R[A] = R[C] */ \
+	OPCODE(GETMETHOD, ABC)	/* R[A] = method K[C] of R[B], bound to R[B] */ \
+	OPCODE(ADD, ABC)		/* R[A] = R[B] + R[C] */ \
+	OPCODE(SUB, ABC)		/* R[A] = R[B] - R[C] */ \
+	OPCODE(MUL, ABC)		/* R[A] = R[B] * R[C] */ \
+	OPCODE(DIV, ABC)		/* R[A] = R[B] / R[C] */ \
+	OPCODE(ADDK, ABC)		/* R[A] = R[B] + K[C] */ \
+	OPCODE(SUBK, ABC)		/* R[A] = R[B] - K[C] */ \
+	OPCODE(MULK, ABC)		/* R[A] = R[B] * K[C] */ \
+	OPCODE(DIVK, ABC)		/* R[A] = R[B] / K[C] */ \
+	OPCODE(ADDI, ABSC)		/* R[A] = R[B] + sC */ \
+	OPCODE(LT, ABC)			/* R[A] = R[B] < R[C] */ \
+	OPCODE(LE, ABC)			/* R[A] = R[B] <= R[C] */ \
+	OPCODE(EQ, ABC)			/* R[A] = R[B] == R[C] */ \
+	OPCODE(NE, ABC)			/* R[A] = R[B] != R[C] */ \
+	OPCODE(JMP, SBX)		/* jump sBx */ \
+	OPCODE(JMPIF, ASBX)		/* if R[A] is truthy, jump sBx */ \
+	OPCODE(JMPIFNOT, ASBX)	/* if R[A] is falsy, jump sBx */ \
+	OPCODE(TESTARG, ASBX)	/* if the argument of the parameter R[A] was passed, jump sBx */ \
+	OPCODE(CALL, AB)		/* R[A] = R[A](R[A+1], ..., R[A+B]) */ \
+	OPCODE(INVOKE, ABC)		/* R[A] = method of the site B of R[A](R[A+1], ..., R[A+C]) */ \
+	OPCODE(TAILCALL, AB)	/* like CALL, but the callee replaces the current frame */ \
+	OPCODE(TAILINVOKE, ABC)	/* like INVOKE, but the method replaces the current frame */ \
+	OPCODE(NEW, ABC)		/* R[A] = new instance of class B(R[A+1], ..., R[A+C]) */ \
+	OPCODE(NEWSCOPED, ABC)	/* like NEW, but the instance lives in the scope of the frame */ \
+	OPCODE(DROP, A)			/* drops the scoped instance R[A] (the last one), R[A] = nil */ \
+	OPCODE(CLOSURE, ABX)	/* R[A] = new closure of the nested prototype Bx */ \
+	OPCODE(RETURN, A)		/* return R[A] */ \
+	OPCODE(RETURNNIL, NONE)	/* return nil */ \
+	OPCODE(FORPREP, ASBX)	/* R[A+1] = 0 (R[A] must be iterable), or R[A], R[A+1] = end, start of the range R[A], jump sBx */ \
+	OPCODE(FORNEXT, ASBX)	/* if R[A] has an item at R[A+1] (or R[A+1] < R[A]), R[A+2] = item, R[A+1]++, jump sBx */ \
+	OPCODE(TESTLT, AB)		/* if R[A] < R[B], skip the next instruction (a JMP) */ \
+	OPCODE(TESTLE, AB)		/* if R[A] <= R[B], skip the next instruction (a JMP) */ \
+	OPCODE(TESTEQ, AB)		/* if R[A] == R[B], skip the next instruction (a JMP) */ \
+	OPCODE(TESTNE, AB)		/* if R[A] != R[B], skip the next instruction (a JMP) */ \
+	OPCODE(CONCAT, ABC)		/* like ADD, but a new string is a temporary of the frame */ \
+	OPCODE(NEWLIST, AB)		/* R[A] = new temporary list of R[A+1], ..., R[A+B] */ \
+	OPCODE(JOIN, ABC)		/* R[A] = R[B] + R[B+1] + ... + R[B+C-1], concatenated at once */ \
+	OPCODE(APPEND, ABC)		/* like JOIN, but the string may fill the buffer of the first one in place */ \
+	SPECIALIZED_OPCODES(OPCODE) \
+	SUPERINSTRUCTIONS(SUPERINSTRUCTION_OPCODE, OPCODE)
+
+/**
+ * The forms of the generic instructions specialized for the types of their
+ * operands: integers (INT), decimals (DEC), or a kind of collection. The
+ * compiler emits them when it knows the types, and the generic ones rewrite
+ * themselves into them once they observe the types. Every specialized form
+ * checks the types anyway, and rewrites itself back into the generic form
+ * if they don't match.
+ */
+#define SPECIALIZED_OPCODES(OPCODE) \
+	OPCODE(ADD_INT, ABC) \
+	OPCODE(SUB_INT, ABC) \
+	OPCODE(MUL_INT, ABC) \
+	OPCODE(ADD_DEC, ABC) \
+	OPCODE(SUB_DEC, ABC) \
+	OPCODE(MUL_DEC, ABC) \
+	OPCODE(DIV_DEC, ABC) \
+	OPCODE(ADDK_INT, ABC) \
+	OPCODE(SUBK_INT, ABC) \
+	OPCODE(MULK_INT, ABC) \
+	OPCODE(ADDK_DEC, ABC) \
+	OPCODE(SUBK_DEC, ABC) \
+	OPCODE(MULK_DEC, ABC) \
+	OPCODE(DIVK_DEC, ABC) \
+	OPCODE(ADDI_INT, ABSC) \
+	OPCODE(LT_INT, ABC) \
+	OPCODE(LE_INT, ABC) \
+	OPCODE(TESTLT_INT, AB) \
+	OPCODE(TESTLE_INT, AB) \
+	OPCODE(FORNEXT_COUNT, ASBX) \
+	OPCODE(FORNEXT_LIST, ASBX)
+
+/**
+ * A superinstruction runs a pair of consecutive instructions with a single
+ * dispatch. It replaces the first one of the pair (and keeps its operands),
+ * while the second one stays in place, so a jump can still reach it alone.
+ */
+#define SUPERINSTRUCTION_OPCODE(OPCODE, name, first, second, format) OPCODE(name, format)
+
+typedef enum {
+#define OPCODE(name, format) OP_##name,
+	OPCODES(OPCODE)
+#undef OPCODE
+	OPCODE_COUNT
+} Opcode;
+
+typedef enum {
+	FORMAT_NONE,
+	FORMAT_A,
+	FORMAT_AB,
+	FORMAT_ABC,
+	FORMAT_ABSC,
+	FORMAT_ABX,
+	FORMAT_ASBX,
+	FORMAT_SBX
+} OperandFormat;
+
+/**
+ * A 32-bit instruction: an opcode, a register A, and either two 8-bit
+ * operands (B and C), or a single 16-bit one (Bx, or sBx if it's signed).
+ */
+typedef struct {
+	uint8_t opcode;
+	uint8_t a;
+	union {
+		struct {
+			uint8_t b;
+			uint8_t c;
+		};
+		uint16_t bx;
+		int16_t sbx;
+	};
+} BytecodeInstruction;
+
+#define MAXIMUM_REGISTERS 256
+#define MAXIMUM_OPERAND 255
+#define MAXIMUM_EXTENDED_OPERAND 65535
+
+typedef enum {
+	CAPTURE_FROM_LOCAL,
+	CAPTURE_FROM_CAPTURE
+} CaptureSource;
+
+/**
+ * How a closure obtains a capture when it's created: from a register of the
+ * function that creates it, or from a capture of that function. A shared
+ * capture is a cell (the variable is assigned after the closure is created),
+ * and any other one is a copy of the value.
+ */
+typedef struct {
+	char * name;
+	CaptureSource source;
+	int index;
+	boolean isShared;
+} CaptureDescriptor;
+
+/** The most classes that the inline cache of a call site remembers. */
+#define INLINE_CACHE_SIZE 4
+
+/**
+ * A call site of a method. The method lives in a slot of the table of
+ * methods of the class of the call, which is also the slot of the method in
+ * the table of any descendant (tables extend the one of the parent). The
+ * inline cache remembers the method that each class of the receivers seen so
+ * far runs, up to "INLINE_CACHE_SIZE" of them (a polymorphic site), and then
+ * stops learning (a megamorphic one). If no descendant of the class of the
+ * call overrides the slot, the site is direct: it runs the given method
+ * without looking at the cache.
+ */
+typedef struct {
+	char * name;
+	ClassDefinition * class;
+	int slot;
+	Prototype * method;
+	ClassDefinition * cachedClasses[INLINE_CACHE_SIZE];
+	Prototype * cachedMethods[INLINE_CACHE_SIZE];
+	int cachedCount;
+} InvokeSite;
+
+/**
+ * A compiled lambda, method, class initializer or the top-level code. The
+ * parameters occupy the first registers, after the receiver (if any).
+ */
+struct Prototype {
+	char * name;
+	BytecodeInstruction * code;
+	int codeSize;
+	int codeCapacity;
+	Value * constants;
+	int constantCount;
+	int constantCapacity;
+	Prototype ** prototypes;
+	int prototypeCount;
+	int prototypeCapacity;
+	CaptureDescriptor * captures;
+	int captureCount;
+	InvokeSite * invokeSites;
+	int invokeSiteCount;
+	int invokeSiteCapacity;
+	int parameterCount;
+	boolean hasReceiver;
+	int registerCount;
+	// The code prepared by the virtual machine for its dispatch, if any.
+	void * dispatchCode;
+};
+
+/**
+ * A method in a slot of a table. It's overridden if a descendant of the
+ * class of the table has another method in the slot.
+ */
+typedef struct {
+	char * name;
+	Prototype * prototype;
+	ClassDefinition * owner;
+	boolean isOverridden;
+} MethodDefinition;
+
+/**
+ * A compiled class. The inherited fields are a prefix of the fields, so they
+ * keep their index in every subclass, and the methods include the inherited
+ * ones that are not overridden. The initializer receives the new instance,
+ * and one optional argument per field.
+ *
+ * The eternal fields (and the inherited ones) aren't part of the instances:
+ * each one is a global slot, named after the class that declares it (e.g.,
+ * "Deck.colors"), and the slots of a class are contiguous.
+ */
+struct ClassDefinition {
+	char * name;
+	int index;
+	ClassDefinition * parent;
+	char ** fieldNames;
+	int fieldCount;
+	char ** staticNames;
+	int * staticSlots;
+	int staticCount;
+	MethodDefinition * methods;
+	int methodCount;
+	Prototype * initializer;
+};
+
+/**
+ * The output of the bytecode compiler, ready to be executed.
+ */
+typedef struct {
+	Prototype * main;
+	ClassDefinition ** classes;
+	int classCount;
+	char ** globalNames;
+	int globalCount;
+	Heap literals;
+	boolean hasSuperinstructions;
+} CompiledProgram;
+
+/** The name of the opcode, for listings and profiles. */
+const char * opcodeName(const Opcode opcode);
+
+OperandFormat opcodeFormat(const Opcode opcode);
+
+Prototype * createPrototype(const char * name);
+
+/**
+ * Replaces the first instruction of every pair that has a superinstruction,
+ * in every prototype of the program. The virtual machine also fuses the
+ * pairs that appear when an instruction quickens.
+ */
+void fuseSuperinstructions(CompiledProgram * program);
+
+/** The superinstruction of a pair of opcodes, or OPCODE_COUNT if none. */
+Opcode superinstructionOf(const Opcode first, const Opcode second);
+
+/** Finds a method of the class (or an inherited one), or returns NULL. */
+Prototype * findMethod(const ClassDefinition * class, const char * name);
+
+/**
+ * Writes a human-readable listing of the program: every prototype, with its
+ * constants, captures and instructions.
+ */
+void disassembleProgram(Emitter * emitter, const CompiledProgram * program);
+
+void releasePrototype(Prototype * prototype);
+
+void releaseCompiledProgram(CompiledProgram * program);
+
+#endif
@@ -0,0 +1,1981 @@
+#include "BytecodeCompiler.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeBytecodeCompilerModule() {
+	_logger = createLogger("BytecodeCompiler");
+}
+
+void shutdownBytecodeCompilerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+typedef enum {
+	LOCAL_LOCATION,
+	CAPTURE_LOCATION,
+	FIELD_LOCATION,
+	METHOD_LOCATION,
+	GLOBAL_LOCATION,
+	UNRESOLVED_LOCATION
+} LocationType;
+
+/**
+ * Where a name lives. Unresolved names are globals that no top-level code
+ * has declared yet (e.g., natives, or lambdas declared later). A boxed local
+ * or capture lives in a cell.
+ */
+typedef struct {
+	LocationType type;
+	int index;
+	boolean isBoxed;
+} Location;
+
+/**
+ * What the compiler knows about the values of a local variable or an
+ * expression. The semantic analysis doesn't enforce the declared types, so
+ * it's only a hint: the specialized instructions check the types anyway.
+ */
+typedef enum {
+	UNKNOWN_STATIC_TYPE,
+	INTEGER_STATIC_TYPE,
+	DECIMAL_STATIC_TYPE,
+	STRING_STATIC_TYPE
+} StaticType;
+
+/**
+ * A register reserved by a scope. Hidden registers (e.g., the state of a
+ * for-in loop) have no name.
+ */
+typedef struct {
+	const char * name;
+	int target;
+	boolean isBoxed;
+	int depth;
+	StaticType type;
+} LocalVariable;
+
+typedef struct LoopContext LoopContext;
+
+/** The "pass" instructions of a loop, which jump to its next iteration. */
+struct LoopContext {
+	LoopContext * enclosing;
+	int * continueJumps;
+	int continueCount;
+	int continueCapacity;
+};
+
+/**
+ * The natives for lists are the ones of the runtime if no variable or class
+ * of the program hides their names, so the compiler knows what a call to
+ * them does with its arguments.
+ */
+typedef struct {
+	CompiledProgram * program;
+	boolean hasListNatives;
+	boolean * declaredGlobals;
+	int globalCapacity;
+	Class ** classSources;
+	int classCapacity;
+	int errors;
+} Compilation;
+
+typedef struct FunctionState FunctionState;
+
+/**
+ * The state of the prototype being compiled. Methods and class initializers
+ * have a class, and their receiver lives in the first register. Lambdas and
+ * methods have temporaries (see "_prepareEscapingNames"): the values of the
+ * variables whose names don't escape, and the intermediate results.
+ */
+struct FunctionState {
+	FunctionState * parent;
+	Compilation * compilation;
+	Prototype * prototype;
+	ClassDefinition * class;
+	LocalVariable * locals;
+	int localCount;
+	int localCapacity;
+	const char ** boxedNames;
+	int boxedCount;
+	int boxedCapacity;
+	const char ** escapingNames;
+	int escapingCount;
+	int escapingCapacity;
+	boolean hasTemporaries;
+	LoopContext * loop;
+	int depth;
+	int freeRegister;
+	boolean isTopLevel;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static int _addCapture(FunctionState * state, const char * name, const Location outer);
+static int _addConstant(FunctionState * state, const Value value);
+static int _addInvokeSite(FunctionState * state, const char * name, const int slot);
+static int _addPrototype(FunctionState * state, Prototype * prototype);
+static int _allocateRegister(FunctionState * state);
+static boolean _allowsTailCalls(FunctionState * state);
+static VisitAction _collectBoxedNames(void * state, void * node);
+static VisitAction _collectClass(void * state, void * node);
+static VisitAction _collectHiddenNatives(void * state, void * node);
+static VisitAction _collectHiddenParameter(void * state, void * node);
+static void _compileArithmetic(FunctionState * state, const ExpressionType type, const int target, const int left, const StaticType leftType, Expression * right, const boolean isTemporary);
+static void _compileAssignment(FunctionState * state, AssignmentOperation * assignment);
+static void _compileBlock(FunctionState * state, Block * block);
+static void _compileCall(FunctionState * state, FunctionCall * functionCall, const int target, const boolean isTail, const boolean isDiscarded);
+static void _compileClass(Compilation * compilation, ClassDefinition * class);
+static void _compileComparison(FunctionState * state, Expression * expression, const int target);
+static void _compileConditional(FunctionState * state, Conditional * conditional);
+static void _compileConstant(FunctionState * state, Constant * constant, const int target);
+static void _compileDeclaration(FunctionState * state, VariableDeclaration * variableDeclaration);
+static void _compileDefaultValue(FunctionState * state, const VariableType type, const int target);
+static void _compileExpression(FunctionState * state, Expression * expression, const int target, const char * name);
+static void _compileFactor(FunctionState * state, Factor * factor, const int target, const char * name);
+static void _compileForLoop(FunctionState * state, Loop * loop);
+static void _compileIncrement(FunctionState * state, const char * name, const int delta, const int target);
+static void _compileInstruction(FunctionState * state, Instruction * instruction);
+static boolean _compileJoin(FunctionState * state, Expression * expression, const int target, const char * name);
+static void _compileLambda(FunctionState * state, Lambda * lambda, const char * name, const int target);
+static void _compileMethod(Compilation * compilation, ClassDefinition * class, Prototype * prototype, Lambda * lambda);
+static void _compileOperation(FunctionState * state, Expression * expression, const int target, const char * name, const boolean isTemporary);
+static void _compileScopedBlock(FunctionState * state, Block * block);
+static void _compileStatics(FunctionState * state, Class * source);
+static int _compileTest(FunctionState * state, Expression * expression);
+static void _compileWhileLoop(FunctionState * state, Loop * loop);
+static Location _declareVariable(FunctionState * state, const char * name);
+static int _declareLocal(FunctionState * state, const char * name);
+static StaticType _declaredType(const VariableType type);
+static int _emit(FunctionState * state, const Opcode opcode, const int a, const int b, const int c);
+static int _emitExtended(FunctionState * state, const Opcode opcode, const int a, const int bx);
+static int _emitJump(FunctionState * state, const Opcode opcode, const int a);
+static void _enterScope(FunctionState * state);
+static void _escape(FunctionState * state, const char * name);
+static void _exitScope(FunctionState * state);
+static int _expressionRegister(FunctionState * state, Expression * expression);
+static StaticType _expressionType(FunctionState * state, Expression * expression);
+static int _factorRegister(FunctionState * state, Factor * factor);
+static StaticType _factorType(FunctionState * state, Factor * factor);
+static int _fieldIndex(const ClassDefinition * class, const char * name);
+static ClassDefinition * _findClass(Compilation * compilation, const char * name);
+static void _finishFunctionState(FunctionState * state);
+static int _globalSlot(Compilation * compilation, const char * name);
+static void _initializeFunctionState(FunctionState * state, Compilation * compilation, FunctionState * parent, Prototype * prototype, ClassDefinition * class);
+static boolean _isBoxedName(FunctionState * state, const char * name);
+static boolean _isComparison(Expression * expression);
+static boolean _isEmptyString(Expression * expression);
+static boolean _isEscapingName(FunctionState * state, const char * name);
+static boolean _isEternal(Instruction * instruction);
+static boolean _isListNative(const char * name);
+static boolean _isNumericConstant(FunctionState * state, Expression * expression, Value * value);
+static boolean _isTemporaryTarget(FunctionState * state, const int target);
+static void _layoutClass(Compilation * compilation, ClassDefinition * class, const int depth);
+static void _markOverrides(Compilation * compilation);
+static void _loadLocation(FunctionState * state, const Location location, const char * name, const int target);
+static int _localsTop(FunctionState * state);
+static StaticType _localType(FunctionState * state, const char * name);
+static Lambda * _memberLambda(Instruction * instruction);
+static const char * _memberName(Instruction * instruction);
+static int _operandRegister(FunctionState * state, Expression * expression);
+static void _patchJump(FunctionState * state, const int jump, const int destination);
+static void _prepareBoxedNames(FunctionState * state, Block * block);
+static void _prepareEscapingNames(FunctionState * state, Lambda * lambda);
+static int _receiverRegister(FunctionState * state);
+static Location _resolve(FunctionState * state, const char * name);
+static void _scanBlockEscapes(FunctionState * state, Block * block);
+static void _scanCallEscapes(FunctionState * state, FunctionCall * functionCall, const boolean isDiscarded);
+static void _scanExpressionEscapes(FunctionState * state, Expression * expression, const boolean escapes);
+static void _scanFactorEscapes(FunctionState * state, Factor * factor, const boolean escapes);
+static void _scanInstructionEscapes(FunctionState * state, Instruction * instruction);
+static int _methodSlot(const ClassDefinition * class, const char * name);
+static int _staticSlot(const ClassDefinition * class, const char * name);
+static void _storeLocation(FunctionState * state, const Location location, const char * name, const int source);
+static int _stringConstant(FunctionState * state, const char * characters);
+
+/* ------------------------------ Emission ------------------------------ */
+
+static int _emit(FunctionState * state, const Opcode opcode, const int a, const int b, const int c) {
+	Prototype * prototype = state->prototype;
+	if (prototype->codeSize == prototype->codeCapacity) {
+		prototype->codeCapacity = prototype->codeCapacity == 0 ? 64 : 2 * prototype->codeCapacity;
+		prototype->code = realloc(prototype->code, prototype->codeCapacity * sizeof(BytecodeInstruction));
+	}
+	BytecodeInstruction * instruction = &prototype->code[prototype->codeSize];
+	instruction->opcode = opcode;
+	instruction->a = a;
+	instruction->b = b;
+	instruction->c = c;
+	return prototype->codeSize++;
+}
+
+static int _emitExtended(FunctionState * state, const Opcode opcode, const int a, const int bx) {
+	const int index = _emit(state, opcode, a, 0, 0);
+	state->prototype->code[index].bx = bx;
+	return index;
+}
+
+static int _emitJump(FunctionState * state, const Opcode opcode, const int a) {
+	return _emit(state, opcode, a, 0, 0);
+}
+
+static void _patchJump(FunctionState * state, const int jump, const int destination) {
+	const int offset = destination - (jump + 1);
+	if (offset < INT16_MIN || INT16_MAX < offset) {
+		logError(_logger, "The body of '%s' is too large to jump across.", state->prototype->name);
+		state->compilation->errors += 1;
+		return;
+	}
+	state->prototype->code[jump].sbx = offset;
+}
+
+static int _addConstant(FunctionState * state, const Value value) {
+	Prototype * prototype = state->prototype;
+	for (int k = 0; k < prototype->constantCount; ++k) {
+		const Value constant = prototype->constants[k];
+		// Decimals match by their bits, and strings and boxed integers by their contents.
+		if (constant.bits == value.bits) return k;
+		if (isObject(constant) && isObject(value) && valuesEqual(constant, value)) return k;
+	}
+	if (prototype->constantCount == MAXIMUM_EXTENDED_OPERAND) {
+		logError(_logger, "The body of '%s' has too many constants.", prototype->name);
+		state->compilation->errors += 1;
+		return 0;
+	}
+	if (prototype->constantCount == prototype->constantCapacity) {
+		prototype->constantCapacity = prototype->constantCapacity == 0 ? 16 : 2 * prototype->constantCapacity;
+		prototype->constants = realloc(prototype->constants, prototype->constantCapacity * sizeof(Value));
+	}
+	prototype->constants[prototype->constantCount] = value;
+	return prototype->constantCount++;
+}
+
+static int _stringConstant(FunctionState * state, const char * characters) {
+	Prototype * prototype = state->prototype;
+	const int length = strlen(characters);
+	for (int k = 0; k < prototype->constantCount; ++k) {
+		const Value constant = prototype->constants[k];
+		if (isObjectOfType(constant, STRING_OBJECT)
+			&& ((StringObject *) asObject(constant))->length == length
+			&& memcmp(((StringObject *) asObject(constant))->characters, characters, length) == 0) {
+			return k;
+		}
+	}
+	return _addConstant(state, objectValue(newString(&state->compilation->program->literals, characters, length)));
+}
+
+/**
+ * A new call site of the method in the slot of the class of the function
+ * (or of the closest enclosing function that has one).
+ */
+static int _addInvokeSite(FunctionState * state, const char * name, const int slot) {
+	FunctionState * owner = state;
+	while (owner->class == NULL) {
+		owner = owner->parent;
+	}
+	Prototype * prototype = state->prototype;
+	if (prototype->invokeSiteCount == prototype->invokeSiteCapacity) {
+		prototype->invokeSiteCapacity = prototype->invokeSiteCapacity == 0 ? 4 : 2 * prototype->invokeSiteCapacity;
+		prototype->invokeSites = realloc(prototype->invokeSites, prototype->invokeSiteCapacity * sizeof(InvokeSite));
+	}
+	InvokeSite * site = &prototype->invokeSites[prototype->invokeSiteCount];
+	memset(site, 0, sizeof(InvokeSite));
+	site->name = strdup(name);
+	site->class = owner->class;
+	site->slot = slot;
+	if (!owner->class->methods[slot].isOverridden) {
+		site->method = owner->class->methods[slot].prototype;
+	}
+	return prototype->invokeSiteCount++;
+}
+
+static int _addPrototype(FunctionState * state, Prototype * prototype) {
+	Prototype * parent = state->prototype;
+	if (parent->prototypeCount == parent->prototypeCapacity) {
+		parent->prototypeCapacity = parent->prototypeCapacity == 0 ? 4 : 2 * parent->prototypeCapacity;
+		parent->prototypes = realloc(parent->prototypes, parent->prototypeCapacity * sizeof(Prototype *));
+	}
+	parent->prototypes[parent->prototypeCount] = prototype;
+	return parent->prototypeCount++;
+}
+
+/* ------------------------- Registers and scopes ------------------------- */
+
+static int _allocateRegister(FunctionState * state) {
+	const int target = state->freeRegister++;
+	if (state->freeRegister == MAXIMUM_REGISTERS + 1) {
+		logError(_logger, "The body of '%s' needs more than %d registers.", state->prototype->name, MAXIMUM_REGISTERS);
+		state->compilation->errors += 1;
+	}
+	if (state->prototype->registerCount < state->freeRegister) {
+		state->prototype->registerCount = state->freeRegister;
+	}
+	return target < MAXIMUM_REGISTERS ? target : MAXIMUM_REGISTERS - 1;
+}
+
+static int _localsTop(FunctionState * state) {
+	return state->localCount == 0 ? 0 : 1 + state->locals[state->localCount - 1].target;
+}
+
+/**
+ * Reserves the next register for a variable of the current scope. It must be
+ * called when only the registers of other variables are in use.
+ */
+static int _declareLocal(FunctionState * state, const char * name) {
+	if (state->localCount == state->localCapacity) {
+		state->localCapacity = state->localCapacity == 0 ? 16 : 2 * state->localCapacity;
+		state->locals = realloc(state->locals, state->localCapacity * sizeof(LocalVariable));
+	}
+	LocalVariable * local = &state->locals[state->localCount++];
+	local->name = name;
+	local->target = _allocateRegister(state);
+	local->isBoxed = (name != NULL && _isBoxedName(state, name)) ? true : false;
+	local->depth = state->depth;
+	local->type = UNKNOWN_STATIC_TYPE;
+	return local->target;
+}
+
+/** The type of the values of a local variable, if the name resolves to one. */
+static StaticType _localType(FunctionState * state, const char * name) {
+	for (int k = state->localCount - 1; 0 <= k; --k) {
+		if (state->locals[k].name != NULL && strcmp(state->locals[k].name, name) == 0) {
+			return state->locals[k].type;
+		}
+	}
+	return UNKNOWN_STATIC_TYPE;
+}
+
+static void _enterScope(FunctionState * state) {
+	state->depth += 1;
+}
+
+static void _exitScope(FunctionState * state) {
+	while (0 < state->localCount && state->depth <= state->locals[state->localCount - 1].depth) {
+		state->localCount -= 1;
+	}
+	state->depth -= 1;
+	state->freeRegister = _localsTop(state);
+}
+
+static boolean _isBoxedName(FunctionState * state, const char * name) {
+	for (int k = 0; k < state->boxedCount; ++k) {
+		if (strcmp(state->boxedNames[k], name) == 0) return true;
+	}
+	return false;
+}
+
+/**
+ * The variables captured by the lambdas of a body (according to the capture
+ * analysis) that are assigned after a lambda is created live in cells, so
+ * every closure shares them. The closures copy any other capture.
+ */
+static VisitAction _collectBoxedNames(void * context, void * node) {
+	FunctionState * state = context;
+	Lambda * lambda = ((Expression *) node)->lambda;
+	if (lambda->captureList != NULL) {
+		for (Node * capture = lambda->captureList->first; capture != NULL; capture = capture->next) {
+			const char * name = ((Capture *) capture->data)->name;
+			if (((Capture *) capture->data)->isMutable && !_isBoxedName(state, name)) {
+				if (state->boxedCount == state->boxedCapacity) {
+					state->boxedCapacity = state->boxedCapacity == 0 ? 8 : 2 * state->boxedCapacity;
+					state->boxedNames = realloc(state->boxedNames, state->boxedCapacity * sizeof(const char *));
+				}
+				state->boxedNames[state->boxedCount++] = name;
+			}
+		}
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+static VisitAction _skipClass(void * context, void * node) {
+	return VISIT_SKIP_CHILDREN;
+}
+
+static void _prepareBoxedNames(FunctionState * state, Block * block) {
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "boxed names";
+	visitor.pre[LAMBDA_NODE] = _collectBoxedNames;
+	visitor.pre[CLASS_NODE] = _skipClass;
+	visitor.pre[INTERFACE_NODE] = _skipClass;
+	visitor.state = state;
+	Visitor * visitors[] = { &visitor };
+	walkBlock(block, visitors, 1);
+}
+
+static void _initializeFunctionState(FunctionState * state, Compilation * compilation, FunctionState * parent, Prototype * prototype, ClassDefinition * class) {
+	memset(state, 0, sizeof(FunctionState));
+	state->parent = parent;
+	state->compilation = compilation;
+	state->prototype = prototype;
+	state->class = class;
+	prototype->hasReceiver = class == NULL ? false : true;
+}
+
+static void _finishFunctionState(FunctionState * state) {
+	free(state->locals);
+	free(state->boxedNames);
+	free(state->escapingNames);
+}
+
+/* ------------------------------ Temporaries ----------------------------- */
+
+/** The natives that receive a list, or create one. */
+static boolean _isListNative(const char * name) {
+	static const char * const natives[] = { "get", "list", "print", "push", "set", "size" };
+	for (unsigned int k = 0; k < sizeof(natives) / sizeof(natives[0]); ++k) {
+		if (strcmp(natives[k], name) == 0) return true;
+	}
+	return false;
+}
+
+static VisitAction _collectHiddenNatives(void * context, void * node) {
+	Compilation * compilation = context;
+	Instruction * instruction = node;
+	const char * name = NULL;
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT: name = instruction->assignment->name; break;
+		case INSTRUCTION_VARIABLE_DECLARATION: name = instruction->variableDeclaration->name; break;
+		case INSTRUCTION_LOOP: name = instruction->loop->itemName; break;
+		case INSTRUCTION_CLASS: name = instruction->class->object->name; break;
+		default: break;
+	}
+	if (name != NULL && _isListNative(name)) {
+		compilation->hasListNatives = false;
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _collectHiddenParameter(void * context, void * node) {
+	if (_isListNative(((VariableDeclaration *) node)->name)) {
+		((Compilation *) context)->hasListNatives = false;
+	}
+	return VISIT_CHILDREN;
+}
+
+static boolean _isEscapingName(FunctionState * state, const char * name) {
+	for (int k = 0; k < state->escapingCount; ++k) {
+		if (strcmp(state->escapingNames[k], name) == 0) return true;
+	}
+	return false;
+}
+
+static void _escape(FunctionState * state, const char * name) {
+	if (_isEscapingName(state, name)) return;
+	if (state->escapingCount == state->escapingCapacity) {
+		state->escapingCapacity = state->escapingCapacity == 0 ? 8 : 2 * state->escapingCapacity;
+		state->escapingNames = realloc(state->escapingNames, state->escapingCapacity * sizeof(const char *));
+	}
+	state->escapingNames[state->escapingCount++] = name;
+}
+
+static void _scanBlockEscapes(FunctionState * state, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_scanInstructionEscapes(state, node->data);
+	}
+}
+
+/** The value of a compound assignment is an operand, but the one of a plain assignment escapes. */
+static void _scanInstructionEscapes(FunctionState * state, Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			_scanExpressionEscapes(state, instruction->assignment->expression, instruction->assignment->assignmentOperator == ASSIGN_TYPE);
+			break;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			if (instruction->variableDeclaration->expression != NULL) {
+				_scanExpressionEscapes(state, instruction->variableDeclaration->expression, true);
+			}
+			break;
+		case INSTRUCTION_EXPRESSION:
+			if (instruction->expression->type == FUNCTION_CALL) {
+				_scanCallEscapes(state, instruction->expression->functionCall, true);
+			}
+			else {
+				_scanExpressionEscapes(state, instruction->expression, false);
+			}
+			break;
+		case INSTRUCTION_BLOCK:
+			_scanBlockEscapes(state, instruction->block);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+				if (conditional->expression != NULL) {
+					_scanExpressionEscapes(state, conditional->expression, false);
+				}
+				_scanBlockEscapes(state, conditional->block);
+			}
+			break;
+		case INSTRUCTION_LOOP:
+			if (instruction->loop->expression != NULL) {
+				_scanExpressionEscapes(state, instruction->loop->expression, false);
+			}
+			_scanBlockEscapes(state, instruction->loop->block);
+			break;
+		case INSTRUCTION_RETURN: {
+			Instruction * returned = instruction->returnInstruction;
+			if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION) {
+				_scanExpressionEscapes(state, returned->expression, true);
+			}
+			else if (returned != NULL) {
+				_scanInstructionEscapes(state, returned);
+			}
+			break;
+		}
+		case INSTRUCTION_CLASS:
+		case INSTRUCTION_INTERFACE:
+		case INSTRUCTION_PASS:
+			break;
+	}
+}
+
+/**
+ * Scans an expression whose value escapes (or not), so a variable read as
+ * the whole value escapes with it. A nested lambda runs in its own frame, so
+ * the variables that it captures escape.
+ */
+static void _scanExpressionEscapes(FunctionState * state, Expression * expression, const boolean escapes) {
+	switch (expression->type) {
+		case ADDITION:
+		case SUBTRACTION:
+		case MULTIPLICATION:
+		case DIVISION:
+			_scanExpressionEscapes(state, expression->leftExpression, false);
+			_scanExpressionEscapes(state, expression->rightExpression, false);
+			break;
+		case FACTOR:
+			_scanFactorEscapes(state, expression->factor, escapes);
+			break;
+		case FUNCTION_CALL:
+			_scanCallEscapes(state, expression->functionCall, false);
+			break;
+		case LAMBDA:
+			if (expression->lambda->captureType == CAPTURE_UNKNOWN) {
+				state->hasTemporaries = false;
+			}
+			if (expression->lambda->captureList != NULL) {
+				for (Node * node = expression->lambda->captureList->first; node != NULL; node = node->next) {
+					_escape(state, ((Capture *) node->data)->name);
+				}
+			}
+			break;
+		default:
+			_scanFactorEscapes(state, expression->leftFactor, false);
+			_scanFactorEscapes(state, expression->rightFactor, false);
+			break;
+	}
+}
+
+static void _scanFactorEscapes(FunctionState * state, Factor * factor, const boolean escapes) {
+	if (factor->type == VARIABLE_TYPE && escapes) {
+		_escape(state, factor->variable);
+	}
+	else if (factor->type == EXPRESSION) {
+		_scanExpressionEscapes(state, factor->expression, escapes);
+	}
+}
+
+/**
+ * The arguments of a call escape, unless the callee is a native for lists
+ * that only reads them: every argument of "print", and the collection of
+ * "get", "set", "size" and "push" (if the list that it returns is discarded).
+ */
+static void _scanCallEscapes(FunctionState * state, FunctionCall * functionCall, const boolean isDiscarded) {
+	if (functionCall->expressionList == NULL) return;
+	const char * name = functionCall->name;
+	const boolean isKnown = (state->compilation->hasListNatives && _isListNative(name)) ? true : false;
+	const boolean isPrint = (isKnown && strcmp(name, "print") == 0) ? true : false;
+	const boolean readsCollection = (isKnown && strcmp(name, "list") != 0
+		&& (strcmp(name, "push") != 0 || isDiscarded)) ? true : false;
+	int position = 0;
+	for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next, ++position) {
+		const boolean escapes = (isPrint || (position == 0 && readsCollection)) ? false : true;
+		_scanExpressionEscapes(state, node->data, escapes);
+	}
+}
+
+/**
+ * Scans the body (and the default values of the parameters) of a lambda or
+ * a method, so its frame has temporaries: the values of the variables
+ * whose names never escape (see "_scanExpressionEscapes" and
+ * "_scanCallEscapes"), and the intermediate results. Any other read of a
+ * variable makes its name escape, in every scope of the body. A temporary
+ * string that reaches a store anyway (e.g., through a variable of another
+ * frame) is promoted by the machine, but a temporary list can't be, so
+ * the scan must prove that it never escapes.
+ */
+static void _prepareEscapingNames(FunctionState * state, Lambda * lambda) {
+	state->hasTemporaries = true;
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			if (parameter->expression != NULL) {
+				_scanExpressionEscapes(state, parameter->expression, true);
+			}
+		}
+	}
+	_scanBlockEscapes(state, lambda->block);
+}
+
+/**
+ * Whether the value of the target register is a temporary: the register of
+ * a local variable whose name doesn't escape.
+ */
+static boolean _isTemporaryTarget(FunctionState * state, const int target) {
+	if (!state->hasTemporaries) return false;
+	for (int k = state->localCount - 1; 0 <= k; --k) {
+		if (state->locals[k].target == target) {
+			const LocalVariable * local = &state->locals[k];
+			return (local->name != NULL && !local->isBoxed && !_isEscapingName(state, local->name)) ? true : false;
+		}
+	}
+	return false;
+}
+
+/* ---------------------------- Name resolution --------------------------- */
+
+static int _globalSlot(Compilation * compilation, const char * name) {
+	CompiledProgram * program = compilation->program;
+	for (int k = 0; k < program->globalCount; ++k) {
+		if (strcmp(program->globalNames[k], name) == 0) return k;
+	}
+	if (program->globalCount == compilation->globalCapacity) {
+		compilation->globalCapacity = compilation->globalCapacity == 0 ? 32 : 2 * compilation->globalCapacity;
+		program->globalNames = realloc(program->globalNames, compilation->globalCapacity * sizeof(char *));
+		compilation->declaredGlobals = realloc(compilation->declaredGlobals, compilation->globalCapacity * sizeof(boolean));
+	}
+	program->globalNames[program->globalCount] = strdup(name);
+	compilation->declaredGlobals[program->globalCount] = false;
+	return program->globalCount++;
+}
+
+static int _fieldIndex(const ClassDefinition * class, const char * name) {
+	for (int k = 0; k < class->fieldCount; ++k) {
+		if (strcmp(class->fieldNames[k], name) == 0) return k;
+	}
+	return -1;
+}
+
+static int _methodSlot(const ClassDefinition * class, const char * name) {
+	for (int k = 0; k < class->methodCount; ++k) {
+		if (strcmp(class->methods[k].name, name) == 0) return k;
+	}
+	return -1;
+}
+
+static int _staticSlot(const ClassDefinition * class, const char * name) {
+	for (int k = 0; k < class->staticCount; ++k) {
+		if (strcmp(class->staticNames[k], name) == 0) return class->staticSlots[k];
+	}
+	return -1;
+}
+
+static ClassDefinition * _findClass(Compilation * compilation, const char * name) {
+	for (int k = 0; k < compilation->program->classCount; ++k) {
+		if (strcmp(compilation->program->classes[k]->name, name) == 0) {
+			return compilation->program->classes[k];
+		}
+	}
+	return NULL;
+}
+
+static int _addCapture(FunctionState * state, const char * name, const Location outer) {
+	Prototype * prototype = state->prototype;
+	prototype->captures = realloc(prototype->captures, (prototype->captureCount + 1) * sizeof(CaptureDescriptor));
+	CaptureDescriptor * capture = &prototype->captures[prototype->captureCount];
+	capture->name = strdup(name);
+	capture->source = outer.type == LOCAL_LOCATION ? CAPTURE_FROM_LOCAL : CAPTURE_FROM_CAPTURE;
+	capture->index = outer.index;
+	capture->isShared = outer.isBoxed;
+	return prototype->captureCount++;
+}
+
+/**
+ * Resolves a name from the innermost scope outwards. A variable of an
+ * enclosing function becomes a capture of every function in between, so the
+ * closures stay flat. It's shared if the variable lives in a cell.
+ */
+static Location _resolve(FunctionState * state, const char * name) {
+	Location location = { UNRESOLVED_LOCATION, 0, false };
+	for (int k = state->localCount - 1; 0 <= k; --k) {
+		if (state->locals[k].name != NULL && strcmp(state->locals[k].name, name) == 0) {
+			location.type = LOCAL_LOCATION;
+			location.index = state->locals[k].target;
+			location.isBoxed = state->locals[k].isBoxed;
+			return location;
+		}
+	}
+	for (int k = 0; k < state->prototype->captureCount; ++k) {
+		if (strcmp(state->prototype->captures[k].name, name) == 0) {
+			location.type = CAPTURE_LOCATION;
+			location.index = k;
+			location.isBoxed = state->prototype->captures[k].isShared;
+			return location;
+		}
+	}
+	if (state->class != NULL) {
+		location.index = _fieldIndex(state->class, name);
+		if (0 <= location.index) {
+			location.type = FIELD_LOCATION;
+			return location;
+		}
+		location.index = _staticSlot(state->class, name);
+		if (0 <= location.index) {
+			location.type = GLOBAL_LOCATION;
+			return location;
+		}
+		location.index = _methodSlot(state->class, name);
+		if (0 <= location.index) {
+			location.type = METHOD_LOCATION;
+			return location;
+		}
+	}
+	if (state->parent != NULL) {
+		const Location outer = _resolve(state->parent, name);
+		if (outer.type == LOCAL_LOCATION || outer.type == CAPTURE_LOCATION) {
+			location.type = CAPTURE_LOCATION;
+			location.index = _addCapture(state, name, outer);
+			location.isBoxed = outer.isBoxed;
+			return location;
+		}
+		return outer;
+	}
+	location.index = _globalSlot(state->compilation, name);
+	location.type = state->compilation->declaredGlobals[location.index] ? GLOBAL_LOCATION : UNRESOLVED_LOCATION;
+	return location;
+}
+
+/**
+ * Declares a name in the current scope: a global at the top-level, or a new
+ * local otherwise.
+ */
+static Location _declareVariable(FunctionState * state, const char * name) {
+	Location location = { LOCAL_LOCATION, 0, false };
+	if (state->isTopLevel && state->depth == 0) {
+		location.type = GLOBAL_LOCATION;
+		location.index = _globalSlot(state->compilation, name);
+		state->compilation->declaredGlobals[location.index] = true;
+		return location;
+	}
+	location.index = _declareLocal(state, name);
+	location.isBoxed = state->locals[state->localCount - 1].isBoxed;
+	if (location.isBoxed) {
+		_emit(state, OP_LOADNIL, location.index, 0, 0);
+		_emit(state, OP_BOX, location.index, 0, 0);
+	}
+	return location;
+}
+
+/**
+ * A register that holds the receiver of the current method (directly, or
+ * through the captures of the lambdas nested inside it).
+ */
+static int _receiverRegister(FunctionState * state) {
+	const Location location = _resolve(state, "this");
+	if (location.type == LOCAL_LOCATION && !location.isBoxed) {
+		return location.index;
+	}
+	const int target = _allocateRegister(state);
+	_loadLocation(state, location, "this", target);
+	return target;
+}
+
+static void _loadLocation(FunctionState * state, const Location location, const char * name, const int target) {
+	switch (location.type) {
+		case LOCAL_LOCATION:
+			if (location.isBoxed) {
+				_emit(state, OP_GETCELL, target, location.index, 0);
+			}
+			else if (location.index != target) {
+				_emit(state, OP_MOVE, target, location.index, 0);
+			}
+			break;
+		case CAPTURE_LOCATION:
+			_emit(state, location.isBoxed ? OP_GETSHARED : OP_GETCAPTURE, target, location.index, 0);
+			break;
+		case FIELD_LOCATION:
+			_emit(state, OP_GETFIELD, target, _receiverRegister(state), location.index);
+			break;
+		case METHOD_LOCATION: {
+			const int receiver = _receiverRegister(state);
+			const int constant = _stringConstant(state, name);
+			if (MAXIMUM_OPERAND < constant) {
+				logError(_logger, "The body of '%s' has too many names to reference method '%s'.", state->prototype->name, name);
+				state->compilation->errors += 1;
+			}
+			_emit(state, OP_GETMETHOD, target, receiver, constant);
+			break;
+		}
+		default:
+			_emitExtended(state, OP_GETGLOBAL, target, location.index);
+			break;
+	}
+}
+
+static void _storeLocation(FunctionState * state, const Location location, const char * name, const int source) {
+	switch (location.type) {
+		case LOCAL_LOCATION:
+			if (location.isBoxed) {
+				_emit(state, OP_SETCELL, location.index, source, 0);
+			}
+			else if (location.index != source) {
+				_emit(state, OP_MOVE, location.index, source, 0);
+			}
+			break;
+		case CAPTURE_LOCATION:
+			if (!location.isBoxed) {
+				logError(_logger, "Captured variable '%s' is copied, so it cannot be assigned (in '%s').", name, state->prototype->name);
+				state->compilation->errors += 1;
+			}
+			_emit(state, OP_SETSHARED, location.index, source, 0);
+			break;
+		case FIELD_LOCATION:
+			_emit(state, OP_SETFIELD, _receiverRegister(state), location.index, source);
+			break;
+		case METHOD_LOCATION:
+			logError(_logger, "Method '%s' cannot be reassigned (in '%s').", name, state->prototype->name);
+			state->compilation->errors += 1;
+			break;
+		default:
+			_emitExtended(state, OP_SETGLOBAL, source, location.index);
+			break;
+	}
+}
+
+/* ------------------------------ Expressions ----------------------------- */
+
+static boolean _isNumericConstant(FunctionState * state, Expression * expression, Value * value) {
+	if (expression->type != FACTOR || expression->factor->type != CONSTANT) return false;
+	Constant * constant = expression->factor->constant;
+	switch (constant->type) {
+		case C_INT_TYPE:
+			*value = integerValue(&state->compilation->program->literals, constant->intValue);
+			return true;
+		case C_DOUBLE_TYPE:
+			*value = decimalValue(constant->doubleValue);
+			return true;
+		case C_FLOAT_TYPE:
+			*value = decimalValue(constant->floatValue);
+			return true;
+		default:
+			return false;
+	}
+}
+
+static StaticType _declaredType(const VariableType type) {
+	switch (type) {
+		case V_INT:
+		case V_LONG:
+		case V_SHORT:
+			return INTEGER_STATIC_TYPE;
+		case V_DOUBLE:
+		case V_FLOAT:
+			return DECIMAL_STATIC_TYPE;
+		case V_CHAR:
+		case V_STRING:
+			return STRING_STATIC_TYPE;
+		default:
+			return UNKNOWN_STATIC_TYPE;
+	}
+}
+
+/**
+ * The type of the values of an arithmetic expression. Mixing an integer with
+ * a decimal produces a decimal, and adding anything to a string produces a
+ * string.
+ */
+static StaticType _expressionType(FunctionState * state, Expression * expression) {
+	switch (expression->type) {
+		case ADDITION:
+		case SUBTRACTION:
+		case MULTIPLICATION:
+		case DIVISION: {
+			const StaticType left = _expressionType(state, expression->leftExpression);
+			const StaticType right = _expressionType(state, expression->rightExpression);
+			if (left == STRING_STATIC_TYPE || right == STRING_STATIC_TYPE) {
+				return expression->type == ADDITION ? STRING_STATIC_TYPE : UNKNOWN_STATIC_TYPE;
+			}
+			if (left == UNKNOWN_STATIC_TYPE || right == UNKNOWN_STATIC_TYPE) return UNKNOWN_STATIC_TYPE;
+			return left == right ? left : DECIMAL_STATIC_TYPE;
+		}
+		case FACTOR:
+			return _factorType(state, expression->factor);
+		default:
+			return UNKNOWN_STATIC_TYPE;
+	}
+}
+
+static StaticType _factorType(FunctionState * state, Factor * factor) {
+	switch (factor->type) {
+		case CONSTANT:
+			switch (factor->constant->type) {
+				case C_INT_TYPE:
+					return INTEGER_STATIC_TYPE;
+				case C_DOUBLE_TYPE:
+				case C_FLOAT_TYPE:
+					return DECIMAL_STATIC_TYPE;
+				case C_CHAR_TYPE:
+				case C_STRING_TYPE:
+					return STRING_STATIC_TYPE;
+				default:
+					return UNKNOWN_STATIC_TYPE;
+			}
+		case VARIABLE_TYPE:
+		case INCREMENT_TYPE:
+		case DECREMENT_TYPE:
+			return _localType(state, factor->variable);
+		case EXPRESSION:
+			return _expressionType(state, factor->expression);
+	}
+	return UNKNOWN_STATIC_TYPE;
+}
+
+/**
+ * A register that holds the value of the expression: the register of a
+ * local variable, or a new temporary one.
+ */
+static int _expressionRegister(FunctionState * state, Expression * expression) {
+	if (expression->type == FACTOR) {
+		return _factorRegister(state, expression->factor);
+	}
+	const int target = _allocateRegister(state);
+	_compileExpression(state, expression, target, NULL);
+	return target;
+}
+
+/**
+ * A register that holds the value of an operand. An operation compiled into
+ * a new register is an intermediate result, so it's a temporary.
+ */
+static int _operandRegister(FunctionState * state, Expression * expression) {
+	while (expression->type == FACTOR && expression->factor->type == EXPRESSION) {
+		expression = expression->factor->expression;
+	}
+	switch (expression->type) {
+		case ADDITION:
+		case SUBTRACTION:
+		case MULTIPLICATION:
+		case DIVISION: {
+			const int target = _allocateRegister(state);
+			_compileOperation(state, expression, target, NULL, true);
+			return target;
+		}
+		default:
+			return _expressionRegister(state, expression);
+	}
+}
+
+static int _factorRegister(FunctionState * state, Factor * factor) {
+	if (factor->type == VARIABLE_TYPE) {
+		const Location location = _resolve(state, factor->variable);
+		if (location.type == LOCAL_LOCATION && !location.isBoxed) {
+			return location.index;
+		}
+	}
+	else if (factor->type == EXPRESSION) {
+		return _expressionRegister(state, factor->expression);
+	}
+	const int target = _allocateRegister(state);
+	_compileFactor(state, factor, target, NULL);
+	return target;
+}
+
+/**
+ * Emits "target = left <op> right". A constant right operand is encoded in
+ * the instruction, so it doesn't need a register. If both operands have the
+ * same known type, the instruction is already specialized for it (integer
+ * division has no specialized form, since it may fail). A concatenation
+ * whose result is a temporary allocates it in the region of the frame.
+ */
+static void _compileArithmetic(FunctionState * state, const ExpressionType type, const int target, const int left, const StaticType leftType, Expression * right, const boolean isTemporary) {
+	static const Opcode registerOpcodes[][SUBTRACTION + 1] = {
+		[UNKNOWN_STATIC_TYPE] = { [ADDITION] = OP_ADD, [SUBTRACTION] = OP_SUB, [MULTIPLICATION] = OP_MUL, [DIVISION] = OP_DIV },
+		[INTEGER_STATIC_TYPE] = { [ADDITION] = OP_ADD_INT, [SUBTRACTION] = OP_SUB_INT, [MULTIPLICATION] = OP_MUL_INT, [DIVISION] = OP_DIV },
+		[DECIMAL_STATIC_TYPE] = { [ADDITION] = OP_ADD_DEC, [SUBTRACTION] = OP_SUB_DEC, [MULTIPLICATION] = OP_MUL_DEC, [DIVISION] = OP_DIV_DEC }
+	};
+	static const Opcode constantOpcodes[][SUBTRACTION + 1] = {
+		[UNKNOWN_STATIC_TYPE] = { [ADDITION] = OP_ADDK, [SUBTRACTION] = OP_SUBK, [MULTIPLICATION] = OP_MULK, [DIVISION] = OP_DIVK },
+		[INTEGER_STATIC_TYPE] = { [ADDITION] = OP_ADDK_INT, [SUBTRACTION] = OP_SUBK_INT, [MULTIPLICATION] = OP_MULK_INT, [DIVISION] = OP_DIVK },
+		[DECIMAL_STATIC_TYPE] = { [ADDITION] = OP_ADDK_DEC, [SUBTRACTION] = OP_SUBK_DEC, [MULTIPLICATION] = OP_MULK_DEC, [DIVISION] = OP_DIVK_DEC }
+	};
+	const int mark = state->freeRegister;
+	const StaticType rightType = _expressionType(state, right);
+	if (type == ADDITION && isTemporary && state->hasTemporaries && (leftType == STRING_STATIC_TYPE || rightType == STRING_STATIC_TYPE)) {
+		_emit(state, OP_CONCAT, target, left, _operandRegister(state, right));
+		state->freeRegister = mark;
+		return;
+	}
+	const StaticType operandType = (leftType == rightType && leftType != STRING_STATIC_TYPE) ? leftType : UNKNOWN_STATIC_TYPE;
+	Value value;
+	if (_isNumericConstant(state, right, &value)) {
+		if (isInteger(value) && (type == ADDITION || type == SUBTRACTION)) {
+			const int64_t immediate = type == ADDITION ? asInteger(value) : -asInteger(value);
+			if (INT8_MIN <= immediate && immediate <= INT8_MAX) {
+				_emit(state, operandType == INTEGER_STATIC_TYPE ? OP_ADDI_INT : OP_ADDI, target, left, (uint8_t) (int8_t) immediate);
+				return;
+			}
+		}
+		const int constant = _addConstant(state, value);
+		if (constant <= MAXIMUM_OPERAND) {
+			_emit(state, constantOpcodes[operandType][type], target, left, constant);
+			return;
+		}
+	}
+	const int rightRegister = _operandRegister(state, right);
+	_emit(state, registerOpcodes[operandType][type], target, left, rightRegister);
+	state->freeRegister = mark;
+}
+
+static boolean _isComparison(Expression * expression) {
+	switch (expression->type) {
+		case LESS_TYPE:
+		case GREATER_TYPE:
+		case LESS_EQUAL_TYPE:
+		case GREATER_EQUAL_TYPE:
+		case EQUAL_EQUAL_TYPE:
+		case NOT_EQUAL_TYPE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * The grammar only compares factors. The greater-than comparisons swap their
+ * operands, so the machine only needs LT and LE.
+ */
+static void _compileComparison(FunctionState * state, Expression * expression, const int target) {
+	const int mark = state->freeRegister;
+	const int left = _factorRegister(state, expression->leftFactor);
+	const int right = _factorRegister(state, expression->rightFactor);
+	const boolean isInteger = (_factorType(state, expression->leftFactor) == INTEGER_STATIC_TYPE
+		&& _factorType(state, expression->rightFactor) == INTEGER_STATIC_TYPE) ? true : false;
+	switch (expression->type) {
+		case LESS_TYPE: _emit(state, isInteger ? OP_LT_INT : OP_LT, target, left, right); break;
+		case LESS_EQUAL_TYPE: _emit(state, isInteger ? OP_LE_INT : OP_LE, target, left, right); break;
+		case GREATER_TYPE: _emit(state, isInteger ? OP_LT_INT : OP_LT, target, right, left); break;
+		case GREATER_EQUAL_TYPE: _emit(state, isInteger ? OP_LE_INT : OP_LE, target, right, left); break;
+		case EQUAL_EQUAL_TYPE: _emit(state, OP_EQ, target, left, right); break;
+		default: _emit(state, OP_NE, target, left, right); break;
+	}
+	state->freeRegister = mark;
+}
+
+/**
+ * The callee is resolved statically: a method of the receiver is invoked,
+ * a class (if no variable hides it) is instantiated, and anything else must
+ * hold a callable value. The arguments go into the registers that follow the
+ * callee. A call in tail position replaces the frame of the caller (except
+ * for an instantiation, since it returns the new instance). If the result is
+ * discarded, the instance of a class with scoped instances lives in the
+ * scope of the frame, and it's dropped once the initializer returns. A list
+ * created by the native "list" into a temporary is a temporary too.
+ */
+static void _compileCall(FunctionState * state, FunctionCall * functionCall, const int target, const boolean isTail, const boolean isDiscarded) {
+	const int mark = state->freeRegister;
+	const int base = (target == state->freeRegister - 1) ? target : _allocateRegister(state);
+	const char * name = functionCall->name;
+	const Location callee = _resolve(state, name);
+	ClassDefinition * class = callee.type == UNRESOLVED_LOCATION ? _findClass(state->compilation, name) : NULL;
+	const boolean isTemporaryList = (state->compilation->hasListNatives && strcmp(name, "list") == 0
+		&& _isTemporaryTarget(state, target)) ? true : false;
+	if (callee.type == METHOD_LOCATION) {
+		_loadLocation(state, _resolve(state, "this"), "this", base);
+	}
+	else if (class == NULL && !isTemporaryList) {
+		_loadLocation(state, callee, name, base);
+	}
+	state->freeRegister = base + 1;
+	int count = 0;
+	if (functionCall->expressionList != NULL) {
+		for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next, ++count) {
+			_compileExpression(state, node->data, _allocateRegister(state), NULL);
+		}
+	}
+	if (MAXIMUM_OPERAND < count) {
+		logError(_logger, "The call to '%s' in '%s' has too many arguments.", name, state->prototype->name);
+		state->compilation->errors += 1;
+	}
+	if (callee.type == METHOD_LOCATION) {
+		const int site = _addInvokeSite(state, name, callee.index);
+		if (MAXIMUM_OPERAND < site) {
+			logError(_logger, "The body of '%s' has too many calls to invoke method '%s'.", state->prototype->name, name);
+			state->compilation->errors += 1;
+		}
+		_emit(state, isTail ? OP_TAILINVOKE : OP_INVOKE, base, site, count);
+	}
+	else if (class != NULL) {
+		const boolean isScoped = (isDiscarded && state->compilation->classSources[class->index]->hasScopedInstances) ? true : false;
+		_emit(state, isScoped ? OP_NEWSCOPED : OP_NEW, base, class->index, count);
+		if (isScoped) {
+			_emit(state, OP_DROP, base, 0, 0);
+		}
+	}
+	else if (isTemporaryList) {
+		_emit(state, OP_NEWLIST, base, count, 0);
+	}
+	else {
+		_emit(state, isTail ? OP_TAILCALL : OP_CALL, base, count, 0);
+	}
+	if (base != target) {
+		_emit(state, OP_MOVE, target, base, 0);
+	}
+	state->freeRegister = mark;
+}
+
+static void _compileConstant(FunctionState * state, Constant * constant, const int target) {
+	switch (constant->type) {
+		case C_INT_TYPE:
+			if (INT16_MIN <= constant->intValue && constant->intValue <= INT16_MAX) {
+				const int index = _emit(state, OP_LOADINT, target, 0, 0);
+				state->prototype->code[index].sbx = constant->intValue;
+			}
+			else {
+				_emitExtended(state, OP_LOADK, target, _addConstant(state, integerValue(&state->compilation->program->literals, constant->intValue)));
+			}
+			break;
+		case C_BOOLEAN_TYPE:
+			_emit(state, OP_LOADBOOL, target, constant->booleanValue ? 1 : 0, 0);
+			break;
+		case C_DOUBLE_TYPE:
+			_emitExtended(state, OP_LOADK, target, _addConstant(state, decimalValue(constant->doubleValue)));
+			break;
+		case C_FLOAT_TYPE:
+			_emitExtended(state, OP_LOADK, target, _addConstant(state, decimalValue(constant->floatValue)));
+			break;
+		case C_CHAR_TYPE: {
+			const char characters[2] = { constant->charValue, '\0' };
+			_emitExtended(state, OP_LOADK, target, _stringConstant(state, characters));
+			break;
+		}
+		case C_STRING_TYPE:
+			_emitExtended(state, OP_LOADK, target, _stringConstant(state, constant->stringValue));
+			break;
+	}
+}
+
+/** The value of a declaration without initializer. */
+static void _compileDefaultValue(FunctionState * state, const VariableType type, const int target) {
+	switch (type) {
+		case V_INT:
+		case V_LONG:
+		case V_SHORT:
+			_emit(state, OP_LOADINT, target, 0, 0);
+			break;
+		case V_DOUBLE:
+		case V_FLOAT:
+			_emitExtended(state, OP_LOADK, target, _addConstant(state, decimalValue(0.0)));
+			break;
+		case V_BOOLEAN:
+			_emit(state, OP_LOADBOOL, target, 0, 0);
+			break;
+		case V_CHAR:
+		case V_STRING:
+			_emitExtended(state, OP_LOADK, target, _stringConstant(state, ""));
+			break;
+		default:
+			_emit(state, OP_LOADNIL, target, 0, 0);
+			break;
+	}
+}
+
+/**
+ * Increments or decrements a variable. If the target is not negative, it
+ * receives the previous value.
+ */
+static void _compileIncrement(FunctionState * state, const char * name, const int delta, const int target) {
+	const int mark = state->freeRegister;
+	const Location location = _resolve(state, name);
+	if (location.type == LOCAL_LOCATION && !location.isBoxed) {
+		if (0 <= target) {
+			_emit(state, OP_MOVE, target, location.index, 0);
+		}
+		const Opcode opcode = _localType(state, name) == INTEGER_STATIC_TYPE ? OP_ADDI_INT : OP_ADDI;
+		_emit(state, opcode, location.index, location.index, (uint8_t) (int8_t) delta);
+		return;
+	}
+	const int value = 0 <= target ? target : _allocateRegister(state);
+	const int updated = _allocateRegister(state);
+	_loadLocation(state, location, name, value);
+	_emit(state, OP_ADDI, updated, value, (uint8_t) (int8_t) delta);
+	_storeLocation(state, location, name, updated);
+	state->freeRegister = mark;
+}
+
+static void _compileFactor(FunctionState * state, Factor * factor, const int target, const char * name) {
+	switch (factor->type) {
+		case CONSTANT:
+			_compileConstant(state, factor->constant, target);
+			break;
+		case VARIABLE_TYPE: {
+			const int mark = state->freeRegister;
+			_loadLocation(state, _resolve(state, factor->variable), factor->variable, target);
+			state->freeRegister = mark;
+			break;
+		}
+		case INCREMENT_TYPE:
+			_compileIncrement(state, factor->variable, 1, target);
+			break;
+		case DECREMENT_TYPE:
+			_compileIncrement(state, factor->variable, -1, target);
+			break;
+		case EXPRESSION:
+			_compileExpression(state, factor->expression, target, name);
+			break;
+	}
+}
+
+/**
+ * Compiles an expression into the target register. The name is the one of
+ * the variable that receives it, if any, to name the lambdas.
+ */
+static void _compileExpression(FunctionState * state, Expression * expression, const int target, const char * name) {
+	switch (expression->type) {
+		case ADDITION:
+		case SUBTRACTION:
+		case MULTIPLICATION:
+		case DIVISION:
+			_compileOperation(state, expression, target, name, _isTemporaryTarget(state, target));
+			break;
+		case FACTOR:
+			_compileFactor(state, expression->factor, target, name);
+			break;
+		case FUNCTION_CALL:
+			_compileCall(state, expression->functionCall, target, false, false);
+			break;
+		case LAMBDA:
+			_compileLambda(state, expression->lambda, name, target);
+			break;
+		default:
+			_compileComparison(state, expression, target);
+			break;
+	}
+}
+
+static boolean _isEmptyString(Expression * expression) {
+	return (expression->type == FACTOR && expression->factor->type == CONSTANT && expression->factor->constant->type == C_STRING_TYPE
+		&& expression->factor->constant->stringValue[0] == '\0') ? true : false;
+}
+
+/**
+ * A chain of additions whose first or second operand is a string builds its
+ * string at once: the operands go to consecutive registers, and the string
+ * is allocated with their whole length, instead of once per addition. If the
+ * head of the chain (after an empty string, as in a template) is the variable
+ * that it's assigned to, it appends to the string of the variable instead.
+ */
+static boolean _compileJoin(FunctionState * state, Expression * expression, const int target, const char * name) {
+	int count = 1;
+	Expression * link = expression;
+	for (; link->type == ADDITION; link = link->leftExpression) {
+		count += 1;
+	}
+	if (MAXIMUM_OPERAND < count) return false;
+	Expression ** parts = calloc(count, sizeof(Expression *));
+	parts[0] = link;
+	link = expression;
+	for (int k = count - 1; 0 < k; --k, link = link->leftExpression) {
+		parts[k] = link->rightExpression;
+	}
+	const Expression * head = (2 < count && _isEmptyString(parts[0])) ? parts[1] : parts[0];
+	const boolean isAppended = (name != NULL && head->type == FACTOR && head->factor->type == VARIABLE_TYPE
+		&& strcmp(head->factor->variable, name) == 0) ? true : false;
+	const boolean isJoined = ((3 <= count || isAppended)
+		&& (_expressionType(state, parts[0]) == STRING_STATIC_TYPE || _expressionType(state, parts[1]) == STRING_STATIC_TYPE)) ? true : false;
+	if (isJoined) {
+		const int base = state->freeRegister;
+		for (int k = 0; k < count; ++k) {
+			_compileExpression(state, parts[k], _allocateRegister(state), NULL);
+		}
+		_emit(state, isAppended ? OP_APPEND : OP_JOIN, target, base, count);
+		state->freeRegister = base;
+	}
+	free(parts);
+	return isJoined;
+}
+
+static void _compileOperation(FunctionState * state, Expression * expression, const int target, const char * name, const boolean isTemporary) {
+	if (expression->type == ADDITION && _compileJoin(state, expression, target, name)) return;
+	const int mark = state->freeRegister;
+	const int left = _operandRegister(state, expression->leftExpression);
+	const StaticType leftType = _expressionType(state, expression->leftExpression);
+	_compileArithmetic(state, expression->type, target, left, leftType, expression->rightExpression, isTemporary);
+	state->freeRegister = mark;
+}
+
+/* ------------------------------ Functions ------------------------------- */
+
+/** A class initializer must return its instance, so its frame is never replaced. */
+static boolean _allowsTailCalls(FunctionState * state) {
+	return (state->class == NULL || state->prototype != state->class->initializer) ? true : false;
+}
+
+/**
+ * A parameter is optional if it has a default value, which is computed by the
+ * callee only if the argument is missing.
+ */
+static void _compileLambda(FunctionState * state, Lambda * lambda, const char * name, const int target) {
+	Prototype * prototype = createPrototype(name == NULL ? "<lambda>" : name);
+	FunctionState inner;
+	_initializeFunctionState(&inner, state->compilation, state, prototype, NULL);
+	_prepareBoxedNames(&inner, lambda->block);
+	_prepareEscapingNames(&inner, lambda);
+	_enterScope(&inner);
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			const int parameterRegister = _declareLocal(&inner, parameter->name);
+			inner.locals[inner.localCount - 1].type = _declaredType(parameter->type);
+			if (parameter->expression != NULL) {
+				const int jump = _emitJump(&inner, OP_TESTARG, parameterRegister);
+				_compileExpression(&inner, parameter->expression, parameterRegister, parameter->name);
+				_patchJump(&inner, jump, prototype->codeSize);
+			}
+			if (inner.locals[inner.localCount - 1].isBoxed) {
+				_emit(&inner, OP_BOX, parameterRegister, 0, 0);
+			}
+			inner.freeRegister = _localsTop(&inner);
+			prototype->parameterCount += 1;
+		}
+	}
+	_compileBlock(&inner, lambda->block);
+	_emit(&inner, OP_RETURNNIL, 0, 0, 0);
+	_exitScope(&inner);
+	_finishFunctionState(&inner);
+	_emitExtended(state, OP_CLOSURE, target, _addPrototype(state, prototype));
+}
+
+/**
+ * A method receives the instance in its first register, and it can't capture
+ * the variables of the code that declares the class.
+ */
+static void _compileMethod(Compilation * compilation, ClassDefinition * class, Prototype * prototype, Lambda * lambda) {
+	FunctionState state;
+	_initializeFunctionState(&state, compilation, NULL, prototype, class);
+	_prepareBoxedNames(&state, lambda->block);
+	_prepareEscapingNames(&state, lambda);
+	_enterScope(&state);
+	const int receiver = _declareLocal(&state, "this");
+	if (state.locals[0].isBoxed) {
+		_emit(&state, OP_BOX, receiver, 0, 0);
+	}
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			const int parameterRegister = _declareLocal(&state, parameter->name);
+			state.locals[state.localCount - 1].type = _declaredType(parameter->type);
+			if (parameter->expression != NULL) {
+				const int jump = _emitJump(&state, OP_TESTARG, parameterRegister);
+				_compileExpression(&state, parameter->expression, parameterRegister, parameter->name);
+				_patchJump(&state, jump, prototype->codeSize);
+			}
+			if (state.locals[state.localCount - 1].isBoxed) {
+				_emit(&state, OP_BOX, parameterRegister, 0, 0);
+			}
+			state.freeRegister = _localsTop(&state);
+			prototype->parameterCount += 1;
+		}
+	}
+	_compileBlock(&state, lambda->block);
+	_emit(&state, OP_RETURNNIL, 0, 0, 0);
+	_exitScope(&state);
+	_finishFunctionState(&state);
+}
+
+/* ----------------------------- Instructions ----------------------------- */
+
+static void _compileAssignment(FunctionState * state, AssignmentOperation * assignment) {
+	static const ExpressionType operations[] = { [ADD_ASSIGN_TYPE] = ADDITION, [SUB_ASSIGN_TYPE] = SUBTRACTION, [MUL_ASSIGN_TYPE] = MULTIPLICATION };
+	const char * name = assignment->name;
+	Location location = _resolve(state, name);
+	if (assignment->assignmentOperator == ASSIGN_TYPE) {
+		if (location.type == UNRESOLVED_LOCATION) {
+			const StaticType type = _expressionType(state, assignment->expression);
+			location = _declareVariable(state, name);
+			if (location.type == LOCAL_LOCATION) {
+				state->locals[state->localCount - 1].type = type;
+			}
+		}
+		if (location.type == LOCAL_LOCATION && !location.isBoxed) {
+			_compileExpression(state, assignment->expression, location.index, name);
+			return;
+		}
+		const int value = _allocateRegister(state);
+		_compileExpression(state, assignment->expression, value, name);
+		_storeLocation(state, location, name, value);
+		return;
+	}
+	const ExpressionType operation = operations[assignment->assignmentOperator];
+	const StaticType type = location.type == LOCAL_LOCATION ? _localType(state, name) : UNKNOWN_STATIC_TYPE;
+	const boolean isRegister = (location.type == LOCAL_LOCATION && !location.isBoxed) ? true : false;
+	const int value = isRegister ? location.index : _allocateRegister(state);
+	if (!isRegister) {
+		_loadLocation(state, location, name, value);
+	}
+	if (operation == ADDITION && (type == STRING_STATIC_TYPE || _expressionType(state, assignment->expression) == STRING_STATIC_TYPE)) {
+		const int base = state->freeRegister;
+		_emit(state, OP_MOVE, _allocateRegister(state), value, 0);
+		_compileExpression(state, assignment->expression, _allocateRegister(state), NULL);
+		_emit(state, OP_APPEND, value, base, 2);
+		state->freeRegister = base;
+	}
+	else {
+		_compileArithmetic(state, operation, value, value, type, assignment->expression, isRegister ? _isTemporaryTarget(state, value) : false);
+	}
+	if (!isRegister) {
+		_storeLocation(state, location, name, value);
+	}
+}
+
+static void _compileDeclaration(FunctionState * state, VariableDeclaration * variableDeclaration) {
+	const char * name = variableDeclaration->name;
+	const Location location = _declareVariable(state, name);
+	if (location.type == LOCAL_LOCATION) {
+		state->locals[state->localCount - 1].type = _declaredType(variableDeclaration->type);
+	}
+	const int value = (location.type == LOCAL_LOCATION && !location.isBoxed) ? location.index : _allocateRegister(state);
+	if (variableDeclaration->expression == NULL) {
+		_compileDefaultValue(state, variableDeclaration->type, value);
+	}
+	else {
+		_compileExpression(state, variableDeclaration->expression, value, name);
+	}
+	_storeLocation(state, location, name, value);
+}
+
+/**
+ * Tests a comparison without materializing its boolean: the test skips the
+ * jump that follows it when the comparison holds. Returns that jump, which is
+ * taken when it doesn't.
+ */
+static int _compileTest(FunctionState * state, Expression * expression) {
+	const int mark = state->freeRegister;
+	const int left = _factorRegister(state, expression->leftFactor);
+	const int right = _factorRegister(state, expression->rightFactor);
+	const boolean isInteger = (_factorType(state, expression->leftFactor) == INTEGER_STATIC_TYPE
+		&& _factorType(state, expression->rightFactor) == INTEGER_STATIC_TYPE) ? true : false;
+	switch (expression->type) {
+		case LESS_TYPE: _emit(state, isInteger ? OP_TESTLT_INT : OP_TESTLT, left, right, 0); break;
+		case LESS_EQUAL_TYPE: _emit(state, isInteger ? OP_TESTLE_INT : OP_TESTLE, left, right, 0); break;
+		case GREATER_TYPE: _emit(state, isInteger ? OP_TESTLT_INT : OP_TESTLT, right, left, 0); break;
+		case GREATER_EQUAL_TYPE: _emit(state, isInteger ? OP_TESTLE_INT : OP_TESTLE, right, left, 0); break;
+		case EQUAL_EQUAL_TYPE: _emit(state, OP_TESTEQ, left, right, 0); break;
+		default: _emit(state, OP_TESTNE, left, right, 0); break;
+	}
+	state->freeRegister = mark;
+	return _emitJump(state, OP_JMP, 0);
+}
+
+/**
+ * Each condition falls through to its branch, or jumps to the next condition
+ * when it's false. Every branch but the last one jumps to the end.
+ */
+static void _compileConditional(FunctionState * state, Conditional * conditional) {
+	int * exits = NULL;
+	int exitCount = 0;
+	for (; conditional != NULL; conditional = conditional->nextConditional) {
+		if (conditional->expression == NULL) {
+			_compileScopedBlock(state, conditional->block);
+			break;
+		}
+		int skip;
+		if (_isComparison(conditional->expression)) {
+			skip = _compileTest(state, conditional->expression);
+		}
+		else {
+			skip = _emitJump(state, OP_JMPIFNOT, _expressionRegister(state, conditional->expression));
+		}
+		state->freeRegister = _localsTop(state);
+		_compileScopedBlock(state, conditional->block);
+		if (conditional->nextConditional != NULL) {
+			exits = realloc(exits, (exitCount + 1) * sizeof(int));
+			exits[exitCount++] = _emitJump(state, OP_JMP, 0);
+		}
+		_patchJump(state, skip, state->prototype->codeSize);
+	}
+	for (int k = 0; k < exitCount; ++k) {
+		_patchJump(state, exits[k], state->prototype->codeSize);
+	}
+	free(exits);
+}
+
+static void _enterLoop(FunctionState * state, LoopContext * loop) {
+	memset(loop, 0, sizeof(LoopContext));
+	loop->enclosing = state->loop;
+	state->loop = loop;
+}
+
+static void _exitLoop(FunctionState * state, LoopContext * loop, const int continueTarget) {
+	for (int k = 0; k < loop->continueCount; ++k) {
+		_patchJump(state, loop->continueJumps[k], continueTarget);
+	}
+	free(loop->continueJumps);
+	state->loop = loop->enclosing;
+}
+
+/**
+ * The condition is evaluated at the bottom, so every iteration only runs
+ * the condition and one jump besides the body. A constant condition that
+ * holds needs no check at all.
+ */
+static void _compileWhileLoop(FunctionState * state, Loop * loop) {
+	LoopContext context;
+	Value value;
+	Expression * expression = loop->expression;
+	const boolean isEndless = (expression->type == FACTOR && expression->factor->type == CONSTANT
+		&& ((expression->factor->constant->type == C_BOOLEAN_TYPE && expression->factor->constant->booleanValue)
+			|| (_isNumericConstant(state, expression, &value) && isTruthy(value)))) ? true : false;
+	_enterLoop(state, &context);
+	const int entry = isEndless ? -1 : _emitJump(state, OP_JMP, 0);
+	const int body = state->prototype->codeSize;
+	_compileScopedBlock(state, loop->block);
+	const int test = state->prototype->codeSize;
+	if (isEndless) {
+		_patchJump(state, _emitJump(state, OP_JMP, 0), body);
+	}
+	else {
+		_patchJump(state, entry, test);
+		const int condition = _expressionRegister(state, expression);
+		_patchJump(state, _emitJump(state, OP_JMPIF, condition), body);
+		state->freeRegister = _localsTop(state);
+	}
+	_exitLoop(state, &context, test);
+}
+
+/**
+ * A for-in loop keeps the collection, the next index and the item in three
+ * consecutive registers. A loop over a range keeps its end and the next
+ * integer instead (see "FORPREP"), so it counts without reading the range.
+ */
+static void _compileForLoop(FunctionState * state, Loop * loop) {
+	LoopContext context;
+	_enterScope(state);
+	const int base = _declareLocal(state, NULL);
+	_declareLocal(state, NULL);
+	_loadLocation(state, _resolve(state, loop->collectionName), loop->collectionName, base);
+	const int item = _declareLocal(state, loop->itemName);
+	const boolean isBoxed = state->locals[state->localCount - 1].isBoxed;
+	state->freeRegister = _localsTop(state);
+	_enterLoop(state, &context);
+	const int entry = _emitJump(state, OP_FORPREP, base);
+	const int body = state->prototype->codeSize;
+	if (isBoxed) {
+		_emit(state, OP_BOX, item, 0, 0);
+	}
+	_compileBlock(state, loop->block);
+	const int test = state->prototype->codeSize;
+	_patchJump(state, entry, test);
+	_patchJump(state, _emitJump(state, OP_FORNEXT, base), body);
+	_exitLoop(state, &context, test);
+	_exitScope(state);
+}
+
+static void _compileInstruction(FunctionState * state, Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			_compileAssignment(state, instruction->assignment);
+			break;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			_compileDeclaration(state, instruction->variableDeclaration);
+			break;
+		case INSTRUCTION_EXPRESSION: {
+			Expression * expression = instruction->expression;
+			if (expression->type == FACTOR && expression->factor->type == INCREMENT_TYPE) {
+				_compileIncrement(state, expression->factor->variable, 1, -1);
+			}
+			else if (expression->type == FACTOR && expression->factor->type == DECREMENT_TYPE) {
+				_compileIncrement(state, expression->factor->variable, -1, -1);
+			}
+			else if (expression->type == FUNCTION_CALL) {
+				_compileCall(state, expression->functionCall, _allocateRegister(state), false, true);
+			}
+			else {
+				_compileExpression(state, expression, _allocateRegister(state), NULL);
+			}
+			break;
+		}
+		case INSTRUCTION_BLOCK:
+			_compileScopedBlock(state, instruction->block);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			_compileConditional(state, instruction->conditional);
+			break;
+		case INSTRUCTION_LOOP:
+			if (instruction->loop->type == FOR_LOOP) {
+				_compileForLoop(state, instruction->loop);
+			}
+			else {
+				_compileWhileLoop(state, instruction->loop);
+			}
+			break;
+		case INSTRUCTION_RETURN: {
+			Instruction * returned = instruction->returnInstruction;
+			if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION && returned->expression->type == FUNCTION_CALL && _allowsTailCalls(state)) {
+				const int target = _allocateRegister(state);
+				_compileCall(state, returned->expression->functionCall, target, true, false);
+				_emit(state, OP_RETURN, target, 0, 0);
+				break;
+			}
+			if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION) {
+				_emit(state, OP_RETURN, _expressionRegister(state, returned->expression), 0, 0);
+				break;
+			}
+			if (returned != NULL) {
+				_compileInstruction(state, returned);
+			}
+			if (state->class != NULL && state->prototype == state->class->initializer) {
+				_emit(state, OP_RETURN, 0, 0, 0);
+			}
+			else {
+				_emit(state, OP_RETURNNIL, 0, 0, 0);
+			}
+			break;
+		}
+		case INSTRUCTION_PASS:
+			if (state->loop != NULL) {
+				LoopContext * loop = state->loop;
+				if (loop->continueCount == loop->continueCapacity) {
+					loop->continueCapacity = loop->continueCapacity == 0 ? 4 : 2 * loop->continueCapacity;
+					loop->continueJumps = realloc(loop->continueJumps, loop->continueCapacity * sizeof(int));
+				}
+				loop->continueJumps[loop->continueCount++] = _emitJump(state, OP_JMP, 0);
+			}
+			break;
+		case INSTRUCTION_CLASS:
+			_compileStatics(state, instruction->class);
+			break;
+		case INSTRUCTION_INTERFACE:
+			break;
+	}
+	state->freeRegister = _localsTop(state);
+}
+
+static void _compileBlock(FunctionState * state, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_compileInstruction(state, node->data);
+	}
+}
+
+static void _compileScopedBlock(FunctionState * state, Block * block) {
+	_enterScope(state);
+	_compileBlock(state, block);
+	_exitScope(state);
+}
+
+/* -------------------------------- Classes ------------------------------- */
+
+/** The name a class-body instruction declares, or NULL. */
+static const char * _memberName(Instruction * instruction) {
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		return instruction->variableDeclaration->name;
+	}
+	if (instruction->type == INSTRUCTION_ASSIGNMENT && instruction->assignment->assignmentOperator == ASSIGN_TYPE) {
+		return instruction->assignment->name;
+	}
+	return NULL;
+}
+
+/** Whether a class-body instruction declares an eternal field. */
+static boolean _isEternal(Instruction * instruction) {
+	if (instruction->type != INSTRUCTION_VARIABLE_DECLARATION || instruction->variableDeclaration->privacyModifierList == NULL) {
+		return false;
+	}
+	for (Node * node = instruction->variableDeclaration->privacyModifierList->first; node != NULL; node = node->next) {
+		if (((PrivacyModifier *) node->data)->type == STATIC_A) return true;
+	}
+	return false;
+}
+
+/** The lambda literal that defines a member, if it's a method. */
+static Lambda * _memberLambda(Instruction * instruction) {
+	Expression * expression = NULL;
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		expression = instruction->variableDeclaration->expression;
+	}
+	else if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+		expression = instruction->assignment->expression;
+	}
+	return (expression != NULL && expression->type == LAMBDA) ? expression->lambda : NULL;
+}
+
+static VisitAction _collectClass(void * context, void * node) {
+	Compilation * compilation = context;
+	CompiledProgram * program = compilation->program;
+	Class * source = ((Instruction *) node)->class;
+	if (_findClass(compilation, source->object->name) != NULL) return VISIT_CHILDREN;
+	if (program->classCount == compilation->classCapacity) {
+		compilation->classCapacity = compilation->classCapacity == 0 ? 8 : 2 * compilation->classCapacity;
+		program->classes = realloc(program->classes, compilation->classCapacity * sizeof(ClassDefinition *));
+		compilation->classSources = realloc(compilation->classSources, compilation->classCapacity * sizeof(Class *));
+	}
+	ClassDefinition * class = calloc(1, sizeof(ClassDefinition));
+	class->name = strdup(source->object->name);
+	class->index = program->classCount;
+	compilation->classSources[program->classCount] = source;
+	program->classes[program->classCount++] = class;
+	return VISIT_CHILDREN;
+}
+
+/**
+ * Lays out the fields and the methods of a class after the ones of its
+ * parent. Redeclared fields keep their inherited index, and overridden
+ * methods replace the inherited ones. Unknown parents are ignored. Each new
+ * eternal field takes the next global slot instead, so the instances only
+ * hold the other fields.
+ */
+static void _layoutClass(Compilation * compilation, ClassDefinition * class, const int depth) {
+	if (class->initializer != NULL || compilation->program->classCount < depth) return;
+	Class * source = compilation->classSources[class->index];
+	ClassDefinition * parent = source->inherits == NULL ? NULL : _findClass(compilation, source->inherits->name);
+	if (parent != NULL && parent != class) {
+		_layoutClass(compilation, parent, depth + 1);
+		class->parent = parent;
+		class->fieldNames = calloc(parent->fieldCount, sizeof(char *));
+		for (int k = 0; k < parent->fieldCount; ++k) {
+			class->fieldNames[k] = strdup(parent->fieldNames[k]);
+		}
+		class->fieldCount = parent->fieldCount;
+		class->staticNames = calloc(parent->staticCount, sizeof(char *));
+		class->staticSlots = calloc(parent->staticCount, sizeof(int));
+		for (int k = 0; k < parent->staticCount; ++k) {
+			class->staticNames[k] = strdup(parent->staticNames[k]);
+			class->staticSlots[k] = parent->staticSlots[k];
+		}
+		class->staticCount = parent->staticCount;
+		class->methods = calloc(parent->methodCount, sizeof(MethodDefinition));
+		for (int k = 0; k < parent->methodCount; ++k) {
+			class->methods[k] = parent->methods[k];
+			class->methods[k].name = strdup(parent->methods[k].name);
+		}
+		class->methodCount = parent->methodCount;
+	}
+	if (source->block != NULL) {
+		for (Node * node = source->block->first; node != NULL; node = node->next) {
+			const char * name = _memberName(node->data);
+			if (name == NULL) continue;
+			if (_memberLambda(node->data) == NULL) {
+				if (0 <= _fieldIndex(class, name) || 0 <= _staticSlot(class, name)) continue;
+				if (_isEternal(node->data)) {
+					char * qualifiedName = calloc(strlen(class->name) + strlen(name) + 2, sizeof(char));
+					sprintf(qualifiedName, "%s.%s", class->name, name);
+					class->staticNames = realloc(class->staticNames, (class->staticCount + 1) * sizeof(char *));
+					class->staticSlots = realloc(class->staticSlots, (class->staticCount + 1) * sizeof(int));
+					class->staticNames[class->staticCount] = strdup(name);
+					class->staticSlots[class->staticCount] = _globalSlot(compilation, qualifiedName);
+					compilation->declaredGlobals[class->staticSlots[class->staticCount++]] = true;
+					free(qualifiedName);
+				}
+				else {
+					class->fieldNames = realloc(class->fieldNames, (class->fieldCount + 1) * sizeof(char *));
+					class->fieldNames[class->fieldCount++] = strdup(name);
+				}
+				continue;
+			}
+			char * qualifiedName = calloc(strlen(class->name) + strlen(name) + 2, sizeof(char));
+			sprintf(qualifiedName, "%s.%s", class->name, name);
+			MethodDefinition method = { strdup(name), createPrototype(qualifiedName), class, false };
+			free(qualifiedName);
+			int index = 0;
+			while (index < class->methodCount && strcmp(class->methods[index].name, name) != 0) {
+				++index;
+			}
+			if (index == class->methodCount) {
+				class->methods = realloc(class->methods, (class->methodCount + 1) * sizeof(MethodDefinition));
+				class->methodCount += 1;
+			}
+			else if (class->methods[index].owner == class) {
+				releasePrototype(class->methods[index].prototype);
+				free(class->methods[index].name);
+			}
+			else {
+				free(class->methods[index].name);
+			}
+			class->methods[index] = method;
+		}
+	}
+	class->initializer = createPrototype(class->name);
+}
+
+/**
+ * The class hierarchy analysis, once every class is laid out (the program is
+ * the whole world): a slot of an ancestor is overridden if a descendant has
+ * another method in it. The sites that invoke a slot that isn't overridden
+ * are direct.
+ */
+static void _markOverrides(Compilation * compilation) {
+	const int classCount = compilation->program->classCount;
+	for (int k = 0; k < classCount; ++k) {
+		const ClassDefinition * class = compilation->program->classes[k];
+		ClassDefinition * ancestor = class->parent;
+		for (int depth = 0; ancestor != NULL && depth < classCount; ++depth, ancestor = ancestor->parent) {
+			for (int m = 0; m < ancestor->methodCount && m < class->methodCount; ++m) {
+				if (ancestor->methods[m].prototype != class->methods[m].prototype) {
+					ancestor->methods[m].isOverridden = true;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * The eternal fields are defined where their class is declared, once, and in
+ * the scope of the declaration (like globals).
+ */
+static void _compileStatics(FunctionState * state, Class * source) {
+	Compilation * compilation = state->compilation;
+	ClassDefinition * class = _findClass(compilation, source->object->name);
+	if (class == NULL || compilation->classSources[class->index] != source || source->block == NULL) return;
+	for (Node * node = source->block->first; node != NULL; node = node->next) {
+		if (!_isEternal(node->data) || _memberLambda(node->data) != NULL) continue;
+		VariableDeclaration * declaration = ((Instruction *) node->data)->variableDeclaration;
+		const int slot = _staticSlot(class, declaration->name);
+		if (slot < 0) continue;
+		const int value = _allocateRegister(state);
+		if (declaration->expression != NULL) {
+			_compileExpression(state, declaration->expression, value, declaration->name);
+		}
+		else {
+			_compileDefaultValue(state, declaration->type, value);
+		}
+		_emitExtended(state, OP_SETGLOBAL, value, slot);
+		state->freeRegister = _localsTop(state);
+	}
+}
+
+/**
+ * The initializer runs the bodies of the ancestors and then the body of the
+ * class. The first definition of each field only runs if its argument is
+ * missing, and then the value is stored in the instance. The eternal fields
+ * are already defined, but the other assignments to them run as usual.
+ */
+static void _compileClass(Compilation * compilation, ClassDefinition * class) {
+	ClassDefinition ** lineage = calloc(compilation->program->classCount + 1, sizeof(ClassDefinition *));
+	int lineageSize = 0;
+	for (ClassDefinition * ancestor = class; ancestor != NULL && lineageSize <= compilation->program->classCount; ancestor = ancestor->parent) {
+		lineage[lineageSize++] = ancestor;
+	}
+	boolean * isInitialized = calloc(class->fieldCount + 1, sizeof(boolean));
+	FunctionState state;
+	Prototype * prototype = class->initializer;
+	_initializeFunctionState(&state, compilation, NULL, prototype, class);
+	prototype->parameterCount = class->fieldCount;
+	for (int k = lineageSize - 1; 0 <= k; --k) {
+		_prepareBoxedNames(&state, compilation->classSources[lineage[k]->index]->block);
+	}
+	_declareLocal(&state, "this");
+	for (int k = 0; k < class->fieldCount; ++k) {
+		_declareLocal(&state, NULL);
+	}
+	for (int k = lineageSize - 1; 0 <= k; --k) {
+		Block * block = compilation->classSources[lineage[k]->index]->block;
+		if (block == NULL) continue;
+		for (Node * node = block->first; node != NULL; node = node->next) {
+			Instruction * instruction = node->data;
+			const char * name = _memberName(instruction);
+			if (name == NULL) {
+				_compileInstruction(&state, instruction);
+				continue;
+			}
+			if (_memberLambda(instruction) != NULL) continue;
+			const int field = _fieldIndex(class, name);
+			if (field < 0) {
+				if (!_isEternal(instruction)) {
+					_compileInstruction(&state, instruction);
+				}
+				continue;
+			}
+			Expression * expression = instruction->type == INSTRUCTION_ASSIGNMENT
+				? instruction->assignment->expression : instruction->variableDeclaration->expression;
+			const int argument = 1 + field;
+			const int jump = isInitialized[field] ? -1 : _emitJump(&state, OP_TESTARG, argument);
+			const int value = isInitialized[field] ? _allocateRegister(&state) : argument;
+			if (expression != NULL) {
+				_compileExpression(&state, expression, value, name);
+			}
+			else {
+				_compileDefaultValue(&state, instruction->variableDeclaration->type, value);
+			}
+			if (0 <= jump) {
+				_patchJump(&state, jump, prototype->codeSize);
+			}
+			_emit(&state, OP_SETFIELD, 0, field, value);
+			isInitialized[field] = true;
+			state.freeRegister = _localsTop(&state);
+		}
+	}
+	_emit(&state, OP_RETURN, 0, 0, 0);
+	_finishFunctionState(&state);
+	for (int k = 0; k < class->methodCount; ++k) {
+		MethodDefinition * method = &class->methods[k];
+		if (method->owner != class) continue;
+		Block * block = compilation->classSources[class->index]->block;
+		for (Node * node = block->first; node != NULL; node = node->next) {
+			const char * name = _memberName(node->data);
+			Lambda * lambda = _memberLambda(node->data);
+			if (lambda != NULL && strcmp(name, method->name) == 0) {
+				if (method->prototype->codeSize == 0) {
+					_compileMethod(compilation, class, method->prototype, lambda);
+				}
+				break;
+			}
+		}
+	}
+	free(isInitialized);
+	free(lineage);
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompiledProgram * compileProgram(Program * program) {
+	Compilation compilation;
+	memset(&compilation, 0, sizeof(Compilation));
+	compilation.program = calloc(1, sizeof(CompiledProgram));
+
+	Visitor visitor;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "classes";
+	visitor.pre[CLASS_NODE] = _collectClass;
+	visitor.state = &compilation;
+	Visitor * visitors[] = { &visitor };
+	walkProgram(program, visitors, 1);
+	for (int k = 0; k < compilation.program->classCount; ++k) {
+		_layoutClass(&compilation, compilation.program->classes[k], 0);
+	}
+	_markOverrides(&compilation);
+
+	compilation.hasListNatives = true;
+	memset(&visitor, 0, sizeof(Visitor));
+	visitor.name = "hidden natives";
+	visitor.pre[ASSIGNMENT_NODE] = _collectHiddenNatives;
+	visitor.pre[DECLARATION_NODE] = _collectHiddenNatives;
+	visitor.pre[LOOP_NODE] = _collectHiddenNatives;
+	visitor.pre[CLASS_NODE] = _collectHiddenNatives;
+	visitor.pre[PARAMETER_NODE] = _collectHiddenParameter;
+	visitor.state = &compilation;
+	walkProgram(program, visitors, 1);
+
+	FunctionState state;
+	compilation.program->main = createPrototype("<program>");
+	_initializeFunctionState(&state, &compilation, NULL, compilation.program->main, NULL);
+	state.isTopLevel = true;
+	_prepareBoxedNames(&state, program->block);
+	_compileBlock(&state, program->block);
+	_emit(&state, OP_RETURNNIL, 0, 0, 0);
+	_finishFunctionState(&state);
+	for (int k = 0; k < compilation.program->classCount; ++k) {
+		_compileClass(&compilation, compilation.program->classes[k]);
+	}
+
+	free(compilation.declaredGlobals);
+	free(compilation.classSources);
+	if (0 < compilation.errors) {
+		releaseCompiledProgram(compilation.program);
+		return NULL;
+	}
+	logDebugging(_logger, "Compiled %d class(es) and %d global(s).", compilation.program->classCount, compilation.program->globalCount);
+	return compilation.program;
+}
@@ -0,0 +1,35 @@
+#ifndef BYTECODE_COMPILER_HEADER
+#define BYTECODE_COMPILER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/Visitor.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Bytecode.h"
+#include "Value.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBytecodeCompilerModule();
+
+/** Shutdown module's internal state. */
+void shutdownBytecodeCompilerModule();
+
+/**
+ * Lowers an analyzed program to register-based bytecode. Names are resolved
+ * like the semantic analysis does: top-level names are globals, other names
+ * are registers of the function that declares them, and lambdas capture the
+ * variables of their enclosing functions (copied into flat closures, or
+ * through shared cells if they're mutable, see the "captureList" of every
+ * lambda). Inside a class, members are fields or methods of the receiver,
+ * and calling a class by name creates an instance. A call in a "return"
+ * replaces the frame of the caller.
+ *
+ * @return The compiled program, or NULL if it can't be represented (e.g., a
+ *	function needs too many registers).
+ */
+CompiledProgram * compileProgram(Program * program);
+
+#endif
@@ -0,0 +1,300 @@
+#include "GarbageCollector.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeGarbageCollectorModule() {
+	_logger = createLogger("GarbageCollector");
+}
+
+void shutdownGarbageCollectorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** The objects whose references a collection hasn't traced yet. */
+typedef struct {
+	VirtualMachine * machine;
+	Heap * heap;
+	HeapObject ** pending;
+	int pendingCount;
+	int pendingCapacity;
+} Collector;
+
+/** Visits a slot that may reference an object, and may update it. */
+typedef void (*SlotVisitor)(Collector * collector, Value * slot);
+
+/* PRIVATE FUNCTIONS */
+
+static void _collectNursery(Collector * collector);
+static void _collectOldGeneration(Collector * collector);
+static void _evacuate(Collector * collector, Value * slot);
+static boolean _isScoped(const VirtualMachine * machine, const HeapObject * object);
+static void _mark(Collector * collector, Value * slot);
+static size_t _objectSize(const HeapObject * object);
+static void _push(Collector * collector, HeapObject * object);
+static void _traceCards(Collector * collector, ListObject * list);
+static void _traceObject(Collector * collector, HeapObject * object, SlotVisitor visit);
+static void _traceRoots(Collector * collector, SlotVisitor visit);
+
+/** The bytes of an object, as allocated. */
+static size_t _objectSize(const HeapObject * object) {
+	switch (object->type) {
+		case STRING_OBJECT: {
+			const StringObject * string = (const StringObject *) object;
+			if (string->base != NULL) return sizeof(StringObject);
+			return sizeof(StringObject) + (string->length < string->capacity ? string->capacity : string->length) + 1;
+		}
+		case LIST_OBJECT:
+			return sizeof(ListObject);
+		case RANGE_OBJECT:
+			return sizeof(RangeObject);
+		case CELL_OBJECT:
+			return sizeof(CellObject);
+		case CLOSURE_OBJECT:
+			return sizeof(ClosureObject) + ((const ClosureObject *) object)->captureCount * sizeof(Value);
+		case INSTANCE_OBJECT:
+			return sizeof(InstanceObject) + ((const InstanceObject *) object)->fieldCount * sizeof(Value);
+		case BOUND_METHOD_OBJECT:
+			return sizeof(BoundMethodObject);
+		case NATIVE_OBJECT:
+			return sizeof(NativeObject);
+		case INTEGER_OBJECT:
+			return sizeof(IntegerObject);
+	}
+	return sizeof(HeapObject);
+}
+
+/** Scoped instances live in the frames, so only their fields are traced. */
+static boolean _isScoped(const VirtualMachine * machine, const HeapObject * object) {
+	return (uintptr_t) object - (uintptr_t) machine->scopedInstances < SCOPED_INSTANCES_SIZE ? true : false;
+}
+
+static void _push(Collector * collector, HeapObject * object) {
+	if (collector->pendingCount == collector->pendingCapacity) {
+		collector->pendingCapacity = collector->pendingCapacity == 0 ? 256 : 2 * collector->pendingCapacity;
+		collector->pending = realloc(collector->pending, collector->pendingCapacity * sizeof(HeapObject *));
+	}
+	collector->pending[collector->pendingCount++] = object;
+}
+
+static void _traceObject(Collector * collector, HeapObject * object, SlotVisitor visit) {
+	switch (object->type) {
+		case LIST_OBJECT: {
+			ListObject * list = (ListObject *) object;
+			for (int k = 0; k < list->size; ++k) {
+				visit(collector, &list->items[k]);
+			}
+			break;
+		}
+		case CELL_OBJECT:
+			visit(collector, &((CellObject *) object)->value);
+			break;
+		case CLOSURE_OBJECT: {
+			ClosureObject * closure = (ClosureObject *) object;
+			for (int k = 0; k < closure->captureCount; ++k) {
+				visit(collector, &closure->captures[k]);
+			}
+			break;
+		}
+		case INSTANCE_OBJECT: {
+			InstanceObject * instance = (InstanceObject *) object;
+			for (int k = 0; k < instance->fieldCount; ++k) {
+				visit(collector, &instance->fields[k]);
+			}
+			break;
+		}
+		case BOUND_METHOD_OBJECT:
+			visit(collector, &((BoundMethodObject *) object)->receiver);
+			break;
+		case STRING_OBJECT: {
+			StringObject * string = (StringObject *) object;
+			if (string->base == NULL) break;
+			Value base = objectValue(string->base);
+			visit(collector, &base);
+			string->base = (StringObject *) asObject(base);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/** Evacuates the items in the marked cards of a list, and clears them. */
+static void _traceCards(Collector * collector, ListObject * list) {
+	for (int card = 0; card < list->cardCount; ++card) {
+		if (!list->cards[card]) continue;
+		list->cards[card] = false;
+		const int end = (card + 1) << CARD_SHIFT;
+		for (int k = card << CARD_SHIFT; k < end && k < list->size; ++k) {
+			_evacuate(collector, &list->items[k]);
+		}
+	}
+}
+
+/**
+ * The registers of a frame that returned are dead, even if a new frame
+ * reuses them, since every frame clears the registers without an argument.
+ */
+static void _traceRoots(Collector * collector, SlotVisitor visit) {
+	VirtualMachine * machine = collector->machine;
+	for (int k = 0; k < machine->program->globalCount; ++k) {
+		visit(collector, &machine->globals[k].value);
+	}
+	if (0 < machine->frameCount) {
+		const CallFrame * top = &machine->frames[machine->frameCount - 1];
+		for (Value * slot = machine->stack; slot < top->base + top->prototype->registerCount; ++slot) {
+			visit(collector, slot);
+		}
+	}
+	for (int k = 0; k < machine->frameCount; ++k) {
+		CallFrame * frame = &machine->frames[k];
+		if (frame->closure == NULL) continue;
+		Value closure = objectValue(frame->closure);
+		visit(collector, &closure);
+		frame->closure = (ClosureObject *) asObject(closure);
+	}
+	for (size_t offset = 0; offset < machine->scopedInstancesSize;) {
+		InstanceObject * instance = (InstanceObject *) (machine->scopedInstances + offset);
+		_traceObject(collector, &instance->header, visit);
+		offset += sizeof(InstanceObject) + instance->fieldCount * sizeof(Value);
+	}
+}
+
+/**
+ * Copies a young object into the old generation (once), and updates the
+ * slot. The copy of a list takes its items along.
+ */
+static void _evacuate(Collector * collector, Value * slot) {
+	Heap * heap = collector->heap;
+	if (!isObject(*slot) || !isYoungObject(heap, asObject(*slot))) return;
+	HeapObject * object = asObject(*slot);
+	if (!object->isMarked) {
+		const size_t size = _objectSize(object);
+		HeapObject * copy = malloc(size);
+		memcpy(copy, object, size);
+		copy->next = heap->objects;
+		heap->objects = copy;
+		heap->oldBytes += size;
+		heap->statistics.promotedBytes += size;
+		object->isMarked = true;
+		object->next = copy;
+		_push(collector, copy);
+	}
+	*slot = objectValue(object->next);
+}
+
+static void _mark(Collector * collector, Value * slot) {
+	if (!isObject(*slot)) return;
+	HeapObject * object = asObject(*slot);
+	if (_isScoped(collector->machine, object) || isRegionObject(collector->heap, object) || object->isMarked) return;
+	object->isMarked = true;
+	_push(collector, object);
+}
+
+static void _collectNursery(Collector * collector) {
+	Heap * heap = collector->heap;
+	const size_t promotedBytes = heap->statistics.promotedBytes;
+	_traceRoots(collector, _evacuate);
+	for (int k = 0; k < heap->region.listCount; ++k) {
+		_traceObject(collector, &heap->region.lists[k]->header, _evacuate);
+	}
+	for (int k = 0; k < heap->rememberedCount; ++k) {
+		HeapObject * object = heap->remembered[k];
+		object->isRemembered = false;
+		if (object->type == LIST_OBJECT && ((ListObject *) object)->cards != NULL) {
+			_traceCards(collector, (ListObject *) object);
+		}
+		else {
+			_traceObject(collector, object, _evacuate);
+		}
+	}
+	while (0 < collector->pendingCount) {
+		_traceObject(collector, collector->pending[--collector->pendingCount], _evacuate);
+	}
+	for (int k = 0; k < heap->youngListCount; ++k) {
+		if (!heap->youngLists[k]->header.isMarked) {
+			free(heap->youngLists[k]->items);
+		}
+	}
+	const size_t survivingBytes = heap->statistics.promotedBytes - promotedBytes;
+	heap->statistics.freedBytes += survivingBytes < heap->nurseryTop ? heap->nurseryTop - survivingBytes : 0;
+	heap->statistics.minorCollections += 1;
+	heap->nurseryTop = 0;
+	heap->youngListCount = 0;
+	heap->rememberedCount = 0;
+}
+
+/**
+ * Runs after a minor collection, so every object is old (or a temporary,
+ * which is never marked: the lists of the region are roots).
+ */
+static void _collectOldGeneration(Collector * collector) {
+	Heap * heap = collector->heap;
+	_traceRoots(collector, _mark);
+	for (int k = 0; k < heap->region.listCount; ++k) {
+		_traceObject(collector, &heap->region.lists[k]->header, _mark);
+	}
+	while (0 < collector->pendingCount) {
+		_traceObject(collector, collector->pending[--collector->pendingCount], _mark);
+	}
+	HeapObject ** link = &heap->objects;
+	while (*link != NULL) {
+		HeapObject * object = *link;
+		if (object->isMarked) {
+			object->isMarked = false;
+			link = &object->next;
+			continue;
+		}
+		*link = object->next;
+		const size_t size = _objectSize(object);
+		heap->oldBytes -= size;
+		heap->statistics.freedBytes += size;
+		if (object->type == LIST_OBJECT) {
+			free(((ListObject *) object)->items);
+			free(((ListObject *) object)->cards);
+		}
+		free(object);
+	}
+	heap->oldLimit = MINIMUM_OLD_GENERATION_SIZE < 2 * heap->oldBytes ? 2 * heap->oldBytes : MINIMUM_OLD_GENERATION_SIZE;
+	heap->statistics.majorCollections += 1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void createNursery(Heap * heap, const size_t size) {
+	heap->nursery = size == 0 ? NULL : malloc(size);
+	heap->nurserySize = heap->nursery == NULL ? 0 : size;
+	heap->nurseryTop = 0;
+	heap->oldLimit = MINIMUM_OLD_GENERATION_SIZE;
+}
+
+void collectGarbage(VirtualMachine * machine) {
+	struct timespec start;
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	Collector collector;
+	memset(&collector, 0, sizeof(Collector));
+	collector.machine = machine;
+	collector.heap = &machine->heap;
+	_collectNursery(&collector);
+	const boolean isMajor = machine->heap.oldLimit < machine->heap.oldBytes ? true : false;
+	if (isMajor) {
+		_collectOldGeneration(&collector);
+	}
+	machine->heap.isCollectionPending = false;
+	free(collector.pending);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	const double milliseconds = 1e3 * (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e6;
+	HeapStatistics * statistics = &machine->heap.statistics;
+	statistics->pauseMilliseconds += milliseconds;
+	if (statistics->longestPauseMilliseconds < milliseconds) {
+		statistics->longestPauseMilliseconds = milliseconds;
+	}
+	if (isMajor) {
+		logDebugging(_logger, "Collected the old generation in %.3f ms, and %zu byte(s) survive.", milliseconds, machine->heap.oldBytes);
+	}
+}
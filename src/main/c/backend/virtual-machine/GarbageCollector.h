@@ -0,0 +1,47 @@
+#ifndef GARBAGE_COLLECTOR_HEADER
+#define GARBAGE_COLLECTOR_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Value.h"
+#include "VirtualMachine.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** The bytes of the nursery of a running program, by default. */
+#define DEFAULT_NURSERY_SIZE (1 << 20)
+
+/** The bytes of old objects that a program allocates before the first major collection. */
+#define MINIMUM_OLD_GENERATION_SIZE (1 << 23)
+
+/** Initialize module's internal state. */
+void initializeGarbageCollectorModule();
+
+/** Shutdown module's internal state. */
+void shutdownGarbageCollectorModule();
+
+/**
+ * Gives the heap a nursery of the given size, or none if it's zero (then
+ * every object lives until the heap is released).
+ */
+void createNursery(Heap * heap, const size_t size);
+
+/**
+ * Collects the garbage of the heap of the machine, which must be at a
+ * safepoint: every live value is in a register of a frame, a global, the
+ * closure of a frame, a field of a scoped instance, an item of a list in the
+ * region, or an object reachable from those. The temporaries themselves are
+ * released by their frames, never by a collection.
+ *
+ * A minor collection copies the young objects reachable from the roots and
+ * from the remembered objects into the old generation, and then empties the
+ * nursery. If the old generation outgrows its limit, a major collection
+ * marks it from the roots and sweeps it, and the limit grows with the bytes
+ * that survive. The literals of the program are marked once, and they stay
+ * marked, since they're strings and no sweep ever releases them.
+ */
+void collectGarbage(VirtualMachine * machine);
+
+#endif
@@ -0,0 +1,179 @@
+#include "Natives.h"
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _clock(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _expectArguments(VirtualMachine * machine, const char * name, const int count, const int minimum, const int maximum);
+static boolean _expectIndex(VirtualMachine * machine, const char * name, const Value index, const int64_t size, int64_t * position);
+static boolean _get(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _list(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _print(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _push(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _range(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _set(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static boolean _size(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+static Value _storedValue(VirtualMachine * machine, const ListObject * list, const Value value);
+
+/**
+ * The value that a list receives. A temporary list never outlives the frame
+ * that allocates it, so it holds any temporary of that frame (or of an older
+ * one). Other lists hold the promoted value.
+ */
+static Value _storedValue(VirtualMachine * machine, const ListObject * list, const Value value) {
+	return isRegionObject(&machine->heap, &list->header) ? value : promoteValue(&machine->heap, value);
+}
+
+static boolean _expectArguments(VirtualMachine * machine, const char * name, const int count, const int minimum, const int maximum) {
+	if (count < minimum || maximum < count) {
+		runtimeError(machine, "Function '%s' expects between %d and %d argument(s), but it receives %d.", name, minimum, maximum, count);
+		return false;
+	}
+	return true;
+}
+
+static boolean _expectIndex(VirtualMachine * machine, const char * name, const Value index, const int64_t size, int64_t * position) {
+	if (!isInteger(index)) {
+		runtimeError(machine, "Function '%s' expects an integer index, but it receives a %s.", name, valueTypeName(index));
+		return false;
+	}
+	if (asInteger(index) < 0 || size <= asInteger(index)) {
+		runtimeError(machine, "Index %lld is out of bounds [0, %lld).", (long long) asInteger(index), (long long) size);
+		return false;
+	}
+	*position = asInteger(index);
+	return true;
+}
+
+static boolean _print(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	for (int k = 0; k < count; ++k) {
+		if (0 < k) emitText(machine->output, " ", 1);
+		printValue(machine->output, arguments[k]);
+	}
+	emitText(machine->output, "\n", 1);
+	*result = nilValue();
+	return true;
+}
+
+static boolean _list(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	ListObject * list = newList(&machine->heap, count);
+	for (int k = 0; k < count; ++k) {
+		appendToList(list, promoteValue(&machine->heap, arguments[k]));
+	}
+	*result = objectValue(list);
+	return true;
+}
+
+static boolean _push(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "push", count, 2, 2)) return false;
+	if (!isObjectOfType(arguments[0], LIST_OBJECT)) {
+		runtimeError(machine, "Function 'push' expects a list, but it receives a %s.", valueTypeName(arguments[0]));
+		return false;
+	}
+	ListObject * list = (ListObject *) asObject(arguments[0]);
+	const Value item = _storedValue(machine, list, arguments[1]);
+	appendToList(list, item);
+	listWriteBarrier(&machine->heap, list, list->size - 1, item);
+	*result = arguments[0];
+	return true;
+}
+
+static boolean _size(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "size", count, 1, 1)) return false;
+	const Value collection = arguments[0];
+	if (isObjectOfType(collection, LIST_OBJECT)) {
+		*result = smallIntegerValue(((ListObject *) asObject(collection))->size);
+	}
+	else if (isObjectOfType(collection, STRING_OBJECT)) {
+		*result = smallIntegerValue(((StringObject *) asObject(collection))->length);
+	}
+	else if (isObjectOfType(collection, RANGE_OBJECT)) {
+		const RangeObject * range = (RangeObject *) asObject(collection);
+		*result = integerValue(&machine->heap, range->start < range->end ? range->end - range->start : 0);
+	}
+	else {
+		runtimeError(machine, "Function 'size' expects a collection, but it receives a %s.", valueTypeName(collection));
+		return false;
+	}
+	return true;
+}
+
+static boolean _get(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "get", count, 2, 2)) return false;
+	const Value collection = arguments[0];
+	int64_t position;
+	if (isObjectOfType(collection, LIST_OBJECT)) {
+		const ListObject * list = (ListObject *) asObject(collection);
+		if (!_expectIndex(machine, "get", arguments[1], list->size, &position)) return false;
+		*result = list->items[position];
+	}
+	else if (isObjectOfType(collection, STRING_OBJECT)) {
+		const StringObject * string = (StringObject *) asObject(collection);
+		if (!_expectIndex(machine, "get", arguments[1], string->length, &position)) return false;
+		*result = objectValue(newString(&machine->heap, &stringCharacters(string)[position], 1));
+	}
+	else {
+		runtimeError(machine, "Function 'get' expects a list or a string, but it receives a %s.", valueTypeName(collection));
+		return false;
+	}
+	return true;
+}
+
+static boolean _set(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "set", count, 3, 3)) return false;
+	if (!isObjectOfType(arguments[0], LIST_OBJECT)) {
+		runtimeError(machine, "Function 'set' expects a list, but it receives a %s.", valueTypeName(arguments[0]));
+		return false;
+	}
+	ListObject * list = (ListObject *) asObject(arguments[0]);
+	int64_t position;
+	if (!_expectIndex(machine, "set", arguments[1], list->size, &position)) return false;
+	const Value item = _storedValue(machine, list, arguments[2]);
+	list->items[position] = item;
+	listWriteBarrier(&machine->heap, list, position, item);
+	*result = arguments[2];
+	return true;
+}
+
+static boolean _range(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "range", count, 1, 2)) return false;
+	for (int k = 0; k < count; ++k) {
+		if (!isInteger(arguments[k])) {
+			runtimeError(machine, "Function 'range' expects integers, but it receives a %s.", valueTypeName(arguments[k]));
+			return false;
+		}
+	}
+	const int64_t start = count == 1 ? 0 : asInteger(arguments[0]);
+	*result = objectValue(newRange(&machine->heap, start, asInteger(arguments[count - 1])));
+	return true;
+}
+
+/** The seconds elapsed since an arbitrary point, to measure durations. */
+static boolean _clock(VirtualMachine * machine, Value * arguments, const int count, Value * result) {
+	if (!_expectArguments(machine, "clock", count, 0, 0)) return false;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	*result = decimalValue(now.tv_sec + now.tv_nsec / 1e9);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void installNatives(VirtualMachine * machine) {
+	static const struct {
+		const char * name;
+		NativeFunction function;
+	} natives[] = {
+		{ "clock", _clock },
+		{ "get", _get },
+		{ "list", _list },
+		{ "print", _print },
+		{ "push", _push },
+		{ "range", _range },
+		{ "set", _set },
+		{ "size", _size }
+	};
+	for (unsigned int k = 0; k < sizeof(natives) / sizeof(natives[0]); ++k) {
+		Value native = objectValue(newNative(&machine->heap, natives[k].name, natives[k].function));
+		defineGlobal(machine, natives[k].name, native);
+	}
+}
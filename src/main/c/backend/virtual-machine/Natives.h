@@ -0,0 +1,22 @@
+#ifndef NATIVES_HEADER
+#define NATIVES_HEADER
+
+#include "../../shared/Type.h"
+#include "Value.h"
+#include "VirtualMachine.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Defines the functions implemented by the runtime, as globals:
+ *
+ *	print(values...), list(items...), push(list, item), size(collection),
+ *	get(collection, index), set(list, index, item), range([start,] end) and
+ *	clock().
+ *
+ * The program can hide any of them with its own global.
+ */
+void installNatives(VirtualMachine * machine);
+
+#endif
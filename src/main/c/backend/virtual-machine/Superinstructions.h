@@ -0,0 +1,20 @@
+#ifndef SUPERINSTRUCTIONS_HEADER
+#define SUPERINSTRUCTIONS_HEADER
+
+/**
+ * The superinstructions of the virtual machine, as SUPERINSTRUCTION(argument,
+ * name, first, second, format of the first). Generated by
+ * "script/ubuntu/superinstructions.sh" from the hottest pairs of opcodes of
+ * the benchmarks and the execution tests. Don't edit it by hand.
+ */
+#define SUPERINSTRUCTIONS(SUPERINSTRUCTION, argument) \
+	SUPERINSTRUCTION(argument, ADDI_INT_JMPIF, ADDI_INT, JMPIF, ABSC) \
+	SUPERINSTRUCTION(argument, SUB_INT_ADD_INT, SUB_INT, ADD_INT, ABC) \
+	SUPERINSTRUCTION(argument, ADD_INT_ADDI_INT, ADD_INT, ADDI_INT, ABC) \
+	SUPERINSTRUCTION(argument, ADDI_INT_ADDI_INT, ADDI_INT, ADDI_INT, ABSC) \
+	SUPERINSTRUCTION(argument, LOADINT_TESTLE_INT, LOADINT, TESTLE_INT, ASBX) \
+	SUPERINSTRUCTION(argument, ADDI_INT_LOADINT, ADDI_INT, LOADINT, ABSC) \
+	SUPERINSTRUCTION(argument, MUL_DEC_ADD_DEC, MUL_DEC, ADD_DEC, ABC) \
+	SUPERINSTRUCTION(argument, MUL_DEC_ADDK_DEC, MUL_DEC, ADDK_DEC, ABC)
+
+#endif
@@ -0,0 +1,523 @@
+#include "Value.h"
+#include "Bytecode.h"
+
+/**
+ * The text of the values of a join that aren't strings, formatted once (while
+ * they fit), and kept with their terminators.
+ */
+typedef struct {
+	char characters[1024];
+	int top;
+} FormattedParts;
+
+/* PRIVATE FUNCTIONS */
+
+static void * _allocate(Heap * heap, const ObjectType type, const size_t size);
+static void * _allocateTemporary(Heap * heap, const ObjectType type, const size_t size);
+static StringObject * _concatenate(Heap * heap, const Value left, const Value right, const boolean isTemporary);
+static char * _copyParts(FormattedParts * formatted, char * characters, const Value * values, const int count);
+static int _formatDecimal(char * buffer, const size_t size, const double decimal);
+static int _formatInteger(char * buffer, const int64_t integer);
+static int _formatPrimitive(char * buffer, const size_t size, const Value value);
+static size_t _measureParts(FormattedParts * formatted, const Value * values, const int count);
+
+/**
+ * Bump-allocates the object in the nursery, if it has room. Otherwise, the
+ * object is old from the start, and it's remembered, since the caller fills
+ * it without the write barrier. A heap with a nursery then asks for a
+ * collection, which runs once every live value is in a root.
+ */
+static void * _allocate(Heap * heap, const ObjectType type, const size_t size) {
+	const size_t alignedSize = (size + 7) & ~(size_t) 7;
+	HeapObject * object;
+	if (alignedSize <= heap->nurserySize - heap->nurseryTop) {
+		object = (HeapObject *) (heap->nursery + heap->nurseryTop);
+		heap->nurseryTop += alignedSize;
+		memset(object, 0, size);
+	}
+	else {
+		object = calloc(1, size);
+		object->next = heap->objects;
+		heap->objects = object;
+		heap->oldBytes += size;
+		if (heap->nursery != NULL) {
+			rememberObject(heap, object);
+			heap->isCollectionPending = true;
+		}
+	}
+	object->type = type;
+	heap->objectCount += 1;
+	heap->allocatedBytes += size;
+	return object;
+}
+
+/**
+ * Bump-allocates the object in the region, if it has room (or in the heap,
+ * otherwise). A temporary is never remembered, so the write barriers skip it.
+ */
+static void * _allocateTemporary(Heap * heap, const ObjectType type, const size_t size) {
+	const size_t alignedSize = (size + 7) & ~(size_t) 7;
+	if (heap->region.size - heap->region.top < alignedSize) {
+		return _allocate(heap, type, size);
+	}
+	HeapObject * object = (HeapObject *) (heap->region.memory + heap->region.top);
+	heap->region.top += alignedSize;
+	memset(object, 0, size);
+	object->type = type;
+	object->isRemembered = true;
+	heap->objectCount += 1;
+	heap->allocatedBytes += size;
+	return object;
+}
+
+static StringObject * _concatenate(Heap * heap, const Value left, const Value right, const boolean isTemporary) {
+	char leftBuffer[64];
+	char rightBuffer[64];
+	const char * leftCharacters = leftBuffer;
+	const char * rightCharacters = rightBuffer;
+	int leftLength;
+	int rightLength;
+	if (isObjectOfType(left, STRING_OBJECT)) {
+		leftCharacters = stringCharacters((StringObject *) asObject(left));
+		leftLength = ((StringObject *) asObject(left))->length;
+	}
+	else {
+		leftLength = _formatPrimitive(leftBuffer, sizeof(leftBuffer), left);
+	}
+	if (isObjectOfType(right, STRING_OBJECT)) {
+		rightCharacters = stringCharacters((StringObject *) asObject(right));
+		rightLength = ((StringObject *) asObject(right))->length;
+	}
+	else {
+		rightLength = _formatPrimitive(rightBuffer, sizeof(rightBuffer), right);
+	}
+	const size_t size = sizeof(StringObject) + leftLength + rightLength + 1;
+	StringObject * string = isTemporary ? _allocateTemporary(heap, STRING_OBJECT, size) : _allocate(heap, STRING_OBJECT, size);
+	string->length = leftLength + rightLength;
+	memcpy(string->characters, leftCharacters, leftLength);
+	memcpy(string->characters + leftLength, rightCharacters, rightLength);
+	string->characters[string->length] = '\0';
+	return string;
+}
+
+/**
+ * Decimals always show a decimal point (or an exponent), so they can't be
+ * confused with integers.
+ */
+static int _formatDecimal(char * buffer, const size_t size, const double decimal) {
+	int length = snprintf(buffer, size, "%.15g", decimal);
+	if (strpbrk(buffer, ".eninf") == NULL && length + 2 < (int) size) {
+		buffer[length++] = '.';
+		buffer[length++] = '0';
+		buffer[length] = '\0';
+	}
+	return length;
+}
+
+/** Formats an integer without going through printf, since strings interpolate them often. */
+static int _formatInteger(char * buffer, const int64_t integer) {
+	char digits[24];
+	int count = 0;
+	uint64_t magnitude = integer < 0 ? 0 - (uint64_t) integer : (uint64_t) integer;
+	do {
+		digits[count++] = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	int length = 0;
+	if (integer < 0) {
+		buffer[length++] = '-';
+	}
+	while (0 < count) {
+		buffer[length++] = digits[--count];
+	}
+	buffer[length] = '\0';
+	return length;
+}
+
+/**
+ * Formats a value that isn't a string. The buffer must have room for, at
+ * least, 64 characters.
+ */
+static int _formatPrimitive(char * buffer, const size_t size, const Value value) {
+	switch (valueType(value)) {
+		case NIL_VALUE:
+			return snprintf(buffer, size, "nil");
+		case BOOLEAN_VALUE:
+			return snprintf(buffer, size, "%s", asBoolean(value) ? "true" : "false");
+		case INTEGER_VALUE:
+			return _formatInteger(buffer, asInteger(value));
+		case DECIMAL_VALUE:
+			return _formatDecimal(buffer, size, asDecimal(value));
+		default:
+			break;
+	}
+	const HeapObject * object = asObject(value);
+	switch (object->type) {
+		case LIST_OBJECT:
+			return snprintf(buffer, size, "<list of %d>", ((const ListObject *) object)->size);
+		case RANGE_OBJECT:
+			return snprintf(buffer, size, "<range %lld..%lld>",
+				(long long) ((const RangeObject *) object)->start, (long long) ((const RangeObject *) object)->end);
+		case CELL_OBJECT:
+			return snprintf(buffer, size, "<cell>");
+		case CLOSURE_OBJECT:
+			return snprintf(buffer, size, "<lambda %.40s>", ((const ClosureObject *) object)->prototype->name);
+		case INSTANCE_OBJECT:
+			return snprintf(buffer, size, "<%.40s>", ((const InstanceObject *) object)->class->name);
+		case BOUND_METHOD_OBJECT:
+			return snprintf(buffer, size, "<method %.40s>", ((const BoundMethodObject *) object)->method->name);
+		case NATIVE_OBJECT:
+			return snprintf(buffer, size, "<native %.40s>", ((const NativeObject *) object)->name);
+		default:
+			return snprintf(buffer, size, "<object>");
+	}
+}
+
+/** The length of the text of the values, which formats the ones that aren't strings. */
+static size_t _measureParts(FormattedParts * formatted, const Value * values, const int count) {
+	char buffer[64];
+	size_t length = 0;
+	for (int k = 0; k < count; ++k) {
+		if (isObjectOfType(values[k], STRING_OBJECT)) {
+			length += ((StringObject *) asObject(values[k]))->length;
+		}
+		else if (formatted->top + (int) sizeof(buffer) <= (int) sizeof(formatted->characters)) {
+			const int partLength = _formatPrimitive(formatted->characters + formatted->top, sizeof(buffer), values[k]);
+			length += partLength;
+			formatted->top += partLength + 1;
+		}
+		else {
+			length += _formatPrimitive(buffer, sizeof(buffer), values[k]);
+		}
+	}
+	return length;
+}
+
+/** Copies the text of the values that "_measureParts" measured, and returns its end. */
+static char * _copyParts(FormattedParts * formatted, char * characters, const Value * values, const int count) {
+	char buffer[64];
+	int cursor = 0;
+	for (int k = 0; k < count; ++k) {
+		const char * part = buffer;
+		int partLength;
+		if (isObjectOfType(values[k], STRING_OBJECT)) {
+			part = stringCharacters((StringObject *) asObject(values[k]));
+			partLength = ((StringObject *) asObject(values[k]))->length;
+		}
+		else if (cursor + (int) sizeof(buffer) <= (int) sizeof(formatted->characters)) {
+			part = formatted->characters + cursor;
+			partLength = strlen(part);
+			cursor += partLength + 1;
+		}
+		else {
+			partLength = _formatPrimitive(buffer, sizeof(buffer), values[k]);
+		}
+		memcpy(characters, part, partLength);
+		characters += partLength;
+	}
+	return characters;
+}
+
+/* PUBLIC FUNCTIONS */
+
+StringObject * newString(Heap * heap, const char * characters, const int length) {
+	StringObject * string = _allocate(heap, STRING_OBJECT, sizeof(StringObject) + length + 1);
+	string->length = length;
+	memcpy(string->characters, characters, length);
+	string->characters[length] = '\0';
+	return string;
+}
+
+ListObject * newList(Heap * heap, const int capacity) {
+	ListObject * list = _allocate(heap, LIST_OBJECT, sizeof(ListObject));
+	list->capacity = capacity < 4 ? 4 : capacity;
+	list->items = malloc(list->capacity * sizeof(Value));
+	heap->allocatedBytes += list->capacity * sizeof(Value);
+	if (isYoungObject(heap, &list->header)) {
+		if (heap->youngListCount == heap->youngListCapacity) {
+			heap->youngListCapacity = heap->youngListCapacity == 0 ? 64 : 2 * heap->youngListCapacity;
+			heap->youngLists = realloc(heap->youngLists, heap->youngListCapacity * sizeof(ListObject *));
+		}
+		heap->youngLists[heap->youngListCount++] = list;
+	}
+	return list;
+}
+
+ListObject * newRegionList(Heap * heap, const int capacity) {
+	if (heap->region.size - heap->region.top < sizeof(ListObject)) {
+		return newList(heap, capacity);
+	}
+	ListObject * list = _allocateTemporary(heap, LIST_OBJECT, sizeof(ListObject));
+	list->capacity = capacity < 4 ? 4 : capacity;
+	list->items = malloc(list->capacity * sizeof(Value));
+	heap->allocatedBytes += list->capacity * sizeof(Value);
+	if (heap->region.listCount == heap->region.listCapacity) {
+		heap->region.listCapacity = heap->region.listCapacity == 0 ? 64 : 2 * heap->region.listCapacity;
+		heap->region.lists = realloc(heap->region.lists, heap->region.listCapacity * sizeof(ListObject *));
+	}
+	heap->region.lists[heap->region.listCount++] = list;
+	return list;
+}
+
+RangeObject * newRange(Heap * heap, const int64_t start, const int64_t end) {
+	RangeObject * range = _allocate(heap, RANGE_OBJECT, sizeof(RangeObject));
+	range->start = start;
+	range->end = end;
+	return range;
+}
+
+CellObject * newCell(Heap * heap, const Value value) {
+	CellObject * cell = _allocate(heap, CELL_OBJECT, sizeof(CellObject));
+	cell->value = value;
+	return cell;
+}
+
+ClosureObject * newClosure(Heap * heap, Prototype * prototype, const int captureCount) {
+	ClosureObject * closure = _allocate(heap, CLOSURE_OBJECT, sizeof(ClosureObject) + captureCount * sizeof(Value));
+	closure->prototype = prototype;
+	closure->captureCount = captureCount;
+	return closure;
+}
+
+InstanceObject * newInstance(Heap * heap, ClassDefinition * class, const int fieldCount) {
+	InstanceObject * instance = _allocate(heap, INSTANCE_OBJECT, sizeof(InstanceObject) + fieldCount * sizeof(Value));
+	instance->class = class;
+	instance->fieldCount = fieldCount;
+	for (int k = 0; k < fieldCount; ++k) {
+		instance->fields[k] = nilValue();
+	}
+	return instance;
+}
+
+BoundMethodObject * newBoundMethod(Heap * heap, const Value receiver, Prototype * method) {
+	BoundMethodObject * boundMethod = _allocate(heap, BOUND_METHOD_OBJECT, sizeof(BoundMethodObject));
+	boundMethod->receiver = receiver;
+	boundMethod->method = method;
+	return boundMethod;
+}
+
+NativeObject * newNative(Heap * heap, const char * name, NativeFunction function) {
+	NativeObject * native = _allocate(heap, NATIVE_OBJECT, sizeof(NativeObject));
+	native->name = name;
+	native->function = function;
+	return native;
+}
+
+IntegerObject * newInteger(Heap * heap, const int64_t value) {
+	IntegerObject * integer = _allocate(heap, INTEGER_OBJECT, sizeof(IntegerObject));
+	integer->value = value;
+	return integer;
+}
+
+void appendToList(ListObject * list, const Value value) {
+	if (list->size == list->capacity) {
+		list->capacity *= 2;
+		list->items = realloc(list->items, list->capacity * sizeof(Value));
+	}
+	list->items[list->size++] = value;
+}
+
+void rememberObject(Heap * heap, HeapObject * object) {
+	if (heap->rememberedCount == heap->rememberedCapacity) {
+		heap->rememberedCapacity = heap->rememberedCapacity == 0 ? 64 : 2 * heap->rememberedCapacity;
+		heap->remembered = realloc(heap->remembered, heap->rememberedCapacity * sizeof(HeapObject *));
+	}
+	heap->remembered[heap->rememberedCount++] = object;
+	object->isRemembered = true;
+}
+
+void markCard(Heap * heap, ListObject * list, const int index) {
+	if (!list->header.isRemembered) {
+		rememberObject(heap, &list->header);
+		if (list->cards == NULL) {
+			list->cardCount = (list->capacity >> CARD_SHIFT) + 1;
+			list->cards = calloc(list->cardCount, sizeof(uint8_t));
+		}
+	}
+	else if (list->cards == NULL) {
+		return;
+	}
+	const int card = index >> CARD_SHIFT;
+	if (list->cardCount <= card) {
+		const int cardCount = (list->capacity >> CARD_SHIFT) + 1;
+		list->cards = realloc(list->cards, cardCount * sizeof(uint8_t));
+		memset(list->cards + list->cardCount, 0, cardCount - list->cardCount);
+		list->cardCount = cardCount;
+	}
+	list->cards[card] = true;
+}
+
+void createRegion(Heap * heap, const size_t size) {
+	heap->region.memory = size == 0 ? NULL : malloc(size);
+	heap->region.size = heap->region.memory == NULL ? 0 : size;
+	heap->region.top = 0;
+}
+
+void releaseRegion(Heap * heap, const size_t top, const int listCount) {
+	for (int k = listCount; k < heap->region.listCount; ++k) {
+		free(heap->region.lists[k]->items);
+	}
+	heap->region.listCount = listCount;
+	heap->region.top = top;
+}
+
+Value promoteTemporary(Heap * heap, const Value value) {
+	if (asObject(value)->type != STRING_OBJECT) return value;
+	const StringObject * string = (const StringObject *) asObject(value);
+	return objectValue(newString(heap, stringCharacters(string), string->length));
+}
+
+void releaseHeap(Heap * heap) {
+	HeapObject * object = heap->objects;
+	while (object != NULL) {
+		HeapObject * next = object->next;
+		if (object->type == LIST_OBJECT) {
+			free(((ListObject *) object)->items);
+			free(((ListObject *) object)->cards);
+		}
+		free(object);
+		object = next;
+	}
+	for (int k = 0; k < heap->youngListCount; ++k) {
+		free(heap->youngLists[k]->items);
+	}
+	releaseRegion(heap, 0, 0);
+	free(heap->region.lists);
+	free(heap->region.memory);
+	free(heap->youngLists);
+	free(heap->remembered);
+	free(heap->nursery);
+	memset(heap, 0, sizeof(Heap));
+}
+
+StringObject * concatenateValues(Heap * heap, const Value left, const Value right) {
+	return _concatenate(heap, left, right, false);
+}
+
+StringObject * concatenateTemporaries(Heap * heap, const Value left, const Value right) {
+	return _concatenate(heap, left, right, true);
+}
+
+StringObject * joinValues(Heap * heap, const Value * values, const int count) {
+	FormattedParts formatted;
+	formatted.top = 0;
+	const size_t length = _measureParts(&formatted, values, count);
+	StringObject * string = _allocate(heap, STRING_OBJECT, sizeof(StringObject) + length + 1);
+	*_copyParts(&formatted, string->characters, values, count) = '\0';
+	string->length = (int) length;
+	return string;
+}
+
+StringObject * appendValues(Heap * heap, const Value * values, const int count) {
+	int first = 0;
+	while (first < count - 1 && isObjectOfType(values[first], STRING_OBJECT) && ((StringObject *) asObject(values[first]))->length == 0) {
+		first += 1;
+	}
+	FormattedParts formatted;
+	formatted.top = 0;
+	const StringObject * head = isObjectOfType(values[first], STRING_OBJECT) ? (StringObject *) asObject(values[first]) : NULL;
+	StringObject * base = head == NULL ? NULL : head->base;
+	if (base != NULL && head->length == base->length) {
+		const size_t length = _measureParts(&formatted, &values[first + 1], count - first - 1);
+		if (base->length + length <= (size_t) base->capacity) {
+			_copyParts(&formatted, base->characters + base->length, &values[first + 1], count - first - 1);
+			base->length += (int) length;
+		}
+		else {
+			base = NULL;
+			formatted.top = 0;
+		}
+	}
+	else {
+		base = NULL;
+	}
+	if (base == NULL) {
+		const size_t length = _measureParts(&formatted, &values[first], count - first);
+		const size_t capacity = length < 32 ? 64 : 2 * length;
+		base = _allocate(heap, STRING_OBJECT, sizeof(StringObject) + capacity + 1);
+		_copyParts(&formatted, base->characters, &values[first], count - first);
+		base->length = (int) length;
+		base->capacity = (int) capacity;
+	}
+	StringObject * string = _allocate(heap, STRING_OBJECT, sizeof(StringObject));
+	string->length = base->length;
+	string->base = base;
+	return string;
+}
+
+boolean isTruthy(const Value value) {
+	switch (valueType(value)) {
+		case NIL_VALUE:
+			return false;
+		case BOOLEAN_VALUE:
+			return asBoolean(value);
+		case INTEGER_VALUE:
+			return asInteger(value) != 0 ? true : false;
+		case DECIMAL_VALUE:
+			return asDecimal(value) != 0.0 ? true : false;
+		default:
+			if (asObject(value)->type == STRING_OBJECT) {
+				return ((StringObject *) asObject(value))->length != 0 ? true : false;
+			}
+			return true;
+	}
+}
+
+boolean valuesEqual(const Value left, const Value right) {
+	if (isNumber(left) && isNumber(right)) {
+		if (isInteger(left) && isInteger(right)) {
+			return asInteger(left) == asInteger(right) ? true : false;
+		}
+		return toDecimal(left) == toDecimal(right) ? true : false;
+	}
+	// Nils, booleans and objects are equal if they're the same.
+	if (left.bits == right.bits) return true;
+	if (isObjectOfType(left, STRING_OBJECT) && isObjectOfType(right, STRING_OBJECT)) {
+		const StringObject * leftString = (StringObject *) asObject(left);
+		const StringObject * rightString = (StringObject *) asObject(right);
+		return (leftString->length == rightString->length
+			&& memcmp(stringCharacters(leftString), stringCharacters(rightString), leftString->length) == 0) ? true : false;
+	}
+	return false;
+}
+
+const char * valueTypeName(const Value value) {
+	switch (valueType(value)) {
+		case NIL_VALUE: return "nil";
+		case BOOLEAN_VALUE: return "boolean";
+		case INTEGER_VALUE: return "integer";
+		case DECIMAL_VALUE: return "decimal";
+		default: break;
+	}
+	switch (asObject(value)->type) {
+		case STRING_OBJECT: return "string";
+		case LIST_OBJECT: return "list";
+		case RANGE_OBJECT: return "range";
+		case CELL_OBJECT: return "cell";
+		case CLOSURE_OBJECT: return "lambda";
+		case INSTANCE_OBJECT: return "instance";
+		case BOUND_METHOD_OBJECT: return "method";
+		case NATIVE_OBJECT: return "native function";
+		default: return "object";
+	}
+}
+
+void printValue(Emitter * emitter, const Value value) {
+	if (isObjectOfType(value, STRING_OBJECT)) {
+		emitText(emitter, stringCharacters((StringObject *) asObject(value)), ((StringObject *) asObject(value))->length);
+	}
+	else if (isObjectOfType(value, LIST_OBJECT)) {
+		const ListObject * list = (ListObject *) asObject(value);
+		emitText(emitter, "[", 1);
+		for (int k = 0; k < list->size; ++k) {
+			if (0 < k) emitText(emitter, ", ", 2);
+			printValue(emitter, list->items[k]);
+		}
+		emitText(emitter, "]", 1);
+	}
+	else {
+		char buffer[64];
+		const int length = _formatPrimitive(buffer, sizeof(buffer), value);
+		emitText(emitter, buffer, length < (int) sizeof(buffer) ? length : (int) sizeof(buffer) - 1);
+	}
+}
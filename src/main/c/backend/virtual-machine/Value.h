@@ -0,0 +1,448 @@
+#ifndef VALUE_HEADER
+#define VALUE_HEADER
+
+#include "../../shared/Type.h"
+#include "../Emitter.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct ClassDefinition ClassDefinition;
+typedef struct Prototype Prototype;
+typedef struct VirtualMachine VirtualMachine;
+
+/** The types of the values, as the language sees them. */
+typedef enum {
+	NIL_VALUE,
+	BOOLEAN_VALUE,
+	INTEGER_VALUE,
+	DECIMAL_VALUE,
+	OBJECT_VALUE
+} ValueType;
+
+typedef enum {
+	STRING_OBJECT,
+	LIST_OBJECT,
+	RANGE_OBJECT,
+	CELL_OBJECT,
+	CLOSURE_OBJECT,
+	INSTANCE_OBJECT,
+	BOUND_METHOD_OBJECT,
+	NATIVE_OBJECT,
+	INTEGER_OBJECT
+} ObjectType;
+
+/**
+ * The header of every object allocated by the runtime. All the old objects of
+ * a heap are linked, so they can be released together. The marks belong to
+ * the garbage collector (see "GarbageCollector.h"), and a young object that
+ * survives a collection uses the link to forward to its copy.
+ */
+typedef struct HeapObject HeapObject;
+struct HeapObject {
+	ObjectType type;
+	uint8_t isMarked;
+	uint8_t isRemembered;
+	HeapObject * next;
+};
+
+/**
+ * A value of the runtime, NaN-boxed in a word, so no primitive is ever
+ * allocated, and a register, a field, a capture or an item of a list takes 8
+ * bytes. The arithmetic of decimals only makes the quiet NaNs without
+ * payload, so the rest of the NaNs hold the other values:
+ *
+ *	- a decimal is its own bits (up to DECIMAL_LIMIT, the negative NaN),
+ *	- nil, false and true are NIL_BITS, FALSE_BITS and TRUE_BITS,
+ *	- an object is its address plus OBJECT_TAG, and
+ *	- an integer is its bits plus INTEGER_OFFSET, if it fits in 50 bits.
+ *
+ * Every integer type of the language (char excluded) is a 64-bit integer, and
+ * the ones that don't fit are boxed in an "IntegerObject". Both float and
+ * double are decimals. Zeroed memory holds zeros, not nils, so the slots of a
+ * new object are filled before the program reads them.
+ */
+typedef struct {
+	uint64_t bits;
+} Value;
+
+#define DECIMAL_LIMIT ((uint64_t) 0xFFF8000000000000)
+#define NIL_BITS ((uint64_t) 0xFFF9000000000000)
+#define FALSE_BITS (NIL_BITS | 2)
+#define TRUE_BITS (NIL_BITS | 6)
+#define OBJECT_TAG ((uint64_t) 0xFFFA000000000000)
+#define INTEGER_OFFSET ((uint64_t) 0xFFFE000000000000)
+#define MINIMUM_SMALL_INTEGER (-((int64_t) 1 << 49))
+#define MAXIMUM_SMALL_INTEGER (((int64_t) 1 << 49) - 1)
+
+/** An integer beyond the ones that fit in a value. */
+typedef struct {
+	HeapObject header;
+	int64_t value;
+} IntegerObject;
+
+/**
+ * The characters of a string are inline, except in the strings that appends
+ * build: those are a prefix of the characters of a buffer (the base), which
+ * has room for more, so an append to the longest prefix fills it in place.
+ * A prefix never changes, so strings are still immutable, but the characters
+ * of a prefix aren't terminated.
+ */
+typedef struct StringObject {
+	HeapObject header;
+	int length;
+	int capacity;
+	struct StringObject * base;
+	char characters[];
+} StringObject;
+
+/**
+ * The items of an old list are split in cards of 2^CARD_SHIFT items, and the
+ * write barrier marks the card of each young item that the list receives.
+ */
+#define CARD_SHIFT 6
+
+typedef struct {
+	HeapObject header;
+	Value * items;
+	int size;
+	int capacity;
+	uint8_t * cards;
+	int cardCount;
+} ListObject;
+
+/** The integers in [start, end). */
+typedef struct {
+	HeapObject header;
+	int64_t start;
+	int64_t end;
+} RangeObject;
+
+/** A variable shared between a function and the lambdas that capture it. */
+typedef struct {
+	HeapObject header;
+	Value value;
+} CellObject;
+
+/**
+ * A flat closure: the captures are stored inline, in the order of the
+ * descriptors of the prototype. Shared captures hold their cell.
+ */
+typedef struct {
+	HeapObject header;
+	Prototype * prototype;
+	int captureCount;
+	Value captures[];
+} ClosureObject;
+
+typedef struct {
+	HeapObject header;
+	ClassDefinition * class;
+	int fieldCount;
+	Value fields[];
+} InstanceObject;
+
+/** A method read as a value, which remembers its receiver. */
+typedef struct {
+	HeapObject header;
+	Value receiver;
+	Prototype * method;
+} BoundMethodObject;
+
+/**
+ * A function implemented by the runtime. It returns false after reporting a
+ * runtime error.
+ */
+typedef boolean (*NativeFunction)(VirtualMachine * machine, Value * arguments, const int count, Value * result);
+
+typedef struct {
+	HeapObject header;
+	const char * name;
+	NativeFunction function;
+} NativeObject;
+
+/** What the garbage collector did in a heap, so far. */
+typedef struct {
+	int minorCollections;
+	int majorCollections;
+	double pauseMilliseconds;
+	double longestPauseMilliseconds;
+	size_t promotedBytes;
+	size_t freedBytes;
+} HeapStatistics;
+
+/**
+ * The temporaries of the frames of a running program: the strings and lists
+ * that the compiler expects to die with the frame that allocates them. They're
+ * bump-allocated, and a frame releases its own ones at once, when it returns.
+ * The items of the lists live apart, so the region tracks its lists to
+ * release them too.
+ */
+typedef struct {
+	uint8_t * memory;
+	size_t size;
+	size_t top;
+	ListObject ** lists;
+	int listCount;
+	int listCapacity;
+} Region;
+
+/**
+ * The objects allocated by a program, or by the compiler (i.e., literals).
+ * The heap of a running program has a nursery, where the new objects are
+ * bump-allocated until the next collection. The objects that don't fit, and
+ * the ones that survive a collection, are old. A heap without a nursery only
+ * has old objects, and they live until it's released.
+ */
+typedef struct {
+	HeapObject * objects;
+	int objectCount;
+	size_t allocatedBytes;
+	uint8_t * nursery;
+	size_t nurserySize;
+	size_t nurseryTop;
+	// The lists in the nursery, whose items are released with them.
+	ListObject ** youngLists;
+	int youngListCount;
+	int youngListCapacity;
+	// The old objects that may hold young ones.
+	HeapObject ** remembered;
+	int rememberedCount;
+	int rememberedCapacity;
+	size_t oldBytes;
+	size_t oldLimit;
+	boolean isCollectionPending;
+	HeapStatistics statistics;
+	Region region;
+} Heap;
+
+static inline Value nilValue() {
+	Value value = { NIL_BITS };
+	return value;
+}
+
+static inline Value booleanValue(const boolean truth) {
+	Value value = { truth ? TRUE_BITS : FALSE_BITS };
+	return value;
+}
+
+/** Whether an integer fits in a value, without a box. */
+static inline boolean fitsSmallInteger(const int64_t integer) {
+	return (uint64_t) integer - (uint64_t) MINIMUM_SMALL_INTEGER <= (uint64_t) MAXIMUM_SMALL_INTEGER - (uint64_t) MINIMUM_SMALL_INTEGER ? true : false;
+}
+
+/** An integer that fits in a value (see "fitsSmallInteger"). */
+static inline Value smallIntegerValue(const int64_t integer) {
+	Value value = { (uint64_t) integer + INTEGER_OFFSET };
+	return value;
+}
+
+static inline Value decimalValue(const double decimal) {
+	Value value;
+	memcpy(&value.bits, &decimal, sizeof(double));
+	return value;
+}
+
+static inline Value objectValue(void * object) {
+	Value value = { (uint64_t) (uintptr_t) object + OBJECT_TAG };
+	return value;
+}
+
+static inline boolean isNil(const Value value) {
+	return value.bits == NIL_BITS ? true : false;
+}
+
+static inline boolean isBoolean(const Value value) {
+	return (value.bits | 4) == TRUE_BITS ? true : false;
+}
+
+/** Whether the value is an integer that fits in it (i.e., not boxed). */
+static inline boolean isSmallInteger(const Value value) {
+	return smallIntegerValue(MINIMUM_SMALL_INTEGER).bits <= value.bits ? true : false;
+}
+
+static inline boolean isDecimal(const Value value) {
+	return value.bits <= DECIMAL_LIMIT ? true : false;
+}
+
+/** Whether the value is the address of an object (a boxed integer included). */
+static inline boolean isObject(const Value value) {
+	return value.bits - OBJECT_TAG < ((uint64_t) 1 << 48) ? true : false;
+}
+
+static inline boolean asBoolean(const Value value) {
+	return value.bits == TRUE_BITS ? true : false;
+}
+
+static inline int64_t asSmallInteger(const Value value) {
+	return (int64_t) (value.bits - INTEGER_OFFSET);
+}
+
+static inline double asDecimal(const Value value) {
+	double decimal;
+	memcpy(&decimal, &value.bits, sizeof(double));
+	return decimal;
+}
+
+static inline HeapObject * asObject(const Value value) {
+	return (HeapObject *) (uintptr_t) (value.bits - OBJECT_TAG);
+}
+
+static inline boolean isObjectOfType(const Value value, const ObjectType type) {
+	return (isObject(value) && asObject(value)->type == type) ? true : false;
+}
+
+static inline const char * stringCharacters(const StringObject * string) {
+	return string->base == NULL ? string->characters : string->base->characters;
+}
+
+static inline boolean isInteger(const Value value) {
+	return (isSmallInteger(value) || isObjectOfType(value, INTEGER_OBJECT)) ? true : false;
+}
+
+/** The integer in the value, or in its box. */
+static inline int64_t asInteger(const Value value) {
+	return isSmallInteger(value) ? asSmallInteger(value) : ((const IntegerObject *) asObject(value))->value;
+}
+
+static inline boolean isNumber(const Value value) {
+	return (isDecimal(value) || isInteger(value)) ? true : false;
+}
+
+/** A number, as a decimal. */
+static inline double toDecimal(const Value value) {
+	return isDecimal(value) ? asDecimal(value) : (double) asInteger(value);
+}
+
+/** The type of the value in the language, so a boxed integer is an integer. */
+static inline ValueType valueType(const Value value) {
+	if (isDecimal(value)) return DECIMAL_VALUE;
+	if (isSmallInteger(value)) return INTEGER_VALUE;
+	if (isObject(value)) return asObject(value)->type == INTEGER_OBJECT ? INTEGER_VALUE : OBJECT_VALUE;
+	return isNil(value) ? NIL_VALUE : BOOLEAN_VALUE;
+}
+
+/** Whether the object lives in the nursery of the heap. */
+static inline boolean isYoungObject(const Heap * heap, const HeapObject * object) {
+	return (uintptr_t) object - (uintptr_t) heap->nursery < heap->nurserySize ? true : false;
+}
+
+/** Whether the object is a temporary, in the region of the heap. */
+static inline boolean isRegionObject(const Heap * heap, const HeapObject * object) {
+	return (uintptr_t) object - (uintptr_t) heap->region.memory < heap->region.size ? true : false;
+}
+
+/** Adds an old object to the ones that a minor collection traces as roots. */
+void rememberObject(Heap * heap, HeapObject * object);
+
+/**
+ * Every store of a value into an object that already exists goes through
+ * this barrier (or the one of lists): an old object that receives a young
+ * one is remembered, so the next minor collection finds the young one
+ * without tracing the old generation.
+ */
+static inline void writeBarrier(Heap * heap, HeapObject * target, const Value value) {
+	if (isObject(value) && !target->isRemembered && isYoungObject(heap, asObject(value)) && !isYoungObject(heap, target)) {
+		rememberObject(heap, target);
+	}
+}
+
+/** Remembers an old list, and marks the card of the item at the index. */
+void markCard(Heap * heap, ListObject * list, const int index);
+
+/**
+ * The write barrier of the items of a list. A list that is remembered since
+ * its allocation has no cards, so the next minor collection traces it whole.
+ */
+static inline void listWriteBarrier(Heap * heap, ListObject * list, const int index, const Value value) {
+	if (isObject(value) && isYoungObject(heap, asObject(value)) && !isYoungObject(heap, &list->header)) {
+		markCard(heap, list, index);
+	}
+}
+
+StringObject * newString(Heap * heap, const char * characters, const int length);
+ListObject * newList(Heap * heap, const int capacity);
+RangeObject * newRange(Heap * heap, const int64_t start, const int64_t end);
+CellObject * newCell(Heap * heap, const Value value);
+ClosureObject * newClosure(Heap * heap, Prototype * prototype, const int captureCount);
+InstanceObject * newInstance(Heap * heap, ClassDefinition * class, const int fieldCount);
+BoundMethodObject * newBoundMethod(Heap * heap, const Value receiver, Prototype * method);
+NativeObject * newNative(Heap * heap, const char * name, NativeFunction function);
+IntegerObject * newInteger(Heap * heap, const int64_t value);
+
+/** An integer, boxed in the heap if it doesn't fit in the value. */
+static inline Value integerValue(Heap * heap, const int64_t integer) {
+	return fitsSmallInteger(integer) ? smallIntegerValue(integer) : objectValue(newInteger(heap, integer));
+}
+
+/**
+ * Like "newList", but the list is a temporary, if the region has room. It
+ * has no cards, since every collection traces the items of the lists of the
+ * region as roots.
+ */
+ListObject * newRegionList(Heap * heap, const int capacity);
+
+/** Gives the heap a region of the given size, or none if it's zero. */
+void createRegion(Heap * heap, const size_t size);
+
+/**
+ * Releases the temporaries allocated since the region had the given top and
+ * count of lists.
+ */
+void releaseRegion(Heap * heap, const size_t top, const int listCount);
+
+/** A copy of a temporary string, in the heap. */
+Value promoteTemporary(Heap * heap, const Value value);
+
+/**
+ * The value, or a copy of it in the heap if it's a temporary string. Every
+ * store of a value where it may outlive its frame goes through it. A list is
+ * a temporary only if the compiler proves that it never reaches such a store.
+ */
+static inline Value promoteValue(Heap * heap, const Value value) {
+	return (isObject(value) && isRegionObject(heap, asObject(value))) ? promoteTemporary(heap, value) : value;
+}
+
+/** Appends a value, growing the list if needed. */
+void appendToList(ListObject * list, const Value value);
+
+/** Releases every object of the heap. */
+void releaseHeap(Heap * heap);
+
+/**
+ * The concatenation of the textual representation of two values, as a new
+ * string.
+ */
+StringObject * concatenateValues(Heap * heap, const Value left, const Value right);
+
+/** Like "concatenateValues", but the string is a temporary, if the region has room. */
+StringObject * concatenateTemporaries(Heap * heap, const Value left, const Value right);
+
+/**
+ * The concatenation of the textual representation of the values, as a new
+ * string, which is allocated once with their whole length.
+ */
+StringObject * joinValues(Heap * heap, const Value * values, const int count);
+
+/**
+ * Like "joinValues", but the string is a prefix of a buffer with room for
+ * more. If the first string (after the empty ones) is the longest prefix of
+ * its buffer, and the rest fits, it fills the buffer in place, so repeated
+ * appends to the same string take linear time.
+ */
+StringObject * appendValues(Heap * heap, const Value * values, const int count);
+
+/** Whether a condition on the value holds (i.e., it isn't false, zero, empty or nil). */
+boolean isTruthy(const Value value);
+
+/** Equality by value for primitives and strings, and by identity otherwise. */
+boolean valuesEqual(const Value left, const Value right);
+
+/** The name of the type of the value, for error messages. */
+const char * valueTypeName(const Value value);
+
+/** Writes the textual representation of the value. */
+void printValue(Emitter * emitter, const Value value);
+
+#endif
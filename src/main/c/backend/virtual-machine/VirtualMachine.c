@@ -0,0 +1,1098 @@
+#include "VirtualMachine.h"
+#include "GarbageCollector.h"
+#include "Natives.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+#ifdef DIRECT_THREADED_DISPATCH
+/** The address of the handler of each opcode, for the direct threading. */
+static const void * const * _handlers = NULL;
+#endif
+
+#ifdef OPCODE_PROFILING
+/** How many times each opcode (second index) runs right after another one. */
+static uint64_t _pairCounts[OPCODE_COUNT][OPCODE_COUNT];
+#endif
+
+static boolean _execute(VirtualMachine * machine);
+
+void initializeVirtualMachineModule() {
+	_logger = createLogger("VirtualMachine");
+#ifdef DIRECT_THREADED_DISPATCH
+	_execute(NULL);
+	logDebugging(_logger, "The bytecode is dispatched with direct threading.");
+#else
+	logDebugging(_logger, "The bytecode is dispatched with a switch.");
+#endif
+}
+
+void shutdownVirtualMachineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+typedef enum {
+	ADD_OPERATION,
+	SUB_OPERATION,
+	MUL_OPERATION,
+	DIV_OPERATION
+} ArithmeticOperation;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _arithmetic(VirtualMachine * machine, const ArithmeticOperation operation, const Value left, const Value right, Value * result);
+static void _boxInteger(VirtualMachine * machine, Value * slot, const int64_t integer);
+static boolean _call(VirtualMachine * machine, Value * callee, const int count);
+static boolean _expectArguments(VirtualMachine * machine, const Prototype * prototype, const int count);
+static boolean _instantiate(VirtualMachine * machine, ClassDefinition * class, Value * target, const int count, const boolean isScoped);
+static boolean _invoke(VirtualMachine * machine, Value * receiver, InvokeSite * site, const int count);
+static Prototype * _invokedMethod(VirtualMachine * machine, const Value receiver, InvokeSite * site);
+static ClosureObject * _newClosure(VirtualMachine * machine, const CallFrame * frame, Prototype * prototype);
+static int _order(const Opcode opcode, const Value left, const Value right);
+static void _prepareDispatch(Prototype * prototype);
+static boolean _pushFrame(VirtualMachine * machine, ClosureObject * closure, Prototype * prototype, Value * base, const int passed, Value * result);
+static void _releaseDispatch(Prototype * prototype);
+static boolean _replaceFrame(VirtualMachine * machine, ClosureObject * closure, Prototype * prototype, const Value * slots, const int passed);
+static inline void _safepoint(VirtualMachine * machine);
+static inline void _storeInteger(VirtualMachine * machine, Value * slot, const int64_t integer);
+static boolean _tailCall(VirtualMachine * machine, Value * callee, const int count);
+static boolean _tailInvoke(VirtualMachine * machine, Value * receiver, InvokeSite * site, const int count);
+static void _writeProfile(const char * path);
+
+/**
+ * The arithmetic of integers wraps around, and mixing an integer with a
+ * decimal produces a decimal. Adding anything to a string concatenates them.
+ */
+static boolean _arithmetic(VirtualMachine * machine, const ArithmeticOperation operation, const Value left, const Value right, Value * result) {
+	static const char * const symbols[] = { "+", "-", "*", "/" };
+	if (isInteger(left) && isInteger(right)) {
+		const uint64_t x = asInteger(left);
+		const uint64_t y = asInteger(right);
+		switch (operation) {
+			case ADD_OPERATION: _storeInteger(machine, result, (int64_t) (x + y)); break;
+			case SUB_OPERATION: _storeInteger(machine, result, (int64_t) (x - y)); break;
+			case MUL_OPERATION: _storeInteger(machine, result, (int64_t) (x * y)); break;
+			case DIV_OPERATION:
+				if (y == 0) {
+					runtimeError(machine, "Integer division by zero.");
+					return false;
+				}
+				_storeInteger(machine, result, (int64_t) y == -1 ? (int64_t) (0 - x) : (int64_t) x / (int64_t) y);
+				break;
+		}
+		return true;
+	}
+	if (operation == ADD_OPERATION && (isObjectOfType(left, STRING_OBJECT) || isObjectOfType(right, STRING_OBJECT))) {
+		*result = objectValue(concatenateValues(&machine->heap, left, right));
+		_safepoint(machine);
+		return true;
+	}
+	if (!isNumber(left) || !isNumber(right)) {
+		runtimeError(machine, "Operator '%s' cannot be applied to a %s and a %s.", symbols[operation], valueTypeName(left), valueTypeName(right));
+		return false;
+	}
+	const double x = toDecimal(left);
+	const double y = toDecimal(right);
+	switch (operation) {
+		case ADD_OPERATION: *result = decimalValue(x + y); break;
+		case SUB_OPERATION: *result = decimalValue(x - y); break;
+		case MUL_OPERATION: *result = decimalValue(x * y); break;
+		case DIV_OPERATION: *result = decimalValue(x / y); break;
+	}
+	return true;
+}
+
+/**
+ * Whether "left < right" (or "left <= right") holds, for two numbers or two
+ * strings. Returns -1 if they can't be compared.
+ */
+static int _order(const Opcode opcode, const Value left, const Value right) {
+	int comparison;
+	if (isInteger(left) && isInteger(right)) {
+		const int64_t x = asInteger(left);
+		const int64_t y = asInteger(right);
+		comparison = x < y ? -1 : (x == y ? 0 : 1);
+	}
+	else if (isNumber(left) && isNumber(right)) {
+		const double x = toDecimal(left);
+		const double y = toDecimal(right);
+		if (x != x || y != y) return 0;
+		comparison = x < y ? -1 : (x == y ? 0 : 1);
+	}
+	else if (isObjectOfType(left, STRING_OBJECT) && isObjectOfType(right, STRING_OBJECT)) {
+		const StringObject * x = (StringObject *) asObject(left);
+		const StringObject * y = (StringObject *) asObject(right);
+		comparison = memcmp(stringCharacters(x), stringCharacters(y), x->length < y->length ? x->length : y->length);
+		if (comparison == 0) {
+			comparison = x->length - y->length;
+		}
+	}
+	else {
+		return -1;
+	}
+	return (opcode == OP_LT ? comparison < 0 : comparison <= 0) ? 1 : 0;
+}
+
+/**
+ * Collects the garbage if an allocation asks for it. Only the instructions
+ * that allocate reach a safepoint, once they store what they allocate.
+ */
+static inline void _safepoint(VirtualMachine * machine) {
+	if (machine->heap.isCollectionPending) {
+		collectGarbage(machine);
+	}
+}
+
+/** Boxes an integer that doesn't fit in a value into a slot of the stack. */
+static void _boxInteger(VirtualMachine * machine, Value * slot, const int64_t integer) {
+	*slot = objectValue(newInteger(&machine->heap, integer));
+	_safepoint(machine);
+}
+
+/**
+ * Stores an integer in a slot of the stack. An integer that doesn't fit in a
+ * value is boxed, so the slot then reaches a safepoint.
+ */
+static inline void _storeInteger(VirtualMachine * machine, Value * slot, const int64_t integer) {
+	if (fitsSmallInteger(integer)) {
+		*slot = smallIntegerValue(integer);
+	}
+	else {
+		_boxInteger(machine, slot, integer);
+	}
+}
+
+static boolean _pushFrame(VirtualMachine * machine, ClosureObject * closure, Prototype * prototype, Value * base, const int passed, Value * result) {
+	if (machine->frameCount == MAXIMUM_FRAMES || machine->stack + STACK_SIZE < base + prototype->registerCount) {
+		runtimeError(machine, "Stack overflow while calling '%s'.", prototype->name);
+		return false;
+	}
+	for (int k = passed; k < prototype->registerCount; ++k) {
+		base[k] = nilValue();
+	}
+	CallFrame * frame = &machine->frames[machine->frameCount++];
+	frame->closure = closure;
+	frame->prototype = prototype;
+#ifdef DIRECT_THREADED_DISPATCH
+	frame->pc = prototype->dispatchCode;
+#else
+	frame->pc = prototype->code;
+#endif
+	frame->base = base;
+	frame->passedLimit = passed;
+	frame->result = result;
+	frame->regionMark = machine->heap.region.top;
+	frame->regionListMark = machine->heap.region.listCount;
+	return true;
+}
+
+static boolean _expectArguments(VirtualMachine * machine, const Prototype * prototype, const int count) {
+	if (prototype->parameterCount < count) {
+		runtimeError(machine, "Function '%s' expects at most %d argument(s), but it receives %d.", prototype->name, prototype->parameterCount, count);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Calls the value in the slot, with the arguments that follow it. The result
+ * replaces the callee, once the call returns.
+ */
+static boolean _call(VirtualMachine * machine, Value * callee, const int count) {
+	if (isObject(*callee)) {
+		switch (asObject(*callee)->type) {
+			case CLOSURE_OBJECT: {
+				ClosureObject * closure = (ClosureObject *) asObject(*callee);
+				return _expectArguments(machine, closure->prototype, count)
+					&& _pushFrame(machine, closure, closure->prototype, callee + 1, count, callee);
+			}
+			case NATIVE_OBJECT: {
+				Value result;
+				if (!((NativeObject *) asObject(*callee))->function(machine, callee + 1, count, &result)) {
+					return false;
+				}
+				*callee = result;
+				return true;
+			}
+			case BOUND_METHOD_OBJECT: {
+				BoundMethodObject * boundMethod = (BoundMethodObject *) asObject(*callee);
+				*callee = boundMethod->receiver;
+				return _expectArguments(machine, boundMethod->method, count)
+					&& _pushFrame(machine, NULL, boundMethod->method, callee, count + 1, callee);
+			}
+			default:
+				break;
+		}
+	}
+	runtimeError(machine, "A %s cannot be called.", valueTypeName(*callee));
+	return false;
+}
+
+/**
+ * The method that an instance runs when it's invoked at a call site, or NULL
+ * after reporting why it can't. A direct site runs its method if the table
+ * of the class has it in the slot. A class that the inline cache of the site
+ * doesn't know finds it in the slot of its table (if it descends from the
+ * class of the site) or by name, and the cache learns it while it has room.
+ */
+static Prototype * _invokedMethod(VirtualMachine * machine, const Value receiver, InvokeSite * site) {
+	if (!isObjectOfType(receiver, INSTANCE_OBJECT)) {
+		runtimeError(machine, "Method '%s' cannot be invoked on a %s.", site->name, valueTypeName(receiver));
+		return NULL;
+	}
+	ClassDefinition * class = ((InstanceObject *) asObject(receiver))->class;
+	if (site->method != NULL && site->slot < class->methodCount && class->methods[site->slot].prototype == site->method) {
+		return site->method;
+	}
+	for (int k = 0; k < site->cachedCount; ++k) {
+		if (site->cachedClasses[k] == class) return site->cachedMethods[k];
+	}
+	const ClassDefinition * ancestor = class;
+	while (ancestor != NULL && ancestor != site->class) {
+		ancestor = ancestor->parent;
+	}
+	Prototype * method = ancestor != NULL ? class->methods[site->slot].prototype : findMethod(class, site->name);
+	if (method == NULL) {
+		runtimeError(machine, "Class '%s' has no method '%s'.", class->name, site->name);
+	}
+	else if (site->cachedCount < INLINE_CACHE_SIZE) {
+		site->cachedClasses[site->cachedCount] = class;
+		site->cachedMethods[site->cachedCount++] = method;
+	}
+	return method;
+}
+
+static boolean _invoke(VirtualMachine * machine, Value * receiver, InvokeSite * site, const int count) {
+	Prototype * method = _invokedMethod(machine, *receiver, site);
+	return (method != NULL && _expectArguments(machine, method, count)
+		&& _pushFrame(machine, NULL, method, receiver, count + 1, receiver)) ? true : false;
+}
+
+/**
+ * Runs a prototype in the frame of the current one, which has nothing left
+ * to do but to return its result. The slots (the receiver, if any, and the
+ * arguments) move to the base of the frame, and the frame keeps its result
+ * and its temporaries (the arguments may be some of them).
+ */
+static boolean _replaceFrame(VirtualMachine * machine, ClosureObject * closure, Prototype * prototype, const Value * slots, const int passed) {
+	CallFrame * frame = &machine->frames[machine->frameCount - 1];
+	const size_t regionMark = frame->regionMark;
+	const int regionListMark = frame->regionListMark;
+	memmove(frame->base, slots, passed * sizeof(Value));
+	machine->frameCount -= 1;
+	if (!_pushFrame(machine, closure, prototype, frame->base, passed, frame->result)) return false;
+	frame->regionMark = regionMark;
+	frame->regionListMark = regionListMark;
+	return true;
+}
+
+/**
+ * A call in tail position. Lambdas and methods replace the current frame, so
+ * a chain of tail calls runs in constant stack (and the traces of the errors
+ * omit the replaced frames). Natives run like in any other call, and the
+ * RETURN that follows returns their result.
+ */
+static boolean _tailCall(VirtualMachine * machine, Value * callee, const int count) {
+	if (isObjectOfType(*callee, CLOSURE_OBJECT)) {
+		ClosureObject * closure = (ClosureObject *) asObject(*callee);
+		return (_expectArguments(machine, closure->prototype, count)
+			&& _replaceFrame(machine, closure, closure->prototype, callee + 1, count)) ? true : false;
+	}
+	if (isObjectOfType(*callee, BOUND_METHOD_OBJECT)) {
+		BoundMethodObject * boundMethod = (BoundMethodObject *) asObject(*callee);
+		*callee = boundMethod->receiver;
+		return (_expectArguments(machine, boundMethod->method, count)
+			&& _replaceFrame(machine, NULL, boundMethod->method, callee, count + 1)) ? true : false;
+	}
+	return _call(machine, callee, count);
+}
+
+static boolean _tailInvoke(VirtualMachine * machine, Value * receiver, InvokeSite * site, const int count) {
+	Prototype * method = _invokedMethod(machine, *receiver, site);
+	return (method != NULL && _expectArguments(machine, method, count)
+		&& _replaceFrame(machine, NULL, method, receiver, count + 1)) ? true : false;
+}
+
+/**
+ * Creates an instance in the target slot, and runs the initializer with the
+ * arguments that follow it (one per field, in order). A scoped instance goes
+ * after the last one (if there's room), instead of the heap.
+ */
+static boolean _instantiate(VirtualMachine * machine, ClassDefinition * class, Value * target, const int count, const boolean isScoped) {
+	if (class->fieldCount < count) {
+		runtimeError(machine, "Class '%s' has %d field(s), but it receives %d argument(s).", class->name, class->fieldCount, count);
+		return false;
+	}
+	const size_t size = sizeof(InstanceObject) + class->fieldCount * sizeof(Value);
+	if (isScoped && machine->scopedInstancesSize + size <= SCOPED_INSTANCES_SIZE) {
+		InstanceObject * instance = (InstanceObject *) (machine->scopedInstances + machine->scopedInstancesSize);
+		machine->scopedInstancesSize += size;
+		memset(instance, 0, size);
+		instance->header.type = INSTANCE_OBJECT;
+		// The collector traces its fields anyway, so the write barrier skips it.
+		instance->header.isRemembered = true;
+		instance->class = class;
+		instance->fieldCount = class->fieldCount;
+		for (int k = 0; k < class->fieldCount; ++k) {
+			instance->fields[k] = nilValue();
+		}
+		*target = objectValue(instance);
+	}
+	else {
+		*target = objectValue(newInstance(&machine->heap, class, class->fieldCount));
+	}
+	return _pushFrame(machine, NULL, class->initializer, target, count + 1, target);
+}
+
+/**
+ * Copies the captures into the new closure (a temporary string is promoted,
+ * since the closure may outlive the frame). Shared variables already live in
+ * cells, so the closure copies the cell, and shares it with the frame that
+ * creates it.
+ */
+static ClosureObject * _newClosure(VirtualMachine * machine, const CallFrame * frame, Prototype * prototype) {
+	ClosureObject * closure = newClosure(&machine->heap, prototype, prototype->captureCount);
+	for (int k = 0; k < prototype->captureCount; ++k) {
+		const CaptureDescriptor * capture = &prototype->captures[k];
+		closure->captures[k] = capture->source == CAPTURE_FROM_CAPTURE
+			? frame->closure->captures[capture->index]
+			: promoteValue(&machine->heap, frame->base[capture->index]);
+	}
+	return closure;
+}
+
+/**
+ * Threads the code of a prototype, and of its nested prototypes: every
+ * instruction is paired with the address of its handler.
+ */
+static void _prepareDispatch(Prototype * prototype) {
+#ifdef DIRECT_THREADED_DISPATCH
+	DispatchInstruction * code = calloc(prototype->codeSize + 1, sizeof(DispatchInstruction));
+	for (int k = 0; k < prototype->codeSize; ++k) {
+		code[k].handler = _handlers[prototype->code[k].opcode];
+		code[k].instruction = prototype->code[k];
+	}
+	prototype->dispatchCode = code;
+#endif
+	for (int k = 0; k < prototype->prototypeCount; ++k) {
+		_prepareDispatch(prototype->prototypes[k]);
+	}
+}
+
+static void _releaseDispatch(Prototype * prototype) {
+	for (int k = 0; k < prototype->prototypeCount; ++k) {
+		_releaseDispatch(prototype->prototypes[k]);
+	}
+	free(prototype->dispatchCode);
+	prototype->dispatchCode = NULL;
+}
+
+/**
+ * Appends the counts of the pairs of opcodes to a file, as CSV lines with
+ * the first opcode, the second one, and how many times the second one runs
+ * right after the first one.
+ */
+static void _writeProfile(const char * path) {
+#ifdef OPCODE_PROFILING
+	FILE * file = fopen(path, "a");
+	if (file == NULL) {
+		logError(_logger, "The profile cannot be written to \"%s\".", path);
+		return;
+	}
+	int pairs = 0;
+	for (int first = 0; first < OPCODE_COUNT; ++first) {
+		for (int second = 0; second < OPCODE_COUNT; ++second) {
+			if (0 < _pairCounts[first][second]) {
+				fprintf(file, "%s,%s,%llu\n", opcodeName(first), opcodeName(second), (unsigned long long) _pairCounts[first][second]);
+				_pairCounts[first][second] = 0;
+				++pairs;
+			}
+		}
+	}
+	fclose(file);
+	logDebugging(_logger, "Profiled %d pair(s) of opcodes into \"%s\".", pairs, path);
+#else
+	logWarning(_logger, "The profile is not written, since the build has no OPCODE_PROFILING.");
+#endif
+}
+
+/**
+ * Runs the frames from the top of the stack until the bottom one returns.
+ * The state of the current frame is cached in locals, and saved before any
+ * instruction that may push another frame or fail.
+ *
+ * With direct threading, every handler ends with its own indirect jump to the
+ * handler of the next instruction, so the branch predictor learns the
+ * successors of each opcode separately. Called without a machine, it only
+ * publishes the addresses of its handlers.
+ *
+ * The generic instructions quicken: they rewrite themselves in place into
+ * the form specialized for the types they observe. A specialized form that
+ * observes other types rewrites itself back, and runs again as generic.
+ *
+ * A superinstruction applies the effect of its first instruction, and then
+ * jumps straight into the handler of the second one. If the second one was
+ * rewritten since (e.g., deoptimized, or fused with the next one), it's
+ * dispatched as usual instead. Only the instructions with an EFFECT_* macro
+ * can start a superinstruction.
+ */
+static boolean _execute(VirtualMachine * machine) {
+#ifdef DIRECT_THREADED_DISPATCH
+	static const void * const handlers[OPCODE_COUNT] = {
+#define OPCODE(name, format) [OP_##name] = &&HANDLER_##name,
+		OPCODES(OPCODE)
+#undef OPCODE
+	};
+	if (machine == NULL) {
+		_handlers = handlers;
+		return true;
+	}
+#endif
+	CallFrame * frame = &machine->frames[machine->frameCount - 1];
+	const DispatchInstruction * pc = frame->pc;
+	Value * base = frame->base;
+	const Value * constants = frame->prototype->constants;
+	uint64_t executed = 0;
+	BytecodeInstruction instruction;
+#ifdef OPCODE_PROFILING
+	Opcode previous = OP_CALL;
+#define PROFILE() (_pairCounts[previous][instruction.opcode] += 1, previous = instruction.opcode)
+#else
+#define PROFILE() ((void) 0)
+#endif
+
+#define R(n) (base[(n)])
+#define K(n) (constants[(n)])
+#define SAVE_STATE() (frame->pc = pc, machine->executedInstructions += executed, executed = 0)
+#define LOAD_STATE() \
+	(frame = &machine->frames[machine->frameCount - 1], \
+	pc = frame->pc, \
+	base = frame->base, \
+	constants = frame->prototype->constants)
+#define FAIL() do { SAVE_STATE(); return false; } while (0)
+#ifdef DIRECT_THREADED_DISPATCH
+#define CASE(name) HANDLER_##name:
+#define NEXT() do { instruction = pc->instruction; ++executed; PROFILE(); goto *(pc++)->handler; } while (0)
+#define FOLLOWING() (pc->instruction)
+#define REWRITE(name) \
+	(((DispatchInstruction *) pc)[-1].instruction.opcode = OP_##name, \
+	((DispatchInstruction *) pc)[-1].handler = &&HANDLER_##name)
+#define FUSE(superinstruction) \
+	(((DispatchInstruction *) pc)[-1].instruction.opcode = (superinstruction), \
+	((DispatchInstruction *) pc)[-1].handler = handlers[(superinstruction)])
+#else
+#define CASE(name) case OP_##name: HANDLER_##name:
+#define NEXT() continue
+#define FOLLOWING() (*pc)
+#define REWRITE(name) (((DispatchInstruction *) pc)[-1].opcode = OP_##name)
+#define FUSE(superinstruction) (((DispatchInstruction *) pc)[-1].opcode = (superinstruction))
+#endif
+#define QUICKEN(name) do { \
+	REWRITE(name); \
+	++machine->quickenedInstructions; \
+	if (machine->program->hasSuperinstructions) { \
+		const Opcode superinstruction = superinstructionOf(OP_##name, FOLLOWING().opcode); \
+		if (superinstruction != OPCODE_COUNT) FUSE(superinstruction); \
+	} \
+} while (0)
+#define DEOPTIMIZE(name) { REWRITE(name); ++machine->deoptimizedInstructions; --pc; NEXT(); }
+#define UNORDERED(operator, x, y) { \
+	SAVE_STATE(); \
+	runtimeError(machine, "Operator '%s' cannot be applied to a %s and a %s.", #operator, valueTypeName(x), valueTypeName(y)); \
+	return false; \
+}
+#define ARITHMETIC(operation, operator, right, integerForm, decimalForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = (right); \
+	if (isSmallInteger(x) && isSmallInteger(y)) { \
+		_storeInteger(machine, &R(instruction.a), (int64_t) ((uint64_t) asSmallInteger(x) operator (uint64_t) asSmallInteger(y))); \
+		QUICKEN(integerForm); \
+	} \
+	else if (isDecimal(x) && isDecimal(y)) { \
+		R(instruction.a) = decimalValue(asDecimal(x) operator asDecimal(y)); \
+		QUICKEN(decimalForm); \
+	} \
+	else if (!_arithmetic(machine, operation, x, y, &R(instruction.a))) FAIL(); \
+	NEXT(); \
+}
+#define DIVISION(right, decimalForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = (right); \
+	if (isDecimal(x) && isDecimal(y)) { \
+		R(instruction.a) = decimalValue(asDecimal(x) / asDecimal(y)); \
+		QUICKEN(decimalForm); \
+	} \
+	else if (!_arithmetic(machine, DIV_OPERATION, x, y, &R(instruction.a))) FAIL(); \
+	NEXT(); \
+}
+#define INTEGER_ARITHMETIC(operator, right, genericForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = (right); \
+	if (!isSmallInteger(x) || !isSmallInteger(y)) DEOPTIMIZE(genericForm); \
+	_storeInteger(machine, &R(instruction.a), (int64_t) ((uint64_t) asSmallInteger(x) operator (uint64_t) asSmallInteger(y))); \
+}
+#define DECIMAL_ARITHMETIC(operator, right, genericForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = (right); \
+	if (!isDecimal(x) || !isDecimal(y)) DEOPTIMIZE(genericForm); \
+	R(instruction.a) = decimalValue(asDecimal(x) operator asDecimal(y)); \
+}
+#define COMPARISON(operator, opcode, integerForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = R(instruction.c); \
+	if (isSmallInteger(x) && isSmallInteger(y)) { \
+		R(instruction.a) = booleanValue(asSmallInteger(x) operator asSmallInteger(y) ? true : false); \
+		QUICKEN(integerForm); \
+	} \
+	else { \
+		const int order = _order(opcode, x, y); \
+		if (order < 0) UNORDERED(operator, x, y); \
+		R(instruction.a) = booleanValue(order ? true : false); \
+	} \
+	NEXT(); \
+}
+#define INTEGER_COMPARISON(operator, genericForm) { \
+	const Value x = R(instruction.b); \
+	const Value y = R(instruction.c); \
+	if (!isSmallInteger(x) || !isSmallInteger(y)) DEOPTIMIZE(genericForm); \
+	R(instruction.a) = booleanValue(asSmallInteger(x) operator asSmallInteger(y) ? true : false); \
+}
+// Booleans and small integers are the usual conditions, so they're tested inline.
+#define TRUTH(condition) (isBoolean(condition) ? asBoolean(condition) \
+	: isSmallInteger(condition) ? (condition).bits != smallIntegerValue(0).bits : isTruthy(condition))
+#define BRANCH(holds) { \
+	pc += (holds) ? 1 : 1 + FOLLOWING().sbx; \
+	NEXT(); \
+}
+#define ORDER_TEST(operator, opcode, integerForm) { \
+	const Value x = R(instruction.a); \
+	const Value y = R(instruction.b); \
+	boolean holds; \
+	if (isSmallInteger(x) && isSmallInteger(y)) { \
+		holds = asSmallInteger(x) operator asSmallInteger(y) ? true : false; \
+		QUICKEN(integerForm); \
+	} \
+	else { \
+		const int order = _order(opcode, x, y); \
+		if (order < 0) UNORDERED(operator, x, y); \
+		holds = order ? true : false; \
+	} \
+	BRANCH(holds) \
+}
+#define INTEGER_ORDER_TEST(operator, genericForm) { \
+	const Value x = R(instruction.a); \
+	const Value y = R(instruction.b); \
+	if (!isSmallInteger(x) || !isSmallInteger(y)) DEOPTIMIZE(genericForm); \
+	BRANCH(asSmallInteger(x) operator asSmallInteger(y)) \
+}
+
+/* The effects of the instructions that can start a superinstruction. */
+#define EFFECT_MOVE() R(instruction.a) = R(instruction.b);
+#define EFFECT_LOADK() R(instruction.a) = K(instruction.bx);
+#define EFFECT_LOADINT() R(instruction.a) = smallIntegerValue(instruction.sbx);
+#define EFFECT_GETGLOBAL() { \
+	const GlobalVariable * global = &machine->globals[instruction.bx]; \
+	if (!global->isDefined) { \
+		SAVE_STATE(); \
+		runtimeError(machine, "Variable '%s' is not defined.", global->name); \
+		return false; \
+	} \
+	R(instruction.a) = global->value; \
+}
+#define EFFECT_GETCELL() R(instruction.a) = ((CellObject *) asObject(R(instruction.b)))->value;
+#define EFFECT_GETCAPTURE() R(instruction.a) = frame->closure->captures[instruction.b];
+#define EFFECT_GETFIELD() R(instruction.a) = ((InstanceObject *) asObject(R(instruction.b)))->fields[instruction.c];
+#define EFFECT_ADD_INT() INTEGER_ARITHMETIC(+, R(instruction.c), ADD)
+#define EFFECT_SUB_INT() INTEGER_ARITHMETIC(-, R(instruction.c), SUB)
+#define EFFECT_MUL_INT() INTEGER_ARITHMETIC(*, R(instruction.c), MUL)
+#define EFFECT_ADD_DEC() DECIMAL_ARITHMETIC(+, R(instruction.c), ADD)
+#define EFFECT_SUB_DEC() DECIMAL_ARITHMETIC(-, R(instruction.c), SUB)
+#define EFFECT_MUL_DEC() DECIMAL_ARITHMETIC(*, R(instruction.c), MUL)
+#define EFFECT_DIV_DEC() DECIMAL_ARITHMETIC(/, R(instruction.c), DIV)
+#define EFFECT_ADDK_INT() INTEGER_ARITHMETIC(+, K(instruction.c), ADDK)
+#define EFFECT_SUBK_INT() INTEGER_ARITHMETIC(-, K(instruction.c), SUBK)
+#define EFFECT_MULK_INT() INTEGER_ARITHMETIC(*, K(instruction.c), MULK)
+#define EFFECT_ADDK_DEC() DECIMAL_ARITHMETIC(+, K(instruction.c), ADDK)
+#define EFFECT_SUBK_DEC() DECIMAL_ARITHMETIC(-, K(instruction.c), SUBK)
+#define EFFECT_MULK_DEC() DECIMAL_ARITHMETIC(*, K(instruction.c), MULK)
+#define EFFECT_DIVK_DEC() DECIMAL_ARITHMETIC(/, K(instruction.c), DIVK)
+#define EFFECT_ADDI_INT() INTEGER_ARITHMETIC(+, smallIntegerValue((int8_t) instruction.c), ADDI)
+#define EFFECT_LT_INT() INTEGER_COMPARISON(<, LT)
+#define EFFECT_LE_INT() INTEGER_COMPARISON(<=, LE)
+
+	for (;;) {
+#ifdef DIRECT_THREADED_DISPATCH
+		NEXT();
+		{
+#else
+		instruction = *pc++;
+		++executed;
+		PROFILE();
+		switch (instruction.opcode) {
+#endif
+			CASE(MOVE) EFFECT_MOVE() NEXT();
+			CASE(LOADK) EFFECT_LOADK() NEXT();
+			CASE(LOADINT) EFFECT_LOADINT() NEXT();
+			CASE(LOADBOOL)
+				R(instruction.a) = booleanValue(instruction.b ? true : false);
+				NEXT();
+			CASE(LOADNIL)
+				R(instruction.a) = nilValue();
+				NEXT();
+			CASE(GETGLOBAL) EFFECT_GETGLOBAL() NEXT();
+			CASE(SETGLOBAL)
+				machine->globals[instruction.bx].value = promoteValue(&machine->heap, R(instruction.a));
+				machine->globals[instruction.bx].isDefined = true;
+				NEXT();
+			CASE(BOX)
+				R(instruction.a) = objectValue(newCell(&machine->heap, promoteValue(&machine->heap, R(instruction.a))));
+				_safepoint(machine);
+				NEXT();
+			CASE(GETCELL) EFFECT_GETCELL() NEXT();
+			CASE(SETCELL) {
+				const Value value = promoteValue(&machine->heap, R(instruction.b));
+				((CellObject *) asObject(R(instruction.a)))->value = value;
+				writeBarrier(&machine->heap, asObject(R(instruction.a)), value);
+				NEXT();
+			}
+			CASE(GETCAPTURE) EFFECT_GETCAPTURE() NEXT();
+			CASE(GETSHARED)
+				R(instruction.a) = ((CellObject *) asObject(frame->closure->captures[instruction.b]))->value;
+				NEXT();
+			CASE(SETSHARED) {
+				const Value value = promoteValue(&machine->heap, R(instruction.b));
+				((CellObject *) asObject(frame->closure->captures[instruction.a]))->value = value;
+				writeBarrier(&machine->heap, asObject(frame->closure->captures[instruction.a]), value);
+				NEXT();
+			}
+			CASE(GETFIELD) EFFECT_GETFIELD() NEXT();
+			CASE(SETFIELD) {
+				const Value value = promoteValue(&machine->heap, R(instruction.c));
+				((InstanceObject *) asObject(R(instruction.a)))->fields[instruction.b] = value;
+				writeBarrier(&machine->heap, asObject(R(instruction.a)), value);
+				NEXT();
+			}
+			CASE(GETMETHOD) {
+				const Value receiver = R(instruction.b);
+				const char * name = ((StringObject *) asObject(K(instruction.c)))->characters;
+				Prototype * method = findMethod(((InstanceObject *) asObject(receiver))->class, name);
+				R(instruction.a) = objectValue(newBoundMethod(&machine->heap, receiver, method));
+				_safepoint(machine);
+				NEXT();
+			}
+			CASE(ADD) ARITHMETIC(ADD_OPERATION, +, R(instruction.c), ADD_INT, ADD_DEC)
+			CASE(SUB) ARITHMETIC(SUB_OPERATION, -, R(instruction.c), SUB_INT, SUB_DEC)
+			CASE(MUL) ARITHMETIC(MUL_OPERATION, *, R(instruction.c), MUL_INT, MUL_DEC)
+			CASE(ADDK) ARITHMETIC(ADD_OPERATION, +, K(instruction.c), ADDK_INT, ADDK_DEC)
+			CASE(SUBK) ARITHMETIC(SUB_OPERATION, -, K(instruction.c), SUBK_INT, SUBK_DEC)
+			CASE(MULK) ARITHMETIC(MUL_OPERATION, *, K(instruction.c), MULK_INT, MULK_DEC)
+			CASE(DIV) DIVISION(R(instruction.c), DIV_DEC)
+			CASE(DIVK) DIVISION(K(instruction.c), DIVK_DEC)
+			CASE(ADDI) {
+				const Value x = R(instruction.b);
+				if (isSmallInteger(x)) {
+					_storeInteger(machine, &R(instruction.a), asSmallInteger(x) + (int8_t) instruction.c);
+					QUICKEN(ADDI_INT);
+				}
+				else if (!_arithmetic(machine, ADD_OPERATION, x, smallIntegerValue((int8_t) instruction.c), &R(instruction.a))) FAIL();
+				NEXT();
+			}
+			CASE(LT) COMPARISON(<, OP_LT, LT_INT)
+			CASE(LE) COMPARISON(<=, OP_LE, LE_INT)
+			CASE(EQ)
+				R(instruction.a) = booleanValue(valuesEqual(R(instruction.b), R(instruction.c)));
+				NEXT();
+			CASE(NE)
+				R(instruction.a) = booleanValue(valuesEqual(R(instruction.b), R(instruction.c)) ? false : true);
+				NEXT();
+			CASE(JMP)
+				pc += instruction.sbx;
+				NEXT();
+			CASE(JMPIF) {
+				const Value condition = R(instruction.a);
+				if (TRUTH(condition)) pc += instruction.sbx;
+				NEXT();
+			}
+			CASE(JMPIFNOT) {
+				const Value condition = R(instruction.a);
+				if (!TRUTH(condition)) pc += instruction.sbx;
+				NEXT();
+			}
+			CASE(TESTARG)
+				if (instruction.a < frame->passedLimit) pc += instruction.sbx;
+				NEXT();
+			CASE(CALL)
+				SAVE_STATE();
+				if (!_call(machine, &R(instruction.a), instruction.b)) return false;
+				LOAD_STATE();
+				_safepoint(machine);
+				NEXT();
+			CASE(INVOKE)
+				SAVE_STATE();
+				if (!_invoke(machine, &R(instruction.a), &frame->prototype->invokeSites[instruction.b], instruction.c)) return false;
+				LOAD_STATE();
+				NEXT();
+			CASE(TAILCALL)
+				SAVE_STATE();
+				if (!_tailCall(machine, &R(instruction.a), instruction.b)) return false;
+				LOAD_STATE();
+				_safepoint(machine);
+				NEXT();
+			CASE(TAILINVOKE)
+				SAVE_STATE();
+				if (!_tailInvoke(machine, &R(instruction.a), &frame->prototype->invokeSites[instruction.b], instruction.c)) return false;
+				LOAD_STATE();
+				NEXT();
+			CASE(NEW)
+			CASE(NEWSCOPED)
+				SAVE_STATE();
+				if (!_instantiate(machine, machine->program->classes[instruction.b], &R(instruction.a), instruction.c, instruction.opcode == OP_NEWSCOPED)) return false;
+				LOAD_STATE();
+				_safepoint(machine);
+				NEXT();
+			CASE(DROP) {
+				// Every instance created after this one is already dropped.
+				const uint8_t * instance = (const uint8_t *) asObject(R(instruction.a));
+				if (machine->scopedInstances <= instance && instance < machine->scopedInstances + machine->scopedInstancesSize) {
+					machine->scopedInstancesSize = instance - machine->scopedInstances;
+				}
+				R(instruction.a) = nilValue();
+				NEXT();
+			}
+			CASE(CONCAT) {
+				const Value x = R(instruction.b);
+				const Value y = R(instruction.c);
+				if (isObjectOfType(x, STRING_OBJECT) || isObjectOfType(y, STRING_OBJECT)) {
+					R(instruction.a) = objectValue(concatenateTemporaries(&machine->heap, x, y));
+					_safepoint(machine);
+				}
+				else if (!_arithmetic(machine, ADD_OPERATION, x, y, &R(instruction.a))) FAIL();
+				NEXT();
+			}
+			CASE(JOIN)
+			CASE(APPEND) {
+				// The numbers before the first string add up, and the rest is concatenated at once.
+				Value * parts = &R(instruction.b);
+				Value sum = parts[0];
+				int first = 1;
+				for (; first < instruction.c && !isObjectOfType(sum, STRING_OBJECT) && !isObjectOfType(parts[first], STRING_OBJECT); ++first) {
+					if (!_arithmetic(machine, ADD_OPERATION, sum, parts[first], &sum)) FAIL();
+				}
+				parts[first - 1] = sum;
+				if (first == instruction.c) {
+					R(instruction.a) = sum;
+				}
+				else if (instruction.opcode == OP_APPEND) {
+					R(instruction.a) = objectValue(appendValues(&machine->heap, &parts[first - 1], instruction.c - first + 1));
+				}
+				else {
+					R(instruction.a) = objectValue(joinValues(&machine->heap, &parts[first - 1], instruction.c - first + 1));
+				}
+				_safepoint(machine);
+				NEXT();
+			}
+			CASE(NEWLIST) {
+				ListObject * list = newRegionList(&machine->heap, instruction.b);
+				for (int k = 0; k < instruction.b; ++k) {
+					appendToList(list, R(instruction.a + 1 + k));
+					listWriteBarrier(&machine->heap, list, k, R(instruction.a + 1 + k));
+				}
+				R(instruction.a) = objectValue(list);
+				_safepoint(machine);
+				NEXT();
+			}
+			CASE(CLOSURE)
+				R(instruction.a) = objectValue(_newClosure(machine, frame, frame->prototype->prototypes[instruction.bx]));
+				_safepoint(machine);
+				NEXT();
+			CASE(RETURN)
+			CASE(RETURNNIL) {
+				Value result = instruction.opcode == OP_RETURN ? R(instruction.a) : nilValue();
+				Region * region = &machine->heap.region;
+				if (region->top != frame->regionMark) {
+					// The temporaries of the frame die with it, so its result can't be one of them.
+					const uint8_t * temporaries = region->memory + frame->regionMark;
+					if (isObject(result) && (uintptr_t) asObject(result) - (uintptr_t) temporaries < region->top - frame->regionMark) {
+						result = promoteTemporary(&machine->heap, result);
+					}
+					releaseRegion(&machine->heap, frame->regionMark, frame->regionListMark);
+				}
+				*frame->result = result;
+				machine->frameCount -= 1;
+				if (machine->frameCount == 0) {
+					machine->executedInstructions += executed;
+					return true;
+				}
+				LOAD_STATE();
+				NEXT();
+			}
+			CASE(FORPREP) {
+				const Value collection = R(instruction.a);
+				if (!isObjectOfType(collection, LIST_OBJECT) && !isObjectOfType(collection, RANGE_OBJECT) && !isObjectOfType(collection, STRING_OBJECT)) {
+					SAVE_STATE();
+					runtimeError(machine, "A %s cannot be iterated.", valueTypeName(collection));
+					return false;
+				}
+				R(instruction.a + 1) = smallIntegerValue(0);
+				if (isObjectOfType(collection, RANGE_OBJECT)) {
+					// The range becomes a counted loop, unless its integers are boxed.
+					const RangeObject * range = (const RangeObject *) asObject(collection);
+					if (fitsSmallInteger(range->start) && fitsSmallInteger(range->end)) {
+						R(instruction.a) = smallIntegerValue(range->end);
+						R(instruction.a + 1) = smallIntegerValue(range->start);
+					}
+				}
+				pc += instruction.sbx;
+				NEXT();
+			}
+			CASE(FORNEXT) {
+				if (isSmallInteger(R(instruction.a))) {
+					QUICKEN(FORNEXT_COUNT);
+					goto HANDLER_FORNEXT_COUNT;
+				}
+				const HeapObject * collection = asObject(R(instruction.a));
+				const int64_t index = asSmallInteger(R(instruction.a + 1));
+				boolean hasItem = false;
+				if (collection->type == LIST_OBJECT) {
+					const ListObject * list = (const ListObject *) collection;
+					if (index < list->size) {
+						R(instruction.a + 2) = list->items[index];
+						hasItem = true;
+					}
+				}
+				else if (collection->type == RANGE_OBJECT) {
+					const RangeObject * range = (const RangeObject *) collection;
+					if (range->start + index < range->end) {
+						R(instruction.a + 2) = integerValue(&machine->heap, range->start + index);
+						hasItem = true;
+					}
+				}
+				else {
+					const StringObject * string = (const StringObject *) collection;
+					if (index < string->length) {
+						R(instruction.a + 2) = objectValue(newString(&machine->heap, &stringCharacters(string)[index], 1));
+						hasItem = true;
+					}
+				}
+				if (collection->type == LIST_OBJECT) QUICKEN(FORNEXT_LIST);
+				if (hasItem) {
+					R(instruction.a + 1) = smallIntegerValue(index + 1);
+					pc += instruction.sbx;
+				}
+				_safepoint(machine);
+				NEXT();
+			}
+			CASE(TESTLT) ORDER_TEST(<, OP_LT, TESTLT_INT)
+			CASE(TESTLE) ORDER_TEST(<=, OP_LE, TESTLE_INT)
+			CASE(TESTEQ) BRANCH(valuesEqual(R(instruction.a), R(instruction.b)))
+			CASE(TESTNE) BRANCH(!valuesEqual(R(instruction.a), R(instruction.b)))
+			CASE(ADD_INT) EFFECT_ADD_INT() NEXT();
+			CASE(SUB_INT) EFFECT_SUB_INT() NEXT();
+			CASE(MUL_INT) EFFECT_MUL_INT() NEXT();
+			CASE(ADD_DEC) EFFECT_ADD_DEC() NEXT();
+			CASE(SUB_DEC) EFFECT_SUB_DEC() NEXT();
+			CASE(MUL_DEC) EFFECT_MUL_DEC() NEXT();
+			CASE(DIV_DEC) EFFECT_DIV_DEC() NEXT();
+			CASE(ADDK_INT) EFFECT_ADDK_INT() NEXT();
+			CASE(SUBK_INT) EFFECT_SUBK_INT() NEXT();
+			CASE(MULK_INT) EFFECT_MULK_INT() NEXT();
+			CASE(ADDK_DEC) EFFECT_ADDK_DEC() NEXT();
+			CASE(SUBK_DEC) EFFECT_SUBK_DEC() NEXT();
+			CASE(MULK_DEC) EFFECT_MULK_DEC() NEXT();
+			CASE(DIVK_DEC) EFFECT_DIVK_DEC() NEXT();
+			CASE(ADDI_INT) EFFECT_ADDI_INT() NEXT();
+			CASE(LT_INT) EFFECT_LT_INT() NEXT();
+			CASE(LE_INT) EFFECT_LE_INT() NEXT();
+			CASE(TESTLT_INT) INTEGER_ORDER_TEST(<, TESTLT)
+			CASE(TESTLE_INT) INTEGER_ORDER_TEST(<=, TESTLE)
+			CASE(FORNEXT_LIST) {
+				if (!isObjectOfType(R(instruction.a), LIST_OBJECT)) DEOPTIMIZE(FORNEXT);
+				const ListObject * list = (const ListObject *) asObject(R(instruction.a));
+				const int64_t index = asSmallInteger(R(instruction.a + 1));
+				if (index < list->size) {
+					R(instruction.a + 2) = list->items[index];
+					R(instruction.a + 1) = smallIntegerValue(index + 1);
+					pc += instruction.sbx;
+				}
+				NEXT();
+			}
+			CASE(FORNEXT_COUNT) {
+				if (!isSmallInteger(R(instruction.a))) DEOPTIMIZE(FORNEXT);
+				// Small integers order like their bits.
+				const Value next = R(instruction.a + 1);
+				if (next.bits < R(instruction.a).bits) {
+					R(instruction.a + 2) = next;
+					R(instruction.a + 1).bits = next.bits + 1;
+					pc += instruction.sbx;
+				}
+				NEXT();
+			}
+#define SUPERINSTRUCTION(unused, name, first, second, format) \
+			CASE(name) \
+				EFFECT_##first() \
+				if (FOLLOWING().opcode != OP_##second) NEXT(); \
+				instruction = FOLLOWING(); \
+				++pc; \
+				goto HANDLER_##second;
+			SUPERINSTRUCTIONS(SUPERINSTRUCTION, _)
+#undef SUPERINSTRUCTION
+#ifndef DIRECT_THREADED_DISPATCH
+			default:
+				SAVE_STATE();
+				runtimeError(machine, "Unknown opcode %d.", instruction.opcode);
+				return false;
+#endif
+		}
+	}
+
+#undef EFFECT_LE_INT
+#undef EFFECT_LT_INT
+#undef EFFECT_ADDI_INT
+#undef EFFECT_DIVK_DEC
+#undef EFFECT_MULK_DEC
+#undef EFFECT_SUBK_DEC
+#undef EFFECT_ADDK_DEC
+#undef EFFECT_MULK_INT
+#undef EFFECT_SUBK_INT
+#undef EFFECT_ADDK_INT
+#undef EFFECT_DIV_DEC
+#undef EFFECT_MUL_DEC
+#undef EFFECT_SUB_DEC
+#undef EFFECT_ADD_DEC
+#undef EFFECT_MUL_INT
+#undef EFFECT_SUB_INT
+#undef EFFECT_ADD_INT
+#undef EFFECT_GETFIELD
+#undef EFFECT_GETCAPTURE
+#undef EFFECT_GETCELL
+#undef EFFECT_GETGLOBAL
+#undef EFFECT_LOADINT
+#undef EFFECT_LOADK
+#undef EFFECT_MOVE
+#undef INTEGER_ORDER_TEST
+#undef ORDER_TEST
+#undef BRANCH
+#undef TRUTH
+#undef INTEGER_COMPARISON
+#undef COMPARISON
+#undef DECIMAL_ARITHMETIC
+#undef INTEGER_ARITHMETIC
+#undef DIVISION
+#undef ARITHMETIC
+#undef UNORDERED
+#undef DEOPTIMIZE
+#undef QUICKEN
+#undef REWRITE
+#undef FUSE
+#undef FOLLOWING
+#undef NEXT
+#undef CASE
+#undef PROFILE
+#undef FAIL
+#undef LOAD_STATE
+#undef SAVE_STATE
+#undef K
+#undef R
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean defineGlobal(VirtualMachine * machine, const char * name, const Value value) {
+	for (int k = 0; k < machine->program->globalCount; ++k) {
+		if (strcmp(machine->globals[k].name, name) == 0) {
+			machine->globals[k].value = value;
+			machine->globals[k].isDefined = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void runtimeError(VirtualMachine * machine, const char * const format, ...) {
+	char message[512];
+	va_list arguments;
+	va_start(arguments, format);
+	vsnprintf(message, sizeof(message), format, arguments);
+	va_end(arguments);
+	flushEmitter(machine->output);
+	logError(_logger, "Runtime error: %s", message);
+	const int skipped = machine->frameCount - 2 * TRACED_FRAMES;
+	for (int k = machine->frameCount - 1; 0 <= k; --k) {
+		if (1 < skipped && k == TRACED_FRAMES - 1 + skipped) {
+			logError(_logger, "    ... %d more frames", skipped);
+			k = TRACED_FRAMES - 1;
+		}
+		logError(_logger, "    in %s", machine->frames[k].prototype->name);
+	}
+}
+
+boolean executeProgram(const CompiledProgram * program) {
+	VirtualMachine machine;
+	memset(&machine, 0, sizeof(VirtualMachine));
+	machine.program = program;
+	machine.globals = calloc(program->globalCount + 1, sizeof(GlobalVariable));
+	for (int k = 0; k < program->globalCount; ++k) {
+		machine.globals[k].name = program->globalNames[k];
+		machine.globals[k].value = nilValue();
+	}
+	machine.output = createEmitter(STDOUT_FILENO);
+	machine.stack = calloc(STACK_SIZE, sizeof(Value));
+	machine.frames = calloc(MAXIMUM_FRAMES, sizeof(CallFrame));
+	machine.scopedInstances = malloc(SCOPED_INSTANCES_SIZE);
+	const int nurserySize = getIntegerOrDefault("VM_NURSERY_SIZE", DEFAULT_NURSERY_SIZE);
+	createNursery(&machine.heap, 0 < nurserySize ? nurserySize : 0);
+	const int regionSize = getIntegerOrDefault("VM_REGION_SIZE", DEFAULT_REGION_SIZE);
+	createRegion(&machine.heap, 0 < regionSize ? regionSize : 0);
+	installNatives(&machine);
+	_prepareDispatch(program->main);
+	for (int k = 0; k < program->classCount; ++k) {
+		_prepareDispatch(program->classes[k]->initializer);
+		for (int m = 0; m < program->classes[k]->methodCount; ++m) {
+			if (program->classes[k]->methods[m].owner == program->classes[k]) {
+				_prepareDispatch(program->classes[k]->methods[m].prototype);
+			}
+		}
+	}
+
+	struct timespec start;
+	struct timespec end;
+	Value result;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	const boolean succeed = (_pushFrame(&machine, NULL, program->main, machine.stack, 0, &result) && _execute(&machine)) ? true : false;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	flushEmitter(machine.output);
+
+	const double milliseconds = 1e3 * (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e6;
+	logDebugging(_logger, "Executed %llu instruction(s) in %.3f ms, and allocated %d object(s) (%zu byte(s)).",
+		(unsigned long long) machine.executedInstructions, milliseconds, machine.heap.objectCount, machine.heap.allocatedBytes);
+	logDebugging(_logger, "Quickened %llu instruction(s), and deoptimized %llu.",
+		(unsigned long long) machine.quickenedInstructions, (unsigned long long) machine.deoptimizedInstructions);
+	const HeapStatistics * statistics = &machine.heap.statistics;
+	logDebugging(_logger, "Collected the nursery %d time(s), and the old generation %d, in %.3f ms (the longest pause took %.3f ms).",
+		statistics->minorCollections, statistics->majorCollections, statistics->pauseMilliseconds, statistics->longestPauseMilliseconds);
+	logDebugging(_logger, "Promoted %zu byte(s), freed %zu, and %zu remain in the old generation.",
+		statistics->promotedBytes, statistics->freedBytes, machine.heap.oldBytes);
+	const char * profilePath = getStringOrDefault("VM_PROFILE", NULL);
+	if (profilePath != NULL) {
+		_writeProfile(profilePath);
+	}
+	_releaseDispatch(program->main);
+	for (int k = 0; k < program->classCount; ++k) {
+		_releaseDispatch(program->classes[k]->initializer);
+		for (int m = 0; m < program->classes[k]->methodCount; ++m) {
+			if (program->classes[k]->methods[m].owner == program->classes[k]) {
+				_releaseDispatch(program->classes[k]->methods[m].prototype);
+			}
+		}
+	}
+	releaseHeap(&machine.heap);
+	destroyEmitter(machine.output);
+	free(machine.scopedInstances);
+	free(machine.frames);
+	free(machine.stack);
+	free(machine.globals);
+	return succeed;
+}
@@ -0,0 +1,126 @@
+#ifndef VIRTUAL_MACHINE_HEADER
+#define VIRTUAL_MACHINE_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Bytecode.h"
+#include "Value.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** The amount of registers available to every frame, together. */
+#define STACK_SIZE (1 << 20)
+
+/** The deepest chain of calls before a stack overflow. */
+#define MAXIMUM_FRAMES (1 << 16)
+
+/**
+ * The frames of a runtime error's trace shown at each end of the chain of
+ * calls. The frames in between are summarized in a single line.
+ */
+#define TRACED_FRAMES 10
+
+/**
+ * The bytes for the instances that live in the scope of a frame, together.
+ * Once they're full, scoped instances live in the heap.
+ */
+#define SCOPED_INSTANCES_SIZE (1 << 20)
+
+/**
+ * The bytes for the temporaries of every frame, together, by default. Once
+ * they're full, temporaries live in the heap.
+ */
+#define DEFAULT_REGION_SIZE (1 << 20)
+
+/**
+ * GCC (and compatible compilers) can dispatch the bytecode with direct
+ * threading, if the build defines DIRECT_THREADED_DISPATCH: every instruction
+ * carries the address of its handler. Otherwise, a portable switch decodes
+ * the opcode of every instruction.
+ */
+#if defined(DIRECT_THREADED_DISPATCH) && !defined(__GNUC__)
+#undef DIRECT_THREADED_DISPATCH
+#endif
+
+#ifdef DIRECT_THREADED_DISPATCH
+typedef struct {
+	const void * handler;
+	BytecodeInstruction instruction;
+} DispatchInstruction;
+#else
+typedef BytecodeInstruction DispatchInstruction;
+#endif
+
+/**
+ * An activation of a prototype. The registers of a frame start at its base,
+ * and the arguments of a call are already in place (after the receiver, if
+ * any). The passed limit is the first register whose argument is missing.
+ * The region marks are the top of the region, and its count of lists, when
+ * the frame starts: its temporaries are the ones after them.
+ */
+typedef struct {
+	ClosureObject * closure;
+	Prototype * prototype;
+	const DispatchInstruction * pc;
+	Value * base;
+	int passedLimit;
+	Value * result;
+	size_t regionMark;
+	int regionListMark;
+} CallFrame;
+
+typedef struct {
+	const char * name;
+	Value value;
+	boolean isDefined;
+} GlobalVariable;
+
+struct VirtualMachine {
+	Heap heap;
+	Emitter * output;
+	const CompiledProgram * program;
+	GlobalVariable * globals;
+	Value * stack;
+	CallFrame * frames;
+	int frameCount;
+	// The scoped instances, in order of creation (each one outlives the next).
+	uint8_t * scopedInstances;
+	size_t scopedInstancesSize;
+	uint64_t executedInstructions;
+	uint64_t quickenedInstructions;
+	uint64_t deoptimizedInstructions;
+};
+
+/** Initialize module's internal state. */
+void initializeVirtualMachineModule();
+
+/** Shutdown module's internal state. */
+void shutdownVirtualMachineModule();
+
+/**
+ * Defines a global of the program, if it references it.
+ *
+ * @return Whether the program references the global.
+ */
+boolean defineGlobal(VirtualMachine * machine, const char * name, const Value value);
+
+/**
+ * Reports an error of the running program, with the chain of calls that
+ * reaches it. The execution stops after the failing instruction.
+ */
+void runtimeError(VirtualMachine * machine, const char * const format, ...);
+
+/**
+ * Runs the top-level code of a compiled program, and releases every object
+ * it allocates.
+ *
+ * @return Whether it finishes without runtime errors.
+ */
+boolean executeProgram(const CompiledProgram * program);
+
+#endif
@@ -127,6 +127,21 @@ void QuoteLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
 }
 
+Token BacktickLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
+	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
+	lexicalAnalyzerContext->semanticValue->token = BACKTICK;
+	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
+	return BACKTICK;
+}
+
+Token InterpolationLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
+	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
+	// The lexeme is "${name}".
+	lexicalAnalyzerContext->semanticValue->name = strndup(lexicalAnalyzerContext->lexeme + 2, lexicalAnalyzerContext->length - 3);
+	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
+	return INTERPOLATION;
+}
+
 Token UnknownLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
 	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
@@ -157,8 +172,8 @@ Token ColonLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext){
 
 Token TypeLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, VariableType varType) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	lexicalAnalyzerContext->semanticValue->varType = varType;
 	lexicalAnalyzerContext->semanticValue->token = TYPE;
+	lexicalAnalyzerContext->semanticValue->varType = varType;
 	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
 	return TYPE;
 }
@@ -229,7 +244,8 @@ Token ComparatorLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 		case '=':
 			if(lexicalAnalyzerContext->lexeme[1] == '='){
 				token = EQUAL_EQUAL;
-			};
+			}
+			break;
 		case '!':
 			if(lexicalAnalyzerContext->lexeme[1] == '='){
 				token = NOT_EQUAL;
@@ -189,6 +189,24 @@ void ApostropheLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
  * @param lexicalAnalyzerContext Pointer to the current lexical analyzer context.
  */
 void QuoteLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
+
+/**
+ * @brief Handles the action for recognizing a backtick, which opens or closes a template string.
+ *
+ * @param lexicalAnalyzerContext Pointer to the current lexical analyzer context.
+ * @return Token representing the backtick lexeme.
+ */
+Token BacktickLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
+
+/**
+ * @brief Handles the action for recognizing an interpolation ("${name}") in a template string.
+ *
+ * The semantic value is the name of the interpolated variable.
+ *
+ * @param lexicalAnalyzerContext Pointer to the current lexical analyzer context.
+ * @return Token representing the interpolation lexeme.
+ */
+Token InterpolationLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 #pragma endregion
 
 #pragma region Language Constructs
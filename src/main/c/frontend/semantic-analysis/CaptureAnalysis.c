@@ -0,0 +1,792 @@
+#include "CaptureAnalysis.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeCaptureAnalysisModule() {
+	_logger = createLogger("CaptureAnalysis");
+}
+
+void shutdownCaptureAnalysisModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+typedef enum {
+	GLOBAL_SYMBOL,
+	LOCAL_SYMBOL,
+	PARAMETER_SYMBOL,
+	FIELD_SYMBOL
+} SymbolKind;
+
+typedef struct Symbol Symbol;
+typedef struct Scope Scope;
+typedef struct Function Function;
+typedef struct FreeVariable FreeVariable;
+
+/**
+ * A declared name. Definitions are the initializations (declarations with a
+ * value, first assignments, parameters), and writes are every other
+ * assignment, increment or decrement.
+ */
+struct Symbol {
+	const char * name;
+	SymbolKind kind;
+	Function * boundFunction;
+	int definitions;
+	int writes;
+	boolean isInitializing;
+	boolean escapes;
+	Symbol * next;
+	Symbol * allocated;
+};
+
+struct Scope {
+	Scope * parent;
+	Function * function;
+	boolean isClass;
+	Symbol * symbols;
+};
+
+/**
+ * A free variable of a function. The receiver of a method has no symbol.
+ */
+struct FreeVariable {
+	Symbol * symbol;
+	boolean byReference;
+	FreeVariable * next;
+};
+
+/**
+ * The analysis state of a lambda.
+ */
+struct Function {
+	Lambda * lambda;
+	const char * name;
+	Function * parent;
+	Scope * definingScope;
+	Symbol ** parameters;
+	int parameterCount;
+	FreeVariable * freeVariables;
+	boolean escapes;
+	Function * allocated;
+};
+
+typedef enum {
+	SINK_NONE,
+	SINK_ESCAPE,
+	SINK_SYMBOL,
+	SINK_ARGUMENT,
+	SINK_FUNCTION
+} SinkType;
+
+/**
+ * Where the value of an expression flows to: nowhere (it's consumed), out of
+ * the frame, into a symbol, into the n-th argument of a call (whose callee
+ * symbol may be unknown), or into the closure of a lambda.
+ */
+typedef struct {
+	SinkType type;
+	Symbol * symbol;
+	Function * function;
+	int index;
+} Sink;
+
+/**
+ * A flow from a symbol or a lambda literal into a sink. If the sink escapes,
+ * the source escapes too.
+ */
+typedef struct {
+	Symbol * symbol;
+	Function * function;
+	Sink sink;
+} Edge;
+
+/**
+ * What a node expects from one of its children: the sink of its value, and
+ * the name it's bound to. If the child is a lambda literal (maybe inside
+ * parentheses), its function is reported back, so a definition can bind it.
+ */
+typedef struct {
+	const void * owner;
+	const void * node;
+	Sink sink;
+	const char * name;
+	Symbol * definition;
+	Function * function;
+} Expectation;
+
+struct CaptureAnalysis {
+	Scope * scope;
+	Function * function;
+	Symbol * symbols;
+	Function * functions;
+	Edge * edges;
+	int edgeCount;
+	int edgeCapacity;
+	Expectation * expectations;
+	int expectationCount;
+	int expectationCapacity;
+	const SignatureTable * signatures;
+	int escaping;
+};
+
+static const Sink _noSink = { SINK_NONE, NULL, NULL, 0 };
+static const Sink _escapeSink = { SINK_ESCAPE, NULL, NULL, 0 };
+
+/* PRIVATE FUNCTIONS */
+
+static void _addEdge(CaptureAnalysis * analysis, Symbol * symbol, Function * function, Sink sink);
+static void _addFreeVariable(CaptureAnalysis * analysis, Function * function, Symbol * symbol);
+static Function * _boundFunction(Symbol * symbol);
+static void _capture(CaptureAnalysis * analysis, Symbol * symbol, Scope * scope);
+static Symbol * _declare(CaptureAnalysis * analysis, const char * name, SymbolKind kind);
+static void _declareMembers(CaptureAnalysis * analysis, const TypeSignature * type);
+static void _define(CaptureAnalysis * analysis, const void * owner, Symbol * symbol, Expression * expression);
+static VisitAction _enterAssignment(void * state, void * node);
+static VisitAction _enterCall(void * state, void * node);
+static VisitAction _enterClass(void * state, void * node);
+static VisitAction _enterDeclaration(void * state, void * node);
+static VisitAction _enterExpressionStatement(void * state, void * node);
+static VisitAction _enterFactorExpression(void * state, void * node);
+static VisitAction _enterInterface(void * state, void * node);
+static VisitAction _enterLambda(void * state, void * node);
+static VisitAction _enterLoop(void * state, void * node);
+static VisitAction _enterParameter(void * state, void * node);
+static VisitAction _enterParenthesis(void * state, void * node);
+static VisitAction _enterReturn(void * state, void * node);
+static VisitAction _enterScope(void * state, void * node);
+static VisitAction _enterVariable(void * state, void * node);
+static VisitAction _enterWrite(void * state, void * node);
+static Expectation * _expect(CaptureAnalysis * analysis, const void * owner, const void * node, Sink sink, const char * name);
+static Expectation * _expectation(CaptureAnalysis * analysis, const void * node);
+static void _finishAnalysis(void * state);
+static void _forget(CaptureAnalysis * analysis, const void * owner);
+static boolean _isWithin(Scope * inner, Scope * outer);
+static void _leaveDefinition(void * state, void * node);
+static void _leaveExpectations(void * state, void * node);
+static void _leaveForwarding(void * state, void * node);
+static void _leaveLambda(void * state, void * node);
+static void _leaveParameter(void * state, void * node);
+static void _leaveScope(void * state, void * node);
+static Symbol * _lookup(Scope * scope, const char * name);
+static SymbolKind _newSymbolKind(CaptureAnalysis * analysis);
+static void _popScope(CaptureAnalysis * analysis);
+static void _propagateEscapes(CaptureAnalysis * analysis);
+static void _pushScope(CaptureAnalysis * analysis, boolean isClass);
+static void _releaseAnalysis(CaptureAnalysis * analysis);
+static Symbol * _resolve(CaptureAnalysis * analysis, const char * name);
+static boolean _sinkEscapes(Sink * sink);
+static int _storeResults(CaptureAnalysis * analysis);
+
+static void _pushScope(CaptureAnalysis * analysis, boolean isClass) {
+	Scope * scope = calloc(1, sizeof(Scope));
+	scope->parent = analysis->scope;
+	scope->function = analysis->function;
+	scope->isClass = isClass;
+	analysis->scope = scope;
+}
+
+/**
+ * Pops the innermost scope. Its symbols outlive it, because the escapes are
+ * propagated after the whole program is visited.
+ */
+static void _popScope(CaptureAnalysis * analysis) {
+	Scope * scope = analysis->scope;
+	analysis->scope = scope->parent;
+	free(scope);
+}
+
+static Symbol * _declare(CaptureAnalysis * analysis, const char * name, SymbolKind kind) {
+	Symbol * symbol = calloc(1, sizeof(Symbol));
+	symbol->name = name;
+	symbol->kind = kind;
+	symbol->escapes = (kind == GLOBAL_SYMBOL || kind == FIELD_SYMBOL) ? true : false;
+	symbol->next = analysis->scope->symbols;
+	analysis->scope->symbols = symbol;
+	symbol->allocated = analysis->symbols;
+	analysis->symbols = symbol;
+	return symbol;
+}
+
+static SymbolKind _newSymbolKind(CaptureAnalysis * analysis) {
+	if (analysis->scope->isClass) return FIELD_SYMBOL;
+	if (analysis->scope->parent == NULL) return GLOBAL_SYMBOL;
+	return LOCAL_SYMBOL;
+}
+
+static Symbol * _lookup(Scope * scope, const char * name) {
+	for (Symbol * symbol = scope->symbols; symbol != NULL; symbol = symbol->next) {
+		if (strcmp(symbol->name, name) == 0) return symbol;
+	}
+	return NULL;
+}
+
+static boolean _isWithin(Scope * inner, Scope * outer) {
+	for (Scope * scope = inner; scope != NULL; scope = scope->parent) {
+		if (scope == outer) return true;
+	}
+	return false;
+}
+
+/**
+ * Resolves a name from the innermost scope outwards, and records the capture
+ * if it belongs to an enclosing function. Returns NULL for unresolved names.
+ */
+static Symbol * _resolve(CaptureAnalysis * analysis, const char * name) {
+	for (Scope * scope = analysis->scope; scope != NULL; scope = scope->parent) {
+		Symbol * symbol = _lookup(scope, name);
+		if (symbol != NULL) {
+			_capture(analysis, symbol, scope);
+			return symbol;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Every function between the current one and the owner of the symbol must
+ * capture it, so the closures stay flat. Members are reached through the
+ * receiver, so methods don't capture them, but the lambdas nested inside a
+ * method must capture the receiver.
+ */
+static void _capture(CaptureAnalysis * analysis, Symbol * symbol, Scope * scope) {
+	if (symbol->kind == GLOBAL_SYMBOL) return;
+	if (symbol->kind == FIELD_SYMBOL) {
+		for (Function * function = analysis->function;
+			function != NULL && function->definingScope != scope && _isWithin(function->definingScope, scope);
+			function = function->parent) {
+			_addFreeVariable(analysis, function, NULL);
+		}
+		return;
+	}
+	for (Function * function = analysis->function; function != NULL && function != scope->function; function = function->parent) {
+		_addFreeVariable(analysis, function, symbol);
+	}
+}
+
+/**
+ * A function that captures its own variable while it's being initialized
+ * (i.e., a recursive local lambda) sees the value after the assignment, so
+ * that capture must be shared.
+ */
+static void _addFreeVariable(CaptureAnalysis * analysis, Function * function, Symbol * symbol) {
+	const boolean byReference = (symbol != NULL && symbol->isInitializing) ? true : false;
+	FreeVariable ** link = &function->freeVariables;
+	while (*link != NULL) {
+		if ((*link)->symbol == symbol) {
+			if (byReference) (*link)->byReference = true;
+			return;
+		}
+		link = &(*link)->next;
+	}
+	FreeVariable * freeVariable = calloc(1, sizeof(FreeVariable));
+	freeVariable->symbol = symbol;
+	freeVariable->byReference = byReference;
+	*link = freeVariable;
+	if (symbol != NULL) {
+		Sink sink = { SINK_FUNCTION, NULL, function, 0 };
+		_addEdge(analysis, symbol, NULL, sink);
+	}
+}
+
+static void _addEdge(CaptureAnalysis * analysis, Symbol * symbol, Function * function, Sink sink) {
+	if (sink.type == SINK_NONE) return;
+	if (analysis->edgeCount == analysis->edgeCapacity) {
+		analysis->edgeCapacity = analysis->edgeCapacity == 0 ? 64 : 2 * analysis->edgeCapacity;
+		analysis->edges = realloc(analysis->edges, analysis->edgeCapacity * sizeof(Edge));
+	}
+	Edge * edge = &analysis->edges[analysis->edgeCount++];
+	edge->symbol = symbol;
+	edge->function = function;
+	edge->sink = sink;
+}
+
+/**
+ * Declares the members of a class (including the inherited ones) before
+ * visiting its body, so a method can use a member declared after it.
+ */
+static void _declareMembers(CaptureAnalysis * analysis, const TypeSignature * type) {
+	if (type == NULL) return;
+	for (int k = 0; k < type->memberCount; ++k) {
+		if (_lookup(analysis->scope, type->members[k]) == NULL) {
+			_declare(analysis, type->members[k], FIELD_SYMBOL);
+		}
+	}
+}
+
+/**
+ * Records what the owner expects from one of its children. The expectations
+ * of a node are on top of the stack while its children are visited, and
+ * they're forgotten when the node is left.
+ */
+static Expectation * _expect(CaptureAnalysis * analysis, const void * owner, const void * node, Sink sink, const char * name) {
+	if (analysis->expectationCount == analysis->expectationCapacity) {
+		analysis->expectationCapacity = analysis->expectationCapacity == 0 ? 64 : 2 * analysis->expectationCapacity;
+		analysis->expectations = realloc(analysis->expectations, analysis->expectationCapacity * sizeof(Expectation));
+	}
+	Expectation * expectation = &analysis->expectations[analysis->expectationCount++];
+	expectation->owner = owner;
+	expectation->node = node;
+	expectation->sink = sink;
+	expectation->name = name;
+	expectation->definition = NULL;
+	expectation->function = NULL;
+	return expectation;
+}
+
+/**
+ * What the parent of the node expects from it, or NULL if the node is only
+ * evaluated. Only the expectations of the last owner can belong to the
+ * parent, since the ones of its previous children are already forgotten.
+ */
+static Expectation * _expectation(CaptureAnalysis * analysis, const void * node) {
+	if (analysis->expectationCount == 0) return NULL;
+	const void * owner = analysis->expectations[analysis->expectationCount - 1].owner;
+	for (int k = analysis->expectationCount - 1; 0 <= k && analysis->expectations[k].owner == owner; --k) {
+		if (analysis->expectations[k].node == node) return &analysis->expectations[k];
+	}
+	return NULL;
+}
+
+static void _forget(CaptureAnalysis * analysis, const void * owner) {
+	while (0 < analysis->expectationCount && analysis->expectations[analysis->expectationCount - 1].owner == owner) {
+		--analysis->expectationCount;
+	}
+}
+
+/**
+ * Starts the definition of a symbol by the expression, which the owner
+ * completes when it's left.
+ */
+static void _define(CaptureAnalysis * analysis, const void * owner, Symbol * symbol, Expression * expression) {
+	Sink sink = { SINK_SYMBOL, symbol, NULL, 0 };
+	_expect(analysis, owner, expression, sink, symbol->name)->definition = symbol;
+	symbol->isInitializing = true;
+}
+
+static VisitAction _enterScope(void * state, void * node) {
+	(void) node;
+	_pushScope(state, false);
+	return VISIT_CHILDREN;
+}
+
+static void _leaveScope(void * state, void * node) {
+	(void) node;
+	_popScope(state);
+}
+
+static VisitAction _enterAssignment(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	AssignmentOperation * assignment = ((Instruction *) node)->assignment;
+	Symbol * symbol = _resolve(analysis, assignment->name);
+	if (assignment->assignmentOperator != ASSIGN_TYPE) {
+		if (symbol != NULL) symbol->writes += 1;
+	}
+	else if (symbol == NULL) {
+		_define(analysis, node, _declare(analysis, assignment->name, _newSymbolKind(analysis)), assignment->expression);
+	}
+	else if (analysis->scope->isClass && _lookup(analysis->scope, assignment->name) == symbol) {
+		_define(analysis, node, symbol, assignment->expression);
+	}
+	else {
+		Sink sink = { SINK_SYMBOL, symbol, NULL, 0 };
+		symbol->writes += 1;
+		_expect(analysis, node, assignment->expression, sink, assignment->name);
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _enterDeclaration(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	VariableDeclaration * variableDeclaration = ((Instruction *) node)->variableDeclaration;
+	Symbol * symbol = analysis->scope->isClass ? _lookup(analysis->scope, variableDeclaration->name) : NULL;
+	if (symbol == NULL) {
+		symbol = _declare(analysis, variableDeclaration->name, _newSymbolKind(analysis));
+	}
+	if (variableDeclaration->expression != NULL) {
+		_define(analysis, node, symbol, variableDeclaration->expression);
+	}
+	return VISIT_CHILDREN;
+}
+
+/**
+ * Completes the definition started by an assignment or a declaration, if
+ * any: the symbol is bound to the lambda literal it's initialized with.
+ */
+static void _leaveDefinition(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Expectation * expectation = analysis->expectationCount == 0 ? NULL : &analysis->expectations[analysis->expectationCount - 1];
+	if (expectation != NULL && expectation->owner == node && expectation->definition != NULL) {
+		Symbol * symbol = expectation->definition;
+		symbol->isInitializing = false;
+		if (expectation->function != NULL) {
+			symbol->boundFunction = expectation->function;
+		}
+		symbol->definitions += 1;
+	}
+	_forget(analysis, node);
+}
+
+static VisitAction _enterReturn(void * state, void * node) {
+	Instruction * returned = ((Instruction *) node)->returnInstruction;
+	if (returned != NULL && returned->type == INSTRUCTION_EXPRESSION) {
+		_expect(state, node, returned, _escapeSink, NULL);
+	}
+	return VISIT_CHILDREN;
+}
+
+/**
+ * An expression statement is only expected to flow somewhere when it's the
+ * value of a "return".
+ */
+static VisitAction _enterExpressionStatement(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Expectation * expectation = _expectation(analysis, node);
+	if (expectation != NULL) {
+		_expect(analysis, node, ((Instruction *) node)->expression, expectation->sink, expectation->name);
+	}
+	return VISIT_CHILDREN;
+}
+
+static void _leaveExpectations(void * state, void * node) {
+	_forget(state, node);
+}
+
+static VisitAction _enterLoop(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Loop * loop = ((Instruction *) node)->loop;
+	if (loop->collectionName != NULL) {
+		_resolve(analysis, loop->collectionName);
+	}
+	_pushScope(analysis, false);
+	if (loop->itemName != NULL) {
+		_declare(analysis, loop->itemName, LOCAL_SYMBOL)->definitions = 1;
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _enterClass(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	_pushScope(analysis, true);
+	_declareMembers(analysis, findClassSignature(analysis->signatures, ((Instruction *) node)->class));
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _enterInterface(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	_pushScope(analysis, true);
+	_declareMembers(analysis, findInterfaceSignature(analysis->signatures, ((Instruction *) node)->interface));
+	return VISIT_CHILDREN;
+}
+
+/**
+ * A factor expression and a parenthesis are transparent: their child flows
+ * where they do, and reports its lambda to them.
+ */
+static VisitAction _enterFactorExpression(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Expectation * expectation = _expectation(analysis, node);
+	if (expectation != NULL) {
+		_expect(analysis, node, ((Expression *) node)->factor, expectation->sink, expectation->name);
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _enterParenthesis(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Expectation * expectation = _expectation(analysis, node);
+	if (expectation != NULL) {
+		_expect(analysis, node, ((Factor *) node)->expression, expectation->sink, expectation->name);
+	}
+	return VISIT_CHILDREN;
+}
+
+static void _leaveForwarding(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Expectation * child = analysis->expectationCount == 0 ? NULL : &analysis->expectations[analysis->expectationCount - 1];
+	if (child == NULL || child->owner != node) return;
+	Function * function = child->function;
+	_forget(analysis, node);
+	Expectation * expectation = _expectation(analysis, node);
+	if (expectation != NULL) {
+		expectation->function = function;
+	}
+}
+
+static VisitAction _enterCall(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	FunctionCall * functionCall = ((Expression *) node)->functionCall;
+	Symbol * callee = _resolve(analysis, functionCall->name);
+	if (functionCall->expressionList == NULL) return VISIT_CHILDREN;
+	int index = 0;
+	for (Node * argument = functionCall->expressionList->first; argument != NULL; argument = argument->next) {
+		Sink sink = { SINK_ARGUMENT, callee, NULL, index++ };
+		_expect(analysis, node, argument->data, sink, NULL);
+	}
+	return VISIT_CHILDREN;
+}
+
+static VisitAction _enterVariable(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Symbol * symbol = _resolve(analysis, ((Factor *) node)->variable);
+	if (symbol != NULL) {
+		Expectation * expectation = _expectation(analysis, node);
+		_addEdge(analysis, symbol, NULL, expectation == NULL ? _noSink : expectation->sink);
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+static VisitAction _enterWrite(void * state, void * node) {
+	Symbol * symbol = _resolve(state, ((Factor *) node)->variable);
+	if (symbol != NULL) {
+		symbol->writes += 1;
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+/**
+ * The parameters and the body of a lambda share the same scope. Default
+ * values are evaluated inside the callee, so they can capture too.
+ */
+static VisitAction _enterLambda(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Lambda * lambda = ((Expression *) node)->lambda;
+	Expectation * expectation = _expectation(analysis, node);
+	Function * function = calloc(1, sizeof(Function));
+	function->lambda = lambda;
+	function->name = expectation == NULL ? NULL : expectation->name;
+	function->parent = analysis->function;
+	function->definingScope = analysis->scope;
+	function->allocated = analysis->functions;
+	analysis->functions = function;
+	const int size = lambda->variableDeclarationList == NULL ? 0 : lambda->variableDeclarationList->size;
+	function->parameters = calloc(1 + size, sizeof(Symbol *));
+	analysis->function = function;
+	_pushScope(analysis, false);
+	return VISIT_CHILDREN;
+}
+
+static void _leaveLambda(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Function * function = analysis->function;
+	_popScope(analysis);
+	analysis->function = function->parent;
+	Expectation * expectation = _expectation(analysis, node);
+	_addEdge(analysis, NULL, function, expectation == NULL ? _noSink : expectation->sink);
+	if (expectation != NULL) {
+		expectation->function = function;
+	}
+}
+
+static VisitAction _enterParameter(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	VariableDeclaration * parameter = node;
+	Function * function = analysis->function;
+	Symbol * symbol = _declare(analysis, parameter->name, PARAMETER_SYMBOL);
+	function->parameters[function->parameterCount++] = symbol;
+	if (parameter->expression != NULL) {
+		Sink sink = { SINK_SYMBOL, symbol, NULL, 0 };
+		_expect(analysis, node, parameter->expression, sink, parameter->name);
+	}
+	return VISIT_CHILDREN;
+}
+
+static void _leaveParameter(void * state, void * node) {
+	CaptureAnalysis * analysis = state;
+	Function * function = analysis->function;
+	function->parameters[function->parameterCount - 1]->definitions = 1;
+	_forget(analysis, node);
+}
+
+/**
+ * A callee can only be trusted if it's a local or global bound exactly once
+ * to a lambda literal. Members can be overridden, so they never are.
+ */
+static Function * _boundFunction(Symbol * symbol) {
+	if (symbol == NULL || symbol->kind == FIELD_SYMBOL) return NULL;
+	if (symbol->definitions != 1 || symbol->writes != 0) return NULL;
+	return symbol->boundFunction;
+}
+
+static boolean _sinkEscapes(Sink * sink) {
+	switch (sink->type) {
+		case SINK_ESCAPE:
+			return true;
+		case SINK_SYMBOL:
+			return sink->symbol->escapes;
+		case SINK_FUNCTION:
+			return sink->function->escapes;
+		case SINK_ARGUMENT: {
+			Function * callee = _boundFunction(sink->symbol);
+			if (callee == NULL || callee->parameterCount <= sink->index) return true;
+			return callee->parameters[sink->index]->escapes;
+		}
+		default:
+			return false;
+	}
+}
+
+/**
+ * Marks the sources of every escaping sink until a fixed point is reached.
+ */
+static void _propagateEscapes(CaptureAnalysis * analysis) {
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (int k = 0; k < analysis->edgeCount; ++k) {
+			Edge * edge = &analysis->edges[k];
+			boolean * escapes = edge->symbol != NULL ? &edge->symbol->escapes : &edge->function->escapes;
+			if (!*escapes && _sinkEscapes(&edge->sink)) {
+				*escapes = true;
+				changed = true;
+			}
+		}
+	}
+}
+
+static int _storeResults(CaptureAnalysis * analysis) {
+	int escaping = 0;
+	for (Function * function = analysis->functions; function != NULL; function = function->allocated) {
+		Lambda * lambda = function->lambda;
+		releaseCaptureList(lambda->captureList);
+		lambda->captureList = NULL;
+		int count = 0;
+		for (FreeVariable * freeVariable = function->freeVariables; freeVariable != NULL; freeVariable = freeVariable->next) {
+			Capture * capture = calloc(1, sizeof(Capture));
+			capture->name = strdup(freeVariable->symbol == NULL ? "this" : freeVariable->symbol->name);
+			capture->isMutable = (freeVariable->byReference || (freeVariable->symbol != NULL && 0 < freeVariable->symbol->writes)) ? true : false;
+			lambda->captureList = ListSemanticAction(lambda->captureList, capture);
+			++count;
+		}
+		if (count == 0) {
+			lambda->captureType = CAPTURE_NONE;
+		}
+		else if (function->escapes) {
+			lambda->captureType = CAPTURE_ESCAPING;
+			++escaping;
+		}
+		else {
+			lambda->captureType = CAPTURE_BY_VALUE;
+		}
+		logDebugging(_logger, "Lambda '%s' captures %d variable(s) (%s).",
+			function->name == NULL ? "<anonymous>" : function->name,
+			count,
+			lambda->captureType == CAPTURE_NONE ? "plain function"
+				: lambda->captureType == CAPTURE_BY_VALUE ? "by value" : "escaping");
+	}
+	return escaping;
+}
+
+static void _releaseAnalysis(CaptureAnalysis * analysis) {
+	Symbol * symbol = analysis->symbols;
+	while (symbol != NULL) {
+		Symbol * next = symbol->allocated;
+		free(symbol);
+		symbol = next;
+	}
+	Function * function = analysis->functions;
+	while (function != NULL) {
+		Function * next = function->allocated;
+		FreeVariable * freeVariable = function->freeVariables;
+		while (freeVariable != NULL) {
+			FreeVariable * nextFreeVariable = freeVariable->next;
+			free(freeVariable);
+			freeVariable = nextFreeVariable;
+		}
+		free(function->parameters);
+		free(function);
+		function = next;
+	}
+	free(analysis->edges);
+	free(analysis->expectations);
+	analysis->symbols = NULL;
+	analysis->functions = NULL;
+	analysis->edges = NULL;
+	analysis->expectations = NULL;
+	analysis->edgeCount = analysis->edgeCapacity = 0;
+	analysis->expectationCount = analysis->expectationCapacity = 0;
+}
+
+/**
+ * Every flow is known once the whole program is visited, so the escapes are
+ * propagated and the results stored at the end.
+ */
+static void _finishAnalysis(void * state) {
+	CaptureAnalysis * analysis = state;
+	_propagateEscapes(analysis);
+	analysis->escaping = _storeResults(analysis);
+	logDebugging(_logger, "Found %d lambda(s) with escaping closures.", analysis->escaping);
+	_releaseAnalysis(analysis);
+}
+
+
+/* PUBLIC FUNCTIONS */
+
+CaptureAnalysis * createCaptureAnalysis(const SignatureTable * signatures) {
+	CaptureAnalysis * analysis = calloc(1, sizeof(CaptureAnalysis));
+	analysis->signatures = signatures;
+	return analysis;
+}
+
+void initializeCapturesVisitor(Visitor * visitor, CaptureAnalysis * analysis) {
+	memset(visitor, 0, sizeof(Visitor));
+	visitor->name = "captures";
+	visitor->pre[PROGRAM_NODE] = _enterScope;
+	visitor->post[PROGRAM_NODE] = _leaveScope;
+	visitor->pre[BLOCK_NODE] = _enterScope;
+	visitor->post[BLOCK_NODE] = _leaveScope;
+	visitor->pre[BRANCH_NODE] = _enterScope;
+	visitor->post[BRANCH_NODE] = _leaveScope;
+	visitor->pre[LOOP_NODE] = _enterLoop;
+	visitor->post[LOOP_NODE] = _leaveScope;
+	visitor->pre[CLASS_NODE] = _enterClass;
+	visitor->post[CLASS_NODE] = _leaveScope;
+	visitor->pre[INTERFACE_NODE] = _enterInterface;
+	visitor->post[INTERFACE_NODE] = _leaveScope;
+	visitor->pre[ASSIGNMENT_NODE] = _enterAssignment;
+	visitor->post[ASSIGNMENT_NODE] = _leaveDefinition;
+	visitor->pre[DECLARATION_NODE] = _enterDeclaration;
+	visitor->post[DECLARATION_NODE] = _leaveDefinition;
+	visitor->pre[RETURN_NODE] = _enterReturn;
+	visitor->post[RETURN_NODE] = _leaveExpectations;
+	visitor->pre[EXPRESSION_STATEMENT_NODE] = _enterExpressionStatement;
+	visitor->post[EXPRESSION_STATEMENT_NODE] = _leaveExpectations;
+	visitor->pre[FACTOR_EXPRESSION_NODE] = _enterFactorExpression;
+	visitor->post[FACTOR_EXPRESSION_NODE] = _leaveForwarding;
+	visitor->pre[PARENTHESIS_NODE] = _enterParenthesis;
+	visitor->post[PARENTHESIS_NODE] = _leaveForwarding;
+	visitor->pre[LAMBDA_NODE] = _enterLambda;
+	visitor->post[LAMBDA_NODE] = _leaveLambda;
+	visitor->pre[PARAMETER_NODE] = _enterParameter;
+	visitor->post[PARAMETER_NODE] = _leaveParameter;
+	visitor->pre[CALL_NODE] = _enterCall;
+	visitor->post[CALL_NODE] = _leaveExpectations;
+	visitor->pre[VARIABLE_NODE] = _enterVariable;
+	visitor->pre[INCREMENT_NODE] = _enterWrite;
+	visitor->pre[DECREMENT_NODE] = _enterWrite;
+	visitor->finish = _finishAnalysis;
+	visitor->state = analysis;
+}
+
+int analyzeCaptures(Program * program, const SignatureTable * signatures) {
+	if (program == NULL) return 0;
+	CaptureAnalysis * analysis = createCaptureAnalysis(signatures);
+	Visitor capturesVisitor;
+	initializeCapturesVisitor(&capturesVisitor, analysis);
+	Visitor * visitors[] = { &capturesVisitor };
+	walkProgram(program, visitors, 1);
+	capturesVisitor.finish(capturesVisitor.state);
+	const int escaping = analysis->escaping;
+	releaseCaptureAnalysis(analysis);
+	return escaping;
+}
+
+void releaseCaptureAnalysis(CaptureAnalysis * analysis) {
+	if (analysis != NULL) {
+		_releaseAnalysis(analysis);
+		free(analysis);
+	}
+}
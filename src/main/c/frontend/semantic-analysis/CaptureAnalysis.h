@@ -0,0 +1,52 @@
+#ifndef CAPTURE_ANALYSIS_HEADER
+#define CAPTURE_ANALYSIS_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/BisonActions.h"
+#include "../syntactic-analysis/Visitor.h"
+#include "Signatures.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeCaptureAnalysisModule();
+
+/** Shutdown module's internal state. */
+void shutdownCaptureAnalysisModule();
+
+/**
+ * The state of the analysis, while the program is visited.
+ */
+typedef struct CaptureAnalysis CaptureAnalysis;
+
+CaptureAnalysis * createCaptureAnalysis(const SignatureTable * signatures);
+
+/**
+ * Prepares a visitor that computes the free variables of every lambda of the
+ * program, and classifies each one as non-capturing, capturing by value or
+ * escaping (see "CaptureType"). The results are stored in the "captureType"
+ * and "captureList" fields of each lambda when it finishes.
+ *
+ * Names are resolved lexically: a name belongs to the innermost block,
+ * lambda, loop or class that declares it (or that assigns it for the first
+ * time), and unresolved names are considered globals. A lambda escapes if its
+ * value can reach a global, a class member, a "return", or an argument of a
+ * call whose callee cannot be resolved to a lambda that keeps it local. The
+ * members of each class (and inherited ones) come from the signatures, which
+ * must be complete before the walk enters the first class.
+ */
+void initializeCapturesVisitor(Visitor * visitor, CaptureAnalysis * analysis);
+
+/**
+ * Runs the analysis on its own.
+ *
+ * @return The amount of lambdas that need a heap-allocated closure.
+ */
+int analyzeCaptures(Program * program, const SignatureTable * signatures);
+
+void releaseCaptureAnalysis(CaptureAnalysis * analysis);
+
+#endif
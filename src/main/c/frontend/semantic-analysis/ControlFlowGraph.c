@@ -0,0 +1,599 @@
+#include "ControlFlowGraph.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeControlFlowGraphModule() {
+	_logger = createLogger("ControlFlowGraph");
+}
+
+void shutdownControlFlowGraphModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+typedef struct Builder Builder;
+typedef struct Scope Scope;
+typedef struct Symbol Symbol;
+
+/**
+ * The state of the graph under construction. While a lambda is visited, the
+ * builders of the enclosing functions are suspended at the point where the
+ * lambda is created. Class bodies get a builder without graph, because their
+ * members aren't executed in place.
+ */
+struct Builder {
+	ControlFlowGraph * graph;
+	Builder * parent;
+	Instruction * instruction;
+	int current;
+	int * loops;
+	int loopCount;
+	int loopCapacity;
+};
+
+/**
+ * A declared name. Members have no owner, and aren't variables of any graph.
+ */
+struct Symbol {
+	const char * name;
+	Builder * owner;
+	int variable;
+	boolean isInitializing;
+	Symbol * next;
+	Symbol * allocated;
+};
+
+struct Scope {
+	Scope * parent;
+	boolean isClass;
+	Symbol * symbols;
+};
+
+typedef struct {
+	Builder * builder;
+	Scope * scope;
+	Symbol * symbols;
+	ControlFlowGraph * first;
+	ControlFlowGraph ** last;
+	const SignatureTable * signatures;
+	Block * skippedUnits;
+} Construction;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addEffect(Builder * builder, EffectType type, int variable);
+static void _access(Construction * construction, Symbol * symbol, EffectType type);
+static void _buildBlock(Construction * construction, Block * block);
+static void _buildClass(Construction * construction, Class * class);
+static void _buildConditional(Construction * construction, Conditional * conditional);
+static void _buildDefinition(Construction * construction, Symbol * symbol, Expression * expression);
+static void _buildExpression(Construction * construction, Expression * expression);
+static void _buildFactor(Construction * construction, Factor * factor);
+static void _buildFunction(Construction * construction, const char * name, Lambda * lambda, Block * block);
+static void _buildInstruction(Construction * construction, Instruction * instruction);
+static void _buildLoop(Construction * construction, Loop * loop);
+static void _buildScopedBlock(Construction * construction, Block * block);
+static Symbol * _declare(Construction * construction, const char * name, boolean isParameter);
+static void _declareExternals(Construction * construction, const int position);
+static void _declareMembers(Construction * construction, const TypeSignature * type);
+static void * _grow(void * array, int * capacity, const int count, const size_t size);
+static boolean _isConstantlyTrue(Expression * expression);
+static void _link(ControlFlowGraph * graph, const int source, const int target);
+static Symbol * _lookup(Scope * scope, const char * name);
+static int _newBlock(ControlFlowGraph * graph);
+static void _popScope(Construction * construction);
+static void _pushScope(Construction * construction, boolean isClass);
+static Symbol * _resolve(Construction * construction, const char * name);
+static void _terminate(Construction * construction, const int target);
+
+/**
+ * Doubles the capacity of a dynamic array if it's full.
+ */
+static void * _grow(void * array, int * capacity, const int count, const size_t size) {
+	if (count < *capacity) return array;
+	*capacity = *capacity == 0 ? 8 : 2 * *capacity;
+	return realloc(array, *capacity * size);
+}
+
+static int _newBlock(ControlFlowGraph * graph) {
+	graph->blocks = _grow(graph->blocks, &graph->blockCapacity, graph->blockCount, sizeof(BasicBlock *));
+	BasicBlock * block = calloc(1, sizeof(BasicBlock));
+	block->index = graph->blockCount;
+	graph->blocks[graph->blockCount++] = block;
+	return block->index;
+}
+
+static void _link(ControlFlowGraph * graph, const int source, const int target) {
+	BasicBlock * from = graph->blocks[source];
+	BasicBlock * to = graph->blocks[target];
+	for (int k = 0; k < from->successorCount; ++k) {
+		if (from->successors[k] == target) return;
+	}
+	from->successors = _grow(from->successors, &from->successorCapacity, from->successorCount, sizeof(int));
+	from->successors[from->successorCount++] = target;
+	to->predecessors = _grow(to->predecessors, &to->predecessorCapacity, to->predecessorCount, sizeof(int));
+	to->predecessors[to->predecessorCount++] = source;
+}
+
+/**
+ * Jumps to the target, and continues in a new block without predecessors,
+ * because the code after a "return" or a "pass" is unreachable.
+ */
+static void _terminate(Construction * construction, const int target) {
+	Builder * builder = construction->builder;
+	_link(builder->graph, builder->current, target);
+	builder->current = _newBlock(builder->graph);
+}
+
+static void _addEffect(Builder * builder, EffectType type, int variable) {
+	BasicBlock * block = builder->graph->blocks[builder->current];
+	block->effects = _grow(block->effects, &block->effectCapacity, block->effectCount, sizeof(Effect));
+	Effect * effect = &block->effects[block->effectCount++];
+	effect->type = type;
+	effect->variable = variable;
+	effect->instruction = builder->instruction;
+	if (type == EFFECT_USE) {
+		builder->graph->variables[variable].uses += 1;
+	}
+	else {
+		builder->graph->variables[variable].definitions += 1;
+	}
+}
+
+/**
+ * Records the access in the graph that owns the variable. An access from an
+ * inner lambda is a capture: the variable is read when the lambda is created
+ * (unless it's the one being initialized with it), and later by the lambda.
+ */
+static void _access(Construction * construction, Symbol * symbol, EffectType type) {
+	if (symbol == NULL || symbol->owner == NULL) return;
+	if (symbol->owner == construction->builder) {
+		_addEffect(symbol->owner, type, symbol->variable);
+		return;
+	}
+	Variable * variable = &symbol->owner->graph->variables[symbol->variable];
+	variable->isCaptured = true;
+	if (!variable->isGlobal && !symbol->isInitializing) {
+		_addEffect(symbol->owner, EFFECT_USE, symbol->variable);
+	}
+}
+
+static void _pushScope(Construction * construction, boolean isClass) {
+	Scope * scope = calloc(1, sizeof(Scope));
+	scope->parent = construction->scope;
+	scope->isClass = isClass;
+	construction->scope = scope;
+}
+
+static void _popScope(Construction * construction) {
+	Scope * scope = construction->scope;
+	construction->scope = scope->parent;
+	free(scope);
+}
+
+static Symbol * _lookup(Scope * scope, const char * name) {
+	for (Symbol * symbol = scope->symbols; symbol != NULL; symbol = symbol->next) {
+		if (strcmp(symbol->name, name) == 0) return symbol;
+	}
+	return NULL;
+}
+
+static Symbol * _resolve(Construction * construction, const char * name) {
+	for (Scope * scope = construction->scope; scope != NULL; scope = scope->parent) {
+		Symbol * symbol = _lookup(scope, name);
+		if (symbol != NULL) return symbol;
+	}
+	return NULL;
+}
+
+static Symbol * _declare(Construction * construction, const char * name, boolean isParameter) {
+	Symbol * symbol = calloc(1, sizeof(Symbol));
+	symbol->name = name;
+	symbol->next = construction->scope->symbols;
+	construction->scope->symbols = symbol;
+	symbol->allocated = construction->symbols;
+	construction->symbols = symbol;
+	if (construction->scope->isClass) return symbol;
+
+	ControlFlowGraph * graph = construction->builder->graph;
+	graph->variables = _grow(graph->variables, &graph->variableCapacity, graph->variableCount, sizeof(Variable));
+	Variable * variable = &graph->variables[graph->variableCount];
+	memset(variable, 0, sizeof(Variable));
+	variable->name = name;
+	variable->isParameter = isParameter;
+	variable->isGlobal = (construction->scope->parent == NULL) ? true : false;
+	symbol->owner = construction->builder;
+	symbol->variable = graph->variableCount++;
+	return symbol;
+}
+
+/**
+ * Declares the members of a class (including the inherited ones), as the
+ * capture analysis does, so assigning a member never declares a local.
+ */
+static void _declareMembers(Construction * construction, const TypeSignature * type) {
+	if (type == NULL) return;
+	for (int k = 0; k < type->memberCount; ++k) {
+		if (_lookup(construction->scope, type->members[k]) == NULL) {
+			_declare(construction, type->members[k], false);
+		}
+	}
+}
+
+/**
+ * Declares the globals visible from the top-level instruction at the given
+ * position. They belong to the graph of the program, so they aren't
+ * variables of the unit.
+ */
+static void _declareExternals(Construction * construction, const int position) {
+	const SignatureTable * signatures = construction->signatures;
+	for (int k = 0; k < signatures->globalCount && signatures->globals[k].position <= position; ++k) {
+		Symbol * symbol = calloc(1, sizeof(Symbol));
+		symbol->name = signatures->globals[k].name;
+		symbol->next = construction->scope->symbols;
+		construction->scope->symbols = symbol;
+		symbol->allocated = construction->symbols;
+		construction->symbols = symbol;
+	}
+}
+
+static boolean _isConstantlyTrue(Expression * expression) {
+	if (expression == NULL || expression->type != FACTOR || expression->factor->type != CONSTANT) return false;
+	Constant * constant = expression->factor->constant;
+	switch (constant->type) {
+		case C_BOOLEAN_TYPE: return constant->booleanValue;
+		case C_INT_TYPE: return constant->intValue != 0 ? true : false;
+		default: return false;
+	}
+}
+
+static void _buildFunction(Construction * construction, const char * name, Lambda * lambda, Block * block) {
+	ControlFlowGraph * graph = calloc(1, sizeof(ControlFlowGraph));
+	graph->name = name;
+	graph->lambda = lambda;
+	*construction->last = graph;
+	construction->last = &graph->next;
+	_newBlock(graph);
+	_newBlock(graph);
+
+	Builder builder = { 0 };
+	builder.graph = graph;
+	builder.parent = construction->builder;
+	builder.current = _newBlock(graph);
+	_link(graph, ENTRY_BLOCK, builder.current);
+	construction->builder = &builder;
+
+	_pushScope(construction, false);
+	if (lambda != NULL && lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			Symbol * symbol = _declare(construction, parameter->name, true);
+			graph->variables[symbol->variable].definitions = 1;
+			_buildExpression(construction, parameter->expression);
+		}
+	}
+	_buildBlock(construction, block);
+	_popScope(construction);
+
+	_link(graph, builder.current, EXIT_BLOCK);
+	construction->builder = builder.parent;
+	free(builder.loops);
+	logDebugging(_logger, "Graph of '%s': %d block(s), %d variable(s).", name, graph->blockCount, graph->variableCount);
+}
+
+/**
+ * Class bodies are walked with a builder without graph, so only their lambdas
+ * (and what those capture) produce effects.
+ */
+static void _buildClass(Construction * construction, Class * class) {
+	Block * block = class->block;
+	Builder builder = { 0 };
+	builder.parent = construction->builder;
+	construction->builder = &builder;
+	_pushScope(construction, true);
+	_declareMembers(construction, findClassSignature(construction->signatures, class));
+	if (block != NULL) {
+		for (Node * node = block->first; node != NULL; node = node->next) {
+			Instruction * instruction = node->data;
+			if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+				_buildExpression(construction, instruction->variableDeclaration->expression);
+			}
+			else if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+				Expression * expression = instruction->assignment->expression;
+				if (expression != NULL && expression->type == LAMBDA) {
+					_buildFunction(construction, instruction->assignment->name, expression->lambda, expression->lambda->block);
+				}
+				else {
+					_buildExpression(construction, expression);
+				}
+			}
+			else if (instruction->type == INSTRUCTION_CLASS) {
+				_buildClass(construction, instruction->class);
+			}
+		}
+	}
+	_popScope(construction);
+	construction->builder = builder.parent;
+}
+
+/**
+ * The roots of the other units are skipped in the top-level code, except
+ * that a lambda definition still defines its name.
+ */
+static void _buildBlock(Construction * construction, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		Instruction * instruction = node->data;
+		construction->builder->instruction = instruction;
+		if (block != construction->skippedUnits || !isUnitRoot(instruction)) {
+			_buildInstruction(construction, instruction);
+		}
+		else if (instruction->type != INSTRUCTION_CLASS) {
+			const char * name = instruction->type == INSTRUCTION_ASSIGNMENT
+				? instruction->assignment->name
+				: instruction->variableDeclaration->name;
+			Symbol * symbol = instruction->type == INSTRUCTION_ASSIGNMENT ? _resolve(construction, name) : NULL;
+			if (symbol == NULL) {
+				symbol = _declare(construction, name, false);
+			}
+			_access(construction, symbol, EFFECT_DEFINITION);
+		}
+	}
+}
+
+static void _buildScopedBlock(Construction * construction, Block * block) {
+	Instruction * instruction = construction->builder->instruction;
+	_pushScope(construction, false);
+	_buildBlock(construction, block);
+	_popScope(construction);
+	construction->builder->instruction = instruction;
+}
+
+static void _buildDefinition(Construction * construction, Symbol * symbol, Expression * expression) {
+	symbol->isInitializing = true;
+	if (expression != NULL && expression->type == LAMBDA) {
+		_buildFunction(construction, symbol->name, expression->lambda, expression->lambda->block);
+	}
+	else {
+		_buildExpression(construction, expression);
+	}
+	symbol->isInitializing = false;
+	_access(construction, symbol, EFFECT_DEFINITION);
+}
+
+static void _buildInstruction(Construction * construction, Instruction * instruction) {
+	Builder * builder = construction->builder;
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT: {
+			AssignmentOperation * assignment = instruction->assignment;
+			Symbol * symbol = _resolve(construction, assignment->name);
+			if (assignment->assignmentOperator == ASSIGN_TYPE) {
+				if (symbol == NULL) {
+					symbol = _declare(construction, assignment->name, false);
+				}
+				_buildDefinition(construction, symbol, assignment->expression);
+			}
+			else {
+				_access(construction, symbol, EFFECT_USE);
+				_buildExpression(construction, assignment->expression);
+				_access(construction, symbol, EFFECT_DEFINITION);
+			}
+			break;
+		}
+		case INSTRUCTION_VARIABLE_DECLARATION: {
+			VariableDeclaration * variableDeclaration = instruction->variableDeclaration;
+			Symbol * symbol = _declare(construction, variableDeclaration->name, false);
+			if (variableDeclaration->expression != NULL) {
+				_buildDefinition(construction, symbol, variableDeclaration->expression);
+			}
+			break;
+		}
+		case INSTRUCTION_EXPRESSION:
+			_buildExpression(construction, instruction->expression);
+			break;
+		case INSTRUCTION_BLOCK:
+			_buildScopedBlock(construction, instruction->block);
+			break;
+		case INSTRUCTION_CONDITIONAL:
+			_buildConditional(construction, instruction->conditional);
+			break;
+		case INSTRUCTION_LOOP:
+			_buildLoop(construction, instruction->loop);
+			break;
+		case INSTRUCTION_CLASS:
+			_buildClass(construction, instruction->class);
+			break;
+		case INSTRUCTION_INTERFACE:
+			break;
+		case INSTRUCTION_RETURN:
+			if (instruction->returnInstruction != NULL) {
+				_buildInstruction(construction, instruction->returnInstruction);
+			}
+			_terminate(construction, EXIT_BLOCK);
+			break;
+		case INSTRUCTION_PASS:
+			if (0 < builder->loopCount) {
+				_terminate(construction, builder->loops[builder->loopCount - 1]);
+			}
+			break;
+	}
+}
+
+/**
+ * Every condition of an if/else-if chain is evaluated in its own block, and
+ * falls through to the next condition (or to the join) when it's false.
+ */
+static void _buildConditional(Construction * construction, Conditional * conditional) {
+	Builder * builder = construction->builder;
+	ControlFlowGraph * graph = builder->graph;
+	const int join = _newBlock(graph);
+	boolean hasElse = false;
+	for (; conditional != NULL; conditional = conditional->nextConditional) {
+		if (conditional->ConditionalType == ELSE_TYPE) {
+			_buildScopedBlock(construction, conditional->block);
+			_link(graph, builder->current, join);
+			hasElse = true;
+			break;
+		}
+		_buildExpression(construction, conditional->expression);
+		const int branch = _newBlock(graph);
+		const int otherwise = _newBlock(graph);
+		_link(graph, builder->current, branch);
+		_link(graph, builder->current, otherwise);
+		builder->current = branch;
+		_buildScopedBlock(construction, conditional->block);
+		_link(graph, builder->current, join);
+		builder->current = otherwise;
+	}
+	if (!hasElse) {
+		_link(graph, builder->current, join);
+	}
+	builder->current = join;
+}
+
+/**
+ * Loops evaluate their condition in a header block, which is also the target
+ * of every "pass" of the body.
+ */
+static void _buildLoop(Construction * construction, Loop * loop) {
+	Builder * builder = construction->builder;
+	ControlFlowGraph * graph = builder->graph;
+	const int header = _newBlock(graph);
+	const int body = _newBlock(graph);
+	const int exit = _newBlock(graph);
+	_link(graph, builder->current, header);
+	builder->current = header;
+	_buildExpression(construction, loop->expression);
+	if (loop->collectionName != NULL) {
+		_access(construction, _resolve(construction, loop->collectionName), EFFECT_USE);
+	}
+	_link(graph, header, body);
+	if (loop->type == FOR_LOOP || !_isConstantlyTrue(loop->expression)) {
+		_link(graph, header, exit);
+	}
+
+	builder->loops = _grow(builder->loops, &builder->loopCapacity, builder->loopCount, sizeof(int));
+	builder->loops[builder->loopCount++] = header;
+	builder->current = body;
+	Instruction * instruction = builder->instruction;
+	_pushScope(construction, false);
+	if (loop->itemName != NULL) {
+		_access(construction, _declare(construction, loop->itemName, false), EFFECT_DEFINITION);
+	}
+	_buildBlock(construction, loop->block);
+	_popScope(construction);
+	builder->instruction = instruction;
+	builder->loopCount -= 1;
+	_link(graph, builder->current, header);
+	builder->current = exit;
+}
+
+static void _buildExpression(Construction * construction, Expression * expression) {
+	if (expression == NULL) return;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			_buildExpression(construction, expression->leftExpression);
+			_buildExpression(construction, expression->rightExpression);
+			break;
+		case FACTOR:
+			_buildFactor(construction, expression->factor);
+			break;
+		case FUNCTION_CALL: {
+			FunctionCall * functionCall = expression->functionCall;
+			_access(construction, _resolve(construction, functionCall->name), EFFECT_USE);
+			if (functionCall->expressionList != NULL) {
+				for (Node * node = functionCall->expressionList->first; node != NULL; node = node->next) {
+					_buildExpression(construction, node->data);
+				}
+			}
+			break;
+		}
+		case LAMBDA:
+			_buildFunction(construction, NULL, expression->lambda, expression->lambda->block);
+			break;
+		default:
+			_buildFactor(construction, expression->leftFactor);
+			_buildFactor(construction, expression->rightFactor);
+			break;
+	}
+}
+
+static void _buildFactor(Construction * construction, Factor * factor) {
+	if (factor == NULL) return;
+	switch (factor->type) {
+		case VARIABLE_TYPE:
+			_access(construction, _resolve(construction, factor->variable), EFFECT_USE);
+			break;
+		case INCREMENT_TYPE:
+		case DECREMENT_TYPE: {
+			Symbol * symbol = _resolve(construction, factor->variable);
+			_access(construction, symbol, EFFECT_USE);
+			_access(construction, symbol, EFFECT_DEFINITION);
+			break;
+		}
+		case EXPRESSION:
+			_buildExpression(construction, factor->expression);
+			break;
+		default:
+			break;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+ControlFlowGraph * buildControlFlowGraphs(const SemanticUnit * unit) {
+	Construction construction = { 0 };
+	construction.last = &construction.first;
+	construction.signatures = unit->signatures;
+	if (unit->type == PROGRAM_UNIT) {
+		construction.skippedUnits = unit->program->block;
+		_buildFunction(&construction, "<program>", NULL, unit->program->block);
+	}
+	else {
+		_pushScope(&construction, false);
+		_declareExternals(&construction, unit->position);
+		Instruction * instruction = unit->instruction;
+		if (unit->type == CLASS_UNIT) {
+			_buildClass(&construction, instruction->class);
+		}
+		else if (instruction->type == INSTRUCTION_ASSIGNMENT) {
+			Lambda * lambda = instruction->assignment->expression->lambda;
+			_buildFunction(&construction, instruction->assignment->name, lambda, lambda->block);
+		}
+		else {
+			Lambda * lambda = instruction->variableDeclaration->expression->lambda;
+			_buildFunction(&construction, instruction->variableDeclaration->name, lambda, lambda->block);
+		}
+		_popScope(&construction);
+	}
+	Symbol * symbol = construction.symbols;
+	while (symbol != NULL) {
+		Symbol * next = symbol->allocated;
+		free(symbol);
+		symbol = next;
+	}
+	return construction.first;
+}
+
+void releaseControlFlowGraphs(ControlFlowGraph * graph) {
+	while (graph != NULL) {
+		ControlFlowGraph * next = graph->next;
+		for (int k = 0; k < graph->blockCount; ++k) {
+			BasicBlock * block = graph->blocks[k];
+			free(block->effects);
+			free(block->successors);
+			free(block->predecessors);
+			free(block);
+		}
+		free(graph->blocks);
+		free(graph->variables);
+		free(graph);
+		graph = next;
+	}
+}
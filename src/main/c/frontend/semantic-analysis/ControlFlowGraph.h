@@ -0,0 +1,95 @@
+#ifndef CONTROL_FLOW_GRAPH_HEADER
+#define CONTROL_FLOW_GRAPH_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "Signatures.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeControlFlowGraphModule();
+
+/** Shutdown module's internal state. */
+void shutdownControlFlowGraphModule();
+
+/** The entry and the exit of every graph are always the first two blocks. */
+#define ENTRY_BLOCK 0
+#define EXIT_BLOCK 1
+
+typedef enum {
+	EFFECT_USE,
+	EFFECT_DEFINITION
+} EffectType;
+
+/**
+ * A read or a write of a local variable, in evaluation order. The instruction
+ * is the one of the enclosing block that produced it.
+ */
+typedef struct {
+	EffectType type;
+	int variable;
+	Instruction * instruction;
+} Effect;
+
+typedef struct {
+	int index;
+	Effect * effects;
+	int effectCount;
+	int effectCapacity;
+	int * successors;
+	int successorCount;
+	int successorCapacity;
+	int * predecessors;
+	int predecessorCount;
+	int predecessorCapacity;
+} BasicBlock;
+
+/**
+ * A local variable of a graph. Every declaration introduces a new variable,
+ * even if it shadows another one with the same name. Captured variables are
+ * read by an inner lambda, and globals are visible to every function, so
+ * neither of them can be considered dead.
+ */
+typedef struct {
+	const char * name;
+	boolean isParameter;
+	boolean isCaptured;
+	boolean isGlobal;
+	int definitions;
+	int uses;
+} Variable;
+
+typedef struct ControlFlowGraph ControlFlowGraph;
+
+/**
+ * The graph of a single function: the top-level of the program, or the body
+ * of a lambda. Graphs of the same program are chained in source order.
+ */
+struct ControlFlowGraph {
+	const char * name;
+	Lambda * lambda;
+	BasicBlock ** blocks;
+	int blockCount;
+	int blockCapacity;
+	Variable * variables;
+	int variableCount;
+	int variableCapacity;
+	ControlFlowGraph * next;
+};
+
+/**
+ * Builds the graph of every function of a unit: the top-level code, or the
+ * lambdas of a top-level class or lambda definition. Names resolve as in the
+ * capture analysis; names that belong to another graph (globals used from a
+ * lambda, captures, members) aren't variables of the graph that reads them.
+ * Creating a lambda reads the local variables it captures, except the one
+ * it's being assigned to.
+ */
+ControlFlowGraph * buildControlFlowGraphs(const SemanticUnit * unit);
+
+/** Releases a chain of graphs. */
+void releaseControlFlowGraphs(ControlFlowGraph * graph);
+
+#endif
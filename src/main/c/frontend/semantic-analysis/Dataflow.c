@@ -0,0 +1,184 @@
+#include "Dataflow.h"
+
+/* PRIVATE FUNCTIONS */
+
+static DataflowProblem * _createProblem(ControlFlowGraph * graph, DataflowDirection direction, DataflowMeet meet);
+static void _meet(BitVector * target, const BitVector * source, DataflowMeet meet);
+static int _postOrder(ControlFlowGraph * graph, int * order);
+
+static DataflowProblem * _createProblem(ControlFlowGraph * graph, DataflowDirection direction, DataflowMeet meet) {
+	DataflowProblem * problem = calloc(1, sizeof(DataflowProblem));
+	problem->direction = direction;
+	problem->meet = meet;
+	problem->blockCount = graph->blockCount;
+	problem->gen = calloc(graph->blockCount, sizeof(BitVector *));
+	problem->kill = calloc(graph->blockCount, sizeof(BitVector *));
+	for (int k = 0; k < graph->blockCount; ++k) {
+		problem->gen[k] = createBitVector(graph->variableCount);
+		problem->kill[k] = createBitVector(graph->variableCount);
+	}
+	problem->boundary = createBitVector(graph->variableCount);
+	return problem;
+}
+
+static void _meet(BitVector * target, const BitVector * source, DataflowMeet meet) {
+	if (meet == DATAFLOW_UNION) {
+		unionBitVector(target, source);
+	}
+	else {
+		intersectBitVector(target, source);
+	}
+}
+
+/**
+ * Computes the post-order of the blocks reachable from the entry, with an
+ * explicit stack (graphs of long functions can be deep). Returns the amount
+ * of reachable blocks.
+ */
+static int _postOrder(ControlFlowGraph * graph, int * order) {
+	int * stack = calloc(graph->blockCount, sizeof(int));
+	int * nextSuccessor = calloc(graph->blockCount, sizeof(int));
+	boolean * visited = calloc(graph->blockCount, sizeof(boolean));
+	int count = 0;
+	int depth = 0;
+	stack[depth++] = ENTRY_BLOCK;
+	visited[ENTRY_BLOCK] = true;
+	while (0 < depth) {
+		BasicBlock * block = graph->blocks[stack[depth - 1]];
+		if (nextSuccessor[block->index] < block->successorCount) {
+			const int successor = block->successors[nextSuccessor[block->index]++];
+			if (!visited[successor]) {
+				visited[successor] = true;
+				stack[depth++] = successor;
+			}
+		}
+		else {
+			order[count++] = block->index;
+			--depth;
+		}
+	}
+	free(visited);
+	free(nextSuccessor);
+	free(stack);
+	return count;
+}
+
+/* PUBLIC FUNCTIONS */
+
+DataflowSolution * solveDataflow(ControlFlowGraph * graph, DataflowProblem * problem) {
+	const int size = graph->variableCount;
+	DataflowSolution * solution = calloc(1, sizeof(DataflowSolution));
+	solution->blockCount = graph->blockCount;
+	solution->in = calloc(graph->blockCount, sizeof(BitVector *));
+	solution->out = calloc(graph->blockCount, sizeof(BitVector *));
+	for (int k = 0; k < graph->blockCount; ++k) {
+		solution->in[k] = createBitVector(size);
+		solution->out[k] = createBitVector(size);
+		if (problem->meet == DATAFLOW_INTERSECTION) {
+			fillBitVector(solution->in[k]);
+			fillBitVector(solution->out[k]);
+		}
+	}
+
+	int * order = calloc(graph->blockCount, sizeof(int));
+	const int count = _postOrder(graph, order);
+	const boolean isForward = problem->direction == DATAFLOW_FORWARD ? true : false;
+	BitVector * scratch = createBitVector(size);
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		solution->iterations += 1;
+		for (int k = 0; k < count; ++k) {
+			// Reverse post-order for forward problems, post-order otherwise.
+			BasicBlock * block = graph->blocks[order[isForward ? count - 1 - k : k]];
+			BitVector * before = isForward ? solution->in[block->index] : solution->out[block->index];
+			BitVector * after = isForward ? solution->out[block->index] : solution->in[block->index];
+			const int * neighbours = isForward ? block->predecessors : block->successors;
+			const int neighbourCount = isForward ? block->predecessorCount : block->successorCount;
+			if (block->index == (isForward ? ENTRY_BLOCK : EXIT_BLOCK)) {
+				copyBitVector(before, problem->boundary);
+			}
+			else if (0 < neighbourCount) {
+				BitVector ** values = isForward ? solution->out : solution->in;
+				copyBitVector(before, values[neighbours[0]]);
+				for (int n = 1; n < neighbourCount; ++n) {
+					_meet(before, values[neighbours[n]], problem->meet);
+				}
+			}
+			copyBitVector(scratch, before);
+			subtractBitVector(scratch, problem->kill[block->index]);
+			unionBitVector(scratch, problem->gen[block->index]);
+			changed |= copyBitVector(after, scratch);
+		}
+	}
+	destroyBitVector(scratch);
+	free(order);
+	return solution;
+}
+
+DataflowSolution * computeDefiniteAssignment(ControlFlowGraph * graph) {
+	DataflowProblem * problem = _createProblem(graph, DATAFLOW_FORWARD, DATAFLOW_INTERSECTION);
+	for (int k = 0; k < graph->blockCount; ++k) {
+		BasicBlock * block = graph->blocks[k];
+		for (int e = 0; e < block->effectCount; ++e) {
+			if (block->effects[e].type == EFFECT_DEFINITION) {
+				setBit(problem->gen[k], block->effects[e].variable);
+			}
+		}
+	}
+	for (int v = 0; v < graph->variableCount; ++v) {
+		if (graph->variables[v].isParameter) {
+			setBit(problem->boundary, v);
+		}
+	}
+	DataflowSolution * solution = solveDataflow(graph, problem);
+	releaseDataflowProblem(problem);
+	return solution;
+}
+
+DataflowSolution * computeLiveness(ControlFlowGraph * graph) {
+	DataflowProblem * problem = _createProblem(graph, DATAFLOW_BACKWARD, DATAFLOW_UNION);
+	for (int k = 0; k < graph->blockCount; ++k) {
+		BasicBlock * block = graph->blocks[k];
+		for (int e = 0; e < block->effectCount; ++e) {
+			const Effect * effect = &block->effects[e];
+			if (effect->type == EFFECT_USE && !testBit(problem->kill[k], effect->variable)) {
+				setBit(problem->gen[k], effect->variable);
+			}
+			else if (effect->type == EFFECT_DEFINITION) {
+				setBit(problem->kill[k], effect->variable);
+			}
+		}
+	}
+	for (int v = 0; v < graph->variableCount; ++v) {
+		if (graph->variables[v].isGlobal || graph->variables[v].isCaptured) {
+			setBit(problem->boundary, v);
+		}
+	}
+	DataflowSolution * solution = solveDataflow(graph, problem);
+	releaseDataflowProblem(problem);
+	return solution;
+}
+
+void releaseDataflowProblem(DataflowProblem * problem) {
+	if (problem == NULL) return;
+	for (int k = 0; k < problem->blockCount; ++k) {
+		destroyBitVector(problem->gen[k]);
+		destroyBitVector(problem->kill[k]);
+	}
+	free(problem->gen);
+	free(problem->kill);
+	destroyBitVector(problem->boundary);
+	free(problem);
+}
+
+void releaseDataflowSolution(DataflowSolution * solution) {
+	if (solution == NULL) return;
+	for (int k = 0; k < solution->blockCount; ++k) {
+		destroyBitVector(solution->in[k]);
+		destroyBitVector(solution->out[k]);
+	}
+	free(solution->in);
+	free(solution->out);
+	free(solution);
+}
@@ -0,0 +1,68 @@
+#ifndef DATAFLOW_HEADER
+#define DATAFLOW_HEADER
+
+#include "../../shared/BitVector.h"
+#include "../../shared/Type.h"
+#include "ControlFlowGraph.h"
+#include <stdlib.h>
+
+typedef enum {
+	DATAFLOW_FORWARD,
+	DATAFLOW_BACKWARD
+} DataflowDirection;
+
+typedef enum {
+	DATAFLOW_UNION,
+	DATAFLOW_INTERSECTION
+} DataflowMeet;
+
+/**
+ * A gen/kill problem over the variables of a graph. The transfer function of
+ * every block is "gen ∪ (x - kill)", and the boundary is the value at the
+ * entry (forward) or at the exit (backward) of the graph. The problem owns
+ * its vectors.
+ */
+typedef struct {
+	DataflowDirection direction;
+	DataflowMeet meet;
+	BitVector ** gen;
+	BitVector ** kill;
+	BitVector * boundary;
+	int blockCount;
+} DataflowProblem;
+
+/**
+ * The values at the entry (in) and at the exit (out) of every block. Blocks
+ * that are unreachable from the entry keep the initial value of the meet
+ * (everything for an intersection, nothing for a union).
+ */
+typedef struct {
+	BitVector ** in;
+	BitVector ** out;
+	int blockCount;
+	int iterations;
+} DataflowSolution;
+
+/**
+ * Solves the problem with a round-robin iteration in reverse post-order (or
+ * post-order, for backward problems), which converges in a few passes on the
+ * structured graphs of the language.
+ */
+DataflowSolution * solveDataflow(ControlFlowGraph * graph, DataflowProblem * problem);
+
+/**
+ * The variables that have been assigned on every path to each point. The
+ * parameters are assigned at the entry.
+ */
+DataflowSolution * computeDefiniteAssignment(ControlFlowGraph * graph);
+
+/**
+ * The variables whose current value can still be read on some path from each
+ * point. Globals and captured variables are live at the exit.
+ */
+DataflowSolution * computeLiveness(ControlFlowGraph * graph);
+
+void releaseDataflowProblem(DataflowProblem * problem);
+void releaseDataflowSolution(DataflowSolution * solution);
+
+#endif
@@ -0,0 +1,119 @@
+#include "PassManager.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializePassManagerModule() {
+	_logger = createLogger("PassManager");
+}
+
+void shutdownPassManagerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * A scheduled pass: either a traversal, or a visitor.
+ */
+typedef struct {
+	const char * name;
+	TraversalFunction traversal;
+	void * state;
+	Visitor * visitor;
+} Pass;
+
+struct PassManager {
+	Pass * passes;
+	int count;
+	int capacity;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static Pass * _appendPass(PassManager * manager);
+static int _runVisitors(PassManager * manager, Program * program, const int first);
+
+static Pass * _appendPass(PassManager * manager) {
+	if (manager->count == manager->capacity) {
+		manager->capacity = manager->capacity == 0 ? 8 : 2 * manager->capacity;
+		manager->passes = realloc(manager->passes, manager->capacity * sizeof(Pass));
+	}
+	Pass * pass = &manager->passes[manager->count++];
+	pass->name = NULL;
+	pass->traversal = NULL;
+	pass->state = NULL;
+	pass->visitor = NULL;
+	return pass;
+}
+
+/**
+ * Fuses the visitors that start at the given pass into a single walk, and
+ * returns how many they were.
+ */
+static int _runVisitors(PassManager * manager, Program * program, const int first) {
+	int count = 0;
+	while (first + count < manager->count && manager->passes[first + count].visitor != NULL) {
+		++count;
+	}
+	Visitor ** visitors = calloc(count, sizeof(Visitor *));
+	for (int k = 0; k < count; ++k) {
+		visitors[k] = manager->passes[first + k].visitor;
+		logDebugging(_logger, "Fusing pass '%s'.", visitors[k]->name);
+	}
+	walkProgram(program, visitors, count);
+	for (int k = 0; k < count; ++k) {
+		if (visitors[k]->finish != NULL) {
+			visitors[k]->finish(visitors[k]->state);
+		}
+	}
+	free(visitors);
+	return count;
+}
+
+/* PUBLIC FUNCTIONS */
+
+PassManager * createPassManager() {
+	return calloc(1, sizeof(PassManager));
+}
+
+void destroyPassManager(PassManager * manager) {
+	if (manager != NULL) {
+		free(manager->passes);
+		free(manager);
+	}
+}
+
+void addTraversalPass(PassManager * manager, const char * name, TraversalFunction traversal, void * state) {
+	Pass * pass = _appendPass(manager);
+	pass->name = name;
+	pass->traversal = traversal;
+	pass->state = state;
+}
+
+void addVisitorPass(PassManager * manager, Visitor * visitor) {
+	Pass * pass = _appendPass(manager);
+	pass->name = visitor->name;
+	pass->visitor = visitor;
+}
+
+int runPasses(PassManager * manager, Program * program) {
+	int errors = 0;
+	int traversals = 0;
+	int k = 0;
+	while (k < manager->count) {
+		Pass * pass = &manager->passes[k];
+		if (pass->visitor != NULL) {
+			k += _runVisitors(manager, program, k);
+		}
+		else {
+			logDebugging(_logger, "Running pass '%s'.", pass->name);
+			errors += pass->traversal(program, pass->state);
+			++k;
+		}
+		++traversals;
+	}
+	logDebugging(_logger, "Ran %d pass(es) in %d traversal(s).", manager->count, traversals);
+	return errors;
+}
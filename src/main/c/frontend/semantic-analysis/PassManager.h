@@ -0,0 +1,42 @@
+#ifndef PASS_MANAGER_HEADER
+#define PASS_MANAGER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/Visitor.h"
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializePassManagerModule();
+
+/** Shutdown module's internal state. */
+void shutdownPassManagerModule();
+
+/**
+ * A pass that walks the tree on its own, and may restructure it. Returns the
+ * amount of errors it found.
+ */
+typedef int (*TraversalFunction)(Program * program, void * state);
+
+typedef struct PassManager PassManager;
+
+PassManager * createPassManager();
+
+void destroyPassManager(PassManager * manager);
+
+/** Appends a pass that walks the tree on its own. */
+void addTraversalPass(PassManager * manager, const char * name, TraversalFunction traversal, void * state);
+
+/** Appends a visitor. Consecutive visitors are fused into a single walk. */
+void addVisitorPass(PassManager * manager, Visitor * visitor);
+
+/**
+ * Runs the passes in order. Every run of consecutive visitors shares one walk,
+ * and their finish callbacks run right after it, in order.
+ *
+ * @return The amount of errors reported by the traversal passes.
+ */
+int runPasses(PassManager * manager, Program * program);
+
+#endif
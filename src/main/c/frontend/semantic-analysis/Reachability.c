@@ -0,0 +1,593 @@
+#include "Reachability.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+static int _eliminated = 0;
+
+void initializeReachabilityModule() {
+	_logger = createLogger("Reachability");
+}
+
+void shutdownReachabilityModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * How the control flows after an instruction: it continues with the next one,
+ * it never reaches the next one (return, pass, endless loop), or the whole
+ * instruction is dead and must be removed from its block.
+ */
+typedef enum {
+	FLOW_CONTINUES,
+	FLOW_TERMINATES,
+	FLOW_VANISHES
+} Flow;
+
+/**
+ * The value of a condition, when it can be known at compile-time.
+ */
+typedef enum {
+	UNKNOWN_TRUTH,
+	ALWAYS_FALSE,
+	ALWAYS_TRUE
+} Truth;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _blockReferences(Block * block, const char * name, Instruction * skip);
+static const char * _describeTermination(Instruction * instruction);
+static boolean _expressionReferences(Expression * expression, const char * name);
+static boolean _factorReferences(Factor * factor, const char * name);
+static boolean _foldExpression(Expression * expression, double * value, boolean * isDecimal);
+static boolean _foldFactor(Factor * factor, double * value, boolean * isDecimal);
+static boolean _instructionReferences(Instruction * instruction, const char * name);
+static boolean _isPrivate(VariableDeclaration * variableDeclaration);
+static boolean _isPureExpression(Expression * expression);
+static boolean _isPureFactor(Factor * factor);
+static void _removeNode(Block * block, Node * previous, Node * node);
+static void _removeUnusedPrivateMembers(Class * class, const char * scope);
+static boolean _trimBlock(Block * block, const char * scope);
+static void _trimClass(Class * class);
+static Flow _trimConditional(Instruction * instruction, const char * scope);
+static void _trimExpression(Expression * expression, const char * name);
+static Flow _trimInstruction(Instruction * instruction, const char * scope);
+static void _trimInterface(Interface * interface);
+static void _trimLambda(Lambda * lambda, const char * name);
+static Flow _trimLoop(Loop * loop, const char * scope);
+static int _truncateAfter(Block * block, Node * node);
+static Truth _truth(Expression * expression);
+
+/**
+ * Folds a numeric constant factor. Strings are never folded.
+ */
+static boolean _foldFactor(Factor * factor, double * value, boolean * isDecimal) {
+	switch (factor->type) {
+		case CONSTANT:
+			*isDecimal = false;
+			switch (factor->constant->type) {
+				case C_INT_TYPE: *value = factor->constant->intValue; return true;
+				case C_CHAR_TYPE: *value = factor->constant->charValue; return true;
+				case C_BOOLEAN_TYPE: *value = factor->constant->booleanValue; return true;
+				case C_DOUBLE_TYPE: *value = factor->constant->doubleValue; *isDecimal = true; return true;
+				case C_FLOAT_TYPE: *value = factor->constant->floatValue; *isDecimal = true; return true;
+				default: return false;
+			}
+		case EXPRESSION:
+			return _foldExpression(factor->expression, value, isDecimal);
+		default:
+			return false;
+	}
+}
+
+/**
+ * Folds an expression made only of numeric constants. Returns false if the
+ * value cannot be known at compile-time (including divisions by zero, that
+ * are left to the runtime).
+ */
+static boolean _foldExpression(Expression * expression, double * value, boolean * isDecimal) {
+	double left, right;
+	boolean isLeftDecimal, isRightDecimal;
+	switch (expression->type) {
+		case FACTOR:
+			return _foldFactor(expression->factor, value, isDecimal);
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			if (!_foldExpression(expression->leftExpression, &left, &isLeftDecimal)) return false;
+			if (!_foldExpression(expression->rightExpression, &right, &isRightDecimal)) return false;
+			*isDecimal = isLeftDecimal || isRightDecimal;
+			switch (expression->type) {
+				case ADDITION: *value = left + right; return true;
+				case SUBTRACTION: *value = left - right; return true;
+				case MULTIPLICATION: *value = left * right; return true;
+				default:
+					if (right == 0) return false;
+					*value = *isDecimal ? left / right : (double) ((long) left / (long) right);
+					return true;
+			}
+		case LESS_TYPE:
+		case GREATER_TYPE:
+		case LESS_EQUAL_TYPE:
+		case GREATER_EQUAL_TYPE:
+		case EQUAL_EQUAL_TYPE:
+		case NOT_EQUAL_TYPE:
+			if (!_foldFactor(expression->leftFactor, &left, &isLeftDecimal)) return false;
+			if (!_foldFactor(expression->rightFactor, &right, &isRightDecimal)) return false;
+			*isDecimal = false;
+			switch (expression->type) {
+				case LESS_TYPE: *value = left < right; return true;
+				case GREATER_TYPE: *value = left > right; return true;
+				case LESS_EQUAL_TYPE: *value = left <= right; return true;
+				case GREATER_EQUAL_TYPE: *value = left >= right; return true;
+				case EQUAL_EQUAL_TYPE: *value = left == right; return true;
+				default: *value = left != right; return true;
+			}
+		default:
+			return false;
+	}
+}
+
+/**
+ * Computes the truth of a condition, if it's a compile-time constant.
+ */
+static Truth _truth(Expression * expression) {
+	double value;
+	boolean isDecimal;
+	if (expression == NULL || !_foldExpression(expression, &value, &isDecimal)) {
+		return UNKNOWN_TRUTH;
+	}
+	return value != 0 ? ALWAYS_TRUE : ALWAYS_FALSE;
+}
+
+/**
+ * Unlinks a node from its block, and releases the instruction inside.
+ */
+static void _removeNode(Block * block, Node * previous, Node * node) {
+	if (previous == NULL) {
+		block->first = node->next;
+	}
+	else {
+		previous->next = node->next;
+	}
+	if (block->last == node) {
+		block->last = previous;
+	}
+	block->size -= 1;
+	releaseInstruction(node->data);
+	free(node);
+}
+
+/**
+ * Releases every instruction of the block after the specified node, and
+ * returns how many of them were removed.
+ */
+static int _truncateAfter(Block * block, Node * node) {
+	int count = 0;
+	Node * current = node->next;
+	while (current != NULL) {
+		Node * next = current->next;
+		releaseInstruction(current->data);
+		free(current);
+		current = next;
+		++count;
+	}
+	node->next = NULL;
+	block->last = node;
+	block->size -= count;
+	return count;
+}
+
+/**
+ * A human readable description of the instruction that ends a path.
+ */
+static const char * _describeTermination(Instruction * instruction) {
+	switch (instruction->type) {
+		case INSTRUCTION_RETURN: return "'return'";
+		case INSTRUCTION_PASS: return "'pass'";
+		case INSTRUCTION_LOOP: return "an endless while-loop";
+		default: return "a branch that always exits";
+	}
+}
+
+/**
+ * Trims a block, and returns true if every path through it ends with a
+ * "return", a "pass" or an endless loop.
+ */
+static boolean _trimBlock(Block * block, const char * scope) {
+	if (block == NULL) return false;
+	Node * previous = NULL;
+	Node * node = block->first;
+	while (node != NULL) {
+		Node * next = node->next;
+		Instruction * instruction = node->data;
+		const Flow flow = _trimInstruction(instruction, scope);
+		if (flow == FLOW_VANISHES) {
+			_removeNode(block, previous, node);
+			node = next;
+			continue;
+		}
+		if (flow == FLOW_TERMINATES) {
+			if (next != NULL) {
+				const int count = _truncateAfter(block, node);
+				logWarning(_logger, "Unreachable code in %s: %d instruction(s) after %s removed.",
+					scope, count, _describeTermination(instruction));
+				_eliminated += count;
+			}
+			return true;
+		}
+		previous = node;
+		node = next;
+	}
+	return false;
+}
+
+static Flow _trimInstruction(Instruction * instruction, const char * scope) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			_trimExpression(instruction->assignment->expression, instruction->assignment->name);
+			return FLOW_CONTINUES;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			_trimExpression(instruction->variableDeclaration->expression, instruction->variableDeclaration->name);
+			return FLOW_CONTINUES;
+		case INSTRUCTION_EXPRESSION:
+			_trimExpression(instruction->expression, NULL);
+			return FLOW_CONTINUES;
+		case INSTRUCTION_BLOCK:
+			return _trimBlock(instruction->block, scope) ? FLOW_TERMINATES : FLOW_CONTINUES;
+		case INSTRUCTION_CONDITIONAL:
+			return _trimConditional(instruction, scope);
+		case INSTRUCTION_LOOP:
+			return _trimLoop(instruction->loop, scope);
+		case INSTRUCTION_CLASS:
+			_trimClass(instruction->class);
+			return FLOW_CONTINUES;
+		case INSTRUCTION_INTERFACE:
+			_trimInterface(instruction->interface);
+			return FLOW_CONTINUES;
+		case INSTRUCTION_RETURN:
+			if (instruction->returnInstruction != NULL
+				&& _trimInstruction(instruction->returnInstruction, scope) == FLOW_VANISHES) {
+				releaseInstruction(instruction->returnInstruction);
+				instruction->returnInstruction = NULL;
+			}
+			return FLOW_TERMINATES;
+		case INSTRUCTION_PASS:
+			return FLOW_TERMINATES;
+	}
+	return FLOW_CONTINUES;
+}
+
+/**
+ * Drops the branches of an if/else-if chain whose condition is constantly
+ * false, and every branch after one whose condition is constantly true. If
+ * the first surviving branch always executes, the conditional collapses into
+ * a plain block.
+ */
+static Flow _trimConditional(Instruction * instruction, const char * scope) {
+	Conditional ** link = &instruction->conditional;
+	while (*link != NULL) {
+		Conditional * conditional = *link;
+		if (conditional->ConditionalType == ELSE_TYPE) break;
+		const Truth truth = _truth(conditional->expression);
+		if (truth == ALWAYS_FALSE) {
+			logWarning(_logger, "Unreachable code in %s: branch whose condition is always false removed.", scope);
+			*link = conditional->nextConditional;
+			conditional->nextConditional = NULL;
+			releaseConditional(conditional);
+			++_eliminated;
+		}
+		else if (truth == ALWAYS_TRUE) {
+			if (conditional->nextConditional != NULL) {
+				logWarning(_logger, "Unreachable code in %s: branches after a condition that is always true removed.", scope);
+				releaseConditional(conditional->nextConditional);
+				conditional->nextConditional = NULL;
+				++_eliminated;
+			}
+			releaseExpression(conditional->expression);
+			conditional->expression = NULL;
+			conditional->ConditionalType = ELSE_TYPE;
+			break;
+		}
+		else {
+			link = &conditional->nextConditional;
+		}
+	}
+	Conditional * head = instruction->conditional;
+	if (head == NULL) {
+		return FLOW_VANISHES;
+	}
+	if (head->ConditionalType == ELSE_TYPE) {
+		Block * block = head->block;
+		head->block = NULL;
+		releaseConditional(head);
+		instruction->type = INSTRUCTION_BLOCK;
+		instruction->block = block;
+		return _trimBlock(block, scope) ? FLOW_TERMINATES : FLOW_CONTINUES;
+	}
+	boolean terminates = true;
+	boolean exhaustive = false;
+	for (Conditional * conditional = head; conditional != NULL; conditional = conditional->nextConditional) {
+		if (!_trimBlock(conditional->block, scope)) terminates = false;
+		if (conditional->ConditionalType == ELSE_TYPE) exhaustive = true;
+	}
+	return (terminates && exhaustive) ? FLOW_TERMINATES : FLOW_CONTINUES;
+}
+
+/**
+ * A while-loop with a constantly false condition never runs, and one with a
+ * constantly true condition can only be left through a "return", so nothing
+ * after it is reachable.
+ */
+static Flow _trimLoop(Loop * loop, const char * scope) {
+	if (loop->type == WHILE_LOOP) {
+		const Truth truth = _truth(loop->expression);
+		if (truth == ALWAYS_FALSE) {
+			logWarning(_logger, "Unreachable code in %s: while-loop whose condition is always false removed.", scope);
+			++_eliminated;
+			return FLOW_VANISHES;
+		}
+		_trimExpression(loop->expression, NULL);
+		_trimBlock(loop->block, scope);
+		return truth == ALWAYS_TRUE ? FLOW_TERMINATES : FLOW_CONTINUES;
+	}
+	_trimBlock(loop->block, scope);
+	return FLOW_CONTINUES;
+}
+
+/**
+ * Looks for lambdas inside an expression. The name is the variable that
+ * directly receives the expression, if any, and it's only used for logging.
+ */
+static void _trimExpression(Expression * expression, const char * name) {
+	if (expression == NULL) return;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			_trimExpression(expression->leftExpression, NULL);
+			_trimExpression(expression->rightExpression, NULL);
+			break;
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				_trimExpression(expression->factor->expression, name);
+			}
+			break;
+		case FUNCTION_CALL:
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					_trimExpression(node->data, NULL);
+				}
+			}
+			break;
+		case LAMBDA:
+			_trimLambda(expression->lambda, name);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _trimLambda(Lambda * lambda, const char * name) {
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * node = lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+			VariableDeclaration * parameter = node->data;
+			_trimExpression(parameter->expression, parameter->name);
+		}
+	}
+	if (name == NULL) {
+		_trimBlock(lambda->block, "an anonymous lambda");
+	}
+	else {
+		char * scope = concatenate(3, "lambda '", name, "'");
+		_trimBlock(lambda->block, scope);
+		free(scope);
+	}
+}
+
+static void _trimClass(Class * class) {
+	char * scope = concatenate(3, "class '", class->object->name, "'");
+	_trimBlock(class->block, scope);
+	_removeUnusedPrivateMembers(class, scope);
+	free(scope);
+}
+
+static void _trimInterface(Interface * interface) {
+	char * scope = concatenate(3, "interface '", interface->object->name, "'");
+	_trimBlock(interface->block, scope);
+	free(scope);
+}
+
+static boolean _isPrivate(VariableDeclaration * variableDeclaration) {
+	if (variableDeclaration->privacyModifierList == NULL) return false;
+	for (Node * node = variableDeclaration->privacyModifierList->first; node != NULL; node = node->next) {
+		PrivacyModifier * modifier = node->data;
+		if (modifier->type == PRIVATE_A) return true;
+	}
+	return false;
+}
+
+/**
+ * An expression is pure if evaluating it has no side effects, so dropping it
+ * cannot change the behaviour of the program.
+ */
+static boolean _isPureExpression(Expression * expression) {
+	if (expression == NULL) return true;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return _isPureExpression(expression->leftExpression) && _isPureExpression(expression->rightExpression);
+		case FACTOR:
+			return _isPureFactor(expression->factor);
+		case LAMBDA:
+			return true;
+		case FUNCTION_CALL:
+			return false;
+		default:
+			return _isPureFactor(expression->leftFactor) && _isPureFactor(expression->rightFactor);
+	}
+}
+
+static boolean _isPureFactor(Factor * factor) {
+	switch (factor->type) {
+		case CONSTANT:
+		case VARIABLE_TYPE:
+			return true;
+		case EXPRESSION:
+			return _isPureExpression(factor->expression);
+		default:
+			return false;
+	}
+}
+
+/**
+ * Removes the private members that no other instruction of the class
+ * mentions. Private members are invisible to subclasses, so the class body is
+ * the only place where they can be used. Removing one member can leave
+ * another one unused, so it iterates until nothing changes. Members with an
+ * impure initializer are reported, but kept.
+ */
+static void _removeUnusedPrivateMembers(Class * class, const char * scope) {
+	Block * block = class->block;
+	if (block == NULL) return;
+	boolean removed = true;
+	while (removed) {
+		removed = false;
+		Node * previous = NULL;
+		Node * node = block->first;
+		while (node != NULL) {
+			Node * next = node->next;
+			Instruction * instruction = node->data;
+			if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+				VariableDeclaration * member = instruction->variableDeclaration;
+				if (_isPrivate(member) && _isPureExpression(member->expression)
+					&& !_blockReferences(block, member->name, instruction)) {
+					logWarning(_logger, "Unused private member '%s' of %s removed.", member->name, scope);
+					_removeNode(block, previous, node);
+					++_eliminated;
+					removed = true;
+					node = next;
+					continue;
+				}
+			}
+			previous = node;
+			node = next;
+		}
+	}
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		Instruction * instruction = node->data;
+		if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+			VariableDeclaration * member = instruction->variableDeclaration;
+			if (_isPrivate(member) && !_blockReferences(block, member->name, instruction)) {
+				logWarning(_logger, "Private member '%s' of %s is never used.", member->name, scope);
+			}
+		}
+	}
+}
+
+/**
+ * Returns true if any instruction of the block (except "skip") mentions the
+ * name. Shadowing is ignored, so the answer is conservative.
+ */
+static boolean _blockReferences(Block * block, const char * name, Instruction * skip) {
+	if (block == NULL) return false;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		if (node->data != skip && _instructionReferences(node->data, name)) return true;
+	}
+	return false;
+}
+
+static boolean _instructionReferences(Instruction * instruction, const char * name) {
+	switch (instruction->type) {
+		case INSTRUCTION_ASSIGNMENT:
+			return strcmp(instruction->assignment->name, name) == 0
+				|| _expressionReferences(instruction->assignment->expression, name);
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			return _expressionReferences(instruction->variableDeclaration->expression, name);
+		case INSTRUCTION_EXPRESSION:
+			return _expressionReferences(instruction->expression, name);
+		case INSTRUCTION_BLOCK:
+			return _blockReferences(instruction->block, name, NULL);
+		case INSTRUCTION_CONDITIONAL:
+			for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+				if (_expressionReferences(conditional->expression, name)) return true;
+				if (_blockReferences(conditional->block, name, NULL)) return true;
+			}
+			return false;
+		case INSTRUCTION_LOOP:
+			return _expressionReferences(instruction->loop->expression, name)
+				|| (instruction->loop->collectionName != NULL && strcmp(instruction->loop->collectionName, name) == 0)
+				|| _blockReferences(instruction->loop->block, name, NULL);
+		case INSTRUCTION_CLASS:
+			return _blockReferences(instruction->class->block, name, NULL);
+		case INSTRUCTION_INTERFACE:
+			return _blockReferences(instruction->interface->block, name, NULL);
+		case INSTRUCTION_RETURN:
+			return instruction->returnInstruction != NULL && _instructionReferences(instruction->returnInstruction, name);
+		case INSTRUCTION_PASS:
+			return false;
+	}
+	return false;
+}
+
+static boolean _expressionReferences(Expression * expression, const char * name) {
+	if (expression == NULL) return false;
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return _expressionReferences(expression->leftExpression, name)
+				|| _expressionReferences(expression->rightExpression, name);
+		case FACTOR:
+			return _factorReferences(expression->factor, name);
+		case FUNCTION_CALL:
+			if (strcmp(expression->functionCall->name, name) == 0) return true;
+			if (expression->functionCall->expressionList != NULL) {
+				for (Node * node = expression->functionCall->expressionList->first; node != NULL; node = node->next) {
+					if (_expressionReferences(node->data, name)) return true;
+				}
+			}
+			return false;
+		case LAMBDA:
+			if (expression->lambda->variableDeclarationList != NULL) {
+				for (Node * node = expression->lambda->variableDeclarationList->first; node != NULL; node = node->next) {
+					VariableDeclaration * parameter = node->data;
+					if (_expressionReferences(parameter->expression, name)) return true;
+				}
+			}
+			return _blockReferences(expression->lambda->block, name, NULL);
+		default:
+			return _factorReferences(expression->leftFactor, name)
+				|| _factorReferences(expression->rightFactor, name);
+	}
+}
+
+static boolean _factorReferences(Factor * factor, const char * name) {
+	switch (factor->type) {
+		case VARIABLE_TYPE:
+		case INCREMENT_TYPE:
+		case DECREMENT_TYPE:
+			return strcmp(factor->variable, name) == 0;
+		case EXPRESSION:
+			return _expressionReferences(factor->expression, name);
+		default:
+			return false;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+int eliminateUnreachableCode(Program * program) {
+	_eliminated = 0;
+	if (program != NULL) {
+		_trimBlock(program->block, "the program");
+	}
+	return _eliminated;
+}
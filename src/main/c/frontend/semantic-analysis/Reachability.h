@@ -0,0 +1,30 @@
+#ifndef REACHABILITY_HEADER
+#define REACHABILITY_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeReachabilityModule();
+
+/** Shutdown module's internal state. */
+void shutdownReachabilityModule();
+
+/**
+ * Removes every instruction that can never execute: the rest of a block after
+ * a "return" or a "pass", branches of an if/else-if chain whose condition is
+ * a constant, while-loops whose condition is constantly false, and the code
+ * after a while-loop that can never exit. Also drops the unused private
+ * (@hidden) members of every class, if their initializers are pure.
+ *
+ * The AST is trimmed in place (removed nodes are released), and a warning is
+ * logged for each elimination.
+ *
+ * @return The amount of eliminated instructions.
+ */
+int eliminateUnreachableCode(Program * program);
+
+#endif
@@ -0,0 +1,110 @@
+#include "SemanticAnalyzer.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeSemanticAnalyzerModule() {
+	_logger = createLogger("SemanticAnalyzer");
+}
+
+void shutdownSemanticAnalyzerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The checks of a unit, and the diagnostics they produce while they run on
+ * a worker thread.
+ */
+typedef struct {
+	SemanticUnit * unit;
+	LogBuffer * diagnostics;
+	int errors;
+} UnitCheck;
+
+/**
+ * What the checks of the bodies need: the signatures of the program, and the
+ * pool that runs them.
+ */
+typedef struct {
+	const SignatureTable * signatures;
+	ThreadPool * threadPool;
+} BodiesCheck;
+
+/* PRIVATE FUNCTIONS */
+
+static int _checkBodies(Program * program, void * state);
+static void _checkUnit(void * context, const int index);
+static int _eliminateUnreachableCode(Program * program, void * state);
+
+static int _eliminateUnreachableCode(Program * program, void * state) {
+	(void) state;
+	const int eliminated = eliminateUnreachableCode(program);
+	logDebugging(_logger, "Eliminated %d unreachable instruction(s).", eliminated);
+	return 0;
+}
+
+static void _checkUnit(void * context, const int index) {
+	UnitCheck * check = &((UnitCheck *) context)[index];
+	redirectLogs(check->diagnostics);
+	check->errors = analyzeVariables(check->unit);
+	redirectLogs(NULL);
+}
+
+/**
+ * Checks every unit on the thread pool, and prints their diagnostics in
+ * source order, so the output doesn't depend on the scheduling.
+ */
+static int _checkBodies(Program * program, void * state) {
+	BodiesCheck * bodies = state;
+	int count = 0;
+	SemanticUnit * units = splitIntoUnits(program, bodies->signatures, &count);
+	UnitCheck * checks = calloc(count, sizeof(UnitCheck));
+	for (int k = 0; k < count; ++k) {
+		checks[k].unit = &units[k];
+		checks[k].diagnostics = createLogBuffer();
+	}
+	logDebugging(_logger, "Checking %d unit(s) on %d thread(s)...", count, getThreadPoolSize(bodies->threadPool));
+	runInThreadPool(bodies->threadPool, _checkUnit, checks, count);
+	int errors = 0;
+	for (int k = 0; k < count; ++k) {
+		flushLogBuffer(checks[k].diagnostics);
+		destroyLogBuffer(checks[k].diagnostics);
+		errors += checks[k].errors;
+	}
+	free(checks);
+	free(units);
+	return errors;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SemanticAnalysisStatus analyze(CompilerState * compilerState) {
+	logDebugging(_logger, "Analyzing...");
+	Program * program = compilerState->abstractSyntaxtTree;
+	SignatureTable * signatures = createSignatureTable();
+	BodiesCheck bodies = { signatures, createThreadPool(getIntegerOrDefault("SEMANTIC_THREADS", 0)) };
+	Visitor signaturesVisitor;
+	initializeSignaturesVisitor(&signaturesVisitor, signatures);
+	CaptureAnalysis * captures = createCaptureAnalysis(signatures);
+	Visitor capturesVisitor;
+	initializeCapturesVisitor(&capturesVisitor, captures);
+	TreeStatistics statistics;
+	Visitor statisticsVisitor;
+	initializeTreeStatisticsVisitor(&statisticsVisitor, &statistics);
+	PassManager * manager = createPassManager();
+	addTraversalPass(manager, "reachability", _eliminateUnreachableCode, NULL);
+	addVisitorPass(manager, &signaturesVisitor);
+	addVisitorPass(manager, &capturesVisitor);
+	addVisitorPass(manager, &statisticsVisitor);
+	addTraversalPass(manager, "bodies", _checkBodies, &bodies);
+	const int errors = runPasses(manager, program) + signatures->errors;
+	destroyPassManager(manager);
+	releaseCaptureAnalysis(captures);
+	destroyThreadPool(bodies.threadPool);
+	releaseSignatureTable(signatures);
+	logDebugging(_logger, "Analysis is done.");
+	return errors == 0 ? SEMANTIC_ACCEPT : SEMANTIC_REJECT;
+}
@@ -0,0 +1,40 @@
+#ifndef SEMANTIC_ANALYZER_HEADER
+#define SEMANTIC_ANALYZER_HEADER
+
+#include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/ThreadPool.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "CaptureAnalysis.h"
+#include "PassManager.h"
+#include "Reachability.h"
+#include "Signatures.h"
+#include "TreeStatistics.h"
+#include "VariableAnalysis.h"
+
+/** Initialize module's internal state. */
+void initializeSemanticAnalyzerModule();
+
+/** Shutdown module's internal state. */
+void shutdownSemanticAnalyzerModule();
+
+typedef enum {
+	SEMANTIC_ACCEPT,
+	SEMANTIC_REJECT
+} SemanticAnalysisStatus;
+
+/**
+ * Executes the semantic-analysis phase of the compiler over the AST produced
+ * by the parser. The passes of this phase can report warnings and trim the
+ * tree in place, so the backend only receives reachable code.
+ *
+ * The passes are scheduled by a pass manager: transformations and
+ * whole-program analyses run serially: the reachability trims the tree first,
+ * and then the signatures, captures and statistics share a single walk. Then the
+ * bodies of every top-level class and lambda are checked in parallel (see
+ * "SEMANTIC_THREADS").
+ */
+SemanticAnalysisStatus analyze(CompilerState * compilerState);
+
+#endif
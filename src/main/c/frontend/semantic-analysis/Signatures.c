@@ -0,0 +1,270 @@
+#include "Signatures.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeSignaturesModule() {
+	_logger = createLogger("Signatures");
+}
+
+void shutdownSignaturesModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _addGlobal(SignatureTable * signatures, const char * name, const int position);
+static void _addMember(TypeSignature * type, const char * name);
+static void _addType(SignatureTable * signatures, const char * name, const char * parent, Class * class, Interface * interface, Block * block);
+static VisitAction _collectSignatures(void * state, void * node);
+static void _collectTypes(SignatureTable * signatures, Block * block);
+static TypeSignature * _findClass(SignatureTable * signatures, const char * name);
+static void _inheritMembers(SignatureTable * signatures, TypeSignature * type);
+static void _logSignatures(void * state);
+static const char * _memberName(Instruction * instruction);
+
+/**
+ * The name a class-body instruction declares, or NULL.
+ */
+static const char * _memberName(Instruction * instruction) {
+	if (instruction->type == INSTRUCTION_VARIABLE_DECLARATION) {
+		return instruction->variableDeclaration->name;
+	}
+	if (instruction->type == INSTRUCTION_ASSIGNMENT && instruction->assignment->assignmentOperator == ASSIGN_TYPE) {
+		return instruction->assignment->name;
+	}
+	return NULL;
+}
+
+static void _addMember(TypeSignature * type, const char * name) {
+	for (int k = 0; k < type->memberCount; ++k) {
+		if (strcmp(type->members[k], name) == 0) return;
+	}
+	type->members = realloc(type->members, (type->memberCount + 1) * sizeof(const char *));
+	type->members[type->memberCount++] = name;
+}
+
+static void _addType(SignatureTable * signatures, const char * name, const char * parent, Class * class, Interface * interface, Block * block) {
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		if (strcmp(signatures->types[k].name, name) == 0) {
+			logError(_logger, "Type '%s' is declared more than once.", name);
+			signatures->errors += 1;
+			break;
+		}
+	}
+	if (signatures->typeCount == signatures->typeCapacity) {
+		signatures->typeCapacity = signatures->typeCapacity == 0 ? 16 : 2 * signatures->typeCapacity;
+		signatures->types = realloc(signatures->types, signatures->typeCapacity * sizeof(TypeSignature));
+	}
+	TypeSignature * type = &signatures->types[signatures->typeCount++];
+	memset(type, 0, sizeof(TypeSignature));
+	type->name = name;
+	type->parent = parent;
+	type->class = class;
+	type->interface = interface;
+	if (block != NULL) {
+		for (Node * node = block->first; node != NULL; node = node->next) {
+			const char * member = _memberName(node->data);
+			if (member != NULL) {
+				_addMember(type, member);
+			}
+		}
+	}
+	type->ownMemberCount = type->memberCount;
+}
+
+/**
+ * Collects the types declared by the statements of a block, including the
+ * ones nested in classes, but not the ones inside lambdas.
+ */
+static void _collectTypes(SignatureTable * signatures, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		Instruction * instruction = node->data;
+		switch (instruction->type) {
+			case INSTRUCTION_CLASS: {
+				Class * class = instruction->class;
+				_addType(signatures, class->object->name, class->inherits == NULL ? NULL : class->inherits->name, class, NULL, class->block);
+				_collectTypes(signatures, class->block);
+				break;
+			}
+			case INSTRUCTION_INTERFACE: {
+				Interface * interface = instruction->interface;
+				_addType(signatures, interface->object->name, NULL, NULL, interface, interface->block);
+				break;
+			}
+			case INSTRUCTION_BLOCK:
+				_collectTypes(signatures, instruction->block);
+				break;
+			case INSTRUCTION_CONDITIONAL:
+				for (Conditional * conditional = instruction->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+					_collectTypes(signatures, conditional->block);
+				}
+				break;
+			case INSTRUCTION_LOOP:
+				_collectTypes(signatures, instruction->loop->block);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Types and globals are declared by statements, so the table is complete as
+ * soon as the walk enters the program, without visiting any expression. The
+ * visitors fused after this one can use it anywhere in the tree.
+ */
+static VisitAction _collectSignatures(void * state, void * node) {
+	SignatureTable * signatures = state;
+	Program * program = node;
+	if (program->block == NULL) return VISIT_SKIP_CHILDREN;
+	_collectTypes(signatures, program->block);
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		if (signatures->types[k].class != NULL) {
+			_inheritMembers(signatures, &signatures->types[k]);
+		}
+	}
+	int position = 0;
+	for (Node * instruction = program->block->first; instruction != NULL; instruction = instruction->next, ++position) {
+		const Instruction * global = instruction->data;
+		if (global->type != INSTRUCTION_CLASS && global->type != INSTRUCTION_INTERFACE) {
+			const char * name = _memberName(instruction->data);
+			if (name != NULL) {
+				_addGlobal(signatures, name, position);
+			}
+		}
+	}
+	return VISIT_SKIP_CHILDREN;
+}
+
+static void _logSignatures(void * state) {
+	SignatureTable * signatures = state;
+	logDebugging(_logger, "Collected %d type(s) and %d global(s).", signatures->typeCount, signatures->globalCount);
+}
+
+static TypeSignature * _findClass(SignatureTable * signatures, const char * name) {
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		if (signatures->types[k].class != NULL && strcmp(signatures->types[k].name, name) == 0) {
+			return &signatures->types[k];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Appends the own members of every known ancestor. The walk is bounded by
+ * the amount of types, so a cyclic hierarchy is reported instead of looping.
+ */
+static void _inheritMembers(SignatureTable * signatures, TypeSignature * type) {
+	const char * parent = type->parent;
+	for (int depth = 0; parent != NULL && depth < signatures->typeCount; ++depth) {
+		TypeSignature * ancestor = _findClass(signatures, parent);
+		if (ancestor == NULL) return;
+		if (ancestor == type) {
+			logError(_logger, "Class '%s' inherits from itself.", type->name);
+			signatures->errors += 1;
+			return;
+		}
+		for (int k = 0; k < ancestor->ownMemberCount; ++k) {
+			_addMember(type, ancestor->members[k]);
+		}
+		parent = ancestor->parent;
+	}
+}
+
+static void _addGlobal(SignatureTable * signatures, const char * name, const int position) {
+	for (int k = 0; k < signatures->globalCount; ++k) {
+		if (strcmp(signatures->globals[k].name, name) == 0) return;
+	}
+	if (signatures->globalCount == signatures->globalCapacity) {
+		signatures->globalCapacity = signatures->globalCapacity == 0 ? 16 : 2 * signatures->globalCapacity;
+		signatures->globals = realloc(signatures->globals, signatures->globalCapacity * sizeof(GlobalSignature));
+	}
+	signatures->globals[signatures->globalCount].name = name;
+	signatures->globals[signatures->globalCount].position = position;
+	signatures->globalCount += 1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SignatureTable * createSignatureTable() {
+	return calloc(1, sizeof(SignatureTable));
+}
+
+void initializeSignaturesVisitor(Visitor * visitor, SignatureTable * signatures) {
+	memset(visitor, 0, sizeof(Visitor));
+	visitor->name = "signatures";
+	visitor->pre[PROGRAM_NODE] = _collectSignatures;
+	visitor->finish = _logSignatures;
+	visitor->state = signatures;
+}
+
+const TypeSignature * findClassSignature(const SignatureTable * signatures, const Class * class) {
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		if (signatures->types[k].class == class) return &signatures->types[k];
+	}
+	return NULL;
+}
+
+const TypeSignature * findInterfaceSignature(const SignatureTable * signatures, const Interface * interface) {
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		if (signatures->types[k].interface == interface) return &signatures->types[k];
+	}
+	return NULL;
+}
+
+boolean isUnitRoot(const Instruction * instruction) {
+	Expression * expression = NULL;
+	switch (instruction->type) {
+		case INSTRUCTION_CLASS:
+			return true;
+		case INSTRUCTION_ASSIGNMENT:
+			if (instruction->assignment->assignmentOperator != ASSIGN_TYPE) return false;
+			expression = instruction->assignment->expression;
+			break;
+		case INSTRUCTION_VARIABLE_DECLARATION:
+			expression = instruction->variableDeclaration->expression;
+			break;
+		default:
+			return false;
+	}
+	return (expression != NULL && expression->type == LAMBDA) ? true : false;
+}
+
+SemanticUnit * splitIntoUnits(Program * program, const SignatureTable * signatures, int * count) {
+	const int size = (program->block == NULL ? 0 : program->block->size) + 1;
+	SemanticUnit * units = calloc(size, sizeof(SemanticUnit));
+	units[0].type = PROGRAM_UNIT;
+	units[0].program = program;
+	units[0].position = -1;
+	units[0].signatures = signatures;
+	*count = 1;
+	if (program->block == NULL) return units;
+	int position = 0;
+	for (Node * node = program->block->first; node != NULL; node = node->next, ++position) {
+		Instruction * instruction = node->data;
+		if (isUnitRoot(instruction)) {
+			SemanticUnit * unit = &units[(*count)++];
+			unit->type = instruction->type == INSTRUCTION_CLASS ? CLASS_UNIT : LAMBDA_UNIT;
+			unit->program = program;
+			unit->instruction = instruction;
+			unit->position = position;
+			unit->signatures = signatures;
+		}
+	}
+	return units;
+}
+
+void releaseSignatureTable(SignatureTable * signatures) {
+	if (signatures == NULL) return;
+	for (int k = 0; k < signatures->typeCount; ++k) {
+		free(signatures->types[k].members);
+	}
+	free(signatures->types);
+	free(signatures->globals);
+	free(signatures);
+}
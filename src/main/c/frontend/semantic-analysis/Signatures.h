@@ -0,0 +1,105 @@
+#ifndef SIGNATURES_HEADER
+#define SIGNATURES_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/Visitor.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeSignaturesModule();
+
+/** Shutdown module's internal state. */
+void shutdownSignaturesModule();
+
+/**
+ * The signature of a class or an interface. The members include the ones
+ * inherited from the known ancestors of a class, after its own.
+ */
+typedef struct {
+	const char * name;
+	const char * parent;
+	Class * class;
+	Interface * interface;
+	const char ** members;
+	int memberCount;
+	int ownMemberCount;
+} TypeSignature;
+
+/**
+ * A name declared by the top-level code, and the index of the top-level
+ * instruction that declares it.
+ */
+typedef struct {
+	const char * name;
+	int position;
+} GlobalSignature;
+
+/**
+ * Everything a body needs to know about the rest of the program to be
+ * checked on its own.
+ */
+typedef struct {
+	TypeSignature * types;
+	int typeCount;
+	int typeCapacity;
+	GlobalSignature * globals;
+	int globalCount;
+	int globalCapacity;
+	int errors;
+} SignatureTable;
+
+typedef enum {
+	PROGRAM_UNIT,
+	CLASS_UNIT,
+	LAMBDA_UNIT
+} SemanticUnitType;
+
+/**
+ * A part of the program that can be checked independently once the
+ * signatures are known: a top-level class, a top-level lambda definition, or
+ * the rest of the top-level code (without the bodies of the other units).
+ */
+typedef struct {
+	SemanticUnitType type;
+	Program * program;
+	Instruction * instruction;
+	int position;
+	const SignatureTable * signatures;
+} SemanticUnit;
+
+/** Creates an empty table. */
+SignatureTable * createSignatureTable();
+
+/**
+ * Prepares a visitor that collects the classes, interfaces and globals of the
+ * program into the table, without entering any lambda. The classes inherit
+ * the members of their ancestors, and the table is complete before the walk
+ * enters any other node. Types declared more than once, and classes that
+ * inherit from themselves, are reported as errors.
+ */
+void initializeSignaturesVisitor(Visitor * visitor, SignatureTable * signatures);
+
+/** The signature of the class, or NULL if it's unknown. */
+const TypeSignature * findClassSignature(const SignatureTable * signatures, const Class * class);
+
+/** The signature of the interface, or NULL if it's unknown. */
+const TypeSignature * findInterfaceSignature(const SignatureTable * signatures, const Interface * interface);
+
+/**
+ * Whether the top-level instruction is the root of its own unit: a class, or
+ * a declaration or assignment of a lambda literal.
+ */
+boolean isUnitRoot(const Instruction * instruction);
+
+/**
+ * Splits the program into units, in source order. The first unit is always
+ * the top-level code.
+ */
+SemanticUnit * splitIntoUnits(Program * program, const SignatureTable * signatures, int * count);
+
+void releaseSignatureTable(SignatureTable * signatures);
+
+#endif
@@ -0,0 +1,73 @@
+#include "TreeStatistics.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeTreeStatisticsModule() {
+	_logger = createLogger("TreeStatistics");
+}
+
+void shutdownTreeStatisticsModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _leaveNode(void * state, void * node);
+static void _logStatistics(void * state);
+
+/**
+ * Since every callback receives the node but not its kind, there is one
+ * counting function per kind, generated from the description of the AST.
+ */
+#define NODE(kind, tag, children) \
+	static VisitAction _count##kind(void * state, void * node) { \
+		TreeStatistics * statistics = state; \
+		(void) node; \
+		statistics->counts[kind] += 1; \
+		statistics->nodes += 1; \
+		if (statistics->maximumDepth < ++statistics->depth) { \
+			statistics->maximumDepth = statistics->depth; \
+		} \
+		return VISIT_CHILDREN; \
+	}
+AST_NODES(NODE)
+#undef NODE
+
+static const PreVisitFunction _counters[NODE_KIND_COUNT] = {
+#define NODE(kind, tag, children) [kind] = _count##kind,
+	AST_NODES(NODE)
+#undef NODE
+};
+
+static void _leaveNode(void * state, void * node) {
+	(void) node;
+	((TreeStatistics *) state)->depth -= 1;
+}
+
+static void _logStatistics(void * state) {
+	TreeStatistics * statistics = state;
+	logDebugging(_logger, "The tree has %d node(s), and a depth of %d.", statistics->nodes, statistics->maximumDepth);
+	for (int kind = 0; kind < NODE_KIND_COUNT; ++kind) {
+		if (statistics->counts[kind] != 0) {
+			logDebugging(_logger, "  %s: %d", nodeKindName(kind), statistics->counts[kind]);
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+void initializeTreeStatisticsVisitor(Visitor * visitor, TreeStatistics * statistics) {
+	memset(visitor, 0, sizeof(Visitor));
+	memset(statistics, 0, sizeof(TreeStatistics));
+	visitor->name = "statistics";
+	for (int kind = 0; kind < NODE_KIND_COUNT; ++kind) {
+		visitor->pre[kind] = _counters[kind];
+		visitor->post[kind] = _leaveNode;
+	}
+	visitor->finish = _logStatistics;
+	visitor->state = statistics;
+}
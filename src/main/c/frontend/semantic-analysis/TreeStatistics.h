@@ -0,0 +1,30 @@
+#ifndef TREE_STATISTICS_HEADER
+#define TREE_STATISTICS_HEADER
+
+#include "../../shared/Logger.h"
+#include "../syntactic-analysis/Visitor.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeTreeStatisticsModule();
+
+/** Shutdown module's internal state. */
+void shutdownTreeStatisticsModule();
+
+/**
+ * The size and the shape of the AST, per kind of node.
+ */
+typedef struct {
+	int counts[NODE_KIND_COUNT];
+	int nodes;
+	int depth;
+	int maximumDepth;
+} TreeStatistics;
+
+/**
+ * Prepares a visitor that fills the statistics, and logs them when it
+ * finishes (at debugging level).
+ */
+void initializeTreeStatisticsVisitor(Visitor * visitor, TreeStatistics * statistics);
+
+#endif
@@ -0,0 +1,117 @@
+#include "VariableAnalysis.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeVariableAnalysisModule() {
+	_logger = createLogger("VariableAnalysis");
+}
+
+void shutdownVariableAnalysisModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static int _checkDefiniteAssignment(ControlFlowGraph * graph, const char * scope);
+static void _checkDeadStores(ControlFlowGraph * graph, const char * scope);
+static void _checkUnusedVariables(ControlFlowGraph * graph, const char * scope);
+static boolean _isTracked(const Variable * variable);
+
+/**
+ * Globals and captured variables can be read and assigned from other
+ * functions, so only the rest can be reported as unassigned, unused or dead.
+ */
+static boolean _isTracked(const Variable * variable) {
+	return (variable->isGlobal || variable->isCaptured) ? false : true;
+}
+
+/**
+ * Replays the effects of every block from its definitely-assigned set, and
+ * reports the first read of each variable that can happen before a write.
+ */
+static int _checkDefiniteAssignment(ControlFlowGraph * graph, const char * scope) {
+	DataflowSolution * solution = computeDefiniteAssignment(graph);
+	BitVector * assigned = createBitVector(graph->variableCount);
+	BitVector * reported = createBitVector(graph->variableCount);
+	int errors = 0;
+	for (int k = 0; k < graph->blockCount; ++k) {
+		BasicBlock * block = graph->blocks[k];
+		copyBitVector(assigned, solution->in[k]);
+		for (int e = 0; e < block->effectCount; ++e) {
+			const Effect * effect = &block->effects[e];
+			const Variable * variable = &graph->variables[effect->variable];
+			if (effect->type == EFFECT_DEFINITION) {
+				setBit(assigned, effect->variable);
+			}
+			else if (!testBit(assigned, effect->variable) && !testBit(reported, effect->variable) && _isTracked(variable)) {
+				setBit(reported, effect->variable);
+				logError(_logger, "Variable '%s' may be used before being assigned in %s.", variable->name, scope);
+				++errors;
+			}
+		}
+	}
+	logDebugging(_logger, "Definite assignment of %s converged in %d iteration(s).", scope, solution->iterations);
+	destroyBitVector(reported);
+	destroyBitVector(assigned);
+	releaseDataflowSolution(solution);
+	return errors;
+}
+
+/**
+ * Replays the effects of every block backwards from its live-out set. Stores
+ * of unused variables are left to the unused-variable report.
+ */
+static void _checkDeadStores(ControlFlowGraph * graph, const char * scope) {
+	DataflowSolution * solution = computeLiveness(graph);
+	BitVector * live = createBitVector(graph->variableCount);
+	for (int k = 0; k < graph->blockCount; ++k) {
+		BasicBlock * block = graph->blocks[k];
+		copyBitVector(live, solution->out[k]);
+		for (int e = block->effectCount - 1; 0 <= e; --e) {
+			const Effect * effect = &block->effects[e];
+			const Variable * variable = &graph->variables[effect->variable];
+			if (effect->type == EFFECT_USE) {
+				setBit(live, effect->variable);
+				continue;
+			}
+			if (!testBit(live, effect->variable) && _isTracked(variable) && 0 < variable->uses) {
+				logWarning(_logger, "Value assigned to '%s' in %s is never read.", variable->name, scope);
+			}
+			clearBit(live, effect->variable);
+		}
+	}
+	logDebugging(_logger, "Liveness of %s converged in %d iteration(s).", scope, solution->iterations);
+	destroyBitVector(live);
+	releaseDataflowSolution(solution);
+}
+
+static void _checkUnusedVariables(ControlFlowGraph * graph, const char * scope) {
+	for (int v = 0; v < graph->variableCount; ++v) {
+		const Variable * variable = &graph->variables[v];
+		if (variable->uses == 0 && !variable->isParameter && _isTracked(variable)) {
+			logWarning(_logger, "Variable '%s' in %s is never used.", variable->name, scope);
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+int analyzeVariables(const SemanticUnit * unit) {
+	ControlFlowGraph * graphs = buildControlFlowGraphs(unit);
+	int errors = 0;
+	for (ControlFlowGraph * graph = graphs; graph != NULL; graph = graph->next) {
+		char * scope = graph->lambda == NULL
+			? concatenate(1, "the program")
+			: concatenate(3, "lambda '", graph->name == NULL ? "<anonymous>" : graph->name, "'");
+		errors += _checkDefiniteAssignment(graph, scope);
+		_checkUnusedVariables(graph, scope);
+		_checkDeadStores(graph, scope);
+		free(scope);
+	}
+	releaseControlFlowGraphs(graphs);
+	return errors;
+}
@@ -0,0 +1,34 @@
+#ifndef VARIABLE_ANALYSIS_HEADER
+#define VARIABLE_ANALYSIS_HEADER
+
+#include "../../shared/BitVector.h"
+#include "../../shared/Logger.h"
+#include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "ControlFlowGraph.h"
+#include "Dataflow.h"
+#include "Signatures.h"
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeVariableAnalysisModule();
+
+/** Shutdown module's internal state. */
+void shutdownVariableAnalysisModule();
+
+/**
+ * Checks the local variables of every function of the unit with the dataflow
+ * framework:
+ *
+ *	- a read of a variable that isn't definitely assigned is an error,
+ *	- a local that is never read is reported as unused,
+ *	- an assignment whose value is never read is reported as a dead store.
+ *
+ * Units share no mutable state, so they can be checked concurrently.
+ *
+ * @return The amount of errors.
+ */
+int analyzeVariables(const SemanticUnit * unit);
+
+#endif
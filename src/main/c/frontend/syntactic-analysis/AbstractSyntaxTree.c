@@ -175,6 +175,7 @@ void releaseLambda(Lambda * lambda) {
 
 	releaseVariableDeclarationList(lambda->variableDeclarationList);
 	releaseBlock(lambda->block);
+	releaseCaptureList(lambda->captureList);
 	free(lambda);
 }
 
@@ -189,6 +190,14 @@ void releaseClass(Class * class) {
 	free(class);
 }
 
+void releaseCapture(Capture * capture) {
+	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
+	if (capture == NULL) return;
+
+	releaseName(capture->name);
+	free(capture);
+}
+
 void releaseImport(Import * import_statement)
 {
 	if (import_statement == NULL)return;
@@ -309,6 +318,12 @@ void releaseImplementationList(ImplementationList * implementationList){
 	return releaseList(implementationList, (releaseDataFn) releaseObject);
 }
 
+// Captures.
+void releaseCaptureList(CaptureList * captureList){
+	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
+	return releaseList(captureList, (releaseDataFn) releaseCapture);
+}
+
 // Instructions & Blocks.
 void releaseBlock(Block * block){
 	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
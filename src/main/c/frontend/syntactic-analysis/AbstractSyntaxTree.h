@@ -21,6 +21,7 @@ typedef enum InstructionType InstructionType;
 typedef enum LoopType LoopType;
 typedef enum ConditionalType ConditionalType;
 typedef enum PrivacyType PrivacyType;
+typedef enum CaptureType CaptureType;
 
 typedef struct Conditional Conditional;
 typedef struct Constant Constant;
@@ -34,6 +35,7 @@ typedef struct VariableDeclaration VariableDeclaration;
 typedef struct AssignmentOperation AssignmentOperation;
 typedef struct Instruction Instruction;
 typedef struct Lambda Lambda;
+typedef struct Capture Capture;
 typedef struct Class Class;
 typedef struct Interface Interface;
 typedef struct Import Import;
@@ -73,6 +75,9 @@ typedef List GenericList;
 
 typedef Node ImplementationListNode;
 typedef List ImplementationList;
+
+typedef Node CaptureNode;
+typedef List CaptureList;
 #pragma endregion
 
 /** ============== ENUMS ============== */
@@ -160,6 +165,20 @@ enum LoopType {
 	WHILE_LOOP,
 	FOR_LOOP,
 };
+
+/**
+ * How a lambda reaches the variables of its enclosing functions. It's unknown
+ * until the semantic-analysis phase computes it.
+ */
+enum CaptureType {
+	CAPTURE_UNKNOWN,
+	// It only uses its own variables and globals: a plain function pointer.
+	CAPTURE_NONE,
+	// It captures variables, but never outlives the frame that creates it.
+	CAPTURE_BY_VALUE,
+	// It captures variables, and may outlive its frame: a heap closure.
+	CAPTURE_ESCAPING,
+};
 #pragma endregion
 
 /** ============== STRUCTS ============== */
@@ -257,17 +276,35 @@ struct Instruction {
 struct Lambda {
 	VariableDeclarationList * variableDeclarationList;
 	Block * block;
+	CaptureType captureType;
+	CaptureList * captureList;
+};
+
+/**
+ * A free variable of a lambda. Mutable captures are assigned somewhere after
+ * the lambda is created, so they must be shared instead of copied. The
+ * receiver of a method is captured with the name "this".
+ */
+struct Capture {
+	char * name;
+	boolean isMutable;
 };
 
 struct Import{
 	char * PathToFile;
 };
 
+/**
+ * A class has scoped instances if they never outlive their initializer, so
+ * a construction whose result is discarded can place the instance in the
+ * frame of its caller. It's false until the escape analysis computes it.
+ */
 struct Class {
 	Object * object;
 	Object * inherits;
 	ImplementationList * implementationList;
 	Block * block;
+	boolean hasScopedInstances;
 };
 
 struct Interface {
@@ -465,6 +502,18 @@ void releaseInterface(Interface * interface);
 void releaseImportList(ImportList * importList);
 
 void releaseImport(Import * import_statement);
+
+/**
+ * Releases the memory used by a capture.
+ * @param capture Pointer to the capture to be released.
+ */
+void releaseCapture(Capture * capture);
+
+/**
+ * Releases the memory used by a capture list and its components.
+ * @param captureList Pointer to the capture list to be released.
+ */
+void releaseCaptureList(CaptureList * captureList);
 #pragma endregion
 // =======================================================
 
@@ -0,0 +1,64 @@
+#ifndef ABSTRACT_SYNTAX_TREE_NODES_HEADER
+#define ABSTRACT_SYNTAX_TREE_NODES_HEADER
+
+/**
+ * The description of every kind of node of the AST. The dispatch tables of
+ * the visitor are generated from these lists, so a new kind of node only
+ * needs an entry here, and a function that visits its children.
+ *
+ * Each entry is NODE(kind, tag, children): the tag is the value of the "type"
+ * field that selects the kind among the variants of its structure, and the
+ * children is the suffix of the function that visits them (i.e., the nodes
+ * with the same shape share that function).
+ */
+
+/** Structures without variants (their tag is unused). */
+#define STRUCTURE_NODES(NODE) \
+	NODE(PROGRAM_NODE, 0, Program) \
+	NODE(BRANCH_NODE, 0, Branch) \
+	NODE(PARAMETER_NODE, 0, Parameter)
+
+/** Variants of "Instruction". */
+#define INSTRUCTION_NODES(NODE) \
+	NODE(ASSIGNMENT_NODE, INSTRUCTION_ASSIGNMENT, Assignment) \
+	NODE(DECLARATION_NODE, INSTRUCTION_VARIABLE_DECLARATION, Declaration) \
+	NODE(EXPRESSION_STATEMENT_NODE, INSTRUCTION_EXPRESSION, ExpressionStatement) \
+	NODE(BLOCK_NODE, INSTRUCTION_BLOCK, Block) \
+	NODE(CONDITIONAL_NODE, INSTRUCTION_CONDITIONAL, Conditional) \
+	NODE(LOOP_NODE, INSTRUCTION_LOOP, Loop) \
+	NODE(CLASS_NODE, INSTRUCTION_CLASS, Class) \
+	NODE(INTERFACE_NODE, INSTRUCTION_INTERFACE, Interface) \
+	NODE(RETURN_NODE, INSTRUCTION_RETURN, Return) \
+	NODE(PASS_NODE, INSTRUCTION_PASS, Leaf)
+
+/** Variants of "Expression". */
+#define EXPRESSION_NODES(NODE) \
+	NODE(ADDITION_NODE, ADDITION, Arithmetic) \
+	NODE(DIVISION_NODE, DIVISION, Arithmetic) \
+	NODE(FACTOR_EXPRESSION_NODE, FACTOR, FactorExpression) \
+	NODE(MULTIPLICATION_NODE, MULTIPLICATION, Arithmetic) \
+	NODE(SUBTRACTION_NODE, SUBTRACTION, Arithmetic) \
+	NODE(LAMBDA_NODE, LAMBDA, Lambda) \
+	NODE(CALL_NODE, FUNCTION_CALL, Call) \
+	NODE(LESS_NODE, LESS_TYPE, Comparison) \
+	NODE(GREATER_NODE, GREATER_TYPE, Comparison) \
+	NODE(LESS_EQUAL_NODE, LESS_EQUAL_TYPE, Comparison) \
+	NODE(GREATER_EQUAL_NODE, GREATER_EQUAL_TYPE, Comparison) \
+	NODE(EQUAL_EQUAL_NODE, EQUAL_EQUAL_TYPE, Comparison) \
+	NODE(NOT_EQUAL_NODE, NOT_EQUAL_TYPE, Comparison)
+
+/** Variants of "Factor". */
+#define FACTOR_NODES(NODE) \
+	NODE(VARIABLE_NODE, VARIABLE_TYPE, Leaf) \
+	NODE(INCREMENT_NODE, INCREMENT_TYPE, Leaf) \
+	NODE(DECREMENT_NODE, DECREMENT_TYPE, Leaf) \
+	NODE(CONSTANT_NODE, CONSTANT, Leaf) \
+	NODE(PARENTHESIS_NODE, EXPRESSION, Parenthesis)
+
+#define AST_NODES(NODE) \
+	STRUCTURE_NODES(NODE) \
+	INSTRUCTION_NODES(NODE) \
+	EXPRESSION_NODES(NODE) \
+	FACTOR_NODES(NODE)
+
+#endif
@@ -106,6 +106,15 @@ Factor * ExpressionFactorSemanticAction(Expression * expression) {
 	return factor;
 }
 
+Expression * TemplateSemanticAction(Expression * template, Factor * part) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (template == NULL) {
+		char * empty = strdup("");
+		return FactorExpressionSemanticAction(ConstantFactorSemanticAction(ConstantSemanticAction(&empty, C_STRING_TYPE)));
+	}
+	return ArithmeticExpressionSemanticAction(template, FactorExpressionSemanticAction(part), ADDITION);
+}
+
 VariableDeclaration * VariableDeclarationSemanticAction(char * name, VariableType type, Expression * expression, Object * object, PrivacyList * privacyModifierList) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	
@@ -113,6 +113,16 @@ Factor * UnaryExpressionSemanticAction(char * name,  ExpressionType type);
  * @return A pointer to the created factor.
  */
 Factor * ExpressionFactorSemanticAction(Expression * expression);
+
+/**
+ * Appends a part (a text or an interpolated variable) to a template string,
+ * which is the concatenation of its parts. It starts as an empty string, so
+ * the parts are concatenated even if they're numbers.
+ * @param template The template string so far, or NULL if it has no parts yet.
+ * @param part The part to append, or NULL if it has no parts yet.
+ * @return A pointer to the template string with the part.
+ */
+Expression * TemplateSemanticAction(Expression * template, Factor * part);
 #pragma endregion
 // ========================================================
 
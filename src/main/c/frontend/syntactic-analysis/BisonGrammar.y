@@ -108,6 +108,10 @@
 		%token <c_boolean> C_BOOLEAN
 		%token <c_string> C_STRING
 
+		/** ===== Template Strings ===== */
+		%token <token> BACKTICK
+		%token <name> INTERPOLATION
+
 	// ------------------ [ Variables ] -------------------
 		/** ===== Privacy Types ===== */
 		%token <token> C_EXPOSED //Public
@@ -208,6 +212,7 @@
 		%type <expression> expression
 		%type <expression> comparator_expression
 		%type <expressionList> expression_list
+		%type <expression> template_parts
 
 	// ------------------ [ Control ] ------------------
 		/** ===== Conditionals ===== */
@@ -448,6 +453,13 @@
 			| NAME INCREMENT 																							{ $$ = UnaryExpressionSemanticAction($1, INCREMENT_TYPE); }
 			| NAME DECREMENT 																							{ $$ = UnaryExpressionSemanticAction($1, DECREMENT_TYPE); }
 			| constant																									{ $$ = ConstantFactorSemanticAction($1); }
+			| BACKTICK template_parts BACKTICK																			{ $$ = ExpressionFactorSemanticAction($2); }
+			;
+
+		/** ===== Template String ===== */
+		template_parts: %empty																							{ $$ = TemplateSemanticAction(NULL, NULL); }
+			| template_parts[template] C_STRING																			{ $$ = TemplateSemanticAction($template, ConstantFactorSemanticAction(ConstantSemanticAction(&$2, C_STRING_TYPE))); }
+			| template_parts[template] INTERPOLATION																	{ $$ = TemplateSemanticAction($template, VariableExpressionSemanticAction($2)); }
 			;
 
 	// ------------------ [ Miscellaneous ] ----------------------
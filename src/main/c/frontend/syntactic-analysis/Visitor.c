@@ -0,0 +1,264 @@
+#include "Visitor.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The state of a fused walk. A visitor that skipped the children of a node
+ * remembers the depth of that node, and stays inactive until it's left.
+ */
+typedef struct {
+	Visitor ** visitors;
+	int * skippedAt;
+	int count;
+	int active;
+	int depth;
+} Walk;
+
+typedef void (*ChildrenFunction)(Walk * walk, void * node);
+
+/* PRIVATE FUNCTIONS */
+
+static void _visit(Walk * walk, const NodeKind kind, void * node);
+static void _visitBlock(Walk * walk, Block * block);
+static void _visitExpression(Walk * walk, Expression * expression);
+static void _visitFactor(Walk * walk, Factor * factor);
+static void _visitInstruction(Walk * walk, Instruction * instruction);
+static void _walkArithmetic(Walk * walk, void * node);
+static void _walkAssignment(Walk * walk, void * node);
+static void _walkBlock(Walk * walk, void * node);
+static void _walkBranch(Walk * walk, void * node);
+static void _walkCall(Walk * walk, void * node);
+static void _walkClass(Walk * walk, void * node);
+static void _walkComparison(Walk * walk, void * node);
+static void _walkConditional(Walk * walk, void * node);
+static void _walkDeclaration(Walk * walk, void * node);
+static void _walkExpressionStatement(Walk * walk, void * node);
+static void _walkFactorExpression(Walk * walk, void * node);
+static void _walkInterface(Walk * walk, void * node);
+static void _walkLambda(Walk * walk, void * node);
+static void _walkLeaf(Walk * walk, void * node);
+static void _walkLoop(Walk * walk, void * node);
+static void _walkParameter(Walk * walk, void * node);
+static void _walkParenthesis(Walk * walk, void * node);
+static void _walkProgram(Walk * walk, void * node);
+static void _walkReturn(Walk * walk, void * node);
+
+/** The function that visits the children of each kind of node. */
+static const ChildrenFunction _children[NODE_KIND_COUNT] = {
+#define NODE(kind, tag, children) [kind] = _walk##children,
+	AST_NODES(NODE)
+#undef NODE
+};
+
+static const char * const _names[NODE_KIND_COUNT] = {
+#define NODE(kind, tag, children) [kind] = #kind,
+	AST_NODES(NODE)
+#undef NODE
+};
+
+static const NodeKind _instructionKinds[] = {
+#define NODE(kind, tag, children) [tag] = kind,
+	INSTRUCTION_NODES(NODE)
+#undef NODE
+};
+
+static const NodeKind _expressionKinds[] = {
+#define NODE(kind, tag, children) [tag] = kind,
+	EXPRESSION_NODES(NODE)
+#undef NODE
+};
+
+static const NodeKind _factorKinds[] = {
+#define NODE(kind, tag, children) [tag] = kind,
+	FACTOR_NODES(NODE)
+#undef NODE
+};
+
+static void _visit(Walk * walk, const NodeKind kind, void * node) {
+	const int depth = ++walk->depth;
+	for (int k = 0; k < walk->count; ++k) {
+		if (walk->skippedAt[k] != 0) continue;
+		PreVisitFunction pre = walk->visitors[k]->pre[kind];
+		if (pre != NULL && pre(walk->visitors[k]->state, node) == VISIT_SKIP_CHILDREN) {
+			walk->skippedAt[k] = depth;
+			--walk->active;
+		}
+	}
+	if (0 < walk->active) {
+		_children[kind](walk, node);
+	}
+	for (int k = walk->count - 1; 0 <= k; --k) {
+		if (walk->skippedAt[k] != 0 && walk->skippedAt[k] != depth) continue;
+		PostVisitFunction post = walk->visitors[k]->post[kind];
+		if (post != NULL) {
+			post(walk->visitors[k]->state, node);
+		}
+		if (walk->skippedAt[k] == depth) {
+			walk->skippedAt[k] = 0;
+			++walk->active;
+		}
+	}
+	--walk->depth;
+}
+
+static void _visitBlock(Walk * walk, Block * block) {
+	if (block == NULL) return;
+	for (Node * node = block->first; node != NULL; node = node->next) {
+		_visitInstruction(walk, node->data);
+	}
+}
+
+static void _visitInstruction(Walk * walk, Instruction * instruction) {
+	if (instruction != NULL) {
+		_visit(walk, instructionKind(instruction), instruction);
+	}
+}
+
+static void _visitExpression(Walk * walk, Expression * expression) {
+	if (expression != NULL) {
+		_visit(walk, expressionKind(expression), expression);
+	}
+}
+
+static void _visitFactor(Walk * walk, Factor * factor) {
+	if (factor != NULL) {
+		_visit(walk, factorKind(factor), factor);
+	}
+}
+
+static void _walkProgram(Walk * walk, void * node) {
+	_visitBlock(walk, ((Program *) node)->block);
+}
+
+static void _walkBranch(Walk * walk, void * node) {
+	Conditional * conditional = node;
+	_visitExpression(walk, conditional->expression);
+	_visitBlock(walk, conditional->block);
+}
+
+static void _walkParameter(Walk * walk, void * node) {
+	_visitExpression(walk, ((VariableDeclaration *) node)->expression);
+}
+
+static void _walkAssignment(Walk * walk, void * node) {
+	_visitExpression(walk, ((Instruction *) node)->assignment->expression);
+}
+
+static void _walkDeclaration(Walk * walk, void * node) {
+	_visitExpression(walk, ((Instruction *) node)->variableDeclaration->expression);
+}
+
+static void _walkExpressionStatement(Walk * walk, void * node) {
+	_visitExpression(walk, ((Instruction *) node)->expression);
+}
+
+static void _walkBlock(Walk * walk, void * node) {
+	_visitBlock(walk, ((Instruction *) node)->block);
+}
+
+static void _walkConditional(Walk * walk, void * node) {
+	for (Conditional * conditional = ((Instruction *) node)->conditional; conditional != NULL; conditional = conditional->nextConditional) {
+		_visit(walk, BRANCH_NODE, conditional);
+	}
+}
+
+static void _walkLoop(Walk * walk, void * node) {
+	Loop * loop = ((Instruction *) node)->loop;
+	_visitExpression(walk, loop->expression);
+	_visitBlock(walk, loop->block);
+}
+
+static void _walkClass(Walk * walk, void * node) {
+	_visitBlock(walk, ((Instruction *) node)->class->block);
+}
+
+static void _walkInterface(Walk * walk, void * node) {
+	_visitBlock(walk, ((Instruction *) node)->interface->block);
+}
+
+static void _walkReturn(Walk * walk, void * node) {
+	_visitInstruction(walk, ((Instruction *) node)->returnInstruction);
+}
+
+static void _walkLeaf(Walk * walk, void * node) {
+	(void) walk;
+	(void) node;
+}
+
+static void _walkArithmetic(Walk * walk, void * node) {
+	Expression * expression = node;
+	_visitExpression(walk, expression->leftExpression);
+	_visitExpression(walk, expression->rightExpression);
+}
+
+static void _walkComparison(Walk * walk, void * node) {
+	Expression * expression = node;
+	_visitFactor(walk, expression->leftFactor);
+	_visitFactor(walk, expression->rightFactor);
+}
+
+static void _walkFactorExpression(Walk * walk, void * node) {
+	_visitFactor(walk, ((Expression *) node)->factor);
+}
+
+static void _walkLambda(Walk * walk, void * node) {
+	Lambda * lambda = ((Expression *) node)->lambda;
+	if (lambda->variableDeclarationList != NULL) {
+		for (Node * parameter = lambda->variableDeclarationList->first; parameter != NULL; parameter = parameter->next) {
+			_visit(walk, PARAMETER_NODE, parameter->data);
+		}
+	}
+	_visitBlock(walk, lambda->block);
+}
+
+static void _walkCall(Walk * walk, void * node) {
+	FunctionCall * functionCall = ((Expression *) node)->functionCall;
+	if (functionCall->expressionList == NULL) return;
+	for (Node * argument = functionCall->expressionList->first; argument != NULL; argument = argument->next) {
+		_visitExpression(walk, argument->data);
+	}
+}
+
+static void _walkParenthesis(Walk * walk, void * node) {
+	_visitExpression(walk, ((Factor *) node)->expression);
+}
+
+/* PUBLIC FUNCTIONS */
+
+const char * nodeKindName(const NodeKind kind) {
+	return _names[kind];
+}
+
+NodeKind instructionKind(const Instruction * instruction) {
+	return _instructionKinds[instruction->type];
+}
+
+NodeKind expressionKind(const Expression * expression) {
+	return _expressionKinds[expression->type];
+}
+
+NodeKind factorKind(const Factor * factor) {
+	return _factorKinds[factor->type];
+}
+
+void walkProgram(Program * program, Visitor ** visitors, const int count) {
+	if (program == NULL || count == 0) return;
+	Walk walk = { 0 };
+	walk.visitors = visitors;
+	walk.count = count;
+	walk.active = count;
+	walk.skippedAt = calloc(count, sizeof(int));
+	_visit(&walk, PROGRAM_NODE, program);
+	free(walk.skippedAt);
+}
+
+void walkBlock(Block * block, Visitor ** visitors, const int count) {
+	if (block == NULL || count == 0) return;
+	Walk walk = { 0 };
+	walk.visitors = visitors;
+	walk.count = count;
+	walk.active = count;
+	walk.skippedAt = calloc(count, sizeof(int));
+	_visitBlock(&walk, block);
+	free(walk.skippedAt);
+}
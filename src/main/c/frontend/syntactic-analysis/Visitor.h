@@ -0,0 +1,63 @@
+#ifndef VISITOR_HEADER
+#define VISITOR_HEADER
+
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+#include "AbstractSyntaxTreeNodes.h"
+#include <stdlib.h>
+
+/**
+ * The kinds of node, generated from the description of the AST. Every node
+ * is visited with a pointer to its structure: "Program", "Conditional" (a
+ * branch), "VariableDeclaration" (a parameter), "Instruction", "Expression"
+ * or "Factor".
+ */
+typedef enum {
+#define NODE(kind, tag, children) kind,
+	AST_NODES(NODE)
+#undef NODE
+	NODE_KIND_COUNT
+} NodeKind;
+
+typedef enum {
+	VISIT_CHILDREN,
+	VISIT_SKIP_CHILDREN
+} VisitAction;
+
+typedef VisitAction (*PreVisitFunction)(void * state, void * node);
+typedef void (*PostVisitFunction)(void * state, void * node);
+
+/**
+ * A pass over the AST, as a table of callbacks indexed by kind of node (a
+ * NULL entry ignores that kind). The pre-order callback of a node can skip
+ * its children for this visitor only; the post-order callback of that node
+ * still runs. The finish callback runs once, after the walk.
+ */
+typedef struct {
+	const char * name;
+	PreVisitFunction pre[NODE_KIND_COUNT];
+	PostVisitFunction post[NODE_KIND_COUNT];
+	void (*finish)(void * state);
+	void * state;
+} Visitor;
+
+/** The name of the kind, for logging. */
+const char * nodeKindName(const NodeKind kind);
+
+NodeKind instructionKind(const Instruction * instruction);
+NodeKind expressionKind(const Expression * expression);
+NodeKind factorKind(const Factor * factor);
+
+/**
+ * Walks the tree once, running several visitors at the same time: at every
+ * node, the pre-order callbacks run in the order of the array, and the
+ * post-order ones in the reverse order, so each visitor observes the same
+ * sequence it would observe on its own. Visitors must not restructure the
+ * tree. The finish callbacks are not called.
+ */
+void walkProgram(Program * program, Visitor ** visitors, const int count);
+
+/** Like "walkProgram", but walks the instructions of a block. */
+void walkBlock(Block * block, Visitor ** visitors, const int count);
+
+#endif
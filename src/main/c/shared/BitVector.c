@@ -0,0 +1,93 @@
+#include "BitVector.h"
+
+#define BITS_PER_WORD 64
+
+/* PRIVATE FUNCTIONS */
+
+static void _clearPadding(BitVector * vector);
+
+/**
+ * Keeps the unused bits of the last word cleared, so whole-word operations
+ * never leak bits outside the range [0, size).
+ */
+static void _clearPadding(BitVector * vector) {
+	const int used = vector->size % BITS_PER_WORD;
+	if (0 < used) {
+		vector->words[vector->wordCount - 1] &= (((uint64_t) 1) << used) - 1;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+BitVector * createBitVector(const int size) {
+	BitVector * vector = calloc(1, sizeof(BitVector));
+	vector->size = size;
+	vector->wordCount = (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	vector->words = calloc(vector->wordCount == 0 ? 1 : vector->wordCount, sizeof(uint64_t));
+	return vector;
+}
+
+void destroyBitVector(BitVector * vector) {
+	if (vector != NULL) {
+		free(vector->words);
+		free(vector);
+	}
+}
+
+void setBit(BitVector * vector, const int bit) {
+	vector->words[bit / BITS_PER_WORD] |= ((uint64_t) 1) << (bit % BITS_PER_WORD);
+}
+
+void clearBit(BitVector * vector, const int bit) {
+	vector->words[bit / BITS_PER_WORD] &= ~(((uint64_t) 1) << (bit % BITS_PER_WORD));
+}
+
+boolean testBit(const BitVector * vector, const int bit) {
+	return (vector->words[bit / BITS_PER_WORD] >> (bit % BITS_PER_WORD)) & 1 ? true : false;
+}
+
+void fillBitVector(BitVector * vector) {
+	memset(vector->words, 0xFF, vector->wordCount * sizeof(uint64_t));
+	_clearPadding(vector);
+}
+
+void clearBitVector(BitVector * vector) {
+	memset(vector->words, 0, vector->wordCount * sizeof(uint64_t));
+}
+
+boolean copyBitVector(BitVector * target, const BitVector * source) {
+	boolean changed = false;
+	for (int k = 0; k < target->wordCount; ++k) {
+		if (target->words[k] != source->words[k]) {
+			target->words[k] = source->words[k];
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+boolean unionBitVector(BitVector * target, const BitVector * source) {
+	uint64_t changed = 0;
+	for (int k = 0; k < target->wordCount; ++k) {
+		const uint64_t word = target->words[k] | source->words[k];
+		changed |= word ^ target->words[k];
+		target->words[k] = word;
+	}
+	return changed ? true : false;
+}
+
+boolean intersectBitVector(BitVector * target, const BitVector * source) {
+	uint64_t changed = 0;
+	for (int k = 0; k < target->wordCount; ++k) {
+		const uint64_t word = target->words[k] & source->words[k];
+		changed |= word ^ target->words[k];
+		target->words[k] = word;
+	}
+	return changed ? true : false;
+}
+
+void subtractBitVector(BitVector * target, const BitVector * source) {
+	for (int k = 0; k < target->wordCount; ++k) {
+		target->words[k] &= ~source->words[k];
+	}
+}
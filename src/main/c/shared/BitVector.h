@@ -0,0 +1,53 @@
+#ifndef BIT_VECTOR_HEADER
+#define BIT_VECTOR_HEADER
+
+#include "Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A dense set of integers in the range [0, size), packed in 64-bit words.
+ * The binary operations require vectors of the same size, and store the
+ * result in the first one.
+ */
+typedef struct {
+	uint64_t * words;
+	int wordCount;
+	int size;
+} BitVector;
+
+/** Creates an empty bit-vector (using heap-memory). */
+BitVector * createBitVector(const int size);
+
+/** Releases the bit-vector. */
+void destroyBitVector(BitVector * vector);
+
+/** Adds the bit to the set. */
+void setBit(BitVector * vector, const int bit);
+
+/** Removes the bit from the set. */
+void clearBit(BitVector * vector, const int bit);
+
+/** Whether the bit belongs to the set. */
+boolean testBit(const BitVector * vector, const int bit);
+
+/** Adds every bit in the range [0, size) to the set. */
+void fillBitVector(BitVector * vector);
+
+/** Removes every bit from the set. */
+void clearBitVector(BitVector * vector);
+
+/** Copies the source into the target, and returns whether it changed. */
+boolean copyBitVector(BitVector * target, const BitVector * source);
+
+/** Computes "target = target ∪ source", and returns whether it changed. */
+boolean unionBitVector(BitVector * target, const BitVector * source);
+
+/** Computes "target = target ∩ source", and returns whether it changed. */
+boolean intersectBitVector(BitVector * target, const BitVector * source);
+
+/** Computes "target = target - source". */
+void subtractBitVector(BitVector * target, const BitVector * source);
+
+#endif
@@ -15,6 +15,19 @@ const boolean getBooleanOrDefault(const char * name, const boolean defaultValue)
 	}
 }
 
+const int getIntegerOrDefault(const char * name, const int defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL || *value == '\0') {
+		return defaultValue;
+	}
+	char * end = NULL;
+	const long integer = strtol(value, &end, 10);
+	if (*end != '\0') {
+		return defaultValue;
+	}
+	return (int) integer;
+}
+
 const char * getStringOrDefault(const char * name, const char * defaultValue) {
 	const char * value = getenv(name);
 	if (value == NULL) {
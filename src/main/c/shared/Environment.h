@@ -12,6 +12,12 @@
  */
 const boolean getBooleanOrDefault(const char * name, const boolean defaultValue);
 
+/**
+ * Analog to "getStringOrDefault", but parsing the value as a decimal integer.
+ * The default value is also used when the value is not a valid integer.
+ */
+const int getIntegerOrDefault(const char * name, const int defaultValue);
+
 /**
  * Gets the value of an environment variable by name, or returns a default
  * value if the variable is undefined.
@@ -1,8 +1,26 @@
 #include "Logger.h"
 
+/* MODULE INTERNAL STATE */
+
+typedef struct LogLine LogLine;
+
+struct LogLine {
+	boolean isError;
+	char * text;
+	LogLine * next;
+};
+
+struct LogBuffer {
+	LogLine * first;
+	LogLine * last;
+};
+
+static THREAD_LOCAL LogBuffer * _buffer = NULL;
+
 /* PRIVATE FUNCTIONS */
 
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments);
+static void _logInBuffer(LogBuffer * buffer, const boolean isError, const char * const format, va_list arguments);
 static LoggingLevel _loggingLevelFromString(const char * loggingLevel);
 static void _logInStream(FILE * const stream, const char * const format, va_list arguments);
 static const char * _toContextString(const LoggingLevel loggingLevel);
@@ -14,7 +32,10 @@ static void _log(const Logger * logger, const LoggingLevel loggingLevel, const c
 	if (logger->loggingLevel <= loggingLevel) {
 		const char * context = _toContextString(loggingLevel);
 		char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
-		if (ERROR <= loggingLevel) {
+		if (_buffer != NULL) {
+			_logInBuffer(_buffer, ERROR <= loggingLevel ? true : false, effectiveFormat, arguments);
+		}
+		else if (ERROR <= loggingLevel) {
 			_logInStream(stderr, effectiveFormat, arguments);
 		}
 		else {
@@ -24,6 +45,28 @@ static void _log(const Logger * logger, const LoggingLevel loggingLevel, const c
 	}
 }
 
+/**
+ * Formats a line in heap-memory, and appends it to the buffer.
+ */
+static void _logInBuffer(LogBuffer * buffer, const boolean isError, const char * const format, va_list arguments) {
+	char probe[1];
+	va_list copy;
+	va_copy(copy, arguments);
+	const int length = vsnprintf(probe, sizeof(probe), format, copy);
+	va_end(copy);
+	LogLine * line = calloc(1, sizeof(LogLine));
+	line->isError = isError;
+	line->text = calloc(1 + length, sizeof(char));
+	vsnprintf(line->text, 1 + length, format, arguments);
+	if (buffer->last == NULL) {
+		buffer->first = line;
+	}
+	else {
+		buffer->last->next = line;
+	}
+	buffer->last = line;
+}
+
 /**
  * Gets the logging level from the specified string. Returns CRITICAL if the
  * provided value is unknown.
@@ -85,6 +128,40 @@ void destroyLogger(Logger * logger) {
 	}
 }
 
+LogBuffer * createLogBuffer() {
+	return calloc(1, sizeof(LogBuffer));
+}
+
+void destroyLogBuffer(LogBuffer * buffer) {
+	if (buffer != NULL) {
+		LogLine * line = buffer->first;
+		while (line != NULL) {
+			LogLine * next = line->next;
+			free(line->text);
+			free(line);
+			line = next;
+		}
+		free(buffer);
+	}
+}
+
+void flushLogBuffer(LogBuffer * buffer) {
+	LogLine * line = buffer->first;
+	while (line != NULL) {
+		LogLine * next = line->next;
+		fputs(line->text, line->isError ? stderr : stdout);
+		free(line->text);
+		free(line);
+		line = next;
+	}
+	buffer->first = NULL;
+	buffer->last = NULL;
+}
+
+void redirectLogs(LogBuffer * buffer) {
+	_buffer = buffer;
+}
+
 void logCritical(const Logger * logger, const char * const format, ...) {
 	va_list arguments;
 	va_start(arguments, format);
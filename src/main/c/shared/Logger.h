@@ -53,6 +53,17 @@
 #define WARNING_COLOR ""
 #endif
 
+/**
+ * Storage with a separate instance per thread.
+ */
+#if defined (_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#elif defined (__GNUC__)
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
 /**
  * The available logging levels. Highest levels represents worst failures;
  * lower levels provides greater traceability.
@@ -75,6 +86,13 @@ typedef struct {
 	char * name;
 } Logger;
 
+/**
+ * An in-memory sequence of log lines. Lines logged while a buffer is active
+ * in the current thread are retained, instead of being printed, so the output
+ * of concurrent tasks can be printed later in a deterministic order.
+ */
+typedef struct LogBuffer LogBuffer;
+
 /**
  * Creates a new logger with the specified name. That name will be visible in
  * every line you log with this object.
@@ -86,6 +104,24 @@ Logger * createLogger(char * name);
  */
 void destroyLogger(Logger * logger);
 
+/** Creates an empty log buffer. */
+LogBuffer * createLogBuffer();
+
+/** Destroy a log buffer and its pending lines. */
+void destroyLogBuffer(LogBuffer * buffer);
+
+/**
+ * Prints the pending lines of the buffer, in the order they were logged, and
+ * empties it.
+ */
+void flushLogBuffer(LogBuffer * buffer);
+
+/**
+ * Retains the logs of the calling thread in the buffer. A NULL buffer restores
+ * the console output.
+ */
+void redirectLogs(LogBuffer * buffer);
+
 /** Logs at CRITICAL level. */
 void logCritical(const Logger * logger, const char * const format, ...);
 
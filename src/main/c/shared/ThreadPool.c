@@ -0,0 +1,142 @@
+#include "ThreadPool.h"
+
+/* MODULE INTERNAL STATE */
+
+struct ThreadPool {
+	int workerCount;
+#ifdef THREAD_POOL_WORKERS
+	pthread_t * workers;
+	pthread_mutex_t mutex;
+	pthread_cond_t started;
+	pthread_cond_t finished;
+	unsigned long generation;
+	boolean isStopping;
+	TaskFunction task;
+	void * context;
+	int count;
+	int next;
+	int finishedWorkers;
+#endif
+};
+
+/* PRIVATE FUNCTIONS */
+
+#ifdef THREAD_POOL_WORKERS
+
+static void _runTasks(ThreadPool * pool, TaskFunction task, void * context, const int count);
+static void * _work(void * argument);
+
+/**
+ * Takes indexes of the current batch until none are left.
+ */
+static void _runTasks(ThreadPool * pool, TaskFunction task, void * context, const int count) {
+	int index;
+	while ((index = __sync_fetch_and_add(&pool->next, 1)) < count) {
+		task(context, index);
+	}
+}
+
+static void * _work(void * argument) {
+	ThreadPool * pool = argument;
+	unsigned long generation = 0;
+	pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (pool->generation == generation && !pool->isStopping) {
+			pthread_cond_wait(&pool->started, &pool->mutex);
+		}
+		if (pool->isStopping) break;
+		generation = pool->generation;
+		TaskFunction task = pool->task;
+		void * context = pool->context;
+		const int count = pool->count;
+		pthread_mutex_unlock(&pool->mutex);
+		_runTasks(pool, task, context, count);
+		pthread_mutex_lock(&pool->mutex);
+		if (++pool->finishedWorkers == pool->workerCount) {
+			pthread_cond_signal(&pool->finished);
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+#endif
+
+/* PUBLIC FUNCTIONS */
+
+ThreadPool * createThreadPool(const int size) {
+	ThreadPool * pool = calloc(1, sizeof(ThreadPool));
+#ifdef THREAD_POOL_WORKERS
+	int threads = size;
+#ifdef _SC_NPROCESSORS_ONLN
+	if (threads <= 0) {
+		threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	}
+#endif
+	if (threads <= 0) {
+		threads = 1;
+	}
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->started, NULL);
+	pthread_cond_init(&pool->finished, NULL);
+	pool->workers = calloc(threads, sizeof(pthread_t));
+	for (int k = 0; k < threads - 1; ++k) {
+		if (pthread_create(&pool->workers[pool->workerCount], NULL, _work, pool) == 0) {
+			++pool->workerCount;
+		}
+	}
+#else
+	(void) size;
+#endif
+	return pool;
+}
+
+void destroyThreadPool(ThreadPool * pool) {
+	if (pool == NULL) return;
+#ifdef THREAD_POOL_WORKERS
+	pthread_mutex_lock(&pool->mutex);
+	pool->isStopping = true;
+	pthread_cond_broadcast(&pool->started);
+	pthread_mutex_unlock(&pool->mutex);
+	for (int k = 0; k < pool->workerCount; ++k) {
+		pthread_join(pool->workers[k], NULL);
+	}
+	pthread_cond_destroy(&pool->finished);
+	pthread_cond_destroy(&pool->started);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->workers);
+#endif
+	free(pool);
+}
+
+int getThreadPoolSize(const ThreadPool * pool) {
+	return 1 + pool->workerCount;
+}
+
+void runInThreadPool(ThreadPool * pool, TaskFunction task, void * context, const int count) {
+	if (pool->workerCount == 0 || count <= 1) {
+		for (int k = 0; k < count; ++k) {
+			task(context, k);
+		}
+		return;
+	}
+#ifdef THREAD_POOL_WORKERS
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->context = context;
+	pool->count = count;
+	pool->next = 0;
+	pool->finishedWorkers = 0;
+	pool->generation += 1;
+	pthread_cond_broadcast(&pool->started);
+	pthread_mutex_unlock(&pool->mutex);
+
+	_runTasks(pool, task, context, count);
+
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->finishedWorkers < pool->workerCount) {
+		pthread_cond_wait(&pool->finished, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+#endif
+}
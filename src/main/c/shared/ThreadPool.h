@@ -0,0 +1,45 @@
+#ifndef THREAD_POOL_HEADER
+#define THREAD_POOL_HEADER
+
+#include "Type.h"
+#include <stdlib.h>
+
+/**
+ * Workers need POSIX threads, and the atomic builtins of GCC (or Clang).
+ * Without them, a pool has no workers, and every batch runs in the caller.
+ */
+#if defined (HAVE_PTHREADS) && defined (__GNUC__)
+#define THREAD_POOL_WORKERS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A task of a batch. The index identifies the item of the batch to process,
+ * and the context is shared by every task of the batch.
+ */
+typedef void (*TaskFunction)(void * context, const int index);
+
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Creates a pool with the specified amount of threads, counting the caller,
+ * which also runs tasks while it waits for a batch. A non-positive size uses
+ * one thread per online processor.
+ */
+ThreadPool * createThreadPool(const int size);
+
+/** Stops the workers, and releases the pool. */
+void destroyThreadPool(ThreadPool * pool);
+
+/** The amount of threads of the pool, counting the caller. */
+int getThreadPoolSize(const ThreadPool * pool);
+
+/**
+ * Runs the task for every index in [0, count), and returns when all of them
+ * are done. Indexes are handed out one at a time, so uneven tasks still keep
+ * every thread busy. Batches cannot be nested.
+ */
+void runInThreadPool(ThreadPool * pool, TaskFunction task, void * context, const int count);
+
+#endif